@@ -137,6 +137,7 @@ AC3DImporter::AC3DImporter()
     : buffer(),
     configSplitBFCull(),
     configEvalSubdivision(),
+    configSubdivisionMaxError(),
     mNumMeshes(),
     mLights(),
     lights(),
@@ -711,6 +712,7 @@ aiNode* AC3DImporter::ConvertObjectSection(Object& object,
             if (object.subDiv)  {
                 if (configEvalSubdivision) {
                     std::unique_ptr<Subdivider> div(Subdivider::Create(Subdivider::CATMULL_CLARKE));
+                    div->SetMaxError(configSubdivisionMaxError);
                     DefaultLogger::get()->info("AC3D: Evaluating subdivision surface: "+object.name);
 
                     std::vector<aiMesh*> cpy(meshes.size()-oldm,NULL);
@@ -782,6 +784,7 @@ void AC3DImporter::SetupProperties(const Importer* pImp)
 {
     configSplitBFCull = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_AC_SEPARATE_BFCULL,1) ? true : false;
     configEvalSubdivision =  pImp->GetPropertyInteger(AI_CONFIG_IMPORT_AC_EVAL_SUBDIVISION,1) ? true : false;
+    configSubdivisionMaxError = pImp->GetPropertyFloat(AI_CONFIG_IMPORT_AC_SUBDIVISION_MAX_ERROR,0.f);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -258,6 +258,10 @@ private:
     // evaluated if the value is true.
     bool configEvalSubdivision;
 
+    // Configuration option: error bound for adaptive
+    // subdivision, 0 to disable.
+    ai_real configSubdivisionMaxError;
+
     // counts how many objects we have in the tree.
     // basing on this information we can find a
     // good estimate how many meshes we'll have in the final scene.
@@ -52,6 +52,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "TextureTransform.h"
 #include "ASELoader.h"
 #include "fast_atof.h"
+#include "TextCursor.h"
 #include <assimp/DefaultLogger.hpp>
 
 using namespace Assimp;
@@ -87,7 +88,8 @@ using namespace Assimp::ASE;
         ++iLineNumber; \
         bLastWasEndLine = true; \
     } else bLastWasEndLine = false; \
-    ++filePtr;
+    ++filePtr; \
+    SkipPlainText();
 
 // ------------------------------------------------------------------------------------------------
 // Handle a nested section in the file. EOF is an error in this case
@@ -115,13 +117,15 @@ using namespace Assimp::ASE;
         ++iLineNumber; \
         bLastWasEndLine = true; \
     } else bLastWasEndLine = false; \
-    ++filePtr;
+    ++filePtr; \
+    SkipPlainText();
 
 // ------------------------------------------------------------------------------------------------
 Parser::Parser (const char* szFile, unsigned int fileFormatDefault)
 {
     ai_assert(NULL != szFile);
     filePtr = szFile;
+    fileEnd = szFile + ::strlen(szFile);
     iFileFormat = fileFormatDefault;
 
     // make sure that the color values are invalid
@@ -206,6 +210,20 @@ bool Parser::SkipToNextToken()
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+void Parser::SkipPlainText()
+{
+    if (filePtr < fileEnd)
+    {
+        const char* sz = FindFirstOf(filePtr,fileEnd,"*{}\r\n\f",6);
+        if (sz != filePtr)
+        {
+            bLastWasEndLine = false;
+            filePtr = sz;
+        }
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 bool Parser::SkipSection()
 {
@@ -2088,6 +2106,14 @@ void Parser::ParseLV4MeshLongTriple(unsigned int* apOut)
 {
     ai_assert(NULL != apOut);
 
+    // try to read all of them at once first
+    const char* sz;
+    if (strtoul10_n(filePtr,fileEnd,apOut,3,&sz) == 3)
+    {
+        filePtr = sz;
+        return;
+    }
+
     for (unsigned int i = 0; i < 3;++i)
         ParseLV4MeshLong(apOut[i]);
 }
@@ -2118,6 +2144,14 @@ void Parser::ParseLV4MeshFloatTriple(ai_real* apOut)
 {
     ai_assert(NULL != apOut);
 
+    // try to read all of them at once first
+    const char* sz;
+    if (fast_atoreal_n<ai_real>(filePtr,fileEnd,apOut,3,&sz) == 3)
+    {
+        filePtr = sz;
+        return;
+    }
+
     for (unsigned int i = 0; i < 3;++i)
         ParseLV4MeshFloat(apOut[i]);
 }
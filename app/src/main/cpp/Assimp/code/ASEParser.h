@@ -582,6 +582,11 @@ private:
     //! Skip everything to the next: '*' or '\0'
     bool SkipToNextToken();
 
+    // -------------------------------------------------------------------
+    //! Skip all characters up to the next '*', '{', '}' or line end.
+    //! The section handlers would just step over them one by one.
+    void SkipPlainText();
+
     // -------------------------------------------------------------------
     //! Skip the current section until the token after the closing }.
     //! This function handles embedded subsections correctly
@@ -615,6 +620,9 @@ public:
     //! Pointer to current data
     const char* filePtr;
 
+    //! Terminating zero of the data
+    const char* fileEnd;
+
     //! background color to be passed to the viewer
     //! QNAN if none was found
     aiColor3D m_clrBackground;
@@ -451,6 +451,9 @@ inline size_t WriteArray(IOStream * stream, const T* in, unsigned int size)
             if (mesh->mTangents && mesh->mBitangents) {
                 c |= ASSBIN_MESH_HAS_TANGENTS_AND_BITANGENTS;
             }
+            if (mesh->HasMeshlets()) {
+                c |= ASSBIN_MESH_HAS_MESHLETS;
+            }
             for (unsigned int n = 0; n < AI_MAX_NUMBER_OF_TEXTURECOORDS;++n) {
                 if (!mesh->mTextureCoords[n]) {
                     break;
@@ -558,6 +561,27 @@ inline size_t WriteArray(IOStream * stream, const T* in, unsigned int size)
                     WriteBinaryBone(&chunk,b);
                 }
             }
+
+            // write meshlets
+            if (mesh->HasMeshlets()) {
+                Write<unsigned int>(&chunk,mesh->mNumMeshlets);
+                for (unsigned int a = 0; a < mesh->mNumMeshlets;++a) {
+                    const aiMeshlet& m = mesh->mMeshlets[a];
+                    Write<unsigned int>(&chunk,m.mVertexOffset);
+                    Write<unsigned int>(&chunk,m.mTriangleOffset);
+                    Write<unsigned int>(&chunk,m.mNumVertices);
+                    Write<unsigned int>(&chunk,m.mNumTriangles);
+                    Write<aiVector3D>(&chunk,m.mCenter);
+                    Write<ai_real>(&chunk,m.mRadius);
+                    Write<aiVector3D>(&chunk,m.mConeApex);
+                    Write<aiVector3D>(&chunk,m.mConeAxis);
+                    Write<ai_real>(&chunk,m.mConeCutoff);
+                }
+                Write<unsigned int>(&chunk,mesh->mNumMeshletVertices);
+                WriteArray<unsigned int>(&chunk,mesh->mMeshletVertices,mesh->mNumMeshletVertices);
+                Write<unsigned int>(&chunk,mesh->mNumMeshletTriangles);
+                chunk.Write(mesh->mMeshletTriangles,1,mesh->mNumMeshletTriangles * 3);
+            }
         }
 
         // -----------------------------------------------------------------------------------
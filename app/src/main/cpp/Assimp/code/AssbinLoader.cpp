@@ -421,6 +421,29 @@ void AssbinImporter::ReadBinaryMesh( IOStream * stream, aiMesh* mesh )
             ReadBinaryBone(stream,mesh->mBones[a]);
         }
     }
+
+    if (c & ASSBIN_MESH_HAS_MESHLETS) {
+        mesh->mNumMeshlets = Read<unsigned int>(stream);
+        mesh->mMeshlets = new aiMeshlet[mesh->mNumMeshlets];
+        for (unsigned int a = 0; a < mesh->mNumMeshlets;++a) {
+            aiMeshlet& m = mesh->mMeshlets[a];
+            m.mVertexOffset = Read<unsigned int>(stream);
+            m.mTriangleOffset = Read<unsigned int>(stream);
+            m.mNumVertices = Read<unsigned int>(stream);
+            m.mNumTriangles = Read<unsigned int>(stream);
+            m.mCenter = Read<aiVector3D>(stream);
+            m.mRadius = Read<ai_real>(stream);
+            m.mConeApex = Read<aiVector3D>(stream);
+            m.mConeAxis = Read<aiVector3D>(stream);
+            m.mConeCutoff = Read<ai_real>(stream);
+        }
+        mesh->mNumMeshletVertices = Read<unsigned int>(stream);
+        mesh->mMeshletVertices = new unsigned int[mesh->mNumMeshletVertices];
+        ReadArray<unsigned int>(stream,mesh->mMeshletVertices,mesh->mNumMeshletVertices);
+        mesh->mNumMeshletTriangles = Read<unsigned int>(stream);
+        mesh->mMeshletTriangles = new unsigned char[mesh->mNumMeshletTriangles * 3];
+        stream->Read(mesh->mMeshletTriangles,1,mesh->mNumMeshletTriangles * 3);
+    }
 }
 
 void AssbinImporter::ReadBinaryMaterialProperty(IOStream * stream, aiMaterialProperty* prop)
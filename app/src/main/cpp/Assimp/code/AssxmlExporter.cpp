@@ -523,6 +523,32 @@ void WriteDump(const aiScene* scene, IOStream* io, bool shortened) {
                 ioprintf(io,"\t\t</FaceList>\n");
             }
 
+            // meshlets
+            if (!shortened && mesh->mNumMeshlets) {
+                ioprintf(io,"\t\t<MeshletList num=\"%i\">\n",mesh->mNumMeshlets);
+                for (unsigned int n = 0; n < mesh->mNumMeshlets; ++n) {
+                    const aiMeshlet& m = mesh->mMeshlets[n];
+                    ioprintf(io,"\t\t\t<Meshlet num_vertices=\"%i\" num_triangles=\"%i\">\n"
+                        "\t\t\t\t<Sphere> %0 8f %0 8f %0 8f %0 8f </Sphere>\n"
+                        "\t\t\t\t<Cone> %0 8f %0 8f %0 8f %0 8f %0 8f %0 8f %0 8f </Cone>\n"
+                        "\t\t\t\t<Vertices>",
+                        m.mNumVertices,m.mNumTriangles,
+                        m.mCenter.x,m.mCenter.y,m.mCenter.z,m.mRadius,
+                        m.mConeApex.x,m.mConeApex.y,m.mConeApex.z,
+                        m.mConeAxis.x,m.mConeAxis.y,m.mConeAxis.z,m.mConeCutoff);
+
+                    for (unsigned int j = 0; j < m.mNumVertices;++j)
+                        ioprintf(io,"%i ",mesh->mMeshletVertices[m.mVertexOffset + j]);
+
+                    ioprintf(io,"</Vertices>\n\t\t\t\t<Triangles>");
+                    for (unsigned int j = 0; j < m.mNumTriangles * 3;++j)
+                        ioprintf(io,"%i ",mesh->mMeshletTriangles[m.mTriangleOffset * 3 + j]);
+
+                    ioprintf(io,"</Triangles>\n\t\t\t</Meshlet>\n");
+                }
+                ioprintf(io,"\t\t</MeshletList>\n");
+            }
+
             // vertex positions
             if (mesh->HasPositions()) {
                 ioprintf(io,"\t\t<Positions num=\"%i\" set=\"0\" num_components=\"3\"> \n",mesh->mNumVertices);
@@ -107,6 +107,84 @@ aiScene* BaseImporter::ReadFile(const Importer* pImp, const std::string& pFile,
     return sc.release();
 }
 
+// ------------------------------------------------------------------------------------------------
+// Starts an incremental import
+bool BaseImporter::BeginIncremental(const Importer* pImp)
+{
+    m_progress = pImp->GetProgressHandler();
+    ai_assert(m_progress);
+    m_ErrorText.clear();
+
+    // Gather configuration properties for this run
+    SetupProperties( pImp );
+
+    try
+    {
+        InternBeginIncremental();
+
+    } catch( const std::exception& err )    {
+        m_ErrorText = err.what();
+        DefaultLogger::get()->error(m_ErrorText);
+        return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Passes the next piece of the file to an incremental import
+bool BaseImporter::FeedIncremental(const void* pData, size_t pLength)
+{
+    try
+    {
+        InternFeedIncremental( static_cast<const char*>( pData ), pLength );
+
+    } catch( const std::exception& err )    {
+        m_ErrorText = err.what();
+        DefaultLogger::get()->error(m_ErrorText);
+        return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Finishes an incremental import and returns the imported data.
+aiScene* BaseImporter::FinishIncremental()
+{
+    // create a scene object to hold the data
+    std::unique_ptr<aiScene> sc(new aiScene());
+
+    try
+    {
+        InternFinishIncremental( sc.get() );
+
+    } catch( const std::exception& err )    {
+        m_ErrorText = err.what();
+        DefaultLogger::get()->error(m_ErrorText);
+        return NULL;
+    }
+
+    // return what we gathered from the import.
+    return sc.release();
+}
+
+// ------------------------------------------------------------------------------------------------
+void BaseImporter::InternBeginIncremental()
+{
+    throw DeadlyImportError("This importer does not support incremental imports");
+}
+
+// ------------------------------------------------------------------------------------------------
+void BaseImporter::InternFeedIncremental(const char* /*pData*/, size_t /*pLength*/)
+{
+    throw DeadlyImportError("This importer does not support incremental imports");
+}
+
+// ------------------------------------------------------------------------------------------------
+void BaseImporter::InternFinishIncremental(aiScene* /*pScene*/)
+{
+    throw DeadlyImportError("This importer does not support incremental imports");
+}
+
 // ------------------------------------------------------------------------------------------------
 void BaseImporter::SetupProperties(const Importer* /*pImp*/)
 {
@@ -138,6 +138,45 @@ public:
         IOSystem* pIOHandler
         );
 
+    // -------------------------------------------------------------------
+    /** Starts an incremental import of a file which is passed in pieces.
+     * The pieces are handed to FeedIncremental() as they arrive and the
+     * scene is built by FinishIncremental(). An unfinished incremental
+     * import of this importer is discarded.
+     *
+     * @param pImp #Importer object hosting this loader.
+     * @return false if the importer does not support incremental imports,
+     * GetErrorText() gives the details.
+     *
+     * @note This function is not intended to be overridden. Implement
+     * InternBeginIncremental() and friends to support incremental imports.
+     */
+    bool BeginIncremental(
+        const Importer* pImp
+        );
+
+    // -------------------------------------------------------------------
+    /** Passes the next piece of the file to an incremental import. All
+     * records which are complete are parsed at once, the remainder is
+     * kept until the next piece arrives.
+     *
+     * @param pData Next bytes of the file
+     * @param pLength Number of bytes in pData
+     * @return false if the data is invalid. The import is discarded then,
+     * GetErrorText() gives the details.
+     */
+    bool FeedIncremental(
+        const void* pData,
+        size_t pLength
+        );
+
+    // -------------------------------------------------------------------
+    /** Finishes an incremental import after the last piece of the file
+     * was passed to FeedIncremental() and returns the imported data.
+     * Ownership and error handling are the same as for ReadFile().
+     */
+    aiScene* FinishIncremental();
+
     // -------------------------------------------------------------------
     /** Returns the error description of the last error that occurred.
      * @return A description of the last error that occurred. An empty
@@ -221,6 +260,31 @@ protected:
         IOSystem* pIOHandler
         ) = 0;
 
+    // -------------------------------------------------------------------
+    /** Starts an incremental import, any state of an unfinished import
+     * must be dropped. The default implementation throws, importers
+     * override the three incremental functions to support them.
+     * The functions are expected to throw an ImportErrorException if
+     * there is an error, see InternReadFile(). */
+    virtual void InternBeginIncremental();
+
+    // -------------------------------------------------------------------
+    /** Parses the complete records of the data passed so far.
+     * @param pData Next bytes of the file, not zero-terminated
+     * @param pLength Number of bytes in pData */
+    virtual void InternFeedIncremental(
+        const char* pData,
+        size_t pLength
+        );
+
+    // -------------------------------------------------------------------
+    /** Parses the rest of the data and fills the given scene, see
+     * InternReadFile() for the requirements.
+     * @param pScene The scene object to hold the imported data. */
+    virtual void InternFinishIncremental(
+        aiScene* pScene
+        );
+
 public: // static utilities
 
     // -------------------------------------------------------------------
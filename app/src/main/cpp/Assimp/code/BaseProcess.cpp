@@ -98,6 +98,16 @@ void BaseProcess::SetupProperties(const Importer* /*pImp*/)
     // the default implementation does nothing
 }
 
+// ------------------------------------------------------------------------------------------------
+bool BaseProcess::IsMeshDirty(unsigned int meshIndex) const
+{
+    std::vector<bool>* dirty = NULL;
+    if (!shared || !shared->GetProperty(AI_SPP_DIRTY_MESHES,dirty) || meshIndex >= dirty->size()) {
+        return true;
+    }
+    return (*dirty)[meshIndex];
+}
+
 // ------------------------------------------------------------------------------------------------
 bool BaseProcess::RequireVerboseFormat() const
 {
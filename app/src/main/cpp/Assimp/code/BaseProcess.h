@@ -200,6 +200,11 @@ private:
 
 #define AI_SPP_SPATIAL_SORT "$Spat"
 
+// std::vector<bool> with one entry per scene mesh, true if the mesh needs
+// to be processed. Only present if the post-processing run was limited to
+// a set of modified meshes, see Importer::ApplyPostProcessing().
+#define AI_SPP_DIRTY_MESHES "$Dirty"
+
 // ---------------------------------------------------------------------------
 /** The BaseProcess defines a common interface for all post processing steps.
  * A post processing step is run after a successful import if the caller
@@ -280,6 +285,16 @@ public:
 
 protected:
 
+    // -------------------------------------------------------------------
+    /** Check whether a mesh needs to be processed in this run.
+    * Steps which process each mesh on its own skip all meshes for
+    * which this returns false.
+    * @param meshIndex Index of the mesh in the scene
+    * @return false if post-processing was limited to a set of modified
+    *   meshes which does not include this mesh, true otherwise.
+    */
+    bool IsMeshDirty(unsigned int meshIndex) const;
+
     /** See the doc of #SharedPostProcessInfo for more details */
     SharedPostProcessInfo* shared;
 
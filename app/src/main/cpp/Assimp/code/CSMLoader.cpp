@@ -134,6 +134,7 @@ void CSMImporter::InternReadFile( const std::string& pFile,
     std::vector<char> mBuffer2;
     TextFileToBuffer(file.get(),mBuffer2);
     const char* buffer = &mBuffer2[0];
+    const char* const end = &mBuffer2.back();
 
     aiAnimation* anim = new aiAnimation();
     int first = 0, last = 0x00ffffff;
@@ -226,7 +227,15 @@ void CSMImporter::InternReadFile( const std::string& pFile,
                             delete[] old;
                         }
 
-                        // read x,y,z
+                        // read x,y,z, usually all of them at once
+                        aiVectorKey* sub = s->mPositionKeys + s->mNumPositionKeys;
+                        const char* sz;
+                        if (fast_atoreal_n<float>(buffer,end,(float*)&sub->mValue.x,3,&sz,true) == 3)  {
+                            sub->mTime = (double)frame;
+                            buffer = sz;
+                            ++s->mNumPositionKeys;
+                            continue;
+                        }
                         if(!SkipSpacesAndLineEnd(&buffer))
                             throw DeadlyImportError("CSM: Unexpected EOF occurred reading sample x coord");
 
@@ -235,7 +244,6 @@ void CSMImporter::InternReadFile( const std::string& pFile,
                             DefaultLogger::get()->warn("CSM: Encountered invalid marker data (DROPOUT)");
                         }
                         else    {
-                            aiVectorKey* sub = s->mPositionKeys + s->mNumPositionKeys;
                             sub->mTime = (double)frame;
                             buffer = fast_atoreal_move<float>(buffer, (float&)sub->mValue.x);
 
@@ -48,15 +48,23 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "CalcTangentsProcess.h"
 #include "ProcessHelper.h"
 #include "TinyFormatter.h"
+#include "VectorKernels.h"
+#include "Hash.h"
 #include "qnan.h"
 
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
 using namespace Assimp;
 
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 CalcTangentsProcess::CalcTangentsProcess()
 : configMaxAngle( AI_DEG_TO_RAD(45.f) )
-, configSourceUV( 0 ) {
+, configSourceUV( 0 )
+, configMikkTSpace( false ) {
     // nothing to do here
 }
 
@@ -86,6 +94,7 @@ void CalcTangentsProcess::SetupProperties(const Importer* pImp)
     configMaxAngle = AI_DEG_TO_RAD(configMaxAngle);
 
     configSourceUV = pImp->GetPropertyInteger(AI_CONFIG_PP_CT_TEXTURE_CHANNEL_INDEX,0);
+    configMikkTSpace = pImp->GetPropertyBool(AI_CONFIG_PP_CT_MIKKTSPACE,false);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -98,7 +107,7 @@ void CalcTangentsProcess::Execute( aiScene* pScene)
 
     bool bHas = false;
     for ( unsigned int a = 0; a < pScene->mNumMeshes; a++ ) {
-        if(ProcessMesh( pScene->mMeshes[a],a))bHas = true;
+        if(IsMeshDirty(a) && ProcessMesh( pScene->mMeshes[a],a))bHas = true;
     }
 
     if ( bHas ) {
@@ -108,6 +117,52 @@ void CalcTangentsProcess::Execute( aiScene* pScene)
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+// SoA staging area for the per-vertex projection of face tangents
+struct TangentBatch
+{
+    ai_real tx[AI_VECTORKERNELS_BATCH_SIZE], ty[AI_VECTORKERNELS_BATCH_SIZE], tz[AI_VECTORKERNELS_BATCH_SIZE];
+    ai_real bx[AI_VECTORKERNELS_BATCH_SIZE], by[AI_VECTORKERNELS_BATCH_SIZE], bz[AI_VECTORKERNELS_BATCH_SIZE];
+    ai_real nx[AI_VECTORKERNELS_BATCH_SIZE], ny[AI_VECTORKERNELS_BATCH_SIZE], nz[AI_VECTORKERNELS_BATCH_SIZE];
+    unsigned int idx[AI_VECTORKERNELS_BATCH_SIZE];
+    unsigned int cnt;
+};
+
+// ------------------------------------------------------------------------------------------------
+// Project all tangents and bitangents in the batch into the plane formed by the vertex normal,
+// normalize them and write them into the mesh.
+static void FlushTangentBatch(TangentBatch& batch, aiVector3D* meshTang, aiVector3D* meshBitang)
+{
+    OrthogonalizeBatch(batch.tx, batch.ty, batch.tz, batch.nx, batch.ny, batch.nz, batch.cnt);
+    OrthogonalizeBatch(batch.bx, batch.by, batch.bz, batch.nx, batch.ny, batch.nz, batch.cnt);
+    NormalizeBatch(batch.tx, batch.ty, batch.tz, batch.cnt, false);
+    NormalizeBatch(batch.bx, batch.by, batch.bz, batch.cnt, false);
+
+    for (unsigned int i = 0; i < batch.cnt; ++i) {
+        aiVector3D localTangent(batch.tx[i], batch.ty[i], batch.tz[i]);
+        aiVector3D localBitangent(batch.bx[i], batch.by[i], batch.bz[i]);
+        const aiVector3D normal(batch.nx[i], batch.ny[i], batch.nz[i]);
+
+        // reconstruct tangent/bitangent according to normal and bitangent/tangent when it's infinite or NaN.
+        bool invalid_tangent = is_special_float(localTangent.x) || is_special_float(localTangent.y) || is_special_float(localTangent.z);
+        bool invalid_bitangent = is_special_float(localBitangent.x) || is_special_float(localBitangent.y) || is_special_float(localBitangent.z);
+        if (invalid_tangent != invalid_bitangent) {
+            if (invalid_tangent) {
+                localTangent = normal ^ localBitangent;
+                localTangent.Normalize();
+            } else {
+                localBitangent = localTangent ^ normal;
+                localBitangent.Normalize();
+            }
+        }
+
+        // and write it into the mesh.
+        meshTang[ batch.idx[i] ]   = localTangent;
+        meshBitang[ batch.idx[i] ] = localBitangent;
+    }
+    batch.cnt = 0;
+}
+
 // ------------------------------------------------------------------------------------------------
 // Calculates tangents and bi-tangents for the given mesh
 bool CalcTangentsProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
@@ -141,6 +196,11 @@ bool CalcTangentsProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
         return false;
     }
 
+    if (configMikkTSpace) {
+        ProcessMeshMikkTSpace(pMesh);
+        return true;
+    }
+
     const float angleEpsilon = 0.9999f;
 
     std::vector<bool> vertexDone( pMesh->mNumVertices, false);
@@ -156,6 +216,9 @@ bool CalcTangentsProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
     aiVector3D* meshTang = pMesh->mTangents;
     aiVector3D* meshBitang = pMesh->mBitangents;
 
+    TangentBatch batch;
+    batch.cnt = 0;
+
     // calculate the tangent and bitangent for every face
     for( unsigned int a = 0; a < pMesh->mNumFaces; a++)
     {
@@ -164,7 +227,11 @@ bool CalcTangentsProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
         {
             // There are less than three indices, thus the tangent vector
             // is not defined. We are finished with these vertices now,
-            // their tangent vectors are set to qnan.
+            // their tangent vectors are set to qnan. Flush the queued faces
+            // first so shared vertices are written in face order.
+            if (batch.cnt) {
+                FlushTangentBatch(batch, meshTang, meshBitang);
+            }
             for (unsigned int i = 0; i < face.mNumIndices;++i)
             {
                 unsigned int idx = face.mIndices[i];
@@ -204,33 +271,21 @@ bool CalcTangentsProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
         bitangent.y = (w.y * sx - v.y * tx) * dirCorrection;
         bitangent.z = (w.z * sx - v.z * tx) * dirCorrection;
 
-        // store for every vertex of that face
+        // queue every vertex of that face for projection
         for( unsigned int b = 0; b < face.mNumIndices; ++b ) {
-            unsigned int p = face.mIndices[b];
-
-            // project tangent and bitangent into the plane formed by the vertex' normal
-            aiVector3D localTangent = tangent - meshNorm[p] * (tangent * meshNorm[p]);
-            aiVector3D localBitangent = bitangent - meshNorm[p] * (bitangent * meshNorm[p]);
-            localTangent.Normalize(); localBitangent.Normalize();
-
-            // reconstruct tangent/bitangent according to normal and bitangent/tangent when it's infinite or NaN.
-            bool invalid_tangent = is_special_float(localTangent.x) || is_special_float(localTangent.y) || is_special_float(localTangent.z);
-            bool invalid_bitangent = is_special_float(localBitangent.x) || is_special_float(localBitangent.y) || is_special_float(localBitangent.z);
-            if (invalid_tangent != invalid_bitangent) {
-                if (invalid_tangent) {
-                    localTangent = meshNorm[p] ^ localBitangent;
-                    localTangent.Normalize();
-                } else {
-                    localBitangent = localTangent ^ meshNorm[p];
-                    localBitangent.Normalize();
-                }
+            const unsigned int p = face.mIndices[b];
+            const unsigned int i = batch.cnt++;
+            batch.tx[i] = tangent.x;   batch.ty[i] = tangent.y;   batch.tz[i] = tangent.z;
+            batch.bx[i] = bitangent.x; batch.by[i] = bitangent.y; batch.bz[i] = bitangent.z;
+            batch.nx[i] = meshNorm[p].x; batch.ny[i] = meshNorm[p].y; batch.nz[i] = meshNorm[p].z;
+            batch.idx[i] = p;
+
+            if (batch.cnt == AI_VECTORKERNELS_BATCH_SIZE) {
+                FlushTangentBatch(batch, meshTang, meshBitang);
             }
-
-            // and write it into the mesh.
-            meshTang[ p ]   = localTangent;
-            meshBitang[ p ] = localBitangent;
         }
     }
+    FlushTangentBatch(batch, meshTang, meshBitang);
 
 
     // create a helper to quickly find locally close vertices among the vertex array
@@ -255,6 +310,10 @@ bool CalcTangentsProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
         vertexFinder = &_vertexFinder;
         posEpsilon = ComputePositionEpsilon(pMesh);
     }
+
+    // Look up the neighbours of all vertices in the order of the SpatialSort,
+    // once for each distinct position.
+    const PositionNeighbours neighbours(*vertexFinder, pMesh->mVertices, pMesh->mNumVertices, posEpsilon);
     std::vector<unsigned int> verticesFound;
 
     const float fLimit = std::cos(configMaxAngle);
@@ -267,14 +326,13 @@ bool CalcTangentsProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
         if( vertexDone[a])
             continue;
 
-        const aiVector3D& origPos = pMesh->mVertices[a];
         const aiVector3D& origNorm = pMesh->mNormals[a];
         const aiVector3D& origTang = pMesh->mTangents[a];
         const aiVector3D& origBitang = pMesh->mBitangents[a];
         closeVertices.resize( 0 );
 
         // find all vertices close to that position
-        vertexFinder->FindPositions( origPos, posEpsilon, verticesFound);
+        neighbours.FindPositions( a, verticesFound);
 
         closeVertices.reserve (verticesFound.size()+5);
         closeVertices.push_back( a);
@@ -316,3 +374,583 @@ bool CalcTangentsProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
     }
     return true;
 }
+
+// ------------------------------------------------------------------------------------------------
+// Key to weld all vertices with identical position, normal and texture coordinate
+struct MikkVertexKey
+{
+    ai_real v[8];
+
+    bool operator == (const MikkVertexKey& o) const {
+        return 0 == ::memcmp(v,o.v,sizeof(v));
+    }
+};
+
+struct MikkVertexKeyHash
+{
+    size_t operator() (const MikkVertexKey& k) const {
+        return SuperFastHash(reinterpret_cast<const char*>(k.v),sizeof(k.v));
+    }
+};
+
+namespace {
+
+// Triangle flags, as in the MikkTSpace reference
+enum {
+    MikkDegenerate = 0x1,
+    MikkQuadOneDegenerate = 0x2,
+    MikkGroupWithAny = 0x4,
+    MikkOrientPreserving = 0x8
+};
+
+// A triangle of a face with three or four vertices
+struct MikkTriangle
+{
+    unsigned int mFace;             ///< Face the triangle belongs to
+    unsigned int mCorners[3];       ///< Corners of that face
+    unsigned int mFlags;
+    int mNeighbours[3];             ///< Triangle across the edge starting at each corner, -1 for none
+    int mGroups[3];                 ///< Group of each corner, -1 for none
+    aiVector3D mOs, mOt;            ///< Normalized derivatives of the position by s and t
+    ai_real mMagS, mMagT;           ///< Their magnitudes
+};
+
+// Corners around a welded vertex which share the UV orientation and are connected by edges
+struct MikkGroup
+{
+    unsigned int mVertex;           ///< Welded vertex
+    bool mOrientPreserving;
+    unsigned int mFirst, mNum;      ///< Triangles of the group in the shared triangle list
+};
+
+// Tangent frame of a face corner
+struct MikkFrame
+{
+    aiVector3D mOs, mOt;
+    ai_real mMagS, mMagT;
+    unsigned int mCounter;
+    bool mOrientPreserving;
+};
+
+// Undirected edge of a triangle, used to find the neighbours
+struct MikkEdge
+{
+    unsigned int mLo, mHi, mTriangle;
+
+    bool operator < (const MikkEdge& o) const {
+        if (mLo != o.mLo) return mLo < o.mLo;
+        if (mHi != o.mHi) return mHi < o.mHi;
+        return mTriangle < o.mTriangle;
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+// Helpers with the same operations as in the reference, so the results match
+inline bool NotZero(ai_real f)
+{
+    return std::fabs(f) > std::numeric_limits<ai_real>::min();
+}
+
+inline bool NotZero(const aiVector3D& v)
+{
+    return NotZero(v.x) || NotZero(v.y) || NotZero(v.z);
+}
+
+inline aiVector3D Normalized(const aiVector3D& v)
+{
+    return v * (1 / v.Length());
+}
+
+inline aiVector3D ProjectNormalized(const aiVector3D& v, const aiVector3D& n)
+{
+    const aiVector3D p = v - n * (n * v);
+    return NotZero(p) ? Normalized(p) : p;
+}
+
+inline ai_real TexArea(const aiVector3D& t1, const aiVector3D& t2, const aiVector3D& t3)
+{
+    const ai_real area = (t2.x - t1.x) * (t3.y - t1.y) - (t2.y - t1.y) * (t3.x - t1.x);
+    return area < 0 ? -area : area;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Finds the edge of a triangle connecting the welded vertices a and b. Returns its
+// number and its vertices in the winding order of the triangle.
+unsigned int GetEdge(const unsigned int* tri, unsigned int a, unsigned int b,
+    unsigned int& first, unsigned int& second)
+{
+    if (tri[0] == a || tri[0] == b) {
+        if (tri[1] == a || tri[1] == b) {
+            first = tri[0]; second = tri[1];
+            return 0;
+        }
+        first = tri[2]; second = tri[0];
+        return 2;
+    }
+    first = tri[1]; second = tri[2];
+    return 1;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Averages two tangent frames. Identical frames are kept as they are, so rounding
+// doesn't split the tangent space later on.
+MikkFrame AverageFrames(const MikkFrame& a, const MikkFrame& b)
+{
+    MikkFrame res = a;
+    if (a.mMagS == b.mMagS && a.mMagT == b.mMagT && a.mOs == b.mOs && a.mOt == b.mOt) {
+        return res;
+    }
+    res.mMagS = static_cast<ai_real>(0.5) * (a.mMagS + b.mMagS);
+    res.mMagT = static_cast<ai_real>(0.5) * (a.mMagT + b.mMagT);
+    res.mOs = a.mOs + b.mOs;
+    res.mOt = a.mOt + b.mOt;
+    if (NotZero(res.mOs)) res.mOs = Normalized(res.mOs);
+    if (NotZero(res.mOt)) res.mOt = Normalized(res.mOt);
+    return res;
+}
+
+} // end of anonymous namespace
+
+// ------------------------------------------------------------------------------------------------
+// Calculates tangents and bi-tangents following the MikkTSpace reference algorithm.
+//
+// Quads are split along their shorter diagonal in texture space. Vertices are welded by
+// hashing their position, normal and texture coordinate, triangles with two identical
+// corner positions are degenerate. Around each welded vertex the corners are grouped by
+// walking over the edges shared with neighbouring triangles of the same UV orientation.
+// Each group gets the angle-weighted average of the tangents of its triangles, projected
+// into the plane of the vertex normal. Corners of degenerate triangles copy the frame of
+// a corner of a healthy triangle at the same vertex. Apart from sorting the edges all of
+// this runs in linear time.
+void CalcTangentsProcess::ProcessMeshMikkTSpace( aiMesh* pMesh)
+{
+    const float qnan = get_qnan();
+    const aiVector3D* meshPos = pMesh->mVertices;
+    const aiVector3D* meshNorm = pMesh->mNormals;
+    const aiVector3D* meshTex = pMesh->mTextureCoords[configSourceUV];
+
+    pMesh->mTangents = new aiVector3D[pMesh->mNumVertices];
+    pMesh->mBitangents = new aiVector3D[pMesh->mNumVertices];
+    for (unsigned int i = 0; i < pMesh->mNumVertices; ++i) {
+        pMesh->mTangents[i] = pMesh->mBitangents[i] = aiVector3D(qnan);
+    }
+
+    // weld all vertices which are identical for MikkTSpace
+    std::vector<unsigned int> weld(pMesh->mNumVertices), weldedVertex;
+    std::unordered_map<MikkVertexKey,unsigned int,MikkVertexKeyHash> welded;
+    welded.reserve(pMesh->mNumVertices);
+    for (unsigned int i = 0; i < pMesh->mNumVertices; ++i) {
+        // adding zero turns -0 into +0 so both hash the same
+        MikkVertexKey key;
+        key.v[0] = meshPos[i].x + 0;  key.v[1] = meshPos[i].y + 0;  key.v[2] = meshPos[i].z + 0;
+        key.v[3] = meshNorm[i].x + 0; key.v[4] = meshNorm[i].y + 0; key.v[5] = meshNorm[i].z + 0;
+        key.v[6] = meshTex[i].x + 0;  key.v[7] = meshTex[i].y + 0;
+
+        weld[i] = welded.insert(std::make_pair(key,static_cast<unsigned int>(welded.size()))).first->second;
+        if (weld[i] == weldedVertex.size()) {
+            weldedVertex.push_back(i);
+        }
+    }
+
+    // split the faces into triangles. Only triangles and quads are supported by MikkTSpace,
+    // the frame of each of their corners is stored at frameOffset[face] + corner.
+    static const unsigned int NoFrames = 0xffffffff;
+    std::vector<unsigned int> frameOffset(pMesh->mNumFaces,NoFrames);
+    std::vector<MikkTriangle> triangles;
+    triangles.reserve(pMesh->mNumFaces * 2);
+    unsigned int numFrames = 0;
+    for (unsigned int a = 0; a < pMesh->mNumFaces; ++a) {
+        const aiFace& face = pMesh->mFaces[a];
+        if (face.mNumIndices != 3 && face.mNumIndices != 4) {
+            continue;
+        }
+        frameOffset[a] = numFrames;
+        numFrames += face.mNumIndices;
+
+        MikkTriangle tri = {};
+        tri.mFace = a;
+        if (face.mNumIndices == 3) {
+            tri.mCorners[0] = 0; tri.mCorners[1] = 1; tri.mCorners[2] = 2;
+            triangles.push_back(tri);
+            continue;
+        }
+
+        // split along the shorter diagonal in texture space, or in object space if they are equal
+        const unsigned int* idx = face.mIndices;
+        bool diagonal02;
+        const ai_real tex02 = (meshTex[idx[2]] - meshTex[idx[0]]).SquareLength();
+        const ai_real tex13 = (meshTex[idx[3]] - meshTex[idx[1]]).SquareLength();
+        if (tex02 < tex13) {
+            diagonal02 = true;
+        }
+        else if (tex13 < tex02) {
+            diagonal02 = false;
+        }
+        else {
+            const ai_real pos02 = (meshPos[idx[2]] - meshPos[idx[0]]).SquareLength();
+            const ai_real pos13 = (meshPos[idx[3]] - meshPos[idx[1]]).SquareLength();
+            diagonal02 = !(pos13 < pos02);
+        }
+
+        if (diagonal02) {
+            tri.mCorners[0] = 0; tri.mCorners[1] = 1; tri.mCorners[2] = 2;
+            triangles.push_back(tri);
+            tri.mCorners[0] = 0; tri.mCorners[1] = 2; tri.mCorners[2] = 3;
+            triangles.push_back(tri);
+        }
+        else {
+            tri.mCorners[0] = 0; tri.mCorners[1] = 1; tri.mCorners[2] = 3;
+            triangles.push_back(tri);
+            tri.mCorners[0] = 1; tri.mCorners[1] = 2; tri.mCorners[2] = 3;
+            triangles.push_back(tri);
+        }
+    }
+
+    // mark the degenerate triangles and the healthy halves of quads with a degenerate half
+    for (std::vector<MikkTriangle>::iterator it = triangles.begin(); it != triangles.end(); ++it) {
+        const unsigned int* idx = pMesh->mFaces[(*it).mFace].mIndices;
+        const aiVector3D& p0 = meshPos[idx[(*it).mCorners[0]]];
+        const aiVector3D& p1 = meshPos[idx[(*it).mCorners[1]]];
+        const aiVector3D& p2 = meshPos[idx[(*it).mCorners[2]]];
+        if (p0 == p1 || p0 == p2 || p1 == p2) {
+            (*it).mFlags |= MikkDegenerate;
+        }
+    }
+    for (size_t t = 0; t + 1 < triangles.size(); ) {
+        if (triangles[t].mFace != triangles[t+1].mFace) {
+            ++t;
+            continue;
+        }
+        if ((triangles[t].mFlags ^ triangles[t+1].mFlags) & MikkDegenerate) {
+            triangles[t].mFlags |= MikkQuadOneDegenerate;
+            triangles[t+1].mFlags |= MikkQuadOneDegenerate;
+        }
+        t += 2;
+    }
+
+    // move the degenerate triangles to the back, keeping the order of the others
+    std::stable_partition(triangles.begin(),triangles.end(),[](const MikkTriangle& tri) {
+        return 0 == (tri.mFlags & MikkDegenerate);
+    });
+    unsigned int numGood = 0;
+    while (numGood < triangles.size() && !(triangles[numGood].mFlags & MikkDegenerate)) {
+        ++numGood;
+    }
+
+    // welded vertices of each triangle
+    std::vector<unsigned int> vertices(triangles.size() * 3);
+    for (size_t t = 0; t < triangles.size(); ++t) {
+        const unsigned int* idx = pMesh->mFaces[triangles[t].mFace].mIndices;
+        for (unsigned int c = 0; c < 3; ++c) {
+            vertices[t*3+c] = weld[idx[triangles[t].mCorners[c]]];
+        }
+    }
+
+    // per-triangle derivatives of the position by the texture coordinates
+    for (unsigned int t = 0; t < numGood; ++t) {
+        MikkTriangle& tri = triangles[t];
+        const unsigned int* idx = pMesh->mFaces[tri.mFace].mIndices;
+        const unsigned int i0 = idx[tri.mCorners[0]], i1 = idx[tri.mCorners[1]], i2 = idx[tri.mCorners[2]];
+
+        tri.mNeighbours[0] = tri.mNeighbours[1] = tri.mNeighbours[2] = -1;
+        tri.mGroups[0] = tri.mGroups[1] = tri.mGroups[2] = -1;
+        tri.mFlags |= MikkGroupWithAny;
+
+        const ai_real t21x = meshTex[i1].x - meshTex[i0].x, t21y = meshTex[i1].y - meshTex[i0].y;
+        const ai_real t31x = meshTex[i2].x - meshTex[i0].x, t31y = meshTex[i2].y - meshTex[i0].y;
+        const aiVector3D d1 = meshPos[i1] - meshPos[i0], d2 = meshPos[i2] - meshPos[i0];
+
+        const ai_real signedAreaSTx2 = t21x * t31y - t21y * t31x;
+        const aiVector3D vOs = d1 * t31y - d2 * t21y;
+        const aiVector3D vOt = d1 * -t31x + d2 * t21x;
+        if (signedAreaSTx2 > 0) {
+            tri.mFlags |= MikkOrientPreserving;
+        }
+
+        // triangles without UV area join any group, they take the orientation of the first one
+        if (NotZero(signedAreaSTx2)) {
+            const ai_real absArea = std::fabs(signedAreaSTx2);
+            const ai_real lenOs = vOs.Length(), lenOt = vOt.Length();
+            const ai_real sign = (tri.mFlags & MikkOrientPreserving) ? 1 : -1;
+            if (NotZero(lenOs)) tri.mOs = vOs * (sign / lenOs);
+            if (NotZero(lenOt)) tri.mOt = vOt * (sign / lenOt);
+
+            tri.mMagS = lenOs / absArea;
+            tri.mMagT = lenOt / absArea;
+            if (NotZero(tri.mMagS) && NotZero(tri.mMagT)) {
+                tri.mFlags &= ~MikkGroupWithAny;
+            }
+        }
+    }
+
+    // both halves of a quad get the same orientation, the one of the half with the larger UV area
+    for (unsigned int t = 0; t + 1 < numGood; ) {
+        MikkTriangle& ta = triangles[t];
+        MikkTriangle& tb = triangles[t+1];
+        if (ta.mFace != tb.mFace) {
+            ++t;
+            continue;
+        }
+        if ((ta.mFlags ^ tb.mFlags) & MikkOrientPreserving) {
+            const unsigned int* idx = pMesh->mFaces[ta.mFace].mIndices;
+            bool chooseFirst = (tb.mFlags & MikkGroupWithAny) != 0;
+            if (!chooseFirst) {
+                chooseFirst = TexArea(meshTex[idx[ta.mCorners[0]]],meshTex[idx[ta.mCorners[1]]],meshTex[idx[ta.mCorners[2]]])
+                    >= TexArea(meshTex[idx[tb.mCorners[0]]],meshTex[idx[tb.mCorners[1]]],meshTex[idx[tb.mCorners[2]]]);
+            }
+            const MikkTriangle& src = chooseFirst ? ta : tb;
+            MikkTriangle& dst = chooseFirst ? tb : ta;
+            dst.mFlags = (dst.mFlags & ~MikkOrientPreserving) | (src.mFlags & MikkOrientPreserving);
+        }
+        t += 2;
+    }
+
+    // find the neighbours across each edge. Edges are paired in the order of the
+    // triangles, only with a triangle using the edge in the opposite direction.
+    std::vector<MikkEdge> edges(numGood * 3);
+    for (unsigned int t = 0; t < numGood; ++t) {
+        for (unsigned int c = 0; c < 3; ++c) {
+            const unsigned int a = vertices[t*3+c], b = vertices[t*3+(c+1)%3];
+            MikkEdge& e = edges[t*3+c];
+            e.mLo = std::min(a,b);
+            e.mHi = std::max(a,b);
+            e.mTriangle = t;
+        }
+    }
+    std::sort(edges.begin(),edges.end());
+    for (size_t i = 0; i < edges.size(); ++i) {
+        const MikkEdge& ea = edges[i];
+        unsigned int a0, a1;
+        const unsigned int na = GetEdge(&vertices[ea.mTriangle*3],ea.mLo,ea.mHi,a0,a1);
+        if (triangles[ea.mTriangle].mNeighbours[na] != -1) {
+            continue;
+        }
+        for (size_t j = i + 1; j < edges.size() && edges[j].mLo == ea.mLo && edges[j].mHi == ea.mHi; ++j) {
+            const MikkEdge& eb = edges[j];
+            unsigned int b0, b1;
+            const unsigned int nb = GetEdge(&vertices[eb.mTriangle*3],eb.mLo,eb.mHi,b0,b1);
+            if (a0 == b1 && a1 == b0 && triangles[eb.mTriangle].mNeighbours[nb] == -1) {
+                triangles[ea.mTriangle].mNeighbours[na] = static_cast<int>(eb.mTriangle);
+                triangles[eb.mTriangle].mNeighbours[nb] = static_cast<int>(ea.mTriangle);
+                break;
+            }
+        }
+    }
+
+    // group the corners around each welded vertex. Starting at a triangle with UV area, the
+    // group spreads over the edges at the vertex to neighbours of the same orientation. The
+    // stack visits the triangles in the same order as the recursion of the reference.
+    std::vector<MikkGroup> groups;
+    std::vector<unsigned int> groupTriangles;
+    groupTriangles.reserve(numGood * 3);
+    std::vector<unsigned int> stack;
+    for (unsigned int f = 0; f < numGood; ++f) {
+        for (unsigned int c = 0; c < 3; ++c) {
+            MikkTriangle& tri = triangles[f];
+            if ((tri.mFlags & MikkGroupWithAny) || tri.mGroups[c] != -1) {
+                continue;
+            }
+            const int g = static_cast<int>(groups.size());
+            MikkGroup group;
+            group.mVertex = vertices[f*3+c];
+            group.mOrientPreserving = (tri.mFlags & MikkOrientPreserving) != 0;
+            group.mFirst = static_cast<unsigned int>(groupTriangles.size());
+            groups.push_back(group);
+
+            groupTriangles.push_back(f);
+            tri.mGroups[c] = g;
+
+            stack.clear();
+            if (tri.mNeighbours[(c+2)%3] >= 0) stack.push_back(tri.mNeighbours[(c+2)%3]);
+            if (tri.mNeighbours[c] >= 0) stack.push_back(tri.mNeighbours[c]);
+            while (!stack.empty()) {
+                MikkTriangle& other = triangles[stack.back()];
+                const unsigned int o = stack.back();
+                stack.pop_back();
+
+                unsigned int k = 0;
+                while (k < 2 && vertices[o*3+k] != group.mVertex) {
+                    ++k;
+                }
+                if (other.mGroups[k] != -1) {
+                    continue;
+                }
+                if ((other.mFlags & MikkGroupWithAny) &&
+                    other.mGroups[0] == -1 && other.mGroups[1] == -1 && other.mGroups[2] == -1) {
+                    // the first group reaching a triangle without UV area decides its orientation
+                    other.mFlags = (other.mFlags & ~MikkOrientPreserving) |
+                        (group.mOrientPreserving ? MikkOrientPreserving : 0);
+                }
+                if (((other.mFlags & MikkOrientPreserving) != 0) != group.mOrientPreserving) {
+                    continue;
+                }
+
+                groupTriangles.push_back(o);
+                other.mGroups[k] = g;
+                if (other.mNeighbours[(k+2)%3] >= 0) stack.push_back(other.mNeighbours[(k+2)%3]);
+                if (other.mNeighbours[k] >= 0) stack.push_back(other.mNeighbours[k]);
+            }
+            groups[g].mNum = static_cast<unsigned int>(groupTriangles.size()) - groups[g].mFirst;
+        }
+    }
+
+    // evaluate the tangent frames. Triangles of a group whose tangents are exactly opposed
+    // form sub groups, with the default angular threshold of the reference this is the only
+    // case which splits a group.
+    const ai_real thresholdCos = -1;
+    MikkFrame defaultFrame;
+    defaultFrame.mOs = aiVector3D(1,0,0);
+    defaultFrame.mOt = aiVector3D(0,1,0);
+    defaultFrame.mMagS = defaultFrame.mMagT = 1;
+    defaultFrame.mCounter = 0;
+    defaultFrame.mOrientPreserving = false;
+    std::vector<MikkFrame> frames(numFrames,defaultFrame);
+
+    std::vector<unsigned int> members;
+    std::vector< std::vector<unsigned int> > subGroups;
+    std::vector<MikkFrame> subGroupFrames;
+    for (std::vector<MikkGroup>::const_iterator git = groups.begin(); git != groups.end(); ++git) {
+        const MikkGroup& group = *git;
+        const unsigned int* const groupBegin = &groupTriangles[group.mFirst];
+        const int g = static_cast<int>(git - groups.begin());
+        const aiVector3D& n = meshNorm[weldedVertex[group.mVertex]];
+
+        subGroups.clear();
+        subGroupFrames.clear();
+        for (unsigned int i = 0; i < group.mNum; ++i) {
+            const unsigned int f = groupBegin[i];
+            const MikkTriangle& tri = triangles[f];
+            const aiVector3D vOs = ProjectNormalized(tri.mOs,n), vOt = ProjectNormalized(tri.mOt,n);
+
+            members.clear();
+            for (unsigned int j = 0; j < group.mNum; ++j) {
+                const unsigned int t = groupBegin[j];
+                const MikkTriangle& other = triangles[t];
+                const aiVector3D vOs2 = ProjectNormalized(other.mOs,n), vOt2 = ProjectNormalized(other.mOt,n);
+
+                // triangles of the same quad are always joined
+                const bool any = ((tri.mFlags | other.mFlags) & MikkGroupWithAny) != 0;
+                if (any || tri.mFace == other.mFace || (vOs * vOs2 > thresholdCos && vOt * vOt2 > thresholdCos)) {
+                    members.push_back(t);
+                }
+            }
+            std::sort(members.begin(),members.end());
+
+            size_t l = 0;
+            while (l < subGroups.size() && subGroups[l] != members) {
+                ++l;
+            }
+            if (l == subGroups.size()) {
+                // angle-weighted average over the triangles with UV area
+                MikkFrame res;
+                res.mMagS = res.mMagT = 0;
+                res.mCounter = 0;
+                res.mOrientPreserving = false;
+                ai_real angleSum = 0;
+                for (std::vector<unsigned int>::const_iterator it = members.begin(); it != members.end(); ++it) {
+                    const MikkTriangle& m = triangles[*it];
+                    if (m.mFlags & MikkGroupWithAny) {
+                        continue;
+                    }
+                    unsigned int k = 0;
+                    while (k < 2 && vertices[*it*3+k] != group.mVertex) {
+                        ++k;
+                    }
+                    const unsigned int* idx = pMesh->mFaces[m.mFace].mIndices;
+                    const aiVector3D& p0 = meshPos[idx[m.mCorners[(k+2)%3]]];
+                    const aiVector3D& p1 = meshPos[idx[m.mCorners[k]]];
+                    const aiVector3D& p2 = meshPos[idx[m.mCorners[(k+1)%3]]];
+                    const aiVector3D v1 = ProjectNormalized(p0 - p1,n), v2 = ProjectNormalized(p2 - p1,n);
+
+                    const ai_real c = std::max(static_cast<ai_real>(-1),std::min(static_cast<ai_real>(1),v1 * v2));
+                    const ai_real angle = static_cast<ai_real>(::acos(static_cast<double>(c)));
+                    res.mOs += ProjectNormalized(m.mOs,n) * angle;
+                    res.mOt += ProjectNormalized(m.mOt,n) * angle;
+                    res.mMagS += angle * m.mMagS;
+                    res.mMagT += angle * m.mMagT;
+                    angleSum += angle;
+                }
+                if (NotZero(res.mOs)) res.mOs = Normalized(res.mOs);
+                if (NotZero(res.mOt)) res.mOt = Normalized(res.mOt);
+                if (angleSum > 0) {
+                    res.mMagS /= angleSum;
+                    res.mMagT /= angleSum;
+                }
+                subGroups.push_back(members);
+                subGroupFrames.push_back(res);
+            }
+
+            // a corner shared by both halves of a quad gets the average of their frames
+            unsigned int k = 0;
+            while (k < 2 && tri.mGroups[k] != g) {
+                ++k;
+            }
+            MikkFrame& out = frames[frameOffset[tri.mFace] + tri.mCorners[k]];
+            if (out.mCounter == 1) {
+                out = AverageFrames(out,subGroupFrames[l]);
+                out.mCounter = 2;
+            }
+            else {
+                out = subGroupFrames[l];
+                out.mCounter = 1;
+            }
+            out.mOrientPreserving = group.mOrientPreserving;
+        }
+    }
+
+    // corners of degenerate triangles copy the frame of the first healthy corner at the same vertex
+    std::vector<unsigned int> firstCorner(welded.size(),NoFrames);
+    for (unsigned int i = numGood * 3; i-- > 0; ) {
+        firstCorner[vertices[i]] = i;
+    }
+    for (size_t t = numGood; t < triangles.size(); ++t) {
+        const MikkTriangle& tri = triangles[t];
+        if (tri.mFlags & MikkQuadOneDegenerate) {
+            continue;
+        }
+        for (unsigned int c = 0; c < 3; ++c) {
+            const unsigned int src = firstCorner[vertices[t*3+c]];
+            if (src != NoFrames) {
+                const MikkTriangle& srcTri = triangles[src / 3];
+                frames[frameOffset[tri.mFace] + tri.mCorners[c]] = frames[frameOffset[srcTri.mFace] + srcTri.mCorners[src % 3]];
+            }
+        }
+    }
+
+    // the corner of a quad which is only part of its degenerate half copies the
+    // frame of a corner at the same position
+    for (unsigned int t = 0; t < numGood; ++t) {
+        const MikkTriangle& tri = triangles[t];
+        if (!(tri.mFlags & MikkQuadOneDegenerate)) {
+            continue;
+        }
+        const unsigned int used = (1u << tri.mCorners[0]) | (1u << tri.mCorners[1]) | (1u << tri.mCorners[2]);
+        unsigned int missing = 0;
+        if (!(used & 2)) missing = 1;
+        else if (!(used & 4)) missing = 2;
+        else if (!(used & 8)) missing = 3;
+
+        const unsigned int* idx = pMesh->mFaces[tri.mFace].mIndices;
+        for (unsigned int c = 0; c < 3; ++c) {
+            if (meshPos[idx[tri.mCorners[c]]] == meshPos[idx[missing]]) {
+                frames[frameOffset[tri.mFace] + missing] = frames[frameOffset[tri.mFace] + tri.mCorners[c]];
+                break;
+            }
+        }
+    }
+
+    // write the frames into the mesh. A vertex used by several corners gets the frame of the
+    // last of them, the frames only differ if the corners are in different groups.
+    for (unsigned int a = 0; a < pMesh->mNumFaces; ++a) {
+        if (frameOffset[a] == NoFrames) {
+            continue;
+        }
+        const aiFace& face = pMesh->mFaces[a];
+        for (unsigned int b = 0; b < face.mNumIndices; ++b) {
+            const unsigned int p = face.mIndices[b];
+            const MikkFrame& frame = frames[frameOffset[a] + b];
+            pMesh->mTangents[p] = frame.mOs;
+            pMesh->mBitangents[p] = (meshNorm[p] ^ frame.mOs) * static_cast<ai_real>(frame.mOrientPreserving ? 1 : -1);
+        }
+    }
+}
@@ -98,6 +98,14 @@ protected:
     */
     bool ProcessMesh( aiMesh* pMesh, unsigned int meshIndex);
 
+    // -------------------------------------------------------------------
+    /** Calculates tangents and bitangents for a specific mesh following
+    * the MikkTSpace reference. Faces with more than four vertices get
+    * qnan tangents. The mesh has been checked by ProcessMesh() already.
+    * @param pMesh The mesh to process.
+    */
+    void ProcessMeshMikkTSpace( aiMesh* pMesh);
+
     // -------------------------------------------------------------------
     /** Executes the post processing step on the given imported data.
     * @param pScene The imported data to work at.
@@ -109,6 +117,7 @@ private:
     /** Configuration option: maximum smoothing angle, in radians*/
     float configMaxAngle;
     unsigned int configSourceUV;
+    bool configMikkTSpace;
 };
 
 } // end of namespace Assimp
@@ -1977,17 +1977,20 @@ void ColladaParser::ReadDataArray()
             }
         } else
         {
-            data.mValues.reserve( count);
+            data.mValues.resize( count);
 
-            for( unsigned int a = 0; a < count; a++)
+            // plain whitespace separated numbers are read in bulk, anything else value by value
+            const char* end = content + ::strlen( content);
+            unsigned int a = count ? (unsigned int) fast_atoreal_n<ai_real>( content, end, &data.mValues[0], count, &content, true) : 0;
+            SkipSpacesAndLineEnd( &content);
+
+            for( ; a < count; a++)
             {
                 if( *content == 0)
                     ThrowException( "Expected more values while reading float_array contents.");
 
-                ai_real value;
                 // read a number
-                content = fast_atoreal_move<ai_real>( content, value);
-                data.mValues.push_back( value);
+                content = fast_atoreal_move<ai_real>( content, data.mValues[a]);
                 // skip whitespace after it
                 SkipSpacesAndLineEnd( &content);
             }
@@ -2330,6 +2333,18 @@ size_t ColladaParser::ReadPrimitives( Mesh* pMesh, std::vector<InputChannel>& pP
     if (pNumPrimitives > 0) // It is possible to not contain any indices
     {
         const char* content = GetTextContent();
+        const char* end = content + ::strlen( content);
+
+        // indices are read in blocks, the remainder the bulk parser stops at one by one
+        int values[ 1024 ];
+        size_t numValues;
+        do {
+            numValues = strtol10_n( content, end, values, 1024, &content, true);
+            for( size_t a = 0; a < numValues; a++)
+                indices.push_back( size_t( std::max( 0, values[a])));
+        } while( numValues == 1024);
+        SkipSpacesAndLineEnd( &content);
+
         while( *content != 0)
         {
             // read a value.
@@ -50,6 +50,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "StdOStreamLogStream.h"
 #include "FileLogStream.h"
 #include "StringUtils.h"
+#include "ParallelHelper.h"
 
 #include <assimp/DefaultIOSystem.h>
 #include <assimp/NullLogger.hpp>
@@ -230,6 +231,12 @@ bool DefaultLogger::isNullLogger()
 
 // ----------------------------------------------------------------------------------
 Logger *DefaultLogger::get() {
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+    // work items of ParallelFor() log to a collector, see ParallelHelper.h
+    if (Logger* logger = GetWorkItemLogger()) {
+        return logger;
+    }
+#endif
     return m_pLogger;
 }
 
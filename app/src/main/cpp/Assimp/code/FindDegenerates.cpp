@@ -50,6 +50,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ProcessHelper.h"
 #include "FindDegenerates.h"
 #include "Exceptional.h"
+#include "StringUtils.h"
+#include "VectorKernels.h"
+#include <algorithm>
 
 using namespace Assimp;
 
@@ -85,41 +88,55 @@ void FindDegeneratesProcess::SetupProperties(const Importer* pImp) {
 // Executes the post processing step on the given imported data.
 void FindDegeneratesProcess::Execute( aiScene* pScene) {
     DefaultLogger::get()->debug("FindDegeneratesProcess begin");
+    mStatistics = aiDegenerateInfo();
     for (unsigned int i = 0; i < pScene->mNumMeshes;++i){
+        if (!IsMeshDirty(i)) {
+            continue;
+        }
         ExecuteOnMesh( pScene->mMeshes[ i ] );
     }
-    DefaultLogger::get()->debug("FindDegeneratesProcess finished");
-}
-
-static ai_real heron( ai_real a, ai_real b, ai_real c ) {
-    ai_real s = (a + b + c) / 2;
-    ai_real area = pow((s * ( s - a ) * ( s - b ) * ( s - c ) ), (ai_real)0.5 );
-    return area;
-}
 
-static ai_real distance3D( const aiVector3D &vA, aiVector3D &vB ) {
-    const ai_real lx = ( vB.x - vA.x );
-    const ai_real ly = ( vB.y - vA.y );
-    const ai_real lz = ( vB.z - vA.z );
-    ai_real a = lx*lx + ly*ly + lz*lz;
-    ai_real d = pow( a, (ai_real)0.5 );
-
-    return d;
+    if (!DefaultLogger::isNullLogger()) {
+        char buffer[1024];
+        ai_snprintf(buffer,1024,"FindDegeneratesProcess finished. %u degenerated primitives, removed %u "
+            "indices, %u degenerated primitives and %u zero-area triangles",mStatistics.degenerate,
+            mStatistics.removedIndices,mStatistics.removedDegenerate,mStatistics.removedZeroArea);
+        DefaultLogger::get()->debug(buffer);
+    }
 }
 
-static ai_real calculateAreaOfTriangle( const aiFace& face, aiMesh* mesh ) {
-    ai_real area = 0;
-
-    aiVector3D vA( mesh->mVertices[ face.mIndices[ 0 ] ] );
-    aiVector3D vB( mesh->mVertices[ face.mIndices[ 1 ] ] );
-    aiVector3D vC( mesh->mVertices[ face.mIndices[ 2 ] ] );
+// ------------------------------------------------------------------------------------------------
+// Checks the triangles of the faces [first,end) for (nearly) zero area, end being at most
+// AI_VECTORKERNELS_BATCH_SIZE faces ahead. The cross product of two edges has twice the area
+// as length, so the squares can be compared without taking any roots. Returns end.
+static unsigned int checkAreaBatch( const aiMesh* mesh, unsigned int first, bool* zeroArea ) {
+    ai_real e1x[AI_VECTORKERNELS_BATCH_SIZE], e1y[AI_VECTORKERNELS_BATCH_SIZE], e1z[AI_VECTORKERNELS_BATCH_SIZE];
+    ai_real e2x[AI_VECTORKERNELS_BATCH_SIZE], e2y[AI_VECTORKERNELS_BATCH_SIZE], e2z[AI_VECTORKERNELS_BATCH_SIZE];
+    unsigned int tris[AI_VECTORKERNELS_BATCH_SIZE];
+
+    const unsigned int end = std::min(mesh->mNumFaces, first + AI_VECTORKERNELS_BATCH_SIZE);
+    unsigned int cnt = 0;
+    for ( unsigned int a = first; a < end; ++a ) {
+        const aiFace& face = mesh->mFaces[a];
+        zeroArea[a - first] = false;
+        if (face.mNumIndices != 3) {
+            continue;
+        }
 
-    ai_real a( distance3D( vA, vB ) );
-    ai_real b( distance3D( vB, vC ) );
-    ai_real c( distance3D( vC, vA ) );
-    area = heron( a, b, c );
+        const aiVector3D& vA = mesh->mVertices[ face.mIndices[ 0 ] ];
+        const aiVector3D& vB = mesh->mVertices[ face.mIndices[ 1 ] ];
+        const aiVector3D& vC = mesh->mVertices[ face.mIndices[ 2 ] ];
+        e1x[cnt] = vB.x - vA.x; e1y[cnt] = vB.y - vA.y; e1z[cnt] = vB.z - vA.z;
+        e2x[cnt] = vC.x - vA.x; e2y[cnt] = vC.y - vA.y; e2z[cnt] = vC.z - vA.z;
+        tris[cnt++] = a - first;
+    }
 
-    return area;
+    CrossBatch(e1x,e1y,e1z,e2x,e2y,e2z,e1x,e1y,e1z,cnt);
+    SquareLengthBatch(e1x,e1y,e1z,e2x,cnt);
+    for ( unsigned int i = 0; i < cnt; ++i ) {
+        zeroArea[tris[i]] = e2x[i] < ai_real( 4e-12 );
+    }
+    return end;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -127,68 +144,73 @@ static ai_real calculateAreaOfTriangle( const aiFace& face, aiMesh* mesh ) {
 void FindDegeneratesProcess::ExecuteOnMesh( aiMesh* mesh) {
     mesh->mPrimitiveTypes = 0;
 
-    std::vector<bool> remove_me;
-    if (mConfigRemoveDegenerates) {
-        remove_me.resize( mesh->mNumFaces, false );
-    }
+    // The area of the triangles is checked ahead in batches, the positions
+    // of a face only change if it has duplicates, which are handled first.
+    const bool checkArea = mConfigCheckAreaOfTriangle && mConfigRemoveDegenerates;
+    bool zeroArea[AI_VECTORKERNELS_BATCH_SIZE];
+    unsigned int batchBegin = 0, batchEnd = 0;
 
-    unsigned int deg = 0, limit;
+    // The faces are compacted in the same pass which checks them, n is the
+    // write position. Their index arrays are compacted in place, too.
+    unsigned int deg = 0, n = 0;
     for ( unsigned int a = 0; a < mesh->mNumFaces; ++a ) {
-        aiFace& face = mesh->mFaces[a];
-        bool first = true;
-
-        // check whether the face contains degenerated entries
-        for (unsigned int i = 0; i < face.mNumIndices; ++i) {
-            // Polygons with more than 4 points are allowed to have double points, that is
-            // simulating polygons with holes just with concave polygons. However,
-            // double points may not come directly after another.
-            limit = face.mNumIndices;
-            if (face.mNumIndices > 4) {
-                limit = std::min( limit, i+2 );
-            }
+        if (checkArea && a == batchEnd) {
+            batchBegin = a;
+            batchEnd = checkAreaBatch(mesh, a, zeroArea);
+        }
 
-            for (unsigned int t = i+1; t < limit; ++t) {
-                if (mesh->mVertices[face.mIndices[ i ] ] == mesh->mVertices[ face.mIndices[ t ] ]) {
-                    // we have found a matching vertex position
-                    // remove the corresponding index from the array
-                    --face.mNumIndices;
-                    --limit;
-                    for (unsigned int m = t; m < face.mNumIndices; ++m) {
-                        face.mIndices[ m ] = face.mIndices[ m+1 ];
-                    }
-                    --t;
-
-                    // NOTE: we set the removed vertex index to an unique value
-                    // to make sure the developer gets notified when his
-                    // application attemps to access this data.
-                    face.mIndices[ face.mNumIndices ] = 0xdeadbeef;
-
-                    if(first) {
-                        ++deg;
-                        first = false;
-                    }
-
-                    if ( mConfigRemoveDegenerates ) {
-                        remove_me[ a ] = true;
-                        goto evil_jump_outside; // hrhrhrh ... yeah, this rocks baby!
-                    }
+        aiFace& face = mesh->mFaces[a];
+        const unsigned int numIndices = face.mNumIndices;
+
+        // Keep only the first occurrence of each vertex position. Polygons with more than
+        // 4 points are allowed to have double points, that is simulating polygons with
+        // holes just with concave polygons. However, double points may not come directly
+        // after another.
+        unsigned int kept = 0;
+        for (unsigned int i = 0; i < numIndices; ++i) {
+            const aiVector3D& v = mesh->mVertices[ face.mIndices[ i ] ];
+            bool found = false;
+            for (unsigned int t = (numIndices > 4 && kept) ? kept-1 : 0; t < kept; ++t) {
+                if (mesh->mVertices[ face.mIndices[ t ] ] == v) {
+                    found = true;
+                    break;
                 }
             }
+            if (!found) {
+                face.mIndices[ kept++ ] = face.mIndices[ i ];
+            }
+        }
 
-            if ( mConfigCheckAreaOfTriangle ) {
-                if ( face.mNumIndices == 3 ) {
-                    ai_real area = calculateAreaOfTriangle( face, mesh );
-                    if ( area < 1e-6 ) {
-                        if ( mConfigRemoveDegenerates ) {
-                            remove_me[ a ] = true;
-                            goto evil_jump_outside;
-                        }
-
-                        // todo: check for index which is corrupt.
-                    }
+        bool remove = false;
+        if (kept != numIndices) {
+            ++deg;
+            if ( mConfigRemoveDegenerates ) {
+                ++mStatistics.removedDegenerate;
+                remove = true;
+            }
+            else {
+                mStatistics.removedIndices += numIndices - kept;
+                face.mNumIndices = kept;
+
+                // NOTE: we set the removed vertex indices to an unique value
+                // to make sure the developer gets notified when his
+                // application attemps to access this data.
+                for (unsigned int i = kept; i < numIndices; ++i) {
+                    face.mIndices[ i ] = 0xdeadbeef;
                 }
             }
         }
+        else if ( checkArea && zeroArea[ a - batchBegin ] ) {
+            ++mStatistics.removedZeroArea;
+            remove = true;
+        }
+
+        if (remove) {
+            delete[] face.mIndices;
+            face.mIndices = NULL;
+            face.mNumIndices = 0;
+            continue;
+        }
 
         // We need to update the primitive flags array of the mesh.
         switch (face.mNumIndices)
@@ -206,45 +228,22 @@ void FindDegeneratesProcess::ExecuteOnMesh( aiMesh* mesh) {
             mesh->mPrimitiveTypes |= aiPrimitiveType_POLYGON;
             break;
         };
-evil_jump_outside:
-        continue;
-    }
 
-    // If AI_CONFIG_PP_FD_REMOVE is true, remove degenerated faces from the import
-    if (mConfigRemoveDegenerates && deg) {
-        unsigned int n = 0;
-        for (unsigned int a = 0; a < mesh->mNumFaces; ++a)
-        {
-            aiFace& face_src = mesh->mFaces[a];
-            if (!remove_me[a]) {
-                aiFace& face_dest = mesh->mFaces[n++];
-
-                // Do a manual copy, keep the index array
-                face_dest.mNumIndices = face_src.mNumIndices;
-                face_dest.mIndices    = face_src.mIndices;
-
-                if (&face_src != &face_dest) {
-                    // clear source
-                    face_src.mNumIndices = 0;
-                    face_src.mIndices = NULL;
-                }
-            }
-            else {
-                // Otherwise delete it if we don't need this face
-                delete[] face_src.mIndices;
-                face_src.mIndices = NULL;
-                face_src.mNumIndices = 0;
-            }
+        aiFace& face_dest = mesh->mFaces[n++];
+        if (&face != &face_dest) {
+            // Do a manual move, keep the index array
+            face_dest.mNumIndices = face.mNumIndices;
+            face_dest.mIndices    = face.mIndices;
+            face.mNumIndices = 0;
+            face.mIndices = NULL;
         }
-        // Just leave the rest of the array unreferenced, we don't care for now
+    }
+    mStatistics.degenerate += deg;
+
+    // Just leave the rest of the array unreferenced, we don't care for now
+    if (n != mesh->mNumFaces) {
         mesh->mNumFaces = n;
         if (!mesh->mNumFaces) {
-            // WTF!?
-            // OK ... for completeness and because I'm not yet tired,
-            // let's write code that willl hopefully never be called
-            // (famous last words)
-
-            // OK ... bad idea.
             throw DeadlyImportError("Mesh is empty after removal of degenerated primitives ... WTF!?");
         }
     }
@@ -95,11 +95,19 @@ public:
     /// @return The area check state.
     bool isAreaCheckEnabled() const;
 
+    // -------------------------------------------------------------------
+    /// @brief Get the statistics of the last run.
+    /// @return What was found and removed, counted over all meshes
+    ///   passed to ExecuteOnMesh() since the last call to Execute().
+    const aiDegenerateInfo& GetStatistics() const;
+
 private:
     //! Configuration option: remove degenerates faces immediately
     bool mConfigRemoveDegenerates;
     //! Configuration option: check for area
     bool mConfigCheckAreaOfTriangle;
+    //! Statistics of the last run
+    aiDegenerateInfo mStatistics;
 };
 
 inline
@@ -122,6 +130,11 @@ bool FindDegeneratesProcess::isAreaCheckEnabled() const {
     return mConfigCheckAreaOfTriangle;
 }
 
+inline
+const aiDegenerateInfo& FindDegeneratesProcess::GetStatistics() const {
+    return mStatistics;
+}
+
 } // Namespace Assimp
 
 #endif // !! AI_FINDDEGENERATESPROCESS_H_INC
@@ -46,7 +46,13 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
 #include "FindInstancesProcess.h"
+#include "Hash.h"
 #include <memory>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <unordered_map>
+#include <cmath>
 #include <stdio.h>
 
 using namespace Assimp;
@@ -55,6 +61,7 @@ using namespace Assimp;
 // Constructor to be privately used by Importer
 FindInstancesProcess::FindInstancesProcess()
 :   configSpeedFlag (false)
+,   configRigidInstances (false)
 {}
 
 // ------------------------------------------------------------------------------------------------
@@ -77,6 +84,9 @@ void FindInstancesProcess::SetupProperties(const Importer* pImp)
 {
     // AI_CONFIG_FAVOUR_SPEED
     configSpeedFlag = (0 != pImp->GetPropertyInteger(AI_CONFIG_FAVOUR_SPEED,0));
+
+    // AI_CONFIG_PP_FI_RIGID_INSTANCES
+    configRigidInstances = (0 != pImp->GetPropertyInteger(AI_CONFIG_PP_FI_RIGID_INSTANCES,0));
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -114,6 +124,384 @@ void UpdateMeshIndices(aiNode* node, unsigned int* lookup)
         UpdateMeshIndices(node->mChildren[n],lookup);
 }
 
+namespace {
+
+// use a constant epsilon for colors, UV coordinates and directions
+const float uvEpsilon = 10e-4f;
+
+// ------------------------------------------------------------------------------------------------
+// Number of values the bucket keys of a mesh are built from: the centroid, the largest and
+// the average distance of the vertices to the centroid. The latter two don't change if the
+// mesh is rotated or translated, they are used to find rigid instances.
+const unsigned int NumHashValues = 5;
+const unsigned int NumRigidHashValues = 2;
+
+// ------------------------------------------------------------------------------------------------
+// Compute a 64 bit hash over the face index data of a mesh. Instances share their
+// index buffers exactly, so there is no need to quantize anything here.
+uint64_t GetTopologyHash(aiMesh* mesh, std::vector<unsigned int>& buffer)
+{
+    buffer.clear();
+    for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+        const aiFace& f = mesh->mFaces[i];
+        buffer.push_back(f.mNumIndices);
+        buffer.insert(buffer.end(),f.mIndices,f.mIndices + f.mNumIndices);
+    }
+    return XXHash64(buffer.empty() ? NULL : &buffer[0],buffer.size() * sizeof(unsigned int),GetMeshHash(mesh));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Compute the values the bucket keys of a mesh are built from, see #NumHashValues.
+// Sums are accumulated in double precision, the values of two instances must not
+// drift apart by more than the comparison epsilon allows.
+void ComputeHashValues(const aiMesh* mesh, ai_real* out)
+{
+    double cx = 0., cy = 0., cz = 0.;
+    for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+        cx += mesh->mVertices[i].x;
+        cy += mesh->mVertices[i].y;
+        cz += mesh->mVertices[i].z;
+    }
+    const double inv = mesh->mNumVertices ? 1. / mesh->mNumVertices : 0.;
+    const aiVector3D center(static_cast<ai_real>(cx * inv),static_cast<ai_real>(cy * inv),static_cast<ai_real>(cz * inv));
+
+    double radius = 0., average = 0.;
+    for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+        const double d = (mesh->mVertices[i] - center).Length();
+        radius = std::max(radius,d);
+        average += d;
+    }
+    out[0] = center.x;
+    out[1] = center.y;
+    out[2] = center.z;
+    out[3] = static_cast<ai_real>(radius);
+    out[4] = static_cast<ai_real>(average * inv);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Get the bucket keys for a set of hash values. The values are snapped to a grid of about
+// 1/64 of the mesh radius, rounded to a power of two so that matching meshes use the same grid.
+// The comparison epsilon is derived from the mesh bounds, so the values of two meshes which
+// are equal within that epsilon differ by less than 1/20 of a grid cell.
+//
+// To look up a mesh, only the grid cells the values fall into are used, yielding a single key.
+// To insert a mesh, all grids and cells within that tolerance of the values are enumerated,
+// so the lookup of any matching mesh finds it, even if its values are snapped to a
+// neighbouring cell.
+void GetBucketKeys(uint64_t seed, const ai_real* values, unsigned int num, ai_real radius,
+    bool insert, std::vector<uint64_t>& keys)
+{
+    ai_assert(num <= NumHashValues);
+
+    const ai_real tolerance = insert ? ai_real(1.0/16) : ai_real(0.0);
+    const ai_real radiusTolerance = insert ? ai_real(1e-3) : ai_real(0.0);
+
+    int exp[2];
+    std::frexp(radius * (1 - radiusTolerance) / 64,&exp[0]);
+    std::frexp(radius * (1 + radiusTolerance) / 64,&exp[1]);
+
+    keys.clear();
+    for (unsigned int e = 0; e < (exp[0] == exp[1] ? 1u : 2u); ++e) {
+        const ai_real invGrid = std::ldexp(ai_real(1.0),-exp[e]);
+
+        int64_t lo[NumHashValues], hi[NumHashValues], cells[NumHashValues + 1];
+        for (unsigned int i = 0; i < num; ++i) {
+            const ai_real q = values[i] * invGrid;
+            lo[i] = static_cast<int64_t>(std::floor(q - tolerance));
+            hi[i] = static_cast<int64_t>(std::floor(q + tolerance));
+        }
+        cells[num] = exp[e];
+
+        for (unsigned int mask = 0; mask < (1u << num); ++mask) {
+            unsigned int i = 0;
+            for (; i < num; ++i) {
+                if (mask & (1u << i)) {
+                    if (hi[i] == lo[i]) {
+                        break;
+                    }
+                    cells[i] = hi[i];
+                }
+                else cells[i] = lo[i];
+            }
+            if (i == num) {
+                keys.push_back(XXHash64(cells,(num + 1) * sizeof(int64_t),seed));
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Build an orthonormal, right-handed frame from two non-parallel vectors
+aiMatrix3x3 GetFrame(const aiVector3D& a, const aiVector3D& b)
+{
+    const aiVector3D e1 = aiVector3D(a).Normalize();
+    const aiVector3D e3 = (a ^ b).Normalize();
+    const aiVector3D e2 = e3 ^ e1;
+
+    return aiMatrix3x3(
+        e1.x, e2.x, e3.x,
+        e1.y, e2.y, e3.y,
+        e1.z, e2.z, e3.z);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Compare two direction arrays after rotating the first one
+bool CompareRotated(const aiVector3D* first, const aiVector3D* second, unsigned int size,
+    const aiMatrix3x3& rot, float e)
+{
+    for (const aiVector3D* end = first+size; first != end; ++first,++second) {
+        if ( (rot * *first - *second).SquareLength() >= e)
+            return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Move the references to rigid instances into new child nodes which carry the
+// transformation of the instance, then update all mesh indices in the node graph.
+void UpdateMeshIndices(aiNode* node, const unsigned int* lookup, const std::vector<aiMatrix4x4>& trafos,
+    const std::vector<bool>& isRigid, const std::vector<aiString>& names)
+{
+    std::vector<aiNode*> added;
+    unsigned int numMeshes = 0;
+    for (unsigned int n = 0; n < node->mNumMeshes;++n) {
+        const unsigned int m = node->mMeshes[n];
+        if (!isRigid[m]) {
+            node->mMeshes[numMeshes++] = lookup[m];
+            continue;
+        }
+
+        aiNode* child = new aiNode();
+        if (names[m].length) {
+            // too long names are cut at the end
+            std::string name = std::string("$Instance_") + names[m].data;
+            name.resize(std::min<size_t>(name.length(),MAXLEN - 1));
+            child->mName.Set(name);
+        }
+        else {
+            ::ai_snprintf(child->mName.data,MAXLEN,"$Instance_%u",m);
+            child->mName.length = ::strlen(child->mName.data);
+        }
+
+        child->mTransformation = trafos[m];
+        child->mParent = node;
+        child->mNumMeshes = 1;
+        child->mMeshes = new unsigned int[1];
+        child->mMeshes[0] = lookup[m];
+        added.push_back(child);
+    }
+
+    for (unsigned int n = 0; n < node->mNumChildren;++n)
+        UpdateMeshIndices(node->mChildren[n],lookup,trafos,isRigid,names);
+
+    if (added.empty()) {
+        return;
+    }
+    node->mNumMeshes = numMeshes;
+    if (!numMeshes) {
+        delete[] node->mMeshes;
+        node->mMeshes = NULL;
+    }
+
+    aiNode** children = new aiNode*[node->mNumChildren + added.size()];
+    for (unsigned int n = 0; n < node->mNumChildren;++n) {
+        children[n] = node->mChildren[n];
+    }
+    for (size_t n = 0; n < added.size(); ++n) {
+        children[node->mNumChildren + n] = added[n];
+    }
+    delete[] node->mChildren;
+    node->mChildren = children;
+    node->mNumChildren += static_cast<unsigned int>(added.size());
+}
+
+} // ! anon namespace
+
+// ------------------------------------------------------------------------------------------------
+// Check whether 'inst' is an exact copy of 'orig'
+bool FindInstancesProcess::CompareMeshes(const aiMesh* orig, const aiMesh* inst) const
+{
+    // check for hash collision .. we needn't check
+    // the vertex format, it *must* match due to the
+    // (brilliant) construction of the hash
+    if (orig->mNumBones       != inst->mNumBones      ||
+        orig->mNumFaces       != inst->mNumFaces      ||
+        orig->mNumVertices    != inst->mNumVertices   ||
+        orig->mMaterialIndex  != inst->mMaterialIndex ||
+        orig->mPrimitiveTypes != inst->mPrimitiveTypes)
+        return false;
+
+    // up to now the meshes are equal. find an appropriate
+    // epsilon to compare position differences against
+    float epsilon = ComputePositionEpsilon(inst);
+    epsilon *= epsilon;
+
+    // now compare vertex positions, normals,
+    // tangents and bitangents using this epsilon.
+    if (orig->HasPositions()) {
+        if(!CompareArrays(orig->mVertices,inst->mVertices,orig->mNumVertices,epsilon))
+            return false;
+    }
+    if (orig->HasNormals()) {
+        if(!CompareArrays(orig->mNormals,inst->mNormals,orig->mNumVertices,epsilon))
+            return false;
+    }
+    if (orig->HasTangentsAndBitangents()) {
+        if (!CompareArrays(orig->mTangents,inst->mTangents,orig->mNumVertices,epsilon) ||
+            !CompareArrays(orig->mBitangents,inst->mBitangents,orig->mNumVertices,epsilon))
+            return false;
+    }
+
+    for (unsigned int i = 0, end = orig->GetNumUVChannels(); i < end; ++i) {
+        if (orig->mTextureCoords[i] &&
+            !CompareArrays(orig->mTextureCoords[i],inst->mTextureCoords[i],orig->mNumVertices,uvEpsilon)) {
+            return false;
+        }
+    }
+    for (unsigned int i = 0, end = orig->GetNumColorChannels(); i < end; ++i) {
+        if (orig->mColors[i] &&
+            !CompareArrays(orig->mColors[i],inst->mColors[i],orig->mNumVertices,uvEpsilon)) {
+            return false;
+        }
+    }
+
+    // These two checks are actually quite expensive and almost *never* required.
+    // Almost. That's why they're still here. But there's no reason to do them
+    // in speed-targeted imports.
+    if (!configSpeedFlag) {
+
+        // It seems to be strange, but we really need to check whether the
+        // bones are identical too. Although it's extremely unprobable
+        // that they're not if control reaches here, we need to deal
+        // with unprobable cases, too. It could still be that there are
+        // equal shapes which are deformed differently.
+        if (!CompareBones(orig,inst))
+            return false;
+
+        // For completeness ... compare even the index buffers for equality
+        // face order & winding order doesn't care. Input data is in verbose format.
+        std::unique_ptr<unsigned int[]> ftbl_orig(new unsigned int[orig->mNumVertices]);
+        std::unique_ptr<unsigned int[]> ftbl_inst(new unsigned int[orig->mNumVertices]);
+
+        for (unsigned int tt = 0; tt < orig->mNumFaces;++tt) {
+            aiFace& f = orig->mFaces[tt];
+            for (unsigned int nn = 0; nn < f.mNumIndices;++nn)
+                ftbl_orig[f.mIndices[nn]] = tt;
+
+            aiFace& f2 = inst->mFaces[tt];
+            for (unsigned int nn = 0; nn < f2.mNumIndices;++nn)
+                ftbl_inst[f2.mIndices[nn]] = tt;
+        }
+        if (0 != ::memcmp(ftbl_inst.get(),ftbl_orig.get(),orig->mNumVertices*sizeof(unsigned int)))
+            return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Check whether 'inst' is a copy of 'orig' moved by a rigid transformation
+bool FindInstancesProcess::FindRigidTransform(const aiMesh* orig, const aiMesh* inst,
+    aiMatrix4x4& out) const
+{
+    if (orig->HasBones()                                  ||
+        inst->HasBones()                                  ||
+        orig->mNumFaces       != inst->mNumFaces          ||
+        orig->mNumVertices    != inst->mNumVertices       ||
+        orig->mMaterialIndex  != inst->mMaterialIndex     ||
+        orig->mPrimitiveTypes != inst->mPrimitiveTypes    ||
+        GetMeshVFormatUnique(orig) != GetMeshVFormatUnique(inst))
+        return false;
+
+    // the topology must match exactly
+    for (unsigned int i = 0; i < orig->mNumFaces; ++i) {
+        const aiFace& fo = orig->mFaces[i];
+        const aiFace& fi = inst->mFaces[i];
+        if (fo.mNumIndices != fi.mNumIndices ||
+            0 != ::memcmp(fo.mIndices,fi.mIndices,fo.mNumIndices*sizeof(unsigned int)))
+            return false;
+    }
+
+    // texture coordinates and colors don't change if the mesh is moved
+    for (unsigned int i = 0, end = orig->GetNumUVChannels(); i < end; ++i) {
+        if (orig->mTextureCoords[i] &&
+            !CompareArrays(orig->mTextureCoords[i],inst->mTextureCoords[i],orig->mNumVertices,uvEpsilon)) {
+            return false;
+        }
+    }
+    for (unsigned int i = 0, end = orig->GetNumColorChannels(); i < end; ++i) {
+        if (orig->mColors[i] &&
+            !CompareArrays(orig->mColors[i],inst->mColors[i],orig->mNumVertices,uvEpsilon)) {
+            return false;
+        }
+    }
+
+    // Estimate the rotation from a frame spanned by the vertex farthest away from the
+    // centroid and the vertex which forms the largest triangle with it and the centroid.
+    // The vertex order is the same for both meshes, so the same vertices can be used.
+    const unsigned int num = orig->mNumVertices;
+    aiVector3D co, ci;
+    for (unsigned int i = 0; i < num; ++i) {
+        co += orig->mVertices[i];
+        ci += inst->mVertices[i];
+    }
+    co /= static_cast<ai_real>(num);
+    ci /= static_cast<ai_real>(num);
+
+    unsigned int va = 0;
+    ai_real best = 0;
+    for (unsigned int i = 0; i < num; ++i) {
+        const ai_real d = (orig->mVertices[i] - co).SquareLength();
+        if (d > best) {
+            best = d;
+            va = i;
+        }
+    }
+    const aiVector3D ao = orig->mVertices[va] - co;
+    const ai_real minArea = best * best * ai_real(1e-6);
+
+    unsigned int vb = 0;
+    best = 0;
+    for (unsigned int i = 0; i < num; ++i) {
+        const ai_real d = (ao ^ (orig->mVertices[i] - co)).SquareLength();
+        if (d > best) {
+            best = d;
+            vb = i;
+        }
+    }
+
+    // all vertices on a line, the rotation is not defined
+    const aiVector3D ai = inst->mVertices[va] - ci;
+    const aiVector3D bo = orig->mVertices[vb] - co, bi = inst->mVertices[vb] - ci;
+    if (best <= minArea || (ai ^ bi).SquareLength() <= minArea) {
+        return false;
+    }
+
+    const aiMatrix3x3 rot = GetFrame(ai,bi) * GetFrame(ao,bo).Transpose();
+    const aiVector3D trans = ci - rot * co;
+
+    float epsilon = ComputePositionEpsilon(inst);
+    epsilon *= epsilon;
+    for (unsigned int i = 0; i < num; ++i) {
+        if ((rot * orig->mVertices[i] + trans - inst->mVertices[i]).SquareLength() >= epsilon)
+            return false;
+    }
+    if (orig->HasNormals()) {
+        if (!CompareRotated(orig->mNormals,inst->mNormals,num,rot,uvEpsilon))
+            return false;
+    }
+    if (orig->HasTangentsAndBitangents()) {
+        if (!CompareRotated(orig->mTangents,inst->mTangents,num,rot,uvEpsilon) ||
+            !CompareRotated(orig->mBitangents,inst->mBitangents,num,rot,uvEpsilon))
+            return false;
+    }
+
+    out = aiMatrix4x4(rot);
+    out.a4 = trans.x;
+    out.b4 = trans.y;
+    out.c4 = trans.z;
+    return true;
+}
+
 // ------------------------------------------------------------------------------------------------
 // Executes the post processing step on the given imported data.
 void FindInstancesProcess::Execute( aiScene* pScene)
@@ -121,135 +509,94 @@ void FindInstancesProcess::Execute( aiScene* pScene)
     DefaultLogger::get()->debug("FindInstancesProcess begin");
     if (pScene->mNumMeshes) {
 
-        // use a pseudo hash for all meshes in the scene to quickly find
-        // the ones which are possibly equal. This step is executed early
-        // in the pipeline, so we could, depending on the file format,
-        // have several thousand small meshes. That's too much for a brute
-        // everyone-against-everyone check involving up to 10 comparisons
-        // each.
-        std::unique_ptr<uint64_t[]> hashes (new uint64_t[pScene->mNumMeshes]);
+        // Hash the contents of all meshes in the scene and sort them into buckets, only
+        // meshes in the same bucket need to be compared. This step is executed early
+        // in the pipeline, so we could, depending on the file format, have several
+        // thousand small meshes. That's too much for a brute everyone-against-everyone
+        // check involving up to 10 comparisons each.
+        typedef std::unordered_map<uint64_t, std::vector<unsigned int> > BucketMap;
+        BucketMap buckets, rigidBuckets;
+        std::vector<unsigned int> indexData;
+        std::vector<uint64_t> keys;
+
         std::unique_ptr<unsigned int[]> remapping (new unsigned int[pScene->mNumMeshes]);
 
-        unsigned int numMeshesOut = 0;
+        // rigid instances only: transformation from the original to the instance
+        std::vector<aiMatrix4x4> trafos;
+        std::vector<bool> isRigid;
+        std::vector<aiString> names;
+        if (configRigidInstances) {
+            trafos.resize(pScene->mNumMeshes);
+            isRigid.resize(pScene->mNumMeshes,false);
+            names.resize(pScene->mNumMeshes);
+        }
+
+        unsigned int numMeshesOut = 0, numRigid = 0;
         for (unsigned int i = 0; i < pScene->mNumMeshes; ++i) {
 
             aiMesh* inst = pScene->mMeshes[i];
-            hashes[i] = GetMeshHash(inst);
-
-            for (int a = i-1; a >= 0; --a) {
-                if (hashes[i] == hashes[a])
-                {
-                    aiMesh* orig = pScene->mMeshes[a];
-                    if (!orig)
-                        continue;
-
-                    // check for hash collision .. we needn't check
-                    // the vertex format, it *must* match due to the
-                    // (brilliant) construction of the hash
-                    if (orig->mNumBones       != inst->mNumBones      ||
-                        orig->mNumFaces       != inst->mNumFaces      ||
-                        orig->mNumVertices    != inst->mNumVertices   ||
-                        orig->mMaterialIndex  != inst->mMaterialIndex ||
-                        orig->mPrimitiveTypes != inst->mPrimitiveTypes)
-                        continue;
-
-                    // up to now the meshes are equal. find an appropriate
-                    // epsilon to compare position differences against
-                    float epsilon = ComputePositionEpsilon(inst);
-                    epsilon *= epsilon;
-
-                    // now compare vertex positions, normals,
-                    // tangents and bitangents using this epsilon.
-                    if (orig->HasPositions()) {
-                        if(!CompareArrays(orig->mVertices,inst->mVertices,orig->mNumVertices,epsilon))
-                            continue;
-                    }
-                    if (orig->HasNormals()) {
-                        if(!CompareArrays(orig->mNormals,inst->mNormals,orig->mNumVertices,epsilon))
-                            continue;
-                    }
-                    if (orig->HasTangentsAndBitangents()) {
-                        if (!CompareArrays(orig->mTangents,inst->mTangents,orig->mNumVertices,epsilon) ||
-                            !CompareArrays(orig->mBitangents,inst->mBitangents,orig->mNumVertices,epsilon))
-                            continue;
-                    }
-
-                    // use a constant epsilon for colors and UV coordinates
-                    static const float uvEpsilon = 10e-4f;
-                    {
-                        unsigned int i, end = orig->GetNumUVChannels();
-                        for(i = 0; i < end; ++i) {
-                            if (!orig->mTextureCoords[i]) {
-                                continue;
-                            }
-                            if(!CompareArrays(orig->mTextureCoords[i],inst->mTextureCoords[i],orig->mNumVertices,uvEpsilon)) {
-                                break;
-                            }
-                        }
-                        if (i != end) {
-                            continue;
-                        }
-                    }
-                    {
-                        unsigned int i, end = orig->GetNumColorChannels();
-                        for(i = 0; i < end; ++i) {
-                            if (!orig->mColors[i]) {
-                                continue;
-                            }
-                            if(!CompareArrays(orig->mColors[i],inst->mColors[i],orig->mNumVertices,uvEpsilon)) {
-                                break;
-                            }
-                        }
-                        if (i != end) {
-                            continue;
-                        }
+            const uint64_t topology = GetTopologyHash(inst,indexData);
+            const uint64_t rigidTopology = topology ^ 0x9e3779b97f4a7c15ULL;
+            const bool rigidCandidate = configRigidInstances && inst->HasPositions() && !inst->HasBones();
+
+            ai_real values[NumHashValues];
+            ComputeHashValues(inst,values);
+
+            // try the most recent candidates first
+            bool found = false;
+            GetBucketKeys(topology,values,NumHashValues,values[3],false,keys);
+            BucketMap::iterator bucket = buckets.find(keys[0]);
+            if (bucket != buckets.end()) {
+                const std::vector<unsigned int>& candidates = (*bucket).second;
+                for (std::vector<unsigned int>::const_reverse_iterator it = candidates.rbegin(); it != candidates.rend(); ++it) {
+                    if (CompareMeshes(pScene->mMeshes[*it],inst)) {
+
+                        // We're still here. Or in other words: 'inst' is an instance of 'orig'.
+                        // Place a marker in our list that we can easily update mesh indices.
+                        remapping[i] = remapping[*it];
+                        found = true;
+                        break;
                     }
+                }
+            }
 
-                    // These two checks are actually quite expensive and almost *never* required.
-                    // Almost. That's why they're still here. But there's no reason to do them
-                    // in speed-targeted imports.
-                    if (!configSpeedFlag) {
-
-                        // It seems to be strange, but we really need to check whether the
-                        // bones are identical too. Although it's extremely unprobable
-                        // that they're not if control reaches here, we need to deal
-                        // with unprobable cases, too. It could still be that there are
-                        // equal shapes which are deformed differently.
-                        if (!CompareBones(orig,inst))
-                            continue;
-
-                        // For completeness ... compare even the index buffers for equality
-                        // face order & winding order doesn't care. Input data is in verbose format.
-                        std::unique_ptr<unsigned int[]> ftbl_orig(new unsigned int[orig->mNumVertices]);
-                        std::unique_ptr<unsigned int[]> ftbl_inst(new unsigned int[orig->mNumVertices]);
-
-                        for (unsigned int tt = 0; tt < orig->mNumFaces;++tt) {
-                            aiFace& f = orig->mFaces[tt];
-                            for (unsigned int nn = 0; nn < f.mNumIndices;++nn)
-                                ftbl_orig[f.mIndices[nn]] = tt;
-
-                            aiFace& f2 = inst->mFaces[tt];
-                            for (unsigned int nn = 0; nn < f2.mNumIndices;++nn)
-                                ftbl_inst[f2.mIndices[nn]] = tt;
+            // no exact copy, but maybe a moved one
+            if (!found && rigidCandidate) {
+                GetBucketKeys(rigidTopology,values + 3,NumRigidHashValues,values[3],false,keys);
+                bucket = rigidBuckets.find(keys[0]);
+                if (bucket != rigidBuckets.end()) {
+                    const std::vector<unsigned int>& candidates = (*bucket).second;
+                    for (std::vector<unsigned int>::const_reverse_iterator it = candidates.rbegin(); it != candidates.rend(); ++it) {
+                        if (FindRigidTransform(pScene->mMeshes[*it],inst,trafos[i])) {
+                            remapping[i] = remapping[*it];
+                            isRigid[i] = true;
+                            names[i] = inst->mName;
+                            found = true;
+                            ++numRigid;
+                            break;
                         }
-                        if (0 != ::memcmp(ftbl_inst.get(),ftbl_orig.get(),orig->mNumVertices*sizeof(unsigned int)))
-                            continue;
                     }
-
-                    // We're still here. Or in other words: 'inst' is an instance of 'orig'.
-                    // Place a marker in our list that we can easily update mesh indices.
-                    remapping[i] = remapping[a];
-
-                    // Delete the instanced mesh, we don't need it anymore
-                    delete inst;
-                    pScene->mMeshes[i] = NULL;
-                    break;
                 }
             }
 
+            if (found) {
+                // Delete the instanced mesh, we don't need it anymore
+                delete inst;
+                pScene->mMeshes[i] = NULL;
+                continue;
+            }
+
             // If we didn't find a match for the current mesh: keep it
-            if (pScene->mMeshes[i]) {
-                remapping[i] = numMeshesOut++;
+            remapping[i] = numMeshesOut++;
+            GetBucketKeys(topology,values,NumHashValues,values[3],true,keys);
+            for (std::vector<uint64_t>::const_iterator it = keys.begin(); it != keys.end(); ++it) {
+                buckets[*it].push_back(i);
+            }
+            if (rigidCandidate) {
+                GetBucketKeys(rigidTopology,values + 3,NumRigidHashValues,values[3],true,keys);
+                for (std::vector<uint64_t>::const_iterator it = keys.begin(); it != keys.end(); ++it) {
+                    rigidBuckets[*it].push_back(i);
+                }
             }
         }
         ai_assert(0 != numMeshesOut);
@@ -262,13 +609,17 @@ void FindInstancesProcess::Execute( aiScene* pScene)
             }
 
             // And update the node graph with our nice lookup table
-            UpdateMeshIndices(pScene->mRootNode,remapping.get());
+            if (numRigid) {
+                UpdateMeshIndices(pScene->mRootNode,remapping.get(),trafos,isRigid,names);
+            }
+            else UpdateMeshIndices(pScene->mRootNode,remapping.get());
 
             // write to log
             if (!DefaultLogger::isNullLogger()) {
 
                 char buffer[512];
-                ::ai_snprintf(buffer,512,"FindInstancesProcess finished. Found %i instances",pScene->mNumMeshes-numMeshesOut);
+                ::ai_snprintf(buffer,512,"FindInstancesProcess finished. Found %i instances, %i of them moved by a rigid transformation",
+                    pScene->mNumMeshes-numMeshesOut,numRigid);
                 DefaultLogger::get()->info(buffer);
             }
             pScene->mNumMeshes = numMeshesOut;
@@ -126,9 +126,22 @@ public:
     // Setup properties prior to executing the process
     void SetupProperties(const Importer* pImp);
 
+private:
+
+    // -------------------------------------------------------------------
+    // Check whether 'inst' is an exact copy of 'orig'
+    bool CompareMeshes(const aiMesh* orig, const aiMesh* inst) const;
+
+    // -------------------------------------------------------------------
+    // Check whether 'inst' is a copy of 'orig' moved by a rigid
+    // transformation. The transformation is returned in 'out'.
+    bool FindRigidTransform(const aiMesh* orig, const aiMesh* inst,
+        aiMatrix4x4& out) const;
+
 private:
 
     bool configSpeedFlag;
+    bool configRigidInstances;
 
 }; // ! end class FindInstancesProcess
 }  // ! end namespace Assimp
@@ -85,7 +85,7 @@ void FixInfacingNormalsProcess::Execute( aiScene* pScene)
 
     bool bHas = false;
     for( unsigned int a = 0; a < pScene->mNumMeshes; a++)
-        if(ProcessMesh( pScene->mMeshes[a],a))bHas = true;
+        if(IsMeshDirty(a) && ProcessMesh( pScene->mMeshes[a],a))bHas = true;
 
     if (bHas)
          DefaultLogger::get()->debug("FixInfacingNormalsProcess finished. Found issues.");
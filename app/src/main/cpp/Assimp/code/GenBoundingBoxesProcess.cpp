@@ -0,0 +1,440 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2017, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file GenBoundingBoxesProcess.cpp
+ *  @brief Implementation of the GenBoundingBoxesProcess post processing step
+ */
+
+#ifndef ASSIMP_BUILD_NO_GENBOUNDINGBOXES_PROCESS
+
+#include "GenBoundingBoxesProcess.h"
+#include "ProcessHelper.h"
+#include "VectorKernels.h"
+#include "StringUtils.h"
+#include <assimp/postprocess.h>
+#include <assimp/DefaultLogger.hpp>
+#include <assimp/scene.h>
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+using namespace Assimp;
+
+namespace {
+
+// number of bins per axis for the SAH split search
+const unsigned int NumBins = 16;
+
+// ------------------------------------------------------------------------------------------------
+// Returns an empty box which can be grown by Grow()
+inline aiAABB EmptyBox()
+{
+    const ai_real big = std::numeric_limits<ai_real>::max();
+    return aiAABB(aiVector3D(big,big,big),aiVector3D(-big,-big,-big));
+}
+
+// ------------------------------------------------------------------------------------------------
+inline void Grow(aiAABB& box, const aiVector3D& p)
+{
+    box.mMin = std::min(box.mMin,p);
+    box.mMax = std::max(box.mMax,p);
+}
+
+// ------------------------------------------------------------------------------------------------
+inline void Grow(aiAABB& box, const aiAABB& other)
+{
+    box.mMin = std::min(box.mMin,other.mMin);
+    box.mMax = std::max(box.mMax,other.mMax);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Half the surface area of a box, which is all the SAH needs
+inline ai_real HalfArea(const aiAABB& box)
+{
+    if (box.IsEmpty()) {
+        return 0;
+    }
+    const aiVector3D d = box.mMax - box.mMin;
+    return d.x * d.y + d.y * d.z + d.z * d.x;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Computes a bounding sphere of the vertices of a mesh. Ritter's approximation is compared with
+// the sphere around the center of the bounding box and the smaller one is taken.
+void ComputeBoundingSphere(const aiMesh* mesh, aiVector3D& center, ai_real& radius)
+{
+    const aiVector3D* const verts = mesh->mVertices;
+    const unsigned int num = mesh->mNumVertices;
+
+    // sphere around the center of the bounding box
+    const aiVector3D boxCenter = (mesh->mAABB.mMin + mesh->mAABB.mMax) * ai_real(0.5);
+    ai_real boxRadius = 0;
+    for (unsigned int i = 0; i < num; ++i) {
+        boxRadius = std::max(boxRadius,(verts[i] - boxCenter).SquareLength());
+    }
+    boxRadius = sqrt(boxRadius);
+
+    // Ritter: start with the sphere spanned by two distant points and grow it
+    unsigned int p = 0, q = 0;
+    ai_real best = 0;
+    for (unsigned int i = 0; i < num; ++i) {
+        const ai_real d = (verts[i] - verts[0]).SquareLength();
+        if (d > best) {
+            best = d;
+            p = i;
+        }
+    }
+    best = 0;
+    for (unsigned int i = 0; i < num; ++i) {
+        const ai_real d = (verts[i] - verts[p]).SquareLength();
+        if (d > best) {
+            best = d;
+            q = i;
+        }
+    }
+
+    aiVector3D c = (verts[p] + verts[q]) * ai_real(0.5);
+    ai_real r = sqrt(best) * ai_real(0.5);
+    for (unsigned int i = 0; i < num; ++i) {
+        const aiVector3D d = verts[i] - c;
+        const ai_real len = d.Length();
+        if (len > r) {
+            const ai_real nr = (r + len) * ai_real(0.5);
+            c += d * ((nr - r) / len);
+            r = nr;
+        }
+    }
+
+    if (r < boxRadius) {
+        center = c;
+        radius = r;
+    }
+    else {
+        center = boxCenter;
+        radius = boxRadius;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Transforms a box and returns the box around the result
+aiAABB TransformBox(const aiAABB& box, const aiMatrix4x4& m)
+{
+    aiAABB out = EmptyBox();
+    for (unsigned int i = 0; i < 8; ++i) {
+        const aiVector3D corner((i & 1) ? box.mMax.x : box.mMin.x,
+            (i & 2) ? box.mMax.y : box.mMin.y,
+            (i & 4) ? box.mMax.z : box.mMin.z);
+        Grow(out,m * corner);
+    }
+    return out;
+}
+
+// ------------------------------------------------------------------------------------------------
+// A pending range of faces during BVH construction
+struct BuildTask
+{
+    unsigned int node, begin, end;
+};
+
+} // ! anon namespace
+
+// ------------------------------------------------------------------------------------------------
+// Constructor to be privately used by Importer
+GenBoundingBoxesProcess::GenBoundingBoxesProcess()
+: mBuildBVH(false)
+, mMaxLeafSize(AI_GB_DEFAULT_BVH_MAX_LEAF_SIZE)
+{
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+// Destructor, private as well
+GenBoundingBoxesProcess::~GenBoundingBoxesProcess()
+{
+    // nothing to do here
+}
+
+// ------------------------------------------------------------------------------------------------
+// Returns whether the processing step is present in the given flag field.
+bool GenBoundingBoxesProcess::IsActive( unsigned int pFlags) const
+{
+    return (pFlags & aiProcess_GenBoundingBoxes) != 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Setup configuration properties for the step
+void GenBoundingBoxesProcess::SetupProperties(const Importer* pImp)
+{
+    mBuildBVH = pImp->GetPropertyBool(AI_CONFIG_PP_GB_BVH,false);
+    mMaxLeafSize = std::max(1,pImp->GetPropertyInteger(AI_CONFIG_PP_GB_BVH_MAX_LEAF_SIZE,AI_GB_DEFAULT_BVH_MAX_LEAF_SIZE));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on the given imported data.
+void GenBoundingBoxesProcess::Execute( aiScene* pScene)
+{
+    DefaultLogger::get()->debug("GenBoundingBoxesProcess begin");
+
+    unsigned int numNodes = 0;
+    for( unsigned int a = 0; a < pScene->mNumMeshes; a++) {
+        if (IsMeshDirty(a)) {
+            ProcessMesh( pScene->mMeshes[a]);
+        }
+        numNodes += pScene->mMeshes[a]->mNumBVHNodes;
+    }
+
+    // node bounds depend on all meshes, so they are always recomputed
+    if (pScene->mRootNode) {
+        ProcessNode( pScene, pScene->mRootNode, aiMatrix4x4());
+    }
+
+    if (!DefaultLogger::isNullLogger()) {
+        char buffer[1024];
+        ai_snprintf(buffer,1024,"GenBoundingBoxesProcess finished. %u BVH nodes in %u meshes",
+            numNodes,pScene->mNumMeshes);
+        DefaultLogger::get()->info(buffer);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Computes the bounds of a single mesh
+void GenBoundingBoxesProcess::ProcessMesh( aiMesh* pMesh) const
+{
+    // drop the hierarchy of a previous run, it might be out of date
+    delete[] pMesh->mBVHNodes;
+    delete[] pMesh->mBVHFaces;
+    pMesh->mBVHNodes = NULL;
+    pMesh->mBVHFaces = NULL;
+    pMesh->mNumBVHNodes = 0;
+    pMesh->mNumBVHFaces = 0;
+
+    if (!pMesh->HasPositions()) {
+        pMesh->mAABB = aiAABB();
+        pMesh->mBoundingSphereCenter = aiVector3D();
+        pMesh->mBoundingSphereRadius = 0;
+        return;
+    }
+
+    // same start values as ArrayBounds()
+    MinMaxChooser<aiVector3D>()(pMesh->mAABB.mMin,pMesh->mAABB.mMax);
+    GrowBoundsBatch(pMesh->mVertices,pMesh->mNumVertices,pMesh->mAABB.mMin,pMesh->mAABB.mMax);
+    ComputeBoundingSphere(pMesh,pMesh->mBoundingSphereCenter,pMesh->mBoundingSphereRadius);
+
+    if (mBuildBVH && pMesh->HasFaces()) {
+        BuildBVH(pMesh);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Builds a BVH over the faces of a mesh using binned SAH splits
+void GenBoundingBoxesProcess::BuildBVH( aiMesh* pMesh) const
+{
+    const unsigned int numFaces = pMesh->mNumFaces;
+
+    // bounds and centroids of all faces
+    std::vector<aiAABB> faceBounds(numFaces);
+    std::vector<aiVector3D> centroids(numFaces);
+    for (unsigned int i = 0; i < numFaces; ++i) {
+        const aiFace& face = pMesh->mFaces[i];
+        aiAABB& box = faceBounds[i] = EmptyBox();
+        for (unsigned int j = 0; j < face.mNumIndices; ++j) {
+            Grow(box,pMesh->mVertices[face.mIndices[j]]);
+        }
+        centroids[i] = (box.mMin + box.mMax) * ai_real(0.5);
+    }
+
+    unsigned int* faces = new unsigned int[numFaces];
+    for (unsigned int i = 0; i < numFaces; ++i) {
+        faces[i] = i;
+    }
+
+    // a binary tree with n leaves has 2n-1 nodes
+    std::vector<aiBVHNode> nodes;
+    nodes.reserve(2 * ((numFaces + mMaxLeafSize - 1) / mMaxLeafSize));
+    nodes.push_back(aiBVHNode());
+
+    std::vector<BuildTask> stack;
+    BuildTask root = { 0, 0, numFaces };
+    stack.push_back(root);
+
+    while (!stack.empty()) {
+        const BuildTask task = stack.back();
+        stack.pop_back();
+
+        const unsigned int count = task.end - task.begin;
+        aiAABB box = EmptyBox(), centroidBox = EmptyBox();
+        for (unsigned int i = task.begin; i < task.end; ++i) {
+            Grow(box,faceBounds[faces[i]]);
+            Grow(centroidBox,centroids[faces[i]]);
+        }
+        nodes[task.node].mBounds = box;
+
+        // find the cheapest split plane, costs are relative to the area of the node
+        unsigned int bestAxis = 0, bestBin = 0;
+        ai_real bestCost = std::numeric_limits<ai_real>::max();
+        if (count > 1) {
+            for (unsigned int axis = 0; axis < 3; ++axis) {
+                const ai_real lo = centroidBox.mMin[axis], extent = centroidBox.mMax[axis] - lo;
+                if (extent <= 0) {
+                    continue;
+                }
+                const ai_real scale = NumBins / extent;
+
+                aiAABB bins[NumBins];
+                unsigned int binCounts[NumBins] = { 0 };
+                for (unsigned int b = 0; b < NumBins; ++b) {
+                    bins[b] = EmptyBox();
+                }
+                for (unsigned int i = task.begin; i < task.end; ++i) {
+                    const unsigned int b = std::min(NumBins - 1,
+                        static_cast<unsigned int>((centroids[faces[i]][axis] - lo) * scale));
+                    Grow(bins[b],faceBounds[faces[i]]);
+                    ++binCounts[b];
+                }
+
+                // sweep from the right to get the area and count right of each plane
+                ai_real rightArea[NumBins];
+                unsigned int rightCount[NumBins];
+                aiAABB acc = EmptyBox();
+                unsigned int n = 0;
+                for (unsigned int b = NumBins - 1; b > 0; --b) {
+                    Grow(acc,bins[b]);
+                    n += binCounts[b];
+                    rightArea[b] = HalfArea(acc);
+                    rightCount[b] = n;
+                }
+
+                acc = EmptyBox();
+                n = 0;
+                for (unsigned int b = 1; b < NumBins; ++b) {
+                    Grow(acc,bins[b - 1]);
+                    n += binCounts[b - 1];
+                    if (!n || !rightCount[b]) {
+                        continue;
+                    }
+                    const ai_real cost = HalfArea(acc) * n + rightArea[b] * rightCount[b];
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestBin = b;
+                    }
+                }
+            }
+        }
+
+        // make a leaf if it is small enough and splitting doesn't pay off
+        const ai_real area = HalfArea(box);
+        const bool canSplit = bestCost < std::numeric_limits<ai_real>::max();
+        if (count <= mMaxLeafSize && (!canSplit || area + bestCost >= area * count)) {
+            nodes[task.node].mFirst = task.begin;
+            nodes[task.node].mNumFaces = count;
+            continue;
+        }
+
+        unsigned int mid;
+        if (canSplit) {
+            const ai_real lo = centroidBox.mMin[bestAxis];
+            const ai_real scale = NumBins / (centroidBox.mMax[bestAxis] - lo);
+            mid = static_cast<unsigned int>(std::partition(faces + task.begin, faces + task.end,
+                [&](unsigned int f) {
+                    return std::min(NumBins - 1,
+                        static_cast<unsigned int>((centroids[f][bestAxis] - lo) * scale)) < bestBin;
+                }) - faces);
+        }
+        else {
+            // all centroids coincide, any split is as good as another
+            mid = task.begin + count / 2;
+        }
+
+        const unsigned int first = static_cast<unsigned int>(nodes.size());
+        nodes[task.node].mFirst = first;
+        nodes[task.node].mNumFaces = 0;
+        nodes.push_back(aiBVHNode());
+        nodes.push_back(aiBVHNode());
+
+        BuildTask right = { first + 1, mid, task.end };
+        BuildTask left = { first, task.begin, mid };
+        stack.push_back(right);
+        stack.push_back(left);
+    }
+
+    pMesh->mNumBVHNodes = static_cast<unsigned int>(nodes.size());
+    pMesh->mBVHNodes = new aiBVHNode[nodes.size()];
+    std::copy(nodes.begin(),nodes.end(),pMesh->mBVHNodes);
+    pMesh->mNumBVHFaces = numFaces;
+    pMesh->mBVHFaces = faces;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Computes the world-space bounds of a node and its subtree
+aiAABB GenBoundingBoxesProcess::ProcessNode( const aiScene* pScene, aiNode* pNode,
+    const aiMatrix4x4& pParent) const
+{
+    const aiMatrix4x4 world = pParent * pNode->mTransformation;
+
+    aiAABB box = EmptyBox();
+    for (unsigned int i = 0; i < pNode->mNumMeshes; ++i) {
+        const aiMesh* mesh = pScene->mMeshes[pNode->mMeshes[i]];
+        if (!mesh->HasPositions()) {
+            continue;
+        }
+        if (mesh->HasInstances()) {
+            for (unsigned int k = 0; k < mesh->mNumInstances; ++k) {
+                Grow(box,TransformBox(mesh->mAABB,world * mesh->mInstanceTransforms[k]));
+            }
+        }
+        else {
+            Grow(box,TransformBox(mesh->mAABB,world));
+        }
+    }
+
+    for (unsigned int i = 0; i < pNode->mNumChildren; ++i) {
+        Grow(box,ProcessNode(pScene,pNode->mChildren[i],world));
+    }
+
+    pNode->mWorldAABB = box;
+    return box;
+}
+
+#endif // !! ASSIMP_BUILD_NO_GENBOUNDINGBOXES_PROCESS
@@ -0,0 +1,136 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2017, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+
+/** @file GenBoundingBoxesProcess.h
+ *  @brief Defines a post processing step to compute bounding volumes.
+ */
+#ifndef AI_GENBOUNDINGBOXESPROCESS_H_INC
+#define AI_GENBOUNDINGBOXESPROCESS_H_INC
+
+#include "BaseProcess.h"
+#include <assimp/aabb.h>
+
+struct aiMesh;
+struct aiNode;
+
+namespace Assimp
+{
+
+// default value for AI_CONFIG_PP_GB_BVH_MAX_LEAF_SIZE
+#if (!defined AI_GB_DEFAULT_BVH_MAX_LEAF_SIZE)
+#   define AI_GB_DEFAULT_BVH_MAX_LEAF_SIZE 4
+#endif
+
+// ---------------------------------------------------------------------------
+/** The GenBoundingBoxesProcess computes a bounding box and a bounding
+ *  sphere for each mesh and the world-space bounding box of each node.
+ *  Optionally it builds a bounding volume hierarchy over the faces of
+ *  each mesh using the binned surface area heuristic.
+ */
+class ASSIMP_API GenBoundingBoxesProcess : public BaseProcess
+{
+public:
+
+    GenBoundingBoxesProcess();
+    ~GenBoundingBoxesProcess();
+
+public:
+    // -------------------------------------------------------------------
+    /** Returns whether the processing step is present in the given flag.
+    * @param pFlags The processing flags the importer was called with.
+    *   A bitwise combination of #aiPostProcessSteps.
+    * @return true if the process is present in this flag fields,
+    *   false if not.
+    */
+    bool IsActive( unsigned int pFlags) const;
+
+    // -------------------------------------------------------------------
+    /** Called prior to ExecuteOnScene().
+    * The function is a request to the process to update its configuration
+    * basing on the Importer's configuration property list.
+    */
+    void SetupProperties(const Importer* pImp);
+
+    // -------------------------------------------------------------------
+    /** Executes the post processing step on the given imported data.
+    * At the moment a process is not supposed to fail.
+    * @param pScene The imported data to work at.
+    */
+    void Execute( aiScene* pScene);
+
+public:
+    // -------------------------------------------------------------------
+    /** Computes the bounding box and bounding sphere of a single mesh
+    * and, if enabled, its bounding volume hierarchy.
+    * @param pMesh The mesh to process.
+    */
+    void ProcessMesh( aiMesh* pMesh) const;
+
+    // -------------------------------------------------------------------
+    /** Builds the bounding volume hierarchy of a single mesh.
+    * @param pMesh The mesh to process, must have faces.
+    */
+    void BuildBVH( aiMesh* pMesh) const;
+
+    // -------------------------------------------------------------------
+    /** Computes the world-space bounds of a node and its children from
+    * the bounding boxes of the meshes they reference.
+    * @param pScene The scene the node belongs to.
+    * @param pNode The node to process.
+    * @param pParent World transformation of the parent node.
+    * @return The world-space bounds of the node.
+    */
+    aiAABB ProcessNode( const aiScene* pScene, aiNode* pNode,
+        const aiMatrix4x4& pParent) const;
+
+public:
+
+    /** Build a bounding volume hierarchy per mesh? */
+    bool mBuildBVH;
+
+    /** Maximum number of faces per BVH leaf */
+    unsigned int mMaxLeafSize;
+};
+
+} // end of namespace Assimp
+
+#endif // AI_GENBOUNDINGBOXESPROCESS_H_INC
@@ -50,7 +50,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/scene.h>
 #include <assimp/DefaultLogger.hpp>
 #include "Exceptional.h"
-#include "qnan.h"
+#include "VectorKernels.h"
 
 
 using namespace Assimp;
@@ -88,7 +88,7 @@ void GenFaceNormalsProcess::Execute( aiScene* pScene)
 
     bool bHas = false;
     for( unsigned int a = 0; a < pScene->mNumMeshes; a++)   {
-        if(this->GenMeshFaceNormals( pScene->mMeshes[a])) {
+        if(IsMeshDirty(a) && this->GenMeshFaceNormals( pScene->mMeshes[a])) {
             bHas = true;
         }
     }
@@ -116,29 +116,9 @@ bool GenFaceNormalsProcess::GenMeshFaceNormals (aiMesh* pMesh)
         return false;
     }
 
-    // allocate an array to hold the output normals
+    // allocate an array to hold the output normals and compute per-face
+    // normals but store them per-vertex.
     pMesh->mNormals = new aiVector3D[pMesh->mNumVertices];
-    const float qnan = get_qnan();
-
-    // iterate through all faces and compute per-face normals but store them per-vertex.
-    for( unsigned int a = 0; a < pMesh->mNumFaces; a++) {
-        const aiFace& face = pMesh->mFaces[a];
-        if (face.mNumIndices < 3)   {
-            // either a point or a line -> no well-defined normal vector
-            for (unsigned int i = 0;i < face.mNumIndices;++i) {
-                pMesh->mNormals[face.mIndices[i]] = aiVector3D(qnan);
-            }
-            continue;
-        }
-
-        const aiVector3D* pV1 = &pMesh->mVertices[face.mIndices[0]];
-        const aiVector3D* pV2 = &pMesh->mVertices[face.mIndices[1]];
-        const aiVector3D* pV3 = &pMesh->mVertices[face.mIndices[face.mNumIndices-1]];
-        const aiVector3D vNor = ((*pV2 - *pV1) ^ (*pV3 - *pV1)).Normalize();
-
-        for (unsigned int i = 0;i < face.mNumIndices;++i) {
-            pMesh->mNormals[face.mIndices[i]] = vNor;
-        }
-    }
+    ComputeFaceNormalsBatched(pMesh,pMesh->mNormals,true);
     return true;
 }
@@ -0,0 +1,338 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2017, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file GenMeshletsProcess.cpp
+ *  @brief Implementation of the GenMeshletsProcess post processing step
+ */
+
+#ifndef ASSIMP_BUILD_NO_GENMESHLETS_PROCESS
+
+#include "GenMeshletsProcess.h"
+#include "ProcessHelper.h"
+#include "VertexTriangleAdjacency.h"
+#include "StringUtils.h"
+#include <assimp/postprocess.h>
+#include <assimp/DefaultLogger.hpp>
+#include <assimp/scene.h>
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+using namespace Assimp;
+
+namespace {
+
+const unsigned int NotSet = 0xffffffff;
+
+// ------------------------------------------------------------------------------------------------
+// Compute the bounding sphere and the normal cone of a meshlet
+void ComputeMeshletBounds(const aiMesh* mesh, const unsigned int* verts, const unsigned char* tris,
+    aiMeshlet& m)
+{
+    // bounding sphere around the center of the bounding box
+    aiVector3D mi = mesh->mVertices[verts[0]], ma = mi;
+    for (unsigned int i = 1; i < m.mNumVertices; ++i) {
+        const aiVector3D& v = mesh->mVertices[verts[i]];
+        mi = std::min(mi,v); // per component, see ProcessHelper.h
+        ma = std::max(ma,v);
+    }
+    m.mCenter = (mi + ma) * ai_real(0.5);
+
+    ai_real radius = 0;
+    for (unsigned int i = 0; i < m.mNumVertices; ++i) {
+        radius = std::max(radius,(mesh->mVertices[verts[i]] - m.mCenter).SquareLength());
+    }
+    m.mRadius = sqrt(radius);
+
+    // the cone axis is the average of the unit face normals
+    aiVector3D axis;
+    for (unsigned int i = 0; i < m.mNumTriangles; ++i) {
+        const unsigned char* t = tris + i * 3;
+        const aiVector3D& p0 = mesh->mVertices[verts[t[0]]];
+        const aiVector3D n = (mesh->mVertices[verts[t[1]]] - p0) ^ (mesh->mVertices[verts[t[2]]] - p0);
+        const ai_real len = n.Length();
+        if (len > 0) {
+            axis += n / len;
+        }
+    }
+
+    m.mConeApex = m.mCenter;
+    m.mConeAxis = aiVector3D(0,0,1);
+    m.mConeCutoff = 1;
+
+    const ai_real len = axis.Length();
+    if (len <= 0) {
+        return;
+    }
+    axis /= len;
+    m.mConeAxis = axis;
+
+    // the cone must contain all face normals
+    ai_real minDot = 1;
+    for (unsigned int i = 0; i < m.mNumTriangles; ++i) {
+        const unsigned char* t = tris + i * 3;
+        const aiVector3D& p0 = mesh->mVertices[verts[t[0]]];
+        aiVector3D n = (mesh->mVertices[verts[t[1]]] - p0) ^ (mesh->mVertices[verts[t[2]]] - p0);
+        const ai_real nlen = n.Length();
+        if (nlen > 0) {
+            minDot = std::min(minDot,(n / nlen) * axis);
+        }
+    }
+
+    // The cone is too wide to be useful. The limit also keeps the
+    // apex computation below from dividing by tiny numbers.
+    if (minDot <= ai_real(0.1)) {
+        return;
+    }
+
+    // Move the apex back along the axis until it is behind all triangle planes,
+    // so the cone test holds for every point of the meshlet.
+    ai_real maxT = 0;
+    for (unsigned int i = 0; i < m.mNumTriangles; ++i) {
+        const unsigned char* t = tris + i * 3;
+        const aiVector3D& p0 = mesh->mVertices[verts[t[0]]];
+        aiVector3D n = (mesh->mVertices[verts[t[1]]] - p0) ^ (mesh->mVertices[verts[t[2]]] - p0);
+        const ai_real nlen = n.Length();
+        if (nlen > 0) {
+            n /= nlen;
+            maxT = std::max(maxT,((m.mCenter - p0) * n) / (axis * n));
+        }
+    }
+    m.mConeApex = m.mCenter - axis * maxT;
+    m.mConeCutoff = sqrt(1 - minDot * minDot);
+}
+
+} // ! anon namespace
+
+// ------------------------------------------------------------------------------------------------
+// Constructor to be privately used by Importer
+GenMeshletsProcess::GenMeshletsProcess()
+: mMaxVertices(AI_GM_DEFAULT_MAX_VERTICES)
+, mMaxTriangles(AI_GM_DEFAULT_MAX_TRIANGLES)
+{
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+// Destructor, private as well
+GenMeshletsProcess::~GenMeshletsProcess()
+{
+    // nothing to do here
+}
+
+// ------------------------------------------------------------------------------------------------
+// Returns whether the processing step is present in the given flag field.
+bool GenMeshletsProcess::IsActive( unsigned int pFlags) const
+{
+    return (pFlags & aiProcess_GenerateMeshlets) != 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Setup configuration properties for the step
+void GenMeshletsProcess::SetupProperties(const Importer* pImp)
+{
+    // local indices are 8 bit, so there may be no more than 256 vertices
+    mMaxVertices = std::min(256,std::max(3,pImp->GetPropertyInteger(AI_CONFIG_PP_GM_MAX_VERTICES,AI_GM_DEFAULT_MAX_VERTICES)));
+    mMaxTriangles = std::max(1,pImp->GetPropertyInteger(AI_CONFIG_PP_GM_MAX_TRIANGLES,AI_GM_DEFAULT_MAX_TRIANGLES));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on the given imported data.
+void GenMeshletsProcess::Execute( aiScene* pScene)
+{
+    DefaultLogger::get()->debug("GenMeshletsProcess begin");
+
+    unsigned int numMeshlets = 0, numSkipped = 0;
+    for( unsigned int a = 0; a < pScene->mNumMeshes; a++) {
+        if (IsMeshDirty(a)) {
+            const unsigned int n = ProcessMesh( pScene->mMeshes[a]);
+            numMeshlets += n;
+            numSkipped += n ? 0 : 1;
+        }
+    }
+
+    if (!DefaultLogger::isNullLogger()) {
+        char buffer[1024];
+        ai_snprintf(buffer,1024,"GenMeshletsProcess finished. Generated %u meshlets, skipped %u meshes "
+            "which are not made of triangles",numMeshlets,numSkipped);
+        DefaultLogger::get()->info(buffer);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Generates the meshlets of a single mesh
+unsigned int GenMeshletsProcess::ProcessMesh( aiMesh* pMesh) const
+{
+    // drop meshlets of a previous run, they might be out of date
+    delete[] pMesh->mMeshlets;
+    delete[] pMesh->mMeshletVertices;
+    delete[] pMesh->mMeshletTriangles;
+    pMesh->mMeshlets = NULL;
+    pMesh->mMeshletVertices = NULL;
+    pMesh->mMeshletTriangles = NULL;
+    pMesh->mNumMeshlets = pMesh->mNumMeshletVertices = pMesh->mNumMeshletTriangles = 0;
+
+    if (!pMesh->mNumFaces || !pMesh->HasPositions() || pMesh->mPrimitiveTypes != aiPrimitiveType_TRIANGLE) {
+        return 0;
+    }
+    for (unsigned int i = 0; i < pMesh->mNumFaces; ++i) {
+        if (pMesh->mFaces[i].mNumIndices != 3) {
+            return 0;
+        }
+    }
+
+    const unsigned int numFaces = pMesh->mNumFaces;
+    VertexTriangleAdjacency adj(pMesh->mFaces,numFaces,pMesh->mNumVertices,false);
+
+    std::vector<aiMeshlet> meshlets;
+    std::vector<unsigned int> verts;
+    std::vector<unsigned char> tris;
+    verts.reserve(numFaces);
+    tris.reserve(numFaces * 3);
+
+    std::vector<bool> emitted(numFaces,false);
+    std::vector<unsigned int> localIndex(pMesh->mNumVertices,NotSet);
+    std::vector<unsigned int> candidates;
+
+    for (unsigned int cursor = 0;;) {
+
+        // start a new meshlet with the first triangle which isn't part of a meshlet yet
+        while (cursor < numFaces && emitted[cursor]) {
+            ++cursor;
+        }
+        if (cursor == numFaces) {
+            break;
+        }
+
+        aiMeshlet m;
+        m.mVertexOffset = static_cast<unsigned int>(verts.size());
+        m.mTriangleOffset = static_cast<unsigned int>(tris.size() / 3);
+        candidates.clear();
+
+        for (unsigned int next = cursor;;) {
+
+            // add the triangle to the meshlet, triangles adjacent to its new vertices become candidates
+            const aiFace& face = pMesh->mFaces[next];
+            emitted[next] = true;
+            for (unsigned int k = 0; k < 3; ++k) {
+                const unsigned int v = face.mIndices[k];
+                if (localIndex[v] == NotSet) {
+                    localIndex[v] = m.mNumVertices++;
+                    verts.push_back(v);
+
+                    const unsigned int* it = adj.mAdjacencyTable + adj.mOffsetTable[v];
+                    for (const unsigned int* end = adj.mAdjacencyTable + adj.mOffsetTable[v+1]; it != end; ++it) {
+                        if (!emitted[*it]) {
+                            candidates.push_back(*it);
+                        }
+                    }
+                }
+                tris.push_back(static_cast<unsigned char>(localIndex[v]));
+            }
+            if (++m.mNumTriangles == mMaxTriangles) {
+                break;
+            }
+
+            // pick the candidate which adds the fewest new vertices, the lowest
+            // face index on ties to stay close to the original face order
+            unsigned int best = NotSet, bestNew = 4;
+            for (size_t c = 0; c < candidates.size();) {
+                const unsigned int t = candidates[c];
+                if (emitted[t]) {
+                    candidates[c] = candidates.back();
+                    candidates.pop_back();
+                    continue;
+                }
+                const unsigned int* idx = pMesh->mFaces[t].mIndices;
+                const unsigned int n = (localIndex[idx[0]] == NotSet) + (localIndex[idx[1]] == NotSet) +
+                    (localIndex[idx[2]] == NotSet);
+                if (n < bestNew || (n == bestNew && t < best)) {
+                    best = t;
+                    bestNew = n;
+                }
+                ++c;
+            }
+
+            // Nothing connected left: continue with the next triangle in face order to
+            // avoid lots of tiny meshlets for meshes made of many small pieces.
+            if (best == NotSet) {
+                while (cursor < numFaces && emitted[cursor]) {
+                    ++cursor;
+                }
+                if (cursor == numFaces) {
+                    break;
+                }
+                const unsigned int* idx = pMesh->mFaces[cursor].mIndices;
+                best = cursor;
+                bestNew = (localIndex[idx[0]] == NotSet) + (localIndex[idx[1]] == NotSet) +
+                    (localIndex[idx[2]] == NotSet);
+            }
+            if (m.mNumVertices + bestNew > mMaxVertices) {
+                break;
+            }
+            next = best;
+        }
+
+        for (unsigned int i = 0; i < m.mNumVertices; ++i) {
+            localIndex[verts[m.mVertexOffset + i]] = NotSet;
+        }
+        ComputeMeshletBounds(pMesh,&verts[m.mVertexOffset],&tris[m.mTriangleOffset * 3],m);
+        meshlets.push_back(m);
+    }
+
+    pMesh->mNumMeshlets = static_cast<unsigned int>(meshlets.size());
+    pMesh->mMeshlets = new aiMeshlet[pMesh->mNumMeshlets];
+    std::copy(meshlets.begin(),meshlets.end(),pMesh->mMeshlets);
+
+    pMesh->mNumMeshletVertices = static_cast<unsigned int>(verts.size());
+    pMesh->mMeshletVertices = new unsigned int[pMesh->mNumMeshletVertices];
+    std::copy(verts.begin(),verts.end(),pMesh->mMeshletVertices);
+
+    pMesh->mNumMeshletTriangles = static_cast<unsigned int>(tris.size() / 3);
+    pMesh->mMeshletTriangles = new unsigned char[tris.size()];
+    std::copy(tris.begin(),tris.end(),pMesh->mMeshletTriangles);
+
+    return pMesh->mNumMeshlets;
+}
+
+#endif // !! ASSIMP_BUILD_NO_GENMESHLETS_PROCESS
@@ -50,6 +50,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "GenVertexNormalsProcess.h"
 #include "ProcessHelper.h"
 #include "Exceptional.h"
+#include "VectorKernels.h"
 #include "qnan.h"
 
 using namespace Assimp;
@@ -95,7 +96,7 @@ void GenVertexNormalsProcess::Execute( aiScene* pScene)
     bool bHas = false;
     for( unsigned int a = 0; a < pScene->mNumMeshes; a++)
     {
-        if(GenMeshVertexNormals( pScene->mMeshes[a],a))
+        if(IsMeshDirty(a) && GenMeshVertexNormals( pScene->mMeshes[a],a))
             bHas = true;
     }
 
@@ -123,33 +124,11 @@ bool GenVertexNormalsProcess::GenMeshVertexNormals (aiMesh* pMesh, unsigned int
         return false;
     }
 
-    // Allocate the array to hold the output normals
-    const float qnan = std::numeric_limits<ai_real>::quiet_NaN();
+    // Allocate the array to hold the output normals and compute per-face
+    // normals but store them per-vertex. They are not normalized, so larger
+    // faces get a larger weight when the normals are smoothed.
     pMesh->mNormals = new aiVector3D[pMesh->mNumVertices];
-
-    // Compute per-face normals but store them per-vertex
-    for( unsigned int a = 0; a < pMesh->mNumFaces; a++)
-    {
-        const aiFace& face = pMesh->mFaces[a];
-        if (face.mNumIndices < 3)
-        {
-            // either a point or a line -> no normal vector
-            for (unsigned int i = 0;i < face.mNumIndices;++i) {
-                pMesh->mNormals[face.mIndices[i]] = aiVector3D(qnan);
-            }
-
-            continue;
-        }
-
-        const aiVector3D* pV1 = &pMesh->mVertices[face.mIndices[0]];
-        const aiVector3D* pV2 = &pMesh->mVertices[face.mIndices[1]];
-        const aiVector3D* pV3 = &pMesh->mVertices[face.mIndices[face.mNumIndices-1]];
-        const aiVector3D vNor = ((*pV2 - *pV1) ^ (*pV3 - *pV1));
-
-        for (unsigned int i = 0;i < face.mNumIndices;++i) {
-            pMesh->mNormals[face.mIndices[i]] = vNor;
-        }
-    }
+    ComputeFaceNormalsBatched(pMesh,pMesh->mNormals,false);
 
     // Set up a SpatialSort to quickly find all vertices close to a given position
     // check whether we can reuse the SpatialSort of a previous step.
@@ -171,6 +150,10 @@ bool GenVertexNormalsProcess::GenMeshVertexNormals (aiMesh* pMesh, unsigned int
         vertexFinder = &_vertexFinder;
         posEpsilon = ComputePositionEpsilon(pMesh);
     }
+
+    // Look up the neighbours of all vertices in the order of the SpatialSort,
+    // once for each distinct position.
+    const PositionNeighbours neighbours(*vertexFinder, pMesh->mVertices, pMesh->mNumVertices, posEpsilon);
     std::vector<unsigned int> verticesFound;
     aiVector3D* pcNew = new aiVector3D[pMesh->mNumVertices];
 
@@ -185,7 +168,7 @@ bool GenVertexNormalsProcess::GenMeshVertexNormals (aiMesh* pMesh, unsigned int
             }
 
             // Get all vertices that share this one ...
-            vertexFinder->FindPositions( pMesh->mVertices[i], posEpsilon, verticesFound);
+            neighbours.FindPositions(i, verticesFound);
 
             aiVector3D pcNor;
             for (unsigned int a = 0; a < verticesFound.size(); ++a) {
@@ -207,25 +190,44 @@ bool GenVertexNormalsProcess::GenMeshVertexNormals (aiMesh* pMesh, unsigned int
     // the effect, this one is the most straightforward one.
     else    {
         const ai_real fLimit = std::cos(configMaxAngle);
-        for (unsigned int i = 0; i < pMesh->mNumVertices;++i)   {
-            // Get all vertices that share this one ...
-            vertexFinder->FindPositions( pMesh->mVertices[i] , posEpsilon, verticesFound);
+        const unsigned int numVertices = pMesh->mNumVertices;
+
+        // Precompute the lengths of all face normals in one batch
+        std::vector<ai_real> soa(numVertices * 4);
+        ai_real* const nx = &soa[0], *const ny = nx + numVertices, *const nz = ny + numVertices;
+        ai_real* const nlen = nz + numVertices;
+        for (unsigned int i = 0; i < numVertices; ++i) {
+            const aiVector3D& v = pMesh->mNormals[i];
+            nx[i] = v.x; ny[i] = v.y; nz[i] = v.z;
+        }
+        LengthBatch(nx, ny, nz, nlen, numVertices);
 
-            aiVector3D vr = pMesh->mNormals[i];
-            ai_real vrlen = vr.Length();
+        // Accumulate the smoothed normals of each vertex into a SoA buffer
+        std::vector<ai_real> sums(numVertices * 3);
+        ai_real* const sx = &sums[0], *const sy = sx + numVertices, *const sz = sy + numVertices;
+        for (unsigned int i = 0; i < numVertices;++i)   {
+            // Get all vertices that share this one ...
+            neighbours.FindPositions(i, verticesFound);
+            const ai_real vrlen = nlen[i];
 
-            aiVector3D pcNor;
+            ai_real ax = 0, ay = 0, az = 0;
             for (unsigned int a = 0; a < verticesFound.size(); ++a) {
-                aiVector3D v = pMesh->mNormals[verticesFound[a]];
+                const unsigned int j = verticesFound[a];
 
                 // check whether the angle between the two normals is not too large
                 // HACK: if v.x is qnan the dot product will become qnan, too
                 //   therefore the comparison against fLimit should be false
                 //   in every case.
-                if (v * vr >= fLimit * vrlen * v.Length())
-                    pcNor += v;
+                if (nx[j]*nx[i] + ny[j]*ny[i] + nz[j]*nz[i] >= fLimit * vrlen * nlen[j]) {
+                    ax += nx[j]; ay += ny[j]; az += nz[j];
+                }
             }
-            pcNew[i] = pcNor.NormalizeSafe();
+            sx[i] = ax; sy[i] = ay; sz[i] = az;
+        }
+        NormalizeBatch(sx, sy, sz, numVertices, true);
+
+        for (unsigned int i = 0; i < numVertices;++i)   {
+            pcNew[i] = aiVector3D(sx[i],sy[i],sz[i]);
         }
     }
 
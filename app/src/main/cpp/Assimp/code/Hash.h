@@ -44,6 +44,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <stdint.h>
 #include <string.h>
+#include <stddef.h>
 
 // ------------------------------------------------------------------------------------------------
 // Hashing function taken from
@@ -114,4 +115,104 @@ int rem;
     return hash;
 }
 
+// ------------------------------------------------------------------------------------------------
+// 64 bit hash for larger binary blobs such as vertex or index buffers.
+// This is a plain implementation of Yann Collet's xxHash64 (BSD 2-clause license),
+// it yields the same values as the reference implementation on little-endian machines.
+// ------------------------------------------------------------------------------------------------
+namespace xxhash_detail {
+
+static const uint64_t PRIME64_1 = 11400714785074694791ULL;
+static const uint64_t PRIME64_2 = 14029467366897019727ULL;
+static const uint64_t PRIME64_3 =  1609587929392839161ULL;
+static const uint64_t PRIME64_4 =  9650029242287828579ULL;
+static const uint64_t PRIME64_5 =  2870177450012600261ULL;
+
+inline uint64_t RotL(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t Read64(const uint8_t* p) {
+    uint64_t v;
+    ::memcpy(&v,p,sizeof v);
+    return v;
+}
+
+inline uint32_t Read32(const uint8_t* p) {
+    uint32_t v;
+    ::memcpy(&v,p,sizeof v);
+    return v;
+}
+
+inline uint64_t Round(uint64_t acc, uint64_t input) {
+    acc += input * PRIME64_2;
+    acc  = RotL(acc,31);
+    return acc * PRIME64_1;
+}
+
+inline uint64_t MergeRound(uint64_t acc, uint64_t val) {
+    acc ^= Round(0,val);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+} // ! xxhash_detail
+
+// ------------------------------------------------------------------------------------------------
+inline uint64_t XXHash64 (const void* input, size_t len, uint64_t seed = 0) {
+    using namespace xxhash_detail;
+
+    const uint8_t* p = static_cast<const uint8_t*>(input);
+    const uint8_t* const end = p + len;
+    uint64_t hash;
+
+    if (len >= 32) {
+        const uint8_t* const limit = end - 32;
+        uint64_t v1 = seed + PRIME64_1 + PRIME64_2;
+        uint64_t v2 = seed + PRIME64_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME64_1;
+
+        do {
+            v1 = Round(v1,Read64(p));    p += 8;
+            v2 = Round(v2,Read64(p));    p += 8;
+            v3 = Round(v3,Read64(p));    p += 8;
+            v4 = Round(v4,Read64(p));    p += 8;
+        }
+        while (p <= limit);
+
+        hash = RotL(v1,1) + RotL(v2,7) + RotL(v3,12) + RotL(v4,18);
+        hash = MergeRound(hash,v1);
+        hash = MergeRound(hash,v2);
+        hash = MergeRound(hash,v3);
+        hash = MergeRound(hash,v4);
+    }
+    else hash = seed + PRIME64_5;
+
+    hash += static_cast<uint64_t>(len);
+
+    /* Handle the remaining 0..31 bytes */
+    for (; p + 8 <= end; p += 8) {
+        hash ^= Round(0,Read64(p));
+        hash  = RotL(hash,27) * PRIME64_1 + PRIME64_4;
+    }
+    if (p + 4 <= end) {
+        hash ^= static_cast<uint64_t>(Read32(p)) * PRIME64_1;
+        hash  = RotL(hash,23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        hash ^= (*p) * PRIME64_5;
+        hash  = RotL(hash,11) * PRIME64_1;
+    }
+
+    /* Final avalanche */
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
 #endif // !! AI_HASH_H_INCLUDED
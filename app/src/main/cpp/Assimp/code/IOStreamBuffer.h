@@ -44,19 +44,49 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/types.h>
 #include <assimp/IOStream.hpp>
 #include "ParsingUtils.h"
+#include "TextCursor.h"
 
 #include <vector>
+#include <algorithm>
+#include <cstring>
 
 namespace Assimp {
 
 // ---------------------------------------------------------------------------
 /**
  *  Implementation of a cached stream buffer.
+ *
+ *  The cache is a sliding window over the stream. Besides the copying line
+ *  accessors it offers line views, which point directly into the window. If
+ *  the window is larger than the file, the whole file is read at once.
  */
 template<class T>
 class IOStreamBuffer {
 public:
+    /// @brief  A view of a line in the window of the stream buffer.
+    ///
+    /// The view includes the line end, which is normalized to '\n'. At
+    /// least one more element behind the view can be read, so parsers with
+    /// a look-ahead stay in bounds. The view is only valid until the next
+    /// call to the stream buffer.
+    struct LineView {
+        const T *begin;
+        const T *end;
+
+        LineView()
+        : begin( nullptr )
+        , end( nullptr ) {
+            // empty
+        }
+
+        size_t size() const {
+            return static_cast<size_t>( end - begin );
+        }
+    };
+
     /// @brief  The class constructor.
+    /// @param  cache       The window size in elements, the window grows if a
+    ///                     single line does not fit into it.
     IOStreamBuffer( size_t cache = 4096 * 4096 );
 
     /// @brief  The class destructor.
@@ -95,13 +125,13 @@ public:
     /// @return The current file pos.
     size_t getFilePos() const;
 
-    /// @brief  Will read the next line.
-    /// @param  buffer      The buffer for the next line.
+    /// @brief  Will read the next line, lines which end with the continuation token are joined.
+    /// @param  buffer      The buffer for the next line, the line end is followed by a zero.
     /// @return true if successful.
     bool getNextDataLine( std::vector<T> &buffer, T continuationToken );
 
     /// @brief  Will read the next line ascii or binary end line char.
-    /// @param  buffer      The buffer for the next line.
+    /// @param  buffer      The buffer for the next line, the line end is followed by a zero.
     /// @return true if successful.
     bool getNextLine(std::vector<T> &buffer);
 
@@ -110,7 +140,33 @@ public:
     /// @return true if successful.
     bool getNextBlock( std::vector<T> &buffer );
 
+    /// @brief  Will return the next line without copying it.
+    ///         Works like getNextLine(), but the line stays in the window.
+    /// @param  line        The view of the next line.
+    /// @return true if successful.
+    bool getNextLineView( LineView &line );
+
+    /// @brief  Will return the next data line without copying it.
+    ///         Works like getNextDataLine(), only lines which contain the
+    ///         continuation token are joined in a separate buffer.
+    /// @param  line        The view of the next data line.
+    /// @return true if successful.
+    bool getNextDataLineView( LineView &line, T continuationToken );
+
 private:
+    /// @brief  Moves the unread data to the front of the window and reads
+    ///         the stream behind it. The window grows if it is full.
+    /// @return The number of elements read.
+    size_t refillWindow();
+
+    /// @brief  Searches the end of the line at the current position, the
+    ///         window is refilled if needed.
+    /// @return The index of the line end, m_cacheSize at the end of the stream.
+    size_t findLineEnd();
+
+    /// @brief  Makes the view for the line up to the given line end.
+    void setLineView( size_t lineEnd, LineView &line );
+
     IOStream *m_stream;
     size_t m_filesize;
     size_t m_cacheSize;
@@ -119,8 +175,12 @@ private:
     std::vector<T> m_cache;
     size_t m_cachePos;
     size_t m_filePos;
+    std::vector<T> m_line;
 };
 
+/// Number of elements behind the window, which keep the look-ahead of the line views in bounds.
+static const size_t StreamBufferPadding = 2;
+
 template<class T>
 inline
 IOStreamBuffer<T>::IOStreamBuffer( size_t cache )
@@ -130,9 +190,9 @@ IOStreamBuffer<T>::IOStreamBuffer( size_t cache )
 , m_numBlocks( 0 )
 , m_blockIdx( 0 )
 , m_cachePos( 0 )
-, m_filePos( 0 ) {
-    m_cache.resize( cache );
-    std::fill( m_cache.begin(), m_cache.end(), '\n' );
+, m_filePos( 0 )
+, m_line() {
+    // the window is allocated in open(), once the file size is known
 }
 
 template<class T>
@@ -162,6 +222,7 @@ bool IOStreamBuffer<T>::open( IOStream *stream ) {
     if ( m_filesize < m_cacheSize ) {
         m_cacheSize = m_filesize;
     }
+    m_cache.assign( m_cacheSize + StreamBufferPadding, '\n' );
 
     m_numBlocks = m_filesize / m_cacheSize;
     if ( ( m_filesize % m_cacheSize ) > 0 ) {
@@ -205,13 +266,11 @@ template<class T>
 inline
 bool IOStreamBuffer<T>::readNextBlock() {
     m_stream->Seek( m_filePos, aiOrigin_SET );
-    size_t readLen = m_stream->Read( &m_cache[ 0 ], sizeof( T ), m_cacheSize );
+    size_t readLen = m_stream->Read( &m_cache[ 0 ], sizeof( T ), m_cache.size() - StreamBufferPadding );
     if ( readLen == 0 ) {
         return false;
     }
-    if ( readLen < m_cacheSize ) {
-        m_cacheSize = readLen;
-    }
+    m_cacheSize = readLen;
     m_filePos += m_cacheSize;
     m_cachePos = 0;
     m_blockIdx++;
@@ -240,111 +299,185 @@ size_t IOStreamBuffer<T>::getFilePos() const {
 template<class T>
 inline
 bool IOStreamBuffer<T>::getNextDataLine( std::vector<T> &buffer, T continuationToken ) {
-    buffer.resize( m_cacheSize );
-    if ( m_cachePos == m_cacheSize || 0 == m_filePos ) {
-        if ( !readNextBlock() ) {
-            return false;
-        }
+    LineView line;
+    if ( !getNextDataLineView( line, continuationToken ) ) {
+        return false;
     }
 
-    bool continuationFound( false ), endOfDataLine( false );
-    size_t i = 0;
-    while ( !endOfDataLine ) {
-        if ( continuationToken == m_cache[ m_cachePos ] ) {
-            continuationFound = true;
-            ++m_cachePos;
-        }
-        if ( IsLineEnd( m_cache[ m_cachePos ] ) ) {
-            if ( !continuationFound ) {
-                // the end of the data line
-                break;
-            } else {
-                // skip line end
-                while ( m_cache[m_cachePos] != '\n') {
-                    ++m_cachePos;
-                }
-                ++m_cachePos;
-                continuationFound = false;
-            }
-        }
+    // the copy ends with the line end and a zero terminator
+    buffer.assign( line.begin, line.end );
+    buffer.push_back( '\0' );
 
-        buffer[ i ] = m_cache[ m_cachePos ];
-        m_cachePos++;
-        i++;
-        if ( m_cachePos >= m_cacheSize ) {
-            if ( !readNextBlock() ) {
-                return false;
-            }
-        }
+    return true;
+}
+
+template<class T>
+inline
+bool IOStreamBuffer<T>::getNextLine(std::vector<T> &buffer) {
+    LineView line;
+    if ( !getNextLineView( line ) ) {
+        return false;
     }
-    
-    buffer[ i ] = '\n';
-    m_cachePos++;
+
+    // the copy ends with the line end and a zero terminator
+    buffer.assign( line.begin, line.end );
+    buffer.push_back( '\0' );
 
     return true;
 }
 
-static 
+template<class T>
 inline
-bool isEndOfCache( size_t pos, size_t cacheSize ) {
-    return ( pos == cacheSize );
+bool IOStreamBuffer<T>::getNextBlock( std::vector<T> &buffer) {
+  //just return the last blockvalue if getNextLine was used before
+  if ( m_cachePos !=  0) {      
+      buffer = std::vector<T>(m_cache.begin() + m_cachePos, m_cache.begin() + m_cacheSize);
+      m_cachePos = 0;
+  }
+  else {
+      if ( !readNextBlock() )
+          return false;
+
+      buffer = std::vector<T>(m_cache.begin(), m_cache.begin() + m_cacheSize);
+  }
+  return true;
 }
 
 template<class T>
 inline
-bool IOStreamBuffer<T>::getNextLine(std::vector<T> &buffer) {
-    buffer.resize(m_cacheSize);
-    if ( isEndOfCache( m_cachePos, m_cacheSize ) || 0 == m_filePos) {
-       if (!readNextBlock()) {
-          return false;
-       }
-      }
+size_t IOStreamBuffer<T>::refillWindow() {
+    if ( 0 == m_filePos ) {
+        // nothing was read so far
+        m_cacheSize = 0;
+        m_cachePos = 0;
+    }
+    const size_t remaining = m_cacheSize - m_cachePos;
+    if ( remaining > 0 && m_cachePos > 0 ) {
+        ::memmove( &m_cache[ 0 ], &m_cache[ m_cachePos ], remaining * sizeof( T ) );
+    }
+    size_t windowSize = m_cache.size() - StreamBufferPadding;
+    if ( remaining == windowSize ) {
+        // a single line fills the whole window
+        windowSize *= 2;
+        m_cache.resize( windowSize + StreamBufferPadding, '\n' );
+    }
+    m_cachePos = 0;
+    m_cacheSize = remaining;
 
-    if (IsLineEnd(m_cache[m_cachePos])) {
-        // skip line end
-        while (m_cache[m_cachePos] != '\n') {
-            ++m_cachePos;
+    if ( m_filePos >= m_filesize ) {
+        return 0;
+    }
+    m_stream->Seek( m_filePos, aiOrigin_SET );
+    const size_t readLen = m_stream->Read( &m_cache[ remaining ], sizeof( T ), windowSize - remaining );
+    if ( readLen > 0 ) {
+        m_cacheSize += readLen;
+        m_filePos += readLen;
+        m_blockIdx++;
+    }
+
+    return readLen;
+}
+
+template<class T>
+inline
+size_t IOStreamBuffer<T>::findLineEnd() {
+    size_t searched = 0;
+    for ( ;; ) {
+        const T *begin = &m_cache[ 0 ] + m_cachePos;
+        const T *it = FindLineEnd( begin + searched, &m_cache[ 0 ] + m_cacheSize );
+        if ( it != &m_cache[ 0 ] + m_cacheSize ) {
+            return static_cast<size_t>( it - &m_cache[ 0 ] );
         }
-        ++m_cachePos;
-        if ( isEndOfCache( m_cachePos, m_cacheSize ) ) {
-            if ( !readNextBlock() ) {
-                return false;
-            }
+        searched = m_cacheSize - m_cachePos;
+        if ( 0 == refillWindow() ) {
+            return m_cacheSize;
+        }
+    }
+}
+
+template<class T>
+inline
+void IOStreamBuffer<T>::setLineView( size_t lineEnd, LineView &line ) {
+    // a missing line end at the end of the stream is added behind the data
+    m_cache[ lineEnd ] = '\n';
+    line.begin = &m_cache[ 0 ] + m_cachePos;
+    line.end = &m_cache[ 0 ] + lineEnd + 1;
+    m_cachePos = std::min( lineEnd + 1, m_cacheSize );
+}
+
+template<class T>
+inline
+bool IOStreamBuffer<T>::getNextLineView( LineView &line ) {
+    if ( m_cachePos == m_cacheSize || 0 == m_filePos ) {
+        if ( 0 == refillWindow() ) {
+            return false;
         }
     }
 
-    size_t i = 0;
-    while (!IsLineEnd(m_cache[ m_cachePos ])) {
-        buffer[i] = m_cache[ m_cachePos ];
-        m_cachePos++;
-        i++;
-        if (m_cachePos >= m_cacheSize) {
-            if (!readNextBlock()) {
+    if ( IsLineEnd( m_cache[ m_cachePos ] ) ) {
+        // skip line end
+        while ( m_cache[ m_cachePos ] != '\n' ) {
+            if ( ++m_cachePos == m_cacheSize && 0 == refillWindow() ) {
                 return false;
             }
         }
+        if ( ++m_cachePos == m_cacheSize && 0 == refillWindow() ) {
+            return false;
+        }
     }
-    buffer[i] = '\n';
-    m_cachePos++;
+
+    setLineView( findLineEnd(), line );
 
     return true;
 }
 
 template<class T>
 inline
-bool IOStreamBuffer<T>::getNextBlock( std::vector<T> &buffer) {
-  //just return the last blockvalue if getNextLine was used before
-  if ( m_cachePos !=  0) {      
-      buffer = std::vector<T>(m_cache.begin() + m_cachePos, m_cache.end());
-      m_cachePos = 0;
-  }
-  else {
-      if ( !readNextBlock() )
-          return false;
+bool IOStreamBuffer<T>::getNextDataLineView( LineView &line, T continuationToken ) {
+    if ( m_cachePos == m_cacheSize || 0 == m_filePos ) {
+        if ( 0 == refillWindow() ) {
+            return false;
+        }
+    }
 
-      buffer = std::vector<T>(m_cache.begin(), m_cache.end());
-  }
-  return true;
+    const size_t lineEnd = findLineEnd();
+    if ( std::find( m_cache.begin() + m_cachePos, m_cache.begin() + lineEnd, continuationToken ) == m_cache.begin() + lineEnd ) {
+        setLineView( lineEnd, line );
+        return true;
+    }
+
+    // join the continued lines, line ends after the token are skipped
+    m_line.clear();
+    bool continuationFound = false;
+    while ( m_cachePos < m_cacheSize || 0 != refillWindow() ) {
+        if ( continuationToken == m_cache[ m_cachePos ] ) {
+            continuationFound = true;
+            if ( ++m_cachePos == m_cacheSize && 0 == refillWindow() ) {
+                break;
+            }
+        }
+        if ( IsLineEnd( m_cache[ m_cachePos ] ) ) {
+            if ( !continuationFound ) {
+                ++m_cachePos;
+                break;
+            }
+            while ( ( m_cachePos < m_cacheSize || 0 != refillWindow() ) && m_cache[ m_cachePos ] != '\n' ) {
+                ++m_cachePos;
+            }
+            m_cachePos = std::min( m_cachePos + 1, m_cacheSize );
+            continuationFound = false;
+            continue;
+        }
+        m_line.push_back( m_cache[ m_cachePos ] );
+        ++m_cachePos;
+    }
+
+    m_line.push_back( '\n' );
+    m_line.push_back( '\0' );
+    line.begin = &m_line[ 0 ];
+    line.end = &m_line[ 0 ] + m_line.size() - 1;
+
+    return true;
 }
 
 } // !ns Assimp
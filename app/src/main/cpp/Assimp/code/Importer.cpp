@@ -80,6 +80,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <set>
 #include <memory>
 #include <cctype>
+#include <algorithm>
 
 #include <assimp/DefaultIOStream.h>
 #include <assimp/DefaultIOSystem.h>
@@ -87,6 +88,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef ASSIMP_BUILD_NO_VALIDATEDS_PROCESS
 #   include "ValidateDataStructure.h"
 #endif
+#ifndef ASSIMP_BUILD_NO_FINDDEGENERATES_PROCESS
+#   include "FindDegenerates.h"
+#endif
 
 using namespace Assimp::Profiling;
 using namespace Assimp::Formatter;
@@ -152,6 +156,8 @@ Importer::Importer()
 
     pimpl->mScene = NULL;
     pimpl->mErrorString = "";
+    pimpl->mIncrementalImporter = NULL;
+    pimpl->mIncrementalFlags = 0;
 
     // Allocate a default IO handler
     pimpl->mIOHandler = new DefaultIOSystem;
@@ -273,6 +279,9 @@ aiReturn Importer::UnregisterLoader(BaseImporter* pImp)
         pimpl->mImporter.end(),pImp);
 
     if (it != pimpl->mImporter.end())   {
+        if (pImp == pimpl->mIncrementalImporter) {
+            pimpl->mIncrementalImporter = NULL;
+        }
         pimpl->mImporter.erase(it);
         DefaultLogger::get()->info("Unregistering custom importer: ");
         return AI_SUCCESS;
@@ -596,6 +605,10 @@ const aiScene* Importer::ReadFile( const char* _pFile, unsigned int pFlags)
     try
 #endif // ! ASSIMP_CATCH_GLOBAL_EXCEPTIONS
     {
+        // an unfinished incremental import ends here, the importer
+        // drops its state when it reads the file
+        pimpl->mIncrementalImporter = NULL;
+
         // Check whether this Importer instance has already loaded
         // a scene. In this case we need to delete the old one
         if (pimpl->mScene)  {
@@ -740,6 +753,147 @@ const aiScene* Importer::ReadFile( const char* _pFile, unsigned int pFlags)
 }
 
 
+// ------------------------------------------------------------------------------------------------
+// Starts an incremental import
+bool Importer::BeginIncremental( const char* pHint, unsigned int pFlags)
+{
+    ASSIMP_BEGIN_EXCEPTION_REGION();
+    if (!pHint || !*pHint || strlen(pHint) > MaxLenHint ) {
+        pimpl->mErrorString = "Invalid parameters passed to BeginIncremental()";
+        return false;
+    }
+    pimpl->mIncrementalImporter = NULL;
+    pimpl->mErrorString = "";
+
+    // Check whether this Importer instance has already loaded
+    // a scene. In this case we need to delete the old one
+    if (pimpl->mScene)  {
+        DefaultLogger::get()->debug("(Deleting previous scene)");
+        FreeScene();
+    }
+
+    // the loader is picked by the extension, there is no data to look at yet
+    static const size_t BufferSize(Importer::MaxLenHint + 28);
+    char fbuff[ BufferSize ];
+    ai_snprintf(fbuff, BufferSize, "%s.%s",AI_MEMORYIO_MAGIC_FILENAME,pHint);
+
+    WriteLogOpening(fbuff);
+
+    BaseImporter* imp = NULL;
+    for( unsigned int a = 0; a < pimpl->mImporter.size(); a++)  {
+        if( pimpl->mImporter[a]->CanRead( fbuff, NULL, false)) {
+            imp = pimpl->mImporter[a];
+            break;
+        }
+    }
+    if( !imp)   {
+        pimpl->mErrorString = "No suitable reader found for the file format of file \"" + std::string(fbuff) + "\".";
+        DefaultLogger::get()->error(pimpl->mErrorString);
+        return false;
+    }
+
+    if (!imp->BeginIncremental(this)) {
+        pimpl->mErrorString = imp->GetErrorText();
+        return false;
+    }
+    pimpl->mIncrementalImporter = imp;
+    pimpl->mIncrementalFlags = pFlags;
+    ASSIMP_END_EXCEPTION_REGION(bool);
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Passes the next piece of the file to the running incremental import
+bool Importer::Feed( const void* pBuffer, size_t pLength)
+{
+    ASSIMP_BEGIN_EXCEPTION_REGION();
+    if (!pimpl->mIncrementalImporter) {
+        pimpl->mErrorString = "Feed() was called without a running incremental import";
+        return false;
+    }
+    if (!pLength) {
+        return true;
+    }
+    if (!pBuffer) {
+        pimpl->mErrorString = "Invalid parameters passed to Feed()";
+        return false;
+    }
+
+    if (!pimpl->mIncrementalImporter->FeedIncremental(pBuffer, pLength)) {
+        pimpl->mErrorString = pimpl->mIncrementalImporter->GetErrorText();
+        pimpl->mIncrementalImporter = NULL;
+        return false;
+    }
+    ASSIMP_END_EXCEPTION_REGION(bool);
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Finishes the running incremental import
+const aiScene* Importer::FinishIncremental()
+{
+    ASSIMP_BEGIN_EXCEPTION_REGION();
+    BaseImporter* imp = pimpl->mIncrementalImporter;
+    if (!imp) {
+        pimpl->mErrorString = "FinishIncremental() was called without a running incremental import";
+        return NULL;
+    }
+    pimpl->mIncrementalImporter = NULL;
+
+#ifdef ASSIMP_CATCH_GLOBAL_EXCEPTIONS
+    try
+#endif // ! ASSIMP_CATCH_GLOBAL_EXCEPTIONS
+    {
+        std::unique_ptr<Profiler> profiler(GetPropertyInteger(AI_CONFIG_GLOB_MEASURE_TIME,0)?new Profiler():NULL);
+        if (profiler) {
+            profiler->BeginRegion("finish");
+        }
+
+        pimpl->mScene = imp->FinishIncremental();
+
+        if (profiler) {
+            profiler->EndRegion("finish");
+        }
+
+        // If successful, apply all active post processing steps like ReadFile()
+        if( pimpl->mScene)  {
+
+#ifndef ASSIMP_BUILD_NO_VALIDATEDS_PROCESS
+            if (pimpl->mIncrementalFlags & aiProcess_ValidateDataStructure)
+            {
+                ValidateDSProcess ds;
+                ds.ExecuteOnScene (this);
+                if (!pimpl->mScene) {
+                    return NULL;
+                }
+            }
+#endif // no validation
+
+            ScenePreprocessor pre(pimpl->mScene);
+            pre.ProcessScene();
+
+            ApplyPostProcessing(pimpl->mIncrementalFlags & (~aiProcess_ValidateDataStructure));
+        }
+        else {
+            pimpl->mErrorString = imp->GetErrorText();
+        }
+
+        // clear any data allocated by post-process steps
+        pimpl->mPPShared->Clean();
+    }
+#ifdef ASSIMP_CATCH_GLOBAL_EXCEPTIONS
+    catch (std::exception &e)
+    {
+        pimpl->mErrorString = std::string("std::exception: ") + e.what();
+        DefaultLogger::get()->error(pimpl->mErrorString);
+        delete pimpl->mScene; pimpl->mScene = NULL;
+    }
+#endif // ! ASSIMP_CATCH_GLOBAL_EXCEPTIONS
+
+    ASSIMP_END_EXCEPTION_REGION(const aiScene*);
+    return pimpl->mScene;
+}
+
 // ------------------------------------------------------------------------------------------------
 // Apply post-processing to the currently bound scene
 const aiScene* Importer::ApplyPostProcessing(unsigned int pFlags)
@@ -786,6 +940,13 @@ const aiScene* Importer::ApplyPostProcessing(unsigned int pFlags)
 #endif // ! DEBUG
 
     std::unique_ptr<Profiler> profiler(GetPropertyInteger(AI_CONFIG_GLOB_MEASURE_TIME,0)?new Profiler():NULL);
+
+    // the meshes the dirty mesh list refers to, if there is one
+    std::vector<bool>* dirty = NULL;
+    std::vector<aiMesh*> dirtyMeshes;
+    if (pimpl->mPPShared->GetProperty(AI_SPP_DIRTY_MESHES,dirty)) {
+        dirtyMeshes.assign(pimpl->mScene->mMeshes,pimpl->mScene->mMeshes + pimpl->mScene->mNumMeshes);
+    }
     for( unsigned int a = 0; a < pimpl->mPostProcessingSteps.size(); a++)   {
 
         BaseProcess* process = pimpl->mPostProcessingSteps[a];
@@ -805,6 +966,17 @@ const aiScene* Importer::ApplyPostProcessing(unsigned int pFlags)
         if( !pimpl->mScene) {
             break;
         }
+
+        // if the step added, removed, reordered or replaced meshes (SortByPType and
+        // OptimizeMeshes do, even if the number of meshes stays the same), the dirty
+        // mesh list is no longer valid. New meshes are always allocated before the ones
+        // they replace are deleted, so comparing the pointers is enough.
+        if (!dirtyMeshes.empty() && (dirtyMeshes.size() != pimpl->mScene->mNumMeshes ||
+            !std::equal(dirtyMeshes.begin(),dirtyMeshes.end(),pimpl->mScene->mMeshes))) {
+            DefaultLogger::get()->debug("Mesh list changed, processing all meshes from now on");
+            pimpl->mPPShared->RemoveProperty(AI_SPP_DIRTY_MESHES);
+            dirtyMeshes.clear();
+        }
 #ifdef ASSIMP_BUILD_DEBUG
 
 #ifdef ASSIMP_BUILD_NO_VALIDATEDS_PROCESS
@@ -838,6 +1010,42 @@ const aiScene* Importer::ApplyPostProcessing(unsigned int pFlags)
     return pimpl->mScene;
 }
 
+// ------------------------------------------------------------------------------------------------
+// Apply post-processing to some meshes of the currently bound scene
+const aiScene* Importer::ApplyPostProcessing(unsigned int pFlags, const unsigned int* pDirtyMeshes,
+    unsigned int pNumDirtyMeshes)
+{
+    ASSIMP_BEGIN_EXCEPTION_REGION();
+    if (!pimpl->mScene) {
+        return NULL;
+    }
+    if (!pFlags) {
+        return pimpl->mScene;
+    }
+    ai_assert(NULL != pDirtyMeshes || 0 == pNumDirtyMeshes);
+
+    std::vector<bool>* dirty = new std::vector<bool>(pimpl->mScene->mNumMeshes,false);
+    for (unsigned int i = 0; i < pNumDirtyMeshes; ++i) {
+        if (pDirtyMeshes[i] >= pimpl->mScene->mNumMeshes) {
+            delete dirty;
+            DefaultLogger::get()->error("ApplyPostProcessing: dirty mesh index is out of range");
+            return pimpl->mScene;
+        }
+        (*dirty)[pDirtyMeshes[i]] = true;
+    }
+
+    pimpl->mPPShared->AddProperty(AI_SPP_DIRTY_MESHES,dirty);
+    ApplyPostProcessing(pFlags);
+
+    // the shared data is only cleaned if the pipeline runs to its end, a failed
+    // validation stops it before. The list must not apply to a later call.
+    if (pimpl->mPPShared->GetProperty(AI_SPP_DIRTY_MESHES,dirty)) {
+        pimpl->mPPShared->RemoveProperty(AI_SPP_DIRTY_MESHES);
+    }
+    ASSIMP_END_EXCEPTION_REGION(const aiScene*);
+    return pimpl->mScene;
+}
+
 // ------------------------------------------------------------------------------------------------
 const aiScene* Importer::ApplyCustomizedPostProcessing( BaseProcess *rootProcess, bool requestValidation ) {
     ASSIMP_BEGIN_EXCEPTION_REGION();
@@ -1193,3 +1401,20 @@ void Importer::GetMemoryRequirements(aiMemoryInfo& in) const
     }
     in.total += in.materials;
 }
+
+// ------------------------------------------------------------------------------------------------
+// Get the statistics of the last FindDegenerates run
+void Importer::GetDegenerateInfo(aiDegenerateInfo& in) const
+{
+    in = aiDegenerateInfo();
+#ifndef ASSIMP_BUILD_NO_FINDDEGENERATES_PROCESS
+    for (std::vector<BaseProcess*>::const_iterator it = pimpl->mPostProcessingSteps.begin();
+        it != pimpl->mPostProcessingSteps.end(); ++it) {
+        const FindDegeneratesProcess* process = dynamic_cast<const FindDegeneratesProcess*>(*it);
+        if (process) {
+            in = process->GetStatistics();
+            return;
+        }
+    }
+#endif
+}
@@ -121,6 +121,12 @@ public:
 
     /** Used by post-process steps to share data */
     SharedPostProcessInfo* mPPShared;
+
+    /** Loader of the running incremental import, NULL if there is none */
+    BaseImporter* mIncrementalImporter;
+
+    /** Post processing steps of the running incremental import */
+    unsigned int mIncrementalFlags;
 };
 //! @endcond
 
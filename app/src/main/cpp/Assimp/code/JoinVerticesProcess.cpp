@@ -90,8 +90,13 @@ void JoinVerticesProcess::Execute( aiScene* pScene)
 
     // execute the step
     int iNumVertices = 0;
-    for( unsigned int a = 0; a < pScene->mNumMeshes; a++)
-        iNumVertices += ProcessMesh( pScene->mMeshes[a],a);
+    for( unsigned int a = 0; a < pScene->mNumMeshes; a++) {
+        if (IsMeshDirty(a)) {
+            iNumVertices += ProcessMesh( pScene->mMeshes[a],a);
+        } else {
+            iNumVertices += pScene->mMeshes[a]->mNumVertices;
+        }
+    }
 
     // if logging is active, print detailed statistics
     if (!DefaultLogger::isNullLogger())
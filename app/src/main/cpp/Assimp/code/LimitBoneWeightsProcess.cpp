@@ -43,6 +43,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
 #include "LimitBoneWeightsProcess.h"
+#include "ProcessHelper.h"
 #include "StringUtils.h"
 #include <assimp/postprocess.h>
 #include <assimp/DefaultLogger.hpp>
@@ -51,6 +52,16 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 using namespace Assimp;
 
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Sorts bone weights by descending weight
+bool CompareWeights(const PerVertexWeight& a, const PerVertexWeight& b)
+{
+    return a.second > b.second;
+}
+
+} // ! anon namespace
 
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
@@ -78,8 +89,11 @@ bool LimitBoneWeightsProcess::IsActive( unsigned int pFlags) const
 void LimitBoneWeightsProcess::Execute( aiScene* pScene)
 {
     DefaultLogger::get()->debug("LimitBoneWeightsProcess begin");
-    for( unsigned int a = 0; a < pScene->mNumMeshes; a++)
-        ProcessMesh( pScene->mMeshes[a]);
+    for( unsigned int a = 0; a < pScene->mNumMeshes; a++) {
+        if (IsMeshDirty(a)) {
+            ProcessMesh( pScene->mMeshes[a]);
+        }
+    }
 
     DefaultLogger::get()->debug("LimitBoneWeightsProcess end");
 }
@@ -100,83 +114,74 @@ void LimitBoneWeightsProcess::ProcessMesh( aiMesh* pMesh)
         return;
 
     // collect all bone weights per vertex
-    typedef std::vector< std::vector< Weight > > WeightsPerVertex;
-    WeightsPerVertex vertexWeights( pMesh->mNumVertices);
-
-    // collect all weights per vertex
-    for( unsigned int a = 0; a < pMesh->mNumBones; a++)
-    {
-        const aiBone* bone = pMesh->mBones[a];
-        for( unsigned int b = 0; b < bone->mNumWeights; b++)
-        {
-            const aiVertexWeight& w = bone->mWeights[b];
-            vertexWeights[w.mVertexId].push_back( Weight( a, w.mWeight));
-        }
-    }
+    VertexBoneWeights vertexWeights;
+    ComputeVertexBoneWeights( pMesh, vertexWeights);
 
     unsigned int removed = 0, old_bones = pMesh->mNumBones;
 
-    // now cut the weight count if it exceeds the maximum
+    // now cut the weight count if it exceeds the maximum. The weights
+    // kept for vertex a are the first numKept[a] weights of the vertex.
     bool bChanged = false;
-    for( WeightsPerVertex::iterator vit = vertexWeights.begin(); vit != vertexWeights.end(); ++vit)
+    std::vector<unsigned int> numKept( pMesh->mNumVertices);
+    for( unsigned int a = 0; a < pMesh->mNumVertices; a++)
     {
-        if( vit->size() <= mMaxWeights)
+        const unsigned int cnt = vertexWeights.GetNumWeights( a);
+        numKept[a] = cnt;
+        if( cnt <= mMaxWeights)
             continue;
 
         bChanged = true;
 
-        // more than the defined maximum -> first sort by weight in descending order. That's
-        // why we defined the < operator in such a weird way.
-        std::sort( vit->begin(), vit->end());
+        // more than the defined maximum -> first sort by weight in descending order.
+        PerVertexWeight* const vw = vertexWeights.GetWeights( a);
+        std::sort( vw, vw + cnt, CompareWeights);
 
         // now kill everything beyond the maximum count
-        unsigned int m = static_cast<unsigned int>(vit->size());
-        vit->erase( vit->begin() + mMaxWeights, vit->end());
-        removed += static_cast<unsigned int>(m-vit->size());
+        numKept[a] = mMaxWeights;
+        removed += cnt - mMaxWeights;
 
         // and renormalize the weights
         float sum = 0.0f;
-        for( std::vector<Weight>::const_iterator it = vit->begin(); it != vit->end(); ++it ) {
-            sum += it->mWeight;
+        for( unsigned int i = 0; i < mMaxWeights; i++ ) {
+            sum += vw[i].second;
         }
         if( 0.0f != sum ) {
             const float invSum = 1.0f / sum;
-            for( std::vector<Weight>::iterator it = vit->begin(); it != vit->end(); ++it ) {
-                it->mWeight *= invSum;
+            for( unsigned int i = 0; i < mMaxWeights; i++ ) {
+                vw[i].second *= invSum;
             }
         }
     }
 
     if (bChanged)   {
-        // rebuild the vertex weight array for all bones
-        typedef std::vector< std::vector< aiVertexWeight > > WeightsPerBone;
-        WeightsPerBone boneWeights( pMesh->mNumBones);
-        for( unsigned int a = 0; a < vertexWeights.size(); a++)
+        // rebuild the vertex weight array for all bones. There are less weights
+        // than before, so the existing arrays can be reused. The weights of the
+        // bones are only read from the per-vertex table, so they can be overwritten.
+        std::vector<unsigned int> numBoneWeights( pMesh->mNumBones, 0);
+        for( unsigned int a = 0; a < pMesh->mNumVertices; a++)
         {
-            const std::vector<Weight>& vw = vertexWeights[a];
-            for( std::vector<Weight>::const_iterator it = vw.begin(); it != vw.end(); ++it)
-                boneWeights[it->mBone].push_back( aiVertexWeight( a, it->mWeight));
+            const PerVertexWeight* vw = vertexWeights.GetWeights( a);
+            for( unsigned int i = 0; i < numKept[a]; i++)
+            {
+                aiBone* bone = pMesh->mBones[vw[i].first];
+                bone->mWeights[numBoneWeights[vw[i].first]++] = aiVertexWeight( a, vw[i].second);
+            }
         }
 
-        // and finally copy the vertex weight list over to the mesh's bones
+        // and finally update the weight counts of the mesh's bones
         std::vector<bool> abNoNeed(pMesh->mNumBones,false);
         bChanged = false;
 
         for( unsigned int a = 0; a < pMesh->mNumBones; a++)
         {
-            const std::vector<aiVertexWeight>& bw = boneWeights[a];
             aiBone* bone = pMesh->mBones[a];
+            ai_assert( numBoneWeights[a] <= bone->mNumWeights);
+            bone->mNumWeights = numBoneWeights[a];
 
-            if ( bw.empty() )
+            if ( !bone->mNumWeights )
             {
                 abNoNeed[a] = bChanged = true;
-                continue;
             }
-
-            // copy the weight list. should always be less weights than before, so we don't need a new allocation
-            ai_assert( bw.size() <= bone->mNumWeights);
-            bone->mNumWeights = static_cast<unsigned int>( bw.size() );
-            ::memcpy( bone->mWeights, &bw[0], bw.size() * sizeof( aiVertexWeight));
         }
 
         if (bChanged)   {
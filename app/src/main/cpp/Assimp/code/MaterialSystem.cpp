@@ -51,9 +51,39 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/material.h>
 #include <assimp/DefaultLogger.hpp>
 #include "Macros.h"
+#include <math.h>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
 
 using namespace Assimp;
 
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Hash of the key, semantic and index of a property
+uint32_t ComputePropertyKeyHash(const char* pKey, unsigned int type, unsigned int index)
+{
+    uint32_t hash = SuperFastHash(pKey);
+    hash = SuperFastHash((const char*)&type,sizeof(unsigned int),hash);
+    return SuperFastHash((const char*)&index,sizeof(unsigned int),hash);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Index built by aiMaterial::BuildPropertyIndex(). Maps the key hash of each property to the
+// first property with this hash, lookups of colliding keys fall back to a linear search.
+struct PropertyIndex
+{
+    std::unordered_map<uint32_t, unsigned int> mSlots;
+
+    // The property list the index was built for. If it was changed directly
+    // and not through aiMaterial, the index is ignored.
+    aiMaterialProperty** mProperties;
+    unsigned int mNumProperties;
+};
+
+} // end of anonymous namespace
+
 // ------------------------------------------------------------------------------------------------
 // Get a specific property from a material
 aiReturn aiGetMaterialProperty(const aiMaterial* pMat,
@@ -66,10 +96,26 @@ aiReturn aiGetMaterialProperty(const aiMaterial* pMat,
     ai_assert (pKey != NULL);
     ai_assert (pPropOut != NULL);
 
-    /*  Just search for a property with exactly this name ..
-     *  could be improved by hashing, but it's possibly
-     *  no worth the effort (we're bound to C structures,
-     *  thus std::map or derivates are not applicable. */
+    // Use the index if there is one and it is up to date, see aiMaterial::BuildPropertyIndex()
+    const PropertyIndex* pIndex = static_cast<const PropertyIndex*>(pMat->mPropertyIndex);
+    if (pIndex && UINT_MAX != type && UINT_MAX != index &&
+        pIndex->mProperties == pMat->mProperties && pIndex->mNumProperties == pMat->mNumProperties) {
+
+        std::unordered_map<uint32_t, unsigned int>::const_iterator it =
+            pIndex->mSlots.find(ComputePropertyKeyHash(pKey,type,index));
+        if (it == pIndex->mSlots.end()) {
+            *pPropOut = NULL;
+            return AI_FAILURE;
+        }
+        aiMaterialProperty* prop = pMat->mProperties[it->second];
+        if (prop && prop->mSemantic == type && prop->mIndex == index && 0 == strcmp( prop->mKey.data, pKey )) {
+            *pPropOut = prop;
+            return AI_SUCCESS;
+        }
+        // another key with the same hash, search linearly
+    }
+
+    /*  Just search for a property with exactly this name .. */
     for ( unsigned int i = 0; i < pMat->mNumProperties; ++i ) {
         aiMaterialProperty* prop = pMat->mProperties[i];
 
@@ -389,7 +435,8 @@ static const unsigned int DefaultNumAllocated = 5;
 aiMaterial::aiMaterial() 
 : mProperties( NULL )
 , mNumProperties( 0 )
-, mNumAllocated( DefaultNumAllocated ) {
+, mNumAllocated( DefaultNumAllocated )
+, mPropertyIndex( NULL ) {
     // Allocate 5 entries by default
     mProperties = new aiMaterialProperty*[ DefaultNumAllocated ];
 }
@@ -398,6 +445,7 @@ aiMaterial::aiMaterial()
 aiMaterial::~aiMaterial()
 {
     Clear();
+    ReleasePropertyIndex();
 
     delete[] mProperties;
 }
@@ -413,6 +461,38 @@ void aiMaterial::Clear()
     mNumProperties = 0;
 
     // The array remains allocated, we just invalidated its contents
+    if (mPropertyIndex) {
+        BuildPropertyIndex();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void aiMaterial::BuildPropertyIndex()
+{
+    PropertyIndex* pIndex = static_cast<PropertyIndex*>(mPropertyIndex);
+    if (!pIndex) {
+        mPropertyIndex = pIndex = new PropertyIndex();
+    }
+
+    pIndex->mSlots.clear();
+    pIndex->mSlots.reserve(mNumProperties);
+    for (unsigned int i = 0; i < mNumProperties;++i) {
+        const aiMaterialProperty* prop = mProperties[i];
+        if (prop) {
+            // insert() keeps the first property on collisions, as the linear search would
+            pIndex->mSlots.insert(std::make_pair(ComputePropertyKeyHash(prop->mKey.data,
+                prop->mSemantic,prop->mIndex),i));
+        }
+    }
+    pIndex->mProperties = mProperties;
+    pIndex->mNumProperties = mNumProperties;
+}
+
+// ------------------------------------------------------------------------------------------------
+void aiMaterial::ReleasePropertyIndex()
+{
+    delete static_cast<PropertyIndex*>(mPropertyIndex);
+    mPropertyIndex = NULL;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -436,6 +516,9 @@ aiReturn aiMaterial::RemoveProperty (const char* pKey,unsigned int type,
             for (unsigned int a = i; a < mNumProperties;++a)    {
                 mProperties[a] = mProperties[a+1];
             }
+            if (mPropertyIndex) {
+                BuildPropertyIndex();
+            }
             return AI_SUCCESS;
         }
     }
@@ -492,6 +575,8 @@ aiReturn aiMaterial::AddBinaryProperty (const void* pInput,
         mProperties[iOutIndex] = pcNew;
         return AI_SUCCESS;
     }
+    PropertyIndex* pIndex = static_cast<PropertyIndex*>(mPropertyIndex);
+    const bool indexValid = pIndex && pIndex->mProperties == mProperties && pIndex->mNumProperties == mNumProperties;
 
     // resize the array ... double the storage allocated
     if (mNumProperties == mNumAllocated)    {
@@ -514,6 +599,16 @@ aiReturn aiMaterial::AddBinaryProperty (const void* pInput,
     }
     // push back ...
     mProperties[mNumProperties++] = pcNew;
+
+    // keep the index up to date, rebuild it if the list was modified directly
+    if (indexValid) {
+        pIndex->mSlots.insert(std::make_pair(ComputePropertyKeyHash(pKey,type,index),mNumProperties-1));
+        pIndex->mProperties = mProperties;
+        pIndex->mNumProperties = mNumProperties;
+    }
+    else if (pIndex) {
+        BuildPropertyIndex();
+    }
     return AI_SUCCESS;
 }
 
@@ -570,6 +665,77 @@ uint32_t Assimp::ComputeMaterialHash(const aiMaterial* mat, bool includeMatName
     return hash;
 }
 
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Append floating-point values rounded to multiples of epsilon to a fingerprint
+template <typename T>
+void AppendQuantized(std::string& out, const char* data, unsigned int count, double epsilon)
+{
+    for (unsigned int i = 0; i < count; ++i) {
+        T value;
+        ::memcpy(&value,data + i * sizeof(T),sizeof(T));
+
+        // NaN, infinities and huge values are taken as they are
+        const double q = floor(value / epsilon + 0.5);
+        if (q > -9.0e18 && q < 9.0e18) {
+            const int64_t n = static_cast<int64_t>(q);
+            out.push_back('q');
+            out.append((const char*)&n,sizeof(int64_t));
+        }
+        else {
+            out.push_back('r');
+            out.append((const char*)&value,sizeof(T));
+        }
+    }
+}
+
+} // end of anonymous namespace
+
+// ------------------------------------------------------------------------------------------------
+std::string Assimp::ComputeMaterialFingerprint(const aiMaterial* mat, ai_real epsilon,
+    bool includeMatName /*= false*/)
+{
+    // sort the properties so the fingerprint doesn't depend on their order
+    std::vector<const aiMaterialProperty*> props;
+    props.reserve(mat->mNumProperties);
+    for ( unsigned int i = 0; i < mat->mNumProperties; ++i ) {
+        const aiMaterialProperty* prop = mat->mProperties[i];
+        if (prop && (includeMatName || prop->mKey.data[0] != '?')) {
+            props.push_back(prop);
+        }
+    }
+    std::sort(props.begin(),props.end(),[](const aiMaterialProperty* a, const aiMaterialProperty* b) {
+        const int c = ::strcmp(a->mKey.data,b->mKey.data);
+        if (c) {
+            return c < 0;
+        }
+        return a->mSemantic != b->mSemantic ? a->mSemantic < b->mSemantic : a->mIndex < b->mIndex;
+    });
+
+    std::string out;
+    for (const aiMaterialProperty* prop : props) {
+        const unsigned int head[] = { prop->mSemantic, prop->mIndex, prop->mType, prop->mDataLength };
+        out.append(prop->mKey.data,prop->mKey.length + 1);
+        out.append((const char*)head,sizeof(head));
+
+        if (epsilon > 0 && aiPTI_Float == prop->mType) {
+            const unsigned int n = prop->mDataLength / sizeof(float);
+            AppendQuantized<float>(out,prop->mData,n,epsilon);
+            out.append(prop->mData + n * sizeof(float),prop->mDataLength - n * sizeof(float));
+        }
+        else if (epsilon > 0 && aiPTI_Double == prop->mType) {
+            const unsigned int n = prop->mDataLength / sizeof(double);
+            AppendQuantized<double>(out,prop->mData,n,epsilon);
+            out.append(prop->mData + n * sizeof(double),prop->mDataLength - n * sizeof(double));
+        }
+        else {
+            out.append(prop->mData,prop->mDataLength);
+        }
+    }
+    return out;
+}
+
 // ------------------------------------------------------------------------------------------------
 void aiMaterial::CopyPropertyList(aiMaterial* pcDest,
     const aiMaterial* pcSrc
@@ -624,4 +790,8 @@ void aiMaterial::CopyPropertyList(aiMaterial* pcDest,
         prop->mData = new char[propSrc->mDataLength];
         memcpy(prop->mData,propSrc->mData,prop->mDataLength);
     }
+
+    if (pcDest->mPropertyIndex) {
+        pcDest->BuildPropertyIndex();
+    }
 }
@@ -46,7 +46,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef AI_MATERIALSYSTEM_H_INC
 #define AI_MATERIALSYSTEM_H_INC
 
+#include <assimp/defs.h>
 #include <stdint.h>
+#include <string>
 
 struct aiMaterial;
 
@@ -65,6 +67,20 @@ namespace Assimp    {
  */
 uint32_t ComputeMaterialHash(const aiMaterial* mat, bool includeMatName = false);
 
+// ------------------------------------------------------------------------------
+/** Builds a canonical fingerprint from all material properties. Unlike the
+ *  hash, equal fingerprints guarantee equal materials, and they do not depend
+ *  on the order of the properties.
+ *
+ *  @param  epsilon Floating-point values are rounded to multiples of this
+ *    value, so values which differ only by rounding noise usually yield the
+ *    same fingerprint. Pass 0 to compare them bit by bit.
+ *  @param  includeMatName See #ComputeMaterialHash
+ *  @return Binary string, suitable as key of a hash map
+ */
+std::string ComputeMaterialFingerprint(const aiMaterial* mat, ai_real epsilon,
+    bool includeMatName = false);
+
 
 } // ! namespace Assimp
 
@@ -48,6 +48,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // internal headers
 #include "NFFLoader.h"
 #include "ParsingUtils.h"
+#include "TextCursor.h"
 #include "StandardShapes.h"
 #include "qnan.h"
 #include "fast_atof.h"
@@ -105,9 +106,11 @@ const aiImporterDesc* NFFImporter::GetInfo () const
 
 // ------------------------------------------------------------------------------------------------
 #define AI_NFF_PARSE_TRIPLE(v) \
-    AI_NFF_PARSE_FLOAT(v[0]) \
-    AI_NFF_PARSE_FLOAT(v[1]) \
-    AI_NFF_PARSE_FLOAT(v[2])
+    if (!cursor.ReadReals(sz, &(float&)v[0], 3)) { \
+        AI_NFF_PARSE_FLOAT(v[0]) \
+        AI_NFF_PARSE_FLOAT(v[1]) \
+        AI_NFF_PARSE_FLOAT(v[2]) \
+    }
 
 // ------------------------------------------------------------------------------------------------
 #define AI_NFF_PARSE_SHAPE_INFORMATION() \
@@ -123,7 +126,7 @@ const aiImporterDesc* NFFImporter::GetInfo () const
 #define AI_NFF2_GET_NEXT_TOKEN() \
     do \
     { \
-    if (!GetNextLine(buffer,line)) \
+    if (!cursor.NextLine(line)) \
         {DefaultLogger::get()->warn("NFF2: Unexpected EOF, can't read next token");break;} \
     SkipSpaces(line,&sz); \
     } \
@@ -164,9 +167,11 @@ void NFFImporter::LoadNFF2MaterialTable(std::vector<ShadingInfo>& output,
     ShadingInfo* curShader = NULL;
 
     // No read the file line per line
-    char line[4096];
+    TextCursor cursor(&mBuffer2[0],&mBuffer2.back());
+    cursor.SetPosition(buffer);
+    const char* line;
     const char* sz;
-    while (GetNextLine(buffer,line))
+    while (cursor.NextLine(line))
     {
         SkipSpaces(line,&sz);
 
@@ -255,7 +260,8 @@ void NFFImporter::InternReadFile( const std::string& pFile,
     std::vector<MeshInfo> meshesWithUVCoords;
     std::vector<MeshInfo> meshesLocked;
 
-    char line[4096];
+    TextCursor cursor(&mBuffer2[0],&mBuffer2.back());
+    const char* line;
     const char* sz;
 
     // camera parameters
@@ -302,7 +308,8 @@ void NFFImporter::InternReadFile( const std::string& pFile,
         // First of all: remove all comments from the file
         CommentRemover::RemoveLineComments("//",&mBuffer2[0]);
 
-        while (GetNextLine(buffer,line))
+        cursor.SetPosition(buffer);
+        while (cursor.NextLine(line))
         {
             SkipSpaces(line,&sz);
             if (TokenMatch(sz,"version",7))
@@ -662,7 +669,7 @@ void NFFImporter::InternReadFile( const std::string& pFile,
     }
     else // "Normal" Neutral file format that is quite more common
     {
-        while (GetNextLine(buffer,line))
+        while (cursor.NextLine(line))
         {
             sz = line;
             if ('p' == line[0] || TokenMatch(sz,"tpp",3))
@@ -747,7 +754,7 @@ void NFFImporter::InternReadFile( const std::string& pFile,
                 }
                 for (unsigned int n = 0; n < m;++n)
                 {
-                    if(!GetNextLine(buffer,line))
+                    if(!cursor.NextLine(line))
                     {
                         DefaultLogger::get()->error("NFF: Unexpected EOF was encountered. Patch definition incomplete");
                         continue;
@@ -768,14 +775,14 @@ void NFFImporter::InternReadFile( const std::string& pFile,
                         SkipSpaces(&sz);
                         if (IsLineEnd(*sz))
                         {
-                            GetNextLine(buffer,line);
+                            cursor.NextLine(line);
                             sz = line;
                         }
                         AI_NFF_PARSE_FLOAT(v.x);
                         SkipSpaces(&sz);
                         if (IsLineEnd(*sz))
                         {
-                            GetNextLine(buffer,line);
+                            cursor.NextLine(line);
                             sz = line;
                         }
                         AI_NFF_PARSE_FLOAT(v.y);
@@ -940,7 +947,7 @@ void NFFImporter::InternReadFile( const std::string& pFile,
                 currentMesh.shader = s;
                 currentMesh.shader.mapping = aiTextureMapping_CYLINDER;
 
-                if(!GetNextLine(buffer,line))
+                if(!cursor.NextLine(line))
                 {
                     DefaultLogger::get()->error("NFF: Unexpected end of file (cone definition not complete)");
                     break;
@@ -952,7 +959,7 @@ void NFFImporter::InternReadFile( const std::string& pFile,
                 AI_NFF_PARSE_TRIPLE(center1);
                 AI_NFF_PARSE_FLOAT(radius1);
 
-                if(!GetNextLine(buffer,line))
+                if(!cursor.NextLine(line))
                 {
                     DefaultLogger::get()->error("NFF: Unexpected end of file (cone definition not complete)");
                     break;
@@ -50,6 +50,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // internal headers
 #include "OFFLoader.h"
 #include "ParsingUtils.h"
+#include "TextCursor.h"
 #include "fast_atof.h"
 #include <memory>
 #include <assimp/IOSystem.hpp>
@@ -120,12 +121,12 @@ void OFFImporter::InternReadFile( const std::string& pFile,
     // allocate storage and copy the contents of the file to a memory buffer
     std::vector<char> mBuffer2;
     TextFileToBuffer(file.get(),mBuffer2);
-    const char* buffer = &mBuffer2[0];
+    TextCursor cursor(&mBuffer2[0],&mBuffer2.back());
 
-    char line[4096];
-    GetNextLine(buffer,line);
+    const char* line = "";
+    cursor.NextLine(line);
     if ('O' == line[0]) {
-        GetNextLine(buffer,line); // skip the 'OFF' line
+        cursor.NextLine(line); // skip the 'OFF' line
     }
 
     const char* sz = line; SkipSpaces(&sz);
@@ -154,14 +155,18 @@ void OFFImporter::InternReadFile( const std::string& pFile,
     // now read all vertex lines
     for (unsigned int i = 0; i< numVertices;++i)
     {
-        if(!GetNextLine(buffer,line))
+        if(!cursor.NextLine(line))
         {
             DefaultLogger::get()->error("OFF: The number of verts in the header is incorrect");
             break;
         }
         aiVector3D& v = tempPositions[i];
 
-        sz = line; SkipSpaces(&sz);
+        sz = line;
+        if (cursor.ReadReals(sz,&v.x,3)) {
+            continue;
+        }
+        SkipSpaces(&sz);
         sz = fast_atoreal_move<ai_real>(sz,(ai_real&)v.x); SkipSpaces(&sz);
         sz = fast_atoreal_move<ai_real>(sz,(ai_real&)v.y); SkipSpaces(&sz);
         fast_atoreal_move<ai_real>(sz,(ai_real&)v.z);
@@ -169,10 +174,10 @@ void OFFImporter::InternReadFile( const std::string& pFile,
 
 
     // First find out how many vertices we'll need
-    const char* old = buffer;
+    const char* old = cursor.GetPosition();
     for (unsigned int i = 0; i< mesh->mNumFaces;++i)
     {
-        if(!GetNextLine(buffer,line))
+        if(!cursor.NextLine(line))
         {
             DefaultLogger::get()->error("OFF: The number of faces in the header is incorrect");
             break;
@@ -197,11 +202,11 @@ void OFFImporter::InternReadFile( const std::string& pFile,
     verts.reserve(mesh->mNumVertices);
 
     // second: now parse all face indices
-    buffer = old;
+    cursor.SetPosition(old);
     faces = mesh->mFaces;
     for (unsigned int i = 0, p = 0; i< mesh->mNumFaces;)
     {
-        if(!GetNextLine(buffer,line))break;
+        if(!cursor.NextLine(line))break;
 
         unsigned int idx;
         sz = line;SkipSpaces(&sz);
@@ -209,11 +214,20 @@ void OFFImporter::InternReadFile( const std::string& pFile,
         if(!(idx) || idx > 9)
             continue;
 
+        // all indices of a face are usually given in a single run of numbers
+        unsigned int indices[9];
+        const bool batch = cursor.ReadUInts(sz,indices,faces->mNumIndices);
+
         faces->mIndices = new unsigned int [faces->mNumIndices];
         for (unsigned int m = 0; m < faces->mNumIndices;++m)
         {
-            SkipSpaces(&sz);
-            idx = strtoul10(sz,&sz);
+            if (batch) {
+                idx = indices[m];
+            }
+            else {
+                SkipSpaces(&sz);
+                idx = strtoul10(sz,&sz);
+            }
             if ((idx) >= numVertices)
             {
                 DefaultLogger::get()->error("OFF: Vertex index is out of range");
@@ -52,43 +52,8 @@ namespace Assimp {
 namespace ObjFile {
 
 struct Object;
-struct Face;
 struct Material;
 
-// ------------------------------------------------------------------------------------------------
-//! \struct Face
-//! \brief  Data structure for a simple obj-face, describes discredit,l.ation and materials
-// ------------------------------------------------------------------------------------------------
-struct Face {
-    typedef std::vector<unsigned int> IndexArray;
-
-    //! Primitive type
-    aiPrimitiveType m_PrimitiveType;
-    //! Vertex indices
-    IndexArray m_vertices;
-    //! Normal indices
-    IndexArray m_normals;
-    //! Texture coordinates indices
-    IndexArray m_texturCoords;
-    //! Pointer to assigned material
-    Material *m_pMaterial;
-
-    //! \brief  Default constructor
-    Face( aiPrimitiveType pt = aiPrimitiveType_POLYGON) 
-    : m_PrimitiveType( pt )
-    , m_vertices()
-    , m_normals()
-    , m_texturCoords()
-    , m_pMaterial( 0L ) {
-        // empty
-    }
-
-    //! \brief  Destructor
-    ~Face() {
-        // empty
-    }
-};
-
 // ------------------------------------------------------------------------------------------------
 //! \struct Object
 //! \brief  Stores all objects of an obj-file object definition
@@ -208,14 +173,30 @@ struct Material {
 // ------------------------------------------------------------------------------------------------
 struct Mesh {
     static const unsigned int NoMaterial = ~0u;
+    /// Marks a face corner without texture coordinate or normal
+    static const unsigned int NoIndex = ~0u;
     /// The name for the mesh
     std::string m_name;
-    /// Array with pointer to all stored faces
-    std::vector<Face*> m_Faces;
+    /// Primitive type of each stored face
+    std::vector<aiPrimitiveType> m_FaceTypes;
+    /// Offset of the first corner of each face, followed by the end offset
+    std::vector<unsigned int> m_FaceOffsets;
+    /// Vertex index of each face corner
+    std::vector<unsigned int> m_VertexIndices;
+    /// Texture coordinate index of each face corner, empty if no corner has one
+    std::vector<unsigned int> m_TexCoordIndices;
+    /// Normal index of each face corner, empty if no corner has one
+    std::vector<unsigned int> m_NormalIndices;
     /// Assigned material
     Material *m_pMaterial;
+    /// Number of stored faces.
+    unsigned int m_uiNumFaces;
     /// Number of stored indices.
     unsigned int m_uiNumIndices;
+    /// Faces, indices and primitive types of the resulting aiMesh, only collected by countFace()
+    unsigned int m_uiNumOutFaces;
+    unsigned int m_uiNumOutIndices;
+    unsigned int m_uiPrimitiveTypes;
     /// Number of UV
     unsigned int m_uiUVCoordinates[ AI_MAX_NUMBER_OF_TEXTURECOORDS ];
     /// Material index.
@@ -228,20 +209,94 @@ struct Mesh {
     /// Constructor
     explicit Mesh( const std::string &name )
     : m_name( name )
+    , m_FaceOffsets( 1, 0u )
     , m_pMaterial(NULL)
+    , m_uiNumFaces(0)
     , m_uiNumIndices(0)
+    , m_uiNumOutFaces(0)
+    , m_uiNumOutIndices(0)
+    , m_uiPrimitiveTypes(0)
     , m_uiMaterialIndex( NoMaterial )
-    , m_hasNormals(false) {
+    , m_hasNormals(false)
+    , m_hasVertexColors(false) {
         memset(m_uiUVCoordinates, 0, sizeof( unsigned int ) * AI_MAX_NUMBER_OF_TEXTURECOORDS);
     }
 
     /// Destructor
     ~Mesh() {
-        for (std::vector<Face*>::iterator it = m_Faces.begin();
-            it != m_Faces.end(); ++it)
-        {
-            delete *it;
+        // empty
+    }
+
+    /// Returns the number of stored faces.
+    size_t getNumFaces() const {
+        return m_uiNumFaces;
+    }
+
+    /// Returns the number of corners of the given face.
+    unsigned int getNumCorners( size_t face ) const {
+        return m_FaceOffsets[ face + 1 ] - m_FaceOffsets[ face ];
+    }
+
+    /// Appends a face, corners are given as (vertex, texture coordinate, normal) triplets.
+    void appendFace( aiPrimitiveType type, const unsigned int *corners, unsigned int numCorners ) {
+        const size_t first = m_VertexIndices.size();
+        bool hasTex = false, hasNormal = false;
+        for ( unsigned int i = 0; i < numCorners; ++i ) {
+            m_VertexIndices.push_back( corners[ i * 3 ] );
+            hasTex = hasTex || corners[ i * 3 + 1 ] != NoIndex;
+            hasNormal = hasNormal || corners[ i * 3 + 2 ] != NoIndex;
+        }
+
+        // the texture coordinate and normal streams are only allocated once needed
+        if ( hasTex || !m_TexCoordIndices.empty() ) {
+            m_TexCoordIndices.resize( first, NoIndex );
+            for ( unsigned int i = 0; i < numCorners; ++i ) {
+                m_TexCoordIndices.push_back( corners[ i * 3 + 1 ] );
+                if ( corners[ i * 3 + 1 ] != NoIndex ) {
+                    ++m_uiUVCoordinates[ 0 ];
+                }
+            }
+        }
+        if ( hasNormal || !m_NormalIndices.empty() ) {
+            m_NormalIndices.resize( first, NoIndex );
+            for ( unsigned int i = 0; i < numCorners; ++i ) {
+                m_NormalIndices.push_back( corners[ i * 3 + 2 ] );
+            }
+            m_hasNormals = m_hasNormals || hasNormal;
+        }
+
+        m_FaceTypes.push_back( type );
+        m_FaceOffsets.push_back( static_cast<unsigned int>( m_VertexIndices.size() ) );
+        ++m_uiNumFaces;
+        m_uiNumIndices += numCorners;
+    }
+
+    /// Counts a face like appendFace() without storing its corners. The sizes of the
+    /// resulting aiMesh are collected instead, lines and points are split like in
+    /// ObjFileImporter::createTopology().
+    void countFace( aiPrimitiveType type, const unsigned int *corners, unsigned int numCorners ) {
+        for ( unsigned int i = 0; i < numCorners; ++i ) {
+            if ( corners[ i * 3 + 1 ] != NoIndex ) {
+                ++m_uiUVCoordinates[ 0 ];
+            }
+            m_hasNormals = m_hasNormals || corners[ i * 3 + 2 ] != NoIndex;
+        }
+
+        if ( type == aiPrimitiveType_LINE ) {
+            m_uiNumOutFaces += numCorners - 1;
+            m_uiNumOutIndices += 2 * ( numCorners - 1 );
+            m_uiPrimitiveTypes |= aiPrimitiveType_LINE;
+        } else if ( type == aiPrimitiveType_POINT ) {
+            m_uiNumOutFaces += numCorners;
+            m_uiNumOutIndices += numCorners;
+            m_uiPrimitiveTypes |= aiPrimitiveType_POINT;
+        } else {
+            ++m_uiNumOutFaces;
+            m_uiNumOutIndices += numCorners;
+            m_uiPrimitiveTypes |= numCorners > 3 ? aiPrimitiveType_POLYGON : aiPrimitiveType_TRIANGLE;
         }
+        ++m_uiNumFaces;
+        m_uiNumIndices += numCorners;
     }
 };
 
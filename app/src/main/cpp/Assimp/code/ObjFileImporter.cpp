@@ -46,13 +46,17 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ObjFileParser.h"
 #include "ObjFileData.h"
 #include "IOStreamBuffer.h"
+#include "Hash.h"
+#include "Profiler.h"
 #include <memory>
+#include <unordered_map>
 #include <assimp/DefaultIOSystem.h>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/ai_assert.h>
 #include <assimp/DefaultLogger.hpp>
 #include <assimp/importerdesc.h>
+#include <assimp/config.h>
 
 static const aiImporterDesc desc = {
     "Wavefront Object Importer",
@@ -73,12 +77,199 @@ namespace Assimp {
 
 using namespace std;
 
+namespace {
+
+// (vertex, texture coordinate, normal) index triplet of a face corner
+struct CornerKey {
+    unsigned int m_Indices[ 3 ];
+
+    bool operator == ( const CornerKey &other ) const {
+        return m_Indices[ 0 ] == other.m_Indices[ 0 ] && m_Indices[ 1 ] == other.m_Indices[ 1 ]
+            && m_Indices[ 2 ] == other.m_Indices[ 2 ];
+    }
+};
+
+struct CornerKeyHash {
+    size_t operator() ( const CornerKey &key ) const {
+        return SuperFastHash( reinterpret_cast<const char*>( key.m_Indices ), sizeof( key.m_Indices ) );
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+//  Allocates the vertex streams of a mesh, every face index gets its own vertex.
+void allocateVertexArray( const ObjFile::Model* pModel, const ObjFile::Mesh* pObjMesh, aiMesh* pMesh,
+                          unsigned int numIndices ) {
+    pMesh->mNumVertices = numIndices;
+    if (pMesh->mNumVertices == 0) {
+        throw DeadlyImportError( "OBJ: no vertices" );
+    } else if (pMesh->mNumVertices > AI_MAX_ALLOC(aiVector3D)) {
+        throw DeadlyImportError( "OBJ: Too many vertices, would run out of memory" );
+    }
+    pMesh->mVertices = new aiVector3D[ pMesh->mNumVertices ];
+
+    // Allocate buffer for normal vectors
+    if ( !pModel->m_Normals.empty() && pObjMesh->m_hasNormals )
+        pMesh->mNormals = new aiVector3D[ pMesh->mNumVertices ];
+
+    // Allocate buffer for vertex-color vectors
+    if ( !pModel->m_VertexColors.empty() )
+        pMesh->mColors[0] = new aiColor4D[ pMesh->mNumVertices ];
+
+    // Allocate buffer for texture coordinates
+    if ( !pModel->m_TextureCoord.empty() && pObjMesh->m_uiUVCoordinates[0] )
+    {
+        pMesh->mNumUVComponents[ 0 ] = 2;
+        pMesh->mTextureCoords[ 0 ] = new aiVector3D[ pMesh->mNumVertices ];
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+//  Copies the vertices of a face, given as (vertex, texture coordinate, normal) triplets, and
+//  writes its faces. Lines are split into segments and points into single faces. newIndex and
+//  outIndex are the next vertex and face of the mesh, face indices which are not allocated yet
+//  are allocated here.
+void fillFace( const ObjFile::Model* pModel, aiMesh* pMesh, aiPrimitiveType type,
+               const unsigned int *corners, unsigned int numCorners,
+               unsigned int &newIndex, unsigned int &outIndex ) {
+    // lines are split into segments, the inner corners are written twice
+    unsigned int numOutVertices = numCorners, numOutFaces = numCorners ? 1 : 0;
+    if ( type == aiPrimitiveType_POINT ) {
+        numOutFaces = numCorners;
+    } else if ( type == aiPrimitiveType_LINE && numCorners ) {
+        numOutVertices = numCorners > 1 ? 2 * ( numCorners - 1 ) : 1;
+        numOutFaces = numCorners - 1;
+    }
+
+    // nothing is written unless the whole face fits
+    if ( pMesh->mNumVertices < newIndex || pMesh->mNumVertices - newIndex < numOutVertices ) {
+        throw DeadlyImportError("OBJ: bad vertex index");
+    }
+    if ( pMesh->mNumFaces < outIndex || pMesh->mNumFaces - outIndex < numOutFaces ) {
+        throw DeadlyImportError("OBJ: bad face index");
+    }
+
+    for ( unsigned int vertexIndex = 0, outVertexIndex = 0; vertexIndex < numCorners; vertexIndex++ ) {
+        const unsigned int vertex = corners[ vertexIndex * 3 ];
+        if ( vertex >= pModel->m_Vertices.size() ) {
+            throw DeadlyImportError( "OBJ: vertex index out of range" );
+        }
+
+        pMesh->mVertices[ newIndex ] = pModel->m_Vertices[ vertex ];
+
+        // Copy all normals
+        const unsigned int normal = corners[ vertexIndex * 3 + 2 ];
+        if ( pMesh->mNormals && normal != ObjFile::Mesh::NoIndex ) {
+            if ( normal >= pModel->m_Normals.size() ) {
+                throw DeadlyImportError( "OBJ: vertex normal index out of range" );
+            }
+            pMesh->mNormals[ newIndex ] = pModel->m_Normals[ normal ];
+        }
+
+        // Copy all vertex colors, vertices without a color keep the default
+        if ( vertex < pModel->m_VertexColors.size() )
+        {
+            const aiVector3D color = pModel->m_VertexColors[ vertex ];
+            pMesh->mColors[0][ newIndex ] = aiColor4D(color.x, color.y, color.z, 1.0);
+        }
+
+        // Copy all texture coordinates
+        const unsigned int tex = corners[ vertexIndex * 3 + 1 ];
+        if ( pMesh->mTextureCoords[ 0 ] && tex != ObjFile::Mesh::NoIndex )
+        {
+            ai_assert( tex < pModel->m_TextureCoord.size() );
+
+            if ( tex >= pModel->m_TextureCoord.size() )
+                throw DeadlyImportError("OBJ: texture coordinate index out of range");
+
+            const aiVector3D &coord3d = pModel->m_TextureCoord[ tex ];
+            pMesh->mTextureCoords[ 0 ][ newIndex ] = aiVector3D( coord3d.x, coord3d.y, coord3d.z );
+        }
+
+        // Get destination face
+        aiFace *pDestFace = &pMesh->mFaces[ outIndex ];
+
+        const bool last = ( vertexIndex == numCorners - 1 );
+        if (type != aiPrimitiveType_LINE || !last) {
+            if ( NULL == pDestFace->mIndices ) {
+                pDestFace->mNumIndices = type == aiPrimitiveType_LINE ? 2 : ( type == aiPrimitiveType_POINT ? 1 : numCorners );
+                pDestFace->mIndices = new unsigned int[ pDestFace->mNumIndices ];
+            }
+            pDestFace->mIndices[ outVertexIndex ] = newIndex;
+            outVertexIndex++;
+        }
+
+        if (type == aiPrimitiveType_POINT) {
+            outIndex++;
+            outVertexIndex = 0;
+        } else if (type == aiPrimitiveType_LINE) {
+            outVertexIndex = 0;
+
+            if(!last)
+                outIndex++;
+
+            if (vertexIndex) {
+                if(!last) {
+                    pMesh->mVertices[ newIndex+1 ] = pMesh->mVertices[ newIndex ];
+                    if ( pMesh->mNormals ) {
+                        pMesh->mNormals[ newIndex+1 ] = pMesh->mNormals[newIndex ];
+                    }
+                    for ( size_t i=0; i < pMesh->GetNumUVChannels(); i++ ) {
+                        pMesh->mTextureCoords[ i ][ newIndex+1 ] = pMesh->mTextureCoords[ i ][ newIndex ];
+                    }
+                    ++newIndex;
+                }
+
+                pDestFace[-1].mIndices[1] = newIndex;
+            }
+        }
+        else if (last) {
+            outIndex++;
+        }
+        ++newIndex;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+//  Fills the meshes of the two-pass import with the faces of the second pass.
+class MeshFiller : public ObjFileParser::FaceSink {
+public:
+    MeshFiller( const ObjFile::Model* pModel, const std::vector<aiMesh*> &meshes )
+    : m_pModel( pModel )
+    , m_Meshes( meshes )
+    , m_Vertices( meshes.size(), 0u )
+    , m_Faces( meshes.size(), 0u ) {
+        // empty
+    }
+
+    void addFace( unsigned int meshIndex, aiPrimitiveType type, const unsigned int *corners, unsigned int numCorners ) {
+        aiMesh *pMesh = meshIndex < m_Meshes.size() ? m_Meshes[ meshIndex ] : NULL;
+        if ( NULL == pMesh ) {
+            throw DeadlyImportError( "OBJ: File changed between the two passes" );
+        }
+        // fillFace() checks the room for the vertices and faces before it writes
+        fillFace( m_pModel, pMesh, type, corners, numCorners, m_Vertices[ meshIndex ], m_Faces[ meshIndex ] );
+    }
+
+private:
+    const ObjFile::Model* m_pModel;
+    const std::vector<aiMesh*> &m_Meshes;
+    std::vector<unsigned int> m_Vertices;
+    std::vector<unsigned int> m_Faces;
+};
+
+} // Namespace
+
 // ------------------------------------------------------------------------------------------------
 //  Default constructor
 ObjFileImporter::ObjFileImporter() :
     m_Buffer(),
     m_pRootObject( NULL ),
-    m_strAbsPath( "" )
+    m_strAbsPath( "" ),
+    m_parallel( true ),
+    m_dedupVertices( false ),
+    m_streamWindowSize( 0 ),
+    m_measureTime( false ),
+    m_twoPass( false )
 {
     DefaultIOSystem io;
     m_strAbsPath = io.getOsSeparator();
@@ -107,6 +298,17 @@ bool ObjFileImporter::CanRead( const std::string& pFile, IOSystem*  pIOHandler ,
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+//  Setup configuration properties for the loader
+void ObjFileImporter::SetupProperties(const Importer* pImp)
+{
+    m_parallel = pImp->GetPropertyBool(AI_CONFIG_IMPORT_OBJ_PARALLEL, true);
+    m_dedupVertices = pImp->GetPropertyBool(AI_CONFIG_IMPORT_OBJ_DEDUP_VERTICES, false);
+    m_streamWindowSize = static_cast<unsigned int>( std::max( 0, pImp->GetPropertyInteger(AI_CONFIG_IMPORT_STREAM_WINDOW_SIZE, 0) ) );
+    m_measureTime = 0 != pImp->GetPropertyInteger(AI_CONFIG_GLOB_MEASURE_TIME, 0);
+    m_twoPass = pImp->GetPropertyBool(AI_CONFIG_IMPORT_OBJ_TWO_PASS, false);
+}
+
 // ------------------------------------------------------------------------------------------------
 const aiImporterDesc* ObjFileImporter::GetInfo () const
 {
@@ -129,12 +331,6 @@ void ObjFileImporter::InternReadFile( const std::string &file, aiScene* pScene,
         throw DeadlyImportError( "OBJ-file is too small.");
     }
 
-    IOStreamBuffer<char> streamedBuffer;
-    streamedBuffer.open( fileStream.get() );
-
-    // Allocate buffer and read file into it
-    //TextFileToBuffer( fileStream.get(),m_Buffer);
-
     // Get the model name
     std::string  modelName, folderName;
     std::string::size_type pos = file.find_last_of( "\\/" );
@@ -177,16 +373,114 @@ void ObjFileImporter::InternReadFile( const std::string &file, aiScene* pScene,
         }
     }*/
 
-    // 1/3rd progress
-    m_progress->UpdateFileRead(1, 3);
+    std::unique_ptr<Profiling::Profiler> profiler( m_measureTime ? new Profiling::Profiler() : NULL );
+
+    if ( m_twoPass ) {
+        // count the faces of each mesh, only the vertex data is kept in memory
+        std::unique_ptr<ObjFileParser> parser;
+        {
+            IOStreamBuffer<char> streamedBuffer( m_streamWindowSize ? m_streamWindowSize : 4096 * 4096 );
+            streamedBuffer.open( fileStream.get() );
+
+            // 1/3rd progress
+            m_progress->UpdateFileRead(1, 3);
+
+            if ( profiler ) {
+                profiler->BeginRegion( "OBJ: count faces" );
+            }
+            parser.reset( new ObjFileParser( streamedBuffer, modelName, pIOHandler, m_progress, file, profiler.get(), true ) );
+            if ( profiler ) {
+                profiler->EndRegion( "OBJ: count faces" );
+            }
+            streamedBuffer.close();
+        }
+
+        // create the scene with the preallocated meshes
+        if ( profiler ) {
+            profiler->BeginRegion( "OBJ: create scene" );
+        }
+        m_twoPassMeshes.assign( parser->GetModel()->m_Meshes.size(), NULL );
+        CreateDataFromImport( parser->GetModel(), pScene );
+        if ( profiler ) {
+            profiler->EndRegion( "OBJ: create scene" );
+        }
 
-    // parse the file into a temporary representation
-    ObjFileParser parser( streamedBuffer, modelName, pIOHandler, m_progress, file);
+        // parse the faces again, they are written into the meshes right away
+        if ( profiler ) {
+            profiler->BeginRegion( "OBJ: fill meshes" );
+        }
+        {
+            IOStreamBuffer<char> streamedBuffer( m_streamWindowSize ? m_streamWindowSize : 4096 * 4096 );
+            fileStream->Seek( 0, aiOrigin_SET );
+            streamedBuffer.open( fileStream.get() );
+            MeshFiller filler( parser->GetModel(), m_twoPassMeshes );
+            parser->parseFaces( streamedBuffer, filler );
+            streamedBuffer.close();
+        }
+        if ( profiler ) {
+            profiler->EndRegion( "OBJ: fill meshes" );
+        }
+        m_twoPassMeshes.clear();
+    } else if ( m_parallel ) {
+        // Allocate buffer and read file into it, the parser splits it into chunks
+        if ( profiler ) {
+            profiler->BeginRegion( "OBJ: read file" );
+        }
+        TextFileToBuffer( fileStream.get(), m_Buffer );
+        if ( profiler ) {
+            profiler->EndRegion( "OBJ: read file" );
+        }
 
-    // And create the proper return structures out of it
-    CreateDataFromImport(parser.GetModel(), pScene);
+        // 1/3rd progress
+        m_progress->UpdateFileRead(1, 3);
 
-    streamedBuffer.close();
+        // parse the file into a temporary representation
+        if ( profiler ) {
+            profiler->BeginRegion( "OBJ: parse" );
+        }
+        ObjFileParser parser( m_Buffer, modelName, pIOHandler, m_progress, file, profiler.get() );
+        if ( profiler ) {
+            profiler->EndRegion( "OBJ: parse" );
+        }
+
+        // the model doesn't reference the file data, release it early
+        std::vector<char>().swap( m_Buffer );
+
+        // And create the proper return structures out of it
+        if ( profiler ) {
+            profiler->BeginRegion( "OBJ: create scene" );
+        }
+        CreateDataFromImport(parser.GetModel(), pScene);
+        if ( profiler ) {
+            profiler->EndRegion( "OBJ: create scene" );
+        }
+    } else {
+        IOStreamBuffer<char> streamedBuffer( m_streamWindowSize ? m_streamWindowSize : 4096 * 4096 );
+        streamedBuffer.open( fileStream.get() );
+
+        // 1/3rd progress
+        m_progress->UpdateFileRead(1, 3);
+
+        // parse the file into a temporary representation
+        if ( profiler ) {
+            profiler->BeginRegion( "OBJ: parse" );
+        }
+        ObjFileParser parser( streamedBuffer, modelName, pIOHandler, m_progress, file, profiler.get() );
+        if ( profiler ) {
+            profiler->EndRegion( "OBJ: parse" );
+        }
+
+        // And create the proper return structures out of it
+        if ( profiler ) {
+            profiler->BeginRegion( "OBJ: create scene" );
+        }
+        CreateDataFromImport(parser.GetModel(), pScene);
+        if ( profiler ) {
+            profiler->EndRegion( "OBJ: create scene" );
+        }
+
+        streamedBuffer.close();
+    }
 
     // Clean up allocated storage for the next import
     m_Buffer.clear();
@@ -313,7 +607,7 @@ aiMesh *ObjFileImporter::createTopology( const ObjFile::Model* pModel, const Obj
         return NULL;
     }
 
-    if( pObjMesh->m_Faces.empty() ) {
+    if( 0 == pObjMesh->getNumFaces() ) {
         return NULL;
     }
 
@@ -322,20 +616,36 @@ aiMesh *ObjFileImporter::createTopology( const ObjFile::Model* pModel, const Obj
         pMesh->mName.Set( pObjMesh->m_name );
     }
 
-    for (size_t index = 0; index < pObjMesh->m_Faces.size(); index++)
+    // the faces of the two-pass import are only counted, the second pass fills the mesh
+    if ( m_twoPass ) {
+        pMesh->mNumFaces = pObjMesh->m_uiNumOutFaces;
+        pMesh->mPrimitiveTypes = pObjMesh->m_uiPrimitiveTypes;
+        if ( pMesh->mNumFaces > 0 ) {
+            pMesh->mFaces = new aiFace[ pMesh->mNumFaces ];
+            if ( pObjMesh->m_uiMaterialIndex != ObjFile::Mesh::NoMaterial ) {
+                pMesh->mMaterialIndex = pObjMesh->m_uiMaterialIndex;
+            }
+        }
+        allocateVertexArray( pModel, pObjMesh, pMesh, pObjMesh->m_uiNumOutIndices );
+        m_twoPassMeshes[ meshIndex ] = pMesh;
+        return pMesh;
+    }
+
+    const size_t numFaces = pObjMesh->getNumFaces();
+    for (size_t index = 0; index < numFaces; index++)
     {
-        ObjFile::Face *const inp = pObjMesh->m_Faces[ index ];
-        ai_assert( NULL != inp  );
+        const aiPrimitiveType type = pObjMesh->m_FaceTypes[ index ];
+        const unsigned int numCorners = pObjMesh->getNumCorners( index );
 
-        if (inp->m_PrimitiveType == aiPrimitiveType_LINE) {
-            pMesh->mNumFaces += static_cast<unsigned int>(inp->m_vertices.size() - 1);
+        if (type == aiPrimitiveType_LINE) {
+            pMesh->mNumFaces += numCorners - 1;
             pMesh->mPrimitiveTypes |= aiPrimitiveType_LINE;
-        } else if (inp->m_PrimitiveType == aiPrimitiveType_POINT) {
-            pMesh->mNumFaces += static_cast<unsigned int>(inp->m_vertices.size());
+        } else if (type == aiPrimitiveType_POINT) {
+            pMesh->mNumFaces += numCorners;
             pMesh->mPrimitiveTypes |= aiPrimitiveType_POINT;
         } else {
             ++pMesh->mNumFaces;
-            if (inp->m_vertices.size() > 3) {
+            if (numCorners > 3) {
                 pMesh->mPrimitiveTypes |= aiPrimitiveType_POLYGON;
             } else {
                 pMesh->mPrimitiveTypes |= aiPrimitiveType_TRIANGLE;
@@ -353,18 +663,19 @@ aiMesh *ObjFileImporter::createTopology( const ObjFile::Model* pModel, const Obj
         unsigned int outIndex( 0 );
 
         // Copy all data from all stored meshes
-        for (size_t index = 0; index < pObjMesh->m_Faces.size(); index++) {
-            ObjFile::Face* const inp = pObjMesh->m_Faces[ index ];
-            if (inp->m_PrimitiveType == aiPrimitiveType_LINE) {
-                for(size_t i = 0; i < inp->m_vertices.size() - 1; ++i) {
+        for (size_t index = 0; index < numFaces; index++) {
+            const aiPrimitiveType type = pObjMesh->m_FaceTypes[ index ];
+            const unsigned int numCorners = pObjMesh->getNumCorners( index );
+            if (type == aiPrimitiveType_LINE) {
+                for(size_t i = 0; i < numCorners - 1; ++i) {
                     aiFace& f = pMesh->mFaces[ outIndex++ ];
                     uiIdxCount += f.mNumIndices = 2;
                     f.mIndices = new unsigned int[2];
                 }
                 continue;
             }
-            else if (inp->m_PrimitiveType == aiPrimitiveType_POINT) {
-                for(size_t i = 0; i < inp->m_vertices.size(); ++i) {
+            else if (type == aiPrimitiveType_POINT) {
+                for(size_t i = 0; i < numCorners; ++i) {
                     aiFace& f = pMesh->mFaces[ outIndex++ ];
                     uiIdxCount += f.mNumIndices = 1;
                     f.mIndices = new unsigned int[1];
@@ -373,16 +684,19 @@ aiMesh *ObjFileImporter::createTopology( const ObjFile::Model* pModel, const Obj
             }
 
             aiFace *pFace = &pMesh->mFaces[ outIndex++ ];
-            const unsigned int uiNumIndices = (unsigned int) pObjMesh->m_Faces[ index ]->m_vertices.size();
-            uiIdxCount += pFace->mNumIndices = (unsigned int) uiNumIndices;
+            uiIdxCount += pFace->mNumIndices = numCorners;
             if (pFace->mNumIndices > 0) {
-                pFace->mIndices = new unsigned int[ uiNumIndices ];
+                pFace->mIndices = new unsigned int[ numCorners ];
             }
         }
     }
 
     // Create mesh vertices
-    createVertexArray(pModel, pData, meshIndex, pMesh, uiIdxCount);
+    if ( m_dedupVertices ) {
+        createIndexedVertexArray(pModel, pObjMesh, pMesh);
+    } else {
+        createVertexArray(pModel, pData, meshIndex, pMesh, uiIdxCount);
+    }
 
     return pMesh;
 }
@@ -408,116 +722,130 @@ void ObjFileImporter::createVertexArray(const ObjFile::Model* pModel,
     }
 
     // Copy vertices of this mesh instance
-    pMesh->mNumVertices = numIndices;
-    if (pMesh->mNumVertices == 0) {
-        throw DeadlyImportError( "OBJ: no vertices" );
-    } else if (pMesh->mNumVertices > AI_MAX_ALLOC(aiVector3D)) {
+    allocateVertexArray( pModel, pObjMesh, pMesh, numIndices );
+
+    // Copy vertices, normals and textures into aiMesh instance
+    const bool hasNormalIndices = !pModel->m_Normals.empty() && !pObjMesh->m_NormalIndices.empty();
+    const bool hasTexCoordIndices = !pModel->m_TextureCoord.empty() && !pObjMesh->m_TexCoordIndices.empty();
+    std::vector<unsigned int> corners;
+    unsigned int newIndex = 0, outIndex = 0;
+    for ( size_t index=0; index < pObjMesh->getNumFaces(); index++ ) {
+        // Get source face
+        const unsigned int firstCorner = pObjMesh->m_FaceOffsets[ index ];
+        const unsigned int numCorners = pObjMesh->getNumCorners( index );
+
+        corners.resize( numCorners * 3 );
+        for ( unsigned int i = 0; i < numCorners; i++ ) {
+            const unsigned int corner = firstCorner + i;
+            corners[ i * 3 ] = pObjMesh->m_VertexIndices[ corner ];
+            corners[ i * 3 + 1 ] = hasTexCoordIndices ? pObjMesh->m_TexCoordIndices[ corner ] : ObjFile::Mesh::NoIndex;
+            corners[ i * 3 + 2 ] = hasNormalIndices ? pObjMesh->m_NormalIndices[ corner ] : ObjFile::Mesh::NoIndex;
+        }
+        fillFace( pModel, pMesh, pObjMesh->m_FaceTypes[ index ], &corners[ 0 ], numCorners, newIndex, outIndex );
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+//  Creates a vertex array with one vertex per distinct (v, vt, vn) triplet
+void ObjFileImporter::createIndexedVertexArray(const ObjFile::Model* pModel,
+                                               const ObjFile::Mesh* pObjMesh,
+                                               aiMesh* pMesh) {
+    if ( pObjMesh->m_uiNumIndices < 1 || 0 == pMesh->mNumFaces ) {
+        return;
+    }
+
+    const bool hasNormals = !pModel->m_Normals.empty() && pObjMesh->m_hasNormals;
+    const bool hasTexCoords = !pModel->m_TextureCoord.empty() && pObjMesh->m_uiUVCoordinates[0];
+
+    // Assign an output vertex to each face corner, in order of first use
+    const size_t numCorners = pObjMesh->m_VertexIndices.size();
+    std::vector<unsigned int> remap( numCorners );
+    std::vector<unsigned int> firstCorner;
+    std::unordered_map<CornerKey, unsigned int, CornerKeyHash> corners;
+    corners.reserve( numCorners );
+    for ( size_t corner = 0; corner < numCorners; ++corner ) {
+        CornerKey key;
+        key.m_Indices[ 0 ] = pObjMesh->m_VertexIndices[ corner ];
+        key.m_Indices[ 1 ] = hasTexCoords ? pObjMesh->m_TexCoordIndices[ corner ] : ObjFile::Mesh::NoIndex;
+        key.m_Indices[ 2 ] = hasNormals ? pObjMesh->m_NormalIndices[ corner ] : ObjFile::Mesh::NoIndex;
+
+        const unsigned int next = static_cast<unsigned int>( firstCorner.size() );
+        const std::pair<std::unordered_map<CornerKey, unsigned int, CornerKeyHash>::iterator, bool> res =
+            corners.insert( std::make_pair( key, next ) );
+        if ( res.second ) {
+            firstCorner.push_back( static_cast<unsigned int>( corner ) );
+        }
+        remap[ corner ] = res.first->second;
+    }
+
+    pMesh->mNumVertices = static_cast<unsigned int>( firstCorner.size() );
+    if ( pMesh->mNumVertices > AI_MAX_ALLOC(aiVector3D) ) {
         throw DeadlyImportError( "OBJ: Too many vertices, would run out of memory" );
     }
     pMesh->mVertices = new aiVector3D[ pMesh->mNumVertices ];
-
-    // Allocate buffer for normal vectors
-    if ( !pModel->m_Normals.empty() && pObjMesh->m_hasNormals )
+    if ( hasNormals ) {
         pMesh->mNormals = new aiVector3D[ pMesh->mNumVertices ];
-
-    // Allocate buffer for vertex-color vectors
-    if ( !pModel->m_VertexColors.empty() )
+    }
+    if ( !pModel->m_VertexColors.empty() ) {
         pMesh->mColors[0] = new aiColor4D[ pMesh->mNumVertices ];
-
-    // Allocate buffer for texture coordinates
-    if ( !pModel->m_TextureCoord.empty() && pObjMesh->m_uiUVCoordinates[0] )
-    {
+    }
+    if ( hasTexCoords ) {
         pMesh->mNumUVComponents[ 0 ] = 2;
         pMesh->mTextureCoords[ 0 ] = new aiVector3D[ pMesh->mNumVertices ];
     }
 
     // Copy vertices, normals and textures into aiMesh instance
-    unsigned int newIndex = 0, outIndex = 0;
-    for ( size_t index=0; index < pObjMesh->m_Faces.size(); index++ ) {
-        // Get source face
-        ObjFile::Face *pSourceFace = pObjMesh->m_Faces[ index ];
-
-        // Copy all index arrays
-        for ( size_t vertexIndex = 0, outVertexIndex = 0; vertexIndex < pSourceFace->m_vertices.size(); vertexIndex++ ) {
-            const unsigned int vertex = pSourceFace->m_vertices.at( vertexIndex );
-            if ( vertex >= pModel->m_Vertices.size() ) {
-                throw DeadlyImportError( "OBJ: vertex index out of range" );
-            }
-
-            pMesh->mVertices[ newIndex ] = pModel->m_Vertices[ vertex ];
-
-            // Copy all normals
-            if ( !pModel->m_Normals.empty() && vertexIndex < pSourceFace->m_normals.size()) {
-                const unsigned int normal = pSourceFace->m_normals.at( vertexIndex );
-                if ( normal >= pModel->m_Normals.size() ) {
-                    throw DeadlyImportError( "OBJ: vertex normal index out of range" );
-                }
-                pMesh->mNormals[ newIndex ] = pModel->m_Normals[ normal ];
-            }
+    for ( unsigned int newIndex = 0; newIndex < pMesh->mNumVertices; ++newIndex ) {
+        const unsigned int corner = firstCorner[ newIndex ];
+        const unsigned int vertex = pObjMesh->m_VertexIndices[ corner ];
+        if ( vertex >= pModel->m_Vertices.size() ) {
+            throw DeadlyImportError( "OBJ: vertex index out of range" );
+        }
+        pMesh->mVertices[ newIndex ] = pModel->m_Vertices[ vertex ];
 
-            // Copy all vertex colors
-            if ( !pModel->m_VertexColors.empty())
-            {
-                const aiVector3D color = pModel->m_VertexColors[ vertex ];
-                pMesh->mColors[0][ newIndex ] = aiColor4D(color.x, color.y, color.z, 1.0);
+        if ( hasNormals && pObjMesh->m_NormalIndices[ corner ] != ObjFile::Mesh::NoIndex ) {
+            const unsigned int normal = pObjMesh->m_NormalIndices[ corner ];
+            if ( normal >= pModel->m_Normals.size() ) {
+                throw DeadlyImportError( "OBJ: vertex normal index out of range" );
             }
+            pMesh->mNormals[ newIndex ] = pModel->m_Normals[ normal ];
+        }
 
-            // Copy all texture coordinates
-            if ( !pModel->m_TextureCoord.empty() && vertexIndex < pSourceFace->m_texturCoords.size())
-            {
-                const unsigned int tex = pSourceFace->m_texturCoords.at( vertexIndex );
-                ai_assert( tex < pModel->m_TextureCoord.size() );
-
-                if ( tex >= pModel->m_TextureCoord.size() )
-                    throw DeadlyImportError("OBJ: texture coordinate index out of range");
-
-                const aiVector3D &coord3d = pModel->m_TextureCoord[ tex ];
-                pMesh->mTextureCoords[ 0 ][ newIndex ] = aiVector3D( coord3d.x, coord3d.y, coord3d.z );
-            }
+        if ( vertex < pModel->m_VertexColors.size() ) {
+            const aiVector3D color = pModel->m_VertexColors[ vertex ];
+            pMesh->mColors[0][ newIndex ] = aiColor4D(color.x, color.y, color.z, 1.0);
+        }
 
-            if ( pMesh->mNumVertices <= newIndex ) {
-                throw DeadlyImportError("OBJ: bad vertex index");
+        if ( hasTexCoords && pObjMesh->m_TexCoordIndices[ corner ] != ObjFile::Mesh::NoIndex ) {
+            const unsigned int tex = pObjMesh->m_TexCoordIndices[ corner ];
+            if ( tex >= pModel->m_TextureCoord.size() ) {
+                throw DeadlyImportError("OBJ: texture coordinate index out of range");
             }
+            pMesh->mTextureCoords[ 0 ][ newIndex ] = pModel->m_TextureCoord[ tex ];
+        }
+    }
 
-            // Get destination face
-            aiFace *pDestFace = &pMesh->mFaces[ outIndex ];
-
-            const bool last = ( vertexIndex == pSourceFace->m_vertices.size() - 1 );
-            if (pSourceFace->m_PrimitiveType != aiPrimitiveType_LINE || !last) {
-                pDestFace->mIndices[ outVertexIndex ] = newIndex;
-                outVertexIndex++;
+    // Write the face indices, lines and points share the vertices of their corners
+    unsigned int outIndex = 0;
+    for ( size_t index = 0; index < pObjMesh->getNumFaces(); ++index ) {
+        const aiPrimitiveType type = pObjMesh->m_FaceTypes[ index ];
+        const unsigned int first = pObjMesh->m_FaceOffsets[ index ];
+        const unsigned int num = pObjMesh->getNumCorners( index );
+        if ( type == aiPrimitiveType_LINE ) {
+            for ( unsigned int i = 0; i + 1 < num; ++i ) {
+                aiFace &face = pMesh->mFaces[ outIndex++ ];
+                face.mIndices[ 0 ] = remap[ first + i ];
+                face.mIndices[ 1 ] = remap[ first + i + 1 ];
             }
-
-            if (pSourceFace->m_PrimitiveType == aiPrimitiveType_POINT) {
-                outIndex++;
-                outVertexIndex = 0;
-            } else if (pSourceFace->m_PrimitiveType == aiPrimitiveType_LINE) {
-                outVertexIndex = 0;
-
-                if(!last)
-                    outIndex++;
-
-                if (vertexIndex) {
-                    if(!last) {
-                        pMesh->mVertices[ newIndex+1 ] = pMesh->mVertices[ newIndex ];
-                        if ( !pSourceFace->m_normals.empty() && !pModel->m_Normals.empty()) {
-                            pMesh->mNormals[ newIndex+1 ] = pMesh->mNormals[newIndex ];
-                        }
-                        if ( !pModel->m_TextureCoord.empty() ) {
-                            for ( size_t i=0; i < pMesh->GetNumUVChannels(); i++ ) {
-                                pMesh->mTextureCoords[ i ][ newIndex+1 ] = pMesh->mTextureCoords[ i ][ newIndex ];
-                            }
-                        }
-                        ++newIndex;
-                    }
-
-                    pDestFace[-1].mIndices[1] = newIndex;
-                }
+        } else if ( type == aiPrimitiveType_POINT ) {
+            for ( unsigned int i = 0; i < num; ++i ) {
+                pMesh->mFaces[ outIndex++ ].mIndices[ 0 ] = remap[ first + i ];
             }
-            else if (last) {
-                outIndex++;
+        } else {
+            aiFace &face = pMesh->mFaces[ outIndex++ ];
+            for ( unsigned int i = 0; i < num; ++i ) {
+                face.mIndices[ i ] = remap[ first + i ];
             }
-            ++newIndex;
         }
     }
 }
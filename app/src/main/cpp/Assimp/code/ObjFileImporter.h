@@ -52,6 +52,7 @@ namespace Assimp {
 
 namespace ObjFile {
     struct Object;
+    struct Mesh;
     struct Model;
 }
 
@@ -72,6 +73,9 @@ public:
     /// \remark See BaseImporter::CanRead() for details.
     bool CanRead( const std::string& pFile, IOSystem* pIOHandler, bool checkSig) const;
 
+    /// \brief  Updates the importer configuration, see BaseImporter::SetupProperties().
+    void SetupProperties(const Importer* pImp);
+
 private:
     //! \brief  Appends the supported extension.
     const aiImporterDesc* GetInfo () const;
@@ -94,6 +98,10 @@ private:
     void createVertexArray(const ObjFile::Model* pModel, const ObjFile::Object* pCurrentObject,
         unsigned int uiMeshIndex, aiMesh* pMesh, unsigned int numIndices );
 
+    //! \brief  Creates vertices from model, sharing vertices between corners with equal indices.
+    void createIndexedVertexArray(const ObjFile::Model* pModel, const ObjFile::Mesh* pObjMesh,
+        aiMesh* pMesh );
+
     //! \brief  Object counter helper method.
     void countObjects(const std::vector<ObjFile::Object*> &rObjects, int &iNumMeshes);
 
@@ -113,6 +121,18 @@ private:
     ObjFile::Object *m_pRootObject;
     //! Absolute pathname of model in file system
     std::string m_strAbsPath;
+    //! Parse the file in memory in parallel chunks
+    bool m_parallel;
+    //! Share vertices between face corners with equal indices
+    bool m_dedupVertices;
+    //! Window size of the streaming parser, 0 for the default
+    unsigned int m_streamWindowSize;
+    //! Log the timings of the import stages, see AI_CONFIG_GLOB_MEASURE_TIME
+    bool m_measureTime;
+    //! Count the faces first and fill the meshes in a second pass, see AI_CONFIG_IMPORT_OBJ_TWO_PASS
+    bool m_twoPass;
+    //! Meshes of the two-pass import by mesh index of the model, filled by the second pass
+    std::vector<aiMesh*> m_twoPassMeshes;
 };
 
 // ------------------------------------------------------------------------------------------------
@@ -51,12 +51,377 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/DefaultLogger.hpp>
 #include <assimp/material.h>
 #include <assimp/Importer.hpp>
+#include "ParallelHelper.h"
+#include "Profiler.h"
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 
 namespace Assimp {
 
 const std::string ObjFileParser::DEFAULT_MATERIAL = AI_DEFAULT_MATERIAL_NAME;
 
+const unsigned int ObjFile::Mesh::NoIndex;
+
+static const std::string DefaultObjName = "defaultobject";
+
+namespace ObjFile {
+
+// ------------------------------------------------------------------------------------------------
+//! \struct Chunk
+//! \brief  Data parsed from a line-aligned part of an obj file, merged into the model in file order
+// ------------------------------------------------------------------------------------------------
+struct Chunk {
+    //! A statement which needs the model state, it is replayed during the merge
+    struct Statement {
+        unsigned int m_Face;
+        std::string m_Line;
+    };
+    //! Chunk-local element counts for a face with negative indices
+    struct Relative {
+        unsigned int m_Face;
+        unsigned int m_Counts[ 3 ];
+    };
+
+    const char *m_Begin;
+    const char *m_End;
+    std::vector<aiVector3D> m_Vertices;
+    std::vector<aiVector3D> m_VertexColors;
+    std::vector<aiVector3D> m_TextureCoord;
+    std::vector<aiVector3D> m_Normals;
+    std::vector<aiPrimitiveType> m_FaceTypes;
+    std::vector<unsigned int> m_FaceOffsets;
+    //! Raw (vertex, texture coordinate, normal) triplets, 0 marks a missing component
+    std::vector<int> m_Corners;
+    std::vector<Relative> m_Relative;
+    std::vector<Statement> m_Statements;
+    std::vector<std::string> m_Errors;
+    //! Set if a face corner can only be resolved with the data of previous chunks
+    bool m_Ambiguous;
+    //! Message of the fatal error which stopped the parsing
+    std::string m_Fatal;
+
+    Chunk( const char *begin, const char *end )
+    : m_Begin( begin )
+    , m_End( end )
+    , m_FaceOffsets( 1, 0u )
+    , m_Ambiguous( false ) {
+        // empty
+    }
+};
+
+} // Namespace ObjFile
+
+namespace {
+
+// Approximate size of a chunk of the in-memory parser
+const size_t ChunkSize = 1024 * 1024;
+
+// Number of chunks which are parsed in parallel before they are merged
+const unsigned int ChunksPerBatch = 16;
+
+// How a single slash after the vertex index of a face corner is interpreted
+enum SlashMode {
+    Slash_TexCoord,     // "v/vt", the model has texture coordinates
+    Slash_Normal,       // "v/vn", the model has normals but no texture coordinates
+    Slash_Unknown       // depends on data which is not known yet
+};
+
+// ------------------------------------------------------------------------------------------------
+//  Returns the next '\n' in [it, end) or end, memchr is vectorized by the C library.
+inline const char *findNewLine( const char *it, const char *end ) {
+    const char *nl = static_cast<const char*>( ::memchr( it, '\n', end - it ) );
+    return nl ? nl : end;
+}
+
+// ------------------------------------------------------------------------------------------------
+//  Returns true, if the physical line [begin, nl) ends with a continuation token.
+inline bool isContinuedLine( const char *begin, const char *nl ) {
+    while ( nl != begin && nl[ -1 ] == '\r' ) {
+        --nl;
+    }
+    return nl != begin && nl[ -1 ] == '\\';
+}
+
+// ------------------------------------------------------------------------------------------------
+//  Returns the number of numeric tokens in the rest of the line.
+size_t countComponents( const char *it, const char *end ) {
+    size_t numComponents( 0 );
+    for ( ;; ) {
+        while ( it != end && IsSpace( *it ) ) {
+            ++it;
+        }
+        if ( it == end || IsLineEnd( *it ) ) {
+            break;
+        }
+        if ( IsNumeric( *it ) ) {
+            ++numComponents;
+        }
+        while ( it != end && !IsSpaceOrNewLine( *it ) ) {
+            ++it;
+        }
+    }
+    return numComponents;
+}
+
+// ------------------------------------------------------------------------------------------------
+//  Reads the next whitespace separated token of the line as a real.
+ai_real readReal( const char *&it, const char *end ) {
+    ai_real value = 0;
+    while ( it != end && IsSpace( *it ) ) {
+        ++it;
+    }
+    if ( it == end || IsLineEnd( *it ) ) {
+        return value;
+    }
+    it = fast_atoreal_move<ai_real>( it, value );
+    while ( it != end && !IsSpaceOrNewLine( *it ) ) {
+        ++it;
+    }
+    return value;
+}
+
+// ------------------------------------------------------------------------------------------------
+//  Reads the numeric tokens of the rest of the line into values, which are zeroed first. Returns
+//  the number of numeric tokens, which may exceed maxValues.
+size_t readComponents( const char *&it, const char *end, ai_real *values, size_t maxValues ) {
+    std::fill( values, values + maxValues, ai_real( 0.0 ) );
+
+    // common case: the line holds nothing but plain numbers
+    const char *next;
+    const size_t numComponents = fast_atoreal_n<ai_real>( it, end, values, maxValues, &next );
+    const char *rest = next;
+    while ( rest != end && IsSpace( *rest ) ) {
+        ++rest;
+    }
+    if ( rest == end || IsLineEnd( *rest ) ) {
+        it = next;
+        return numComponents;
+    }
+
+    std::fill( values, values + maxValues, ai_real( 0.0 ) );
+    const size_t count = countComponents( it, end );
+    for ( size_t i = 0; i < count && i < maxValues; ++i ) {
+        values[ i ] = readReal( it, end );
+    }
+    return count;
+}
+
+// ------------------------------------------------------------------------------------------------
+//  Splits a face, line or point statement into raw (vertex, texture coordinate, normal) triplets,
+//  0 marks a missing component. Returns false for an invalid index.
+bool tokenizeFace( const char *it, const char *end, aiPrimitiveType type, SlashMode mode,
+        std::vector<int> &corners, std::vector<std::string> &errors, bool &ambiguous ) {
+    corners.clear();
+
+    // skip the statement keyword
+    while ( it != end && !IsSpaceOrNewLine( *it ) ) {
+        ++it;
+    }
+
+    int pos = 0;
+    while ( it != end && !IsLineEnd( *it ) ) {
+        if ( *it == '/' ) {
+            if ( type == aiPrimitiveType_POINT ) {
+                errors.push_back( "Obj: Separator unexpected in point statement" );
+            }
+            if ( 0 == pos && it + 1 != end && it[ 1 ] != '/' ) {
+                if ( Slash_Normal == mode ) {
+                    // there are no texture coordinates in the file, but normals
+                    ++pos;
+                    if ( !IsLineEnd( it[ 1 ] ) ) {
+                        ++it;
+                    }
+                } else if ( Slash_Unknown == mode ) {
+                    ambiguous = true;
+                }
+            }
+            ++pos;
+            ++it;
+        } else if ( IsSpace( *it ) ) {
+            pos = 0;
+            ++it;
+        } else {
+            //OBJ USES 1 Base ARRAYS!!!!
+            const bool negative = ( *it == '-' );
+            if ( negative || *it == '+' ) {
+                ++it;
+            }
+            int value = 0;
+            while ( it != end && *it >= '0' && *it <= '9' ) {
+                value = value * 10 + ( *it - '0' );
+                ++it;
+            }
+            if ( 0 == value ) {
+                return false;
+            }
+            if ( pos > 2 ) {
+                errors.push_back( "OBJ: Not supported token in face description detected" );
+                break;
+            }
+            if ( 0 == pos ) {
+                corners.push_back( negative ? -value : value );
+                corners.push_back( 0 );
+                corners.push_back( 0 );
+            } else if ( !corners.empty() ) {
+                corners[ corners.size() - 3 + pos ] = negative ? -value : value;
+            }
+        }
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+//  Resolves a raw 1-based or relative obj index, count is the number of elements known so far.
+inline unsigned int resolveIndex( int value, unsigned int count ) {
+    if ( value > 0 ) {
+        return static_cast<unsigned int>( value - 1 );
+    } else if ( value < 0 ) {
+        return static_cast<unsigned int>( static_cast<int>( count ) + value );
+    }
+    return ObjFile::Mesh::NoIndex;
+}
+
+// ------------------------------------------------------------------------------------------------
+//  Parses one line of a chunk, returns false after a fatal error.
+bool parseChunkLine( ObjFile::Chunk &chunk, const char *it, const char *end, std::vector<int> &corners ) {
+    if ( it == end ) {
+        return true;
+    }
+
+    switch ( *it ) {
+    case 'v':
+        ++it;
+        if ( it == end ) {
+            break;
+        }
+        if ( *it == ' ' || *it == '\t' ) {
+            ai_real v[ 6 ];
+            const size_t numComponents = readComponents( it, end, v, 6 );
+            if ( 3 == numComponents || 6 == numComponents ) {
+                chunk.m_Vertices.push_back( aiVector3D( v[ 0 ], v[ 1 ], v[ 2 ] ) );
+                if ( 6 == numComponents ) {
+                    // vertex and vertex-color
+                    chunk.m_VertexColors.push_back( aiVector3D( v[ 3 ], v[ 4 ], v[ 5 ] ) );
+                }
+            } else if ( 4 == numComponents ) {
+                // homogeneous coords
+                const ai_real w = v[ 3 ];
+                ai_assert( w != 0 );
+                chunk.m_Vertices.push_back( aiVector3D( v[ 0 ] / w, v[ 1 ] / w, v[ 2 ] / w ) );
+            }
+        } else if ( *it == 't' ) {
+            ++it;
+            ai_real v[ 3 ];
+            const size_t numComponents = readComponents( it, end, v, 3 );
+            if ( 2 != numComponents && 3 != numComponents ) {
+                chunk.m_Fatal = "OBJ: Invalid number of components";
+                return false;
+            }
+            chunk.m_TextureCoord.push_back( aiVector3D( v[ 0 ], v[ 1 ], v[ 2 ] ) );
+        } else if ( *it == 'n' ) {
+            ++it;
+            ai_real v[ 3 ];
+            readComponents( it, end, v, 3 );
+            chunk.m_Normals.push_back( aiVector3D( v[ 0 ], v[ 1 ], v[ 2 ] ) );
+        }
+        break;
+
+    case 'p':
+    case 'l':
+    case 'f':
+        {
+            const aiPrimitiveType type = *it == 'f' ? aiPrimitiveType_POLYGON : ( *it == 'l'
+                ? aiPrimitiveType_LINE : aiPrimitiveType_POINT );
+            const SlashMode mode = chunk.m_TextureCoord.empty() ? Slash_Unknown : Slash_TexCoord;
+            if ( !tokenizeFace( it, end, type, mode, corners, chunk.m_Errors, chunk.m_Ambiguous ) ) {
+                chunk.m_Fatal = "OBJ: Invalid face indice";
+                return false;
+            }
+            if ( corners.empty() ) {
+                chunk.m_Errors.push_back( "Obj: Ignoring empty face" );
+                break;
+            }
+
+            const unsigned int face = static_cast<unsigned int>( chunk.m_FaceTypes.size() );
+            for ( size_t i = 0; i < corners.size(); ++i ) {
+                if ( corners[ i ] < 0 ) {
+                    ObjFile::Chunk::Relative relative;
+                    relative.m_Face = face;
+                    relative.m_Counts[ 0 ] = static_cast<unsigned int>( chunk.m_Vertices.size() );
+                    relative.m_Counts[ 1 ] = static_cast<unsigned int>( chunk.m_TextureCoord.size() );
+                    relative.m_Counts[ 2 ] = static_cast<unsigned int>( chunk.m_Normals.size() );
+                    chunk.m_Relative.push_back( relative );
+                    break;
+                }
+            }
+            chunk.m_Corners.insert( chunk.m_Corners.end(), corners.begin(), corners.end() );
+            chunk.m_FaceTypes.push_back( type );
+            chunk.m_FaceOffsets.push_back( static_cast<unsigned int>( chunk.m_Corners.size() / 3 ) );
+        }
+        break;
+
+    case 'u': // material, material library, group and object statements change the model state
+    case 'm':
+    case 'g':
+    case 'o':
+        {
+            while ( end != it && end[ -1 ] == '\r' ) {
+                --end;
+            }
+            ObjFile::Chunk::Statement statement;
+            statement.m_Face = static_cast<unsigned int>( chunk.m_FaceTypes.size() );
+            statement.m_Line.assign( it, end );
+            chunk.m_Statements.push_back( statement );
+        }
+        break;
+
+    default: // comments, smoothing groups and unsupported statements
+        break;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+//  Parses all lines of a chunk, continuation lines are joined in a scratch buffer.
+void parseChunk( ObjFile::Chunk &chunk ) {
+    std::vector<int> corners;
+    std::string joined;
+    const char *it = chunk.m_Begin;
+    while ( it < chunk.m_End ) {
+        const char *nl = findNewLine( it, chunk.m_End );
+        bool ok;
+        if ( !isContinuedLine( it, nl ) ) {
+            ok = parseChunkLine( chunk, it, nl, corners );
+        } else {
+            joined.clear();
+            for ( ;; ) {
+                const bool continued = isContinuedLine( it, nl );
+                const char *last = nl;
+                if ( continued ) {
+                    while ( last[ -1 ] == '\r' ) {
+                        --last;
+                    }
+                    --last;
+                }
+                joined.append( it, last );
+                if ( !continued || nl == chunk.m_End ) {
+                    break;
+                }
+                it = nl + 1;
+                nl = findNewLine( it, chunk.m_End );
+            }
+            ok = parseChunkLine( chunk, joined.c_str(), joined.c_str() + joined.size(), corners );
+        }
+        if ( !ok ) {
+            return;
+        }
+        it = nl + 1;
+    }
+}
+
+} // Namespace
+
 ObjFileParser::ObjFileParser()
 : m_DataIt()
 , m_DataItEnd()
@@ -64,51 +429,92 @@ ObjFileParser::ObjFileParser()
 , m_uiLine( 0 )
 , m_pIO( nullptr )
 , m_progress( nullptr )
-, m_originalObjFileName() {
+, m_originalObjFileName()
+, m_profiler( NULL )
+, m_countFaces( false )
+, m_numFaces( 0 ) {
     // empty
 }
 
 ObjFileParser::ObjFileParser( IOStreamBuffer<char> &streamBuffer, const std::string &modelName,
                               IOSystem *io, ProgressHandler* progress,
-                              const std::string &originalObjFileName) :
+                              const std::string &originalObjFileName,
+                              Profiling::Profiler* profiler, bool countFacesOnly ) :
     m_DataIt(),
     m_DataItEnd(),
     m_pModel(NULL),
     m_uiLine(0),
     m_pIO( io ),
     m_progress(progress),
-    m_originalObjFileName(originalObjFileName)
+    m_originalObjFileName(originalObjFileName),
+    m_profiler(profiler),
+    m_countFaces(countFacesOnly),
+    m_numFaces(0)
 {
     std::fill_n(m_buffer,Buffersize,0);
 
     // Create the model instance to store all the data
-    m_pModel = new ObjFile::Model();
-    m_pModel->m_ModelName = modelName;
-
-    // create default material and store it
-    m_pModel->m_pDefaultMaterial = new ObjFile::Material;
-    m_pModel->m_pDefaultMaterial->MaterialName.Set( DEFAULT_MATERIAL );
-    m_pModel->m_MaterialLib.push_back( DEFAULT_MATERIAL );
-    m_pModel->m_MaterialMap[ DEFAULT_MATERIAL ] = m_pModel->m_pDefaultMaterial;
+    createModel( modelName );
 
     // Start parsing the file
     parseFile( streamBuffer );
 }
 
+ObjFileParser::ObjFileParser( std::vector<char> &buffer, const std::string &modelName,
+                              IOSystem *io, ProgressHandler* progress,
+                              const std::string &originalObjFileName,
+                              Profiling::Profiler* profiler ) :
+    m_DataIt(),
+    m_DataItEnd(),
+    m_pModel(NULL),
+    m_uiLine(0),
+    m_pIO( io ),
+    m_progress(progress),
+    m_originalObjFileName(originalObjFileName),
+    m_profiler(profiler),
+    m_countFaces(false),
+    m_numFaces(0)
+{
+    std::fill_n(m_buffer,Buffersize,0);
+
+    // Create the model instance to store all the data
+    createModel( modelName );
+
+    // Start parsing the file
+    try {
+        parseBuffer( buffer );
+    } catch ( ... ) {
+        delete m_pModel;
+        m_pModel = NULL;
+        throw;
+    }
+}
+
 ObjFileParser::~ObjFileParser() {
     delete m_pModel;
     m_pModel = NULL;
 }
 
 void ObjFileParser::setBuffer( std::vector<char> &buffer ) {
-    m_DataIt = buffer.begin();
-    m_DataItEnd = buffer.end();
+    m_DataIt = buffer.empty() ? NULL : &buffer[ 0 ];
+    m_DataItEnd = m_DataIt + buffer.size();
 }
 
 ObjFile::Model *ObjFileParser::GetModel() const {
     return m_pModel;
 }
 
+void ObjFileParser::createModel( const std::string &modelName ) {
+    m_pModel = new ObjFile::Model();
+    m_pModel->m_ModelName = modelName;
+
+    // create default material and store it
+    m_pModel->m_pDefaultMaterial = new ObjFile::Material;
+    m_pModel->m_pDefaultMaterial->MaterialName.Set( DEFAULT_MATERIAL );
+    m_pModel->m_MaterialLib.push_back( DEFAULT_MATERIAL );
+    m_pModel->m_MaterialMap[ DEFAULT_MATERIAL ] = m_pModel->m_pDefaultMaterial;
+}
+
 void ObjFileParser::parseFile( IOStreamBuffer<char> &streamBuffer ) {
     // only update every 100KB or it'll be too slow
     //const unsigned int updateProgressEveryBytes = 100 * 1024;
@@ -119,10 +525,18 @@ void ObjFileParser::parseFile( IOStreamBuffer<char> &streamBuffer ) {
     unsigned int processed = 0;
     size_t lastFilePos( 0 );
 
-    std::vector<char> buffer;
-    while ( streamBuffer.getNextDataLine( buffer, '\\' ) ) {
-        m_DataIt = buffer.begin();
-        m_DataItEnd = buffer.end();
+    // the lines are parsed right in the window of the stream buffer
+    IOStreamBuffer<char>::LineView line;
+    bool firstLine = true;
+    while ( streamBuffer.getNextDataLineView( line, '\\' ) ) {
+        // like the lines parsed from memory, the line end is followed by one more element
+        m_DataIt = line.begin;
+        m_DataItEnd = line.end + 1;
+        if ( firstLine && line.size() >= 3 && 0 == ::memcmp( line.begin, "\xEF\xBB\xBF", 3 ) ) {
+            // skip the UTF-8 byte order mark, the in-memory parser gets the converted text
+            m_DataIt += 3;
+        }
+        firstLine = false;
 
         // Handle progress reporting
         const size_t filePos( streamBuffer.getFilePos() );
@@ -133,111 +547,353 @@ void ObjFileParser::parseFile( IOStreamBuffer<char> &streamBuffer ) {
             m_progress->UpdateFileRead( progressOffset + processed * 2, progressTotal );
         }
 
-        // parse line
-        switch (*m_DataIt) {
-        case 'v': // Parse a vertex texture coordinate
-            {
-                ++m_DataIt;
-                if (*m_DataIt == ' ' || *m_DataIt == '\t') {
-                    size_t numComponents = getNumComponentsInDataDefinition();
-                    if (numComponents == 3) {
-                        // read in vertex definition
-                        getVector3(m_pModel->m_Vertices);
-                    } else if (numComponents == 4) {
-                        // read in vertex definition (homogeneous coords)
-                        getHomogeneousVector3(m_pModel->m_Vertices);
-                    } else if (numComponents == 6) {
-                        // read vertex and vertex-color
-                        getTwoVectors3(m_pModel->m_Vertices, m_pModel->m_VertexColors);
-                    }
-                } else if (*m_DataIt == 't') {
-                    // read in texture coordinate ( 2D or 3D )
-                    ++m_DataIt;
-                    getVector( m_pModel->m_TextureCoord );
-                } else if (*m_DataIt == 'n') {
-                    // Read in normal vector definition
-                    ++m_DataIt;
-                    getVector3( m_pModel->m_Normals );
-                }
+        parseLine();
+    }
+}
+
+void ObjFileParser::parseFaces( IOStreamBuffer<char> &streamBuffer, FaceSink &sink ) {
+    ai_assert( m_countFaces );
+
+    // the element counts at each statement give the slash mode and resolve negative indices
+    unsigned int counts[ 3 ] = { 0, 0, 0 };
+    unsigned int face = 0, mesh = 0;
+    size_t nextRun = 0;
+    std::vector<std::string> errors;
+    std::vector<aiVector3D> vertices, colors;
+
+    IOStreamBuffer<char>::LineView line;
+    bool firstLine = true;
+    while ( streamBuffer.getNextDataLineView( line, '\\' ) ) {
+        m_DataIt = line.begin;
+        m_DataItEnd = line.end + 1;
+        if ( firstLine && line.size() >= 3 && 0 == ::memcmp( line.begin, "\xEF\xBB\xBF", 3 ) ) {
+            m_DataIt += 3;
+        }
+        firstLine = false;
+
+        switch ( *m_DataIt ) {
+        case 'v': // only the elements stored by parseLine() are counted
+            ++m_DataIt;
+            if ( *m_DataIt == ' ' || *m_DataIt == '\t' ) {
+                // read like in the first pass, so both passes agree on the vertices
+                vertices.clear();
+                colors.clear();
+                getVertex( vertices, colors );
+                counts[ 0 ] += static_cast<unsigned int>( vertices.size() );
+            } else if ( *m_DataIt == 't' ) {
+                ++counts[ 1 ];
+            } else if ( *m_DataIt == 'n' ) {
+                ++counts[ 2 ];
             }
             break;
 
-        case 'p': // Parse a face, line or point statement
+        case 'p':
         case 'l':
         case 'f':
             {
-                getFace(*m_DataIt == 'f' ? aiPrimitiveType_POLYGON : (*m_DataIt == 'l'
-                    ? aiPrimitiveType_LINE : aiPrimitiveType_POINT));
+                const aiPrimitiveType type = *m_DataIt == 'f' ? aiPrimitiveType_POLYGON : ( *m_DataIt == 'l'
+                    ? aiPrimitiveType_LINE : aiPrimitiveType_POINT );
+
+                // the first pass has reported the errors already
+                bool ambiguous = false;
+                errors.clear();
+                if ( !tokenizeFace( m_DataIt, m_DataItEnd, type, ( 0 == counts[ 1 ] && 0 != counts[ 2 ] ) ? Slash_Normal : Slash_TexCoord,
+                        m_rawCorners, errors, ambiguous ) ) {
+                    throw DeadlyImportError( "OBJ: Invalid face indice" );
+                }
+                if ( m_rawCorners.empty() ) {
+                    break;
+                }
+
+                m_corners.resize( m_rawCorners.size() );
+                for ( size_t i = 0; i < m_rawCorners.size(); ++i ) {
+                    m_corners[ i ] = resolveIndex( m_rawCorners[ i ], counts[ i % 3 ] );
+                }
+                for ( ; nextRun < m_meshRuns.size() && m_meshRuns[ nextRun ].m_Face == face; ++nextRun ) {
+                    mesh = m_meshRuns[ nextRun ].m_Mesh;
+                }
+                if ( face++ >= m_numFaces ) {
+                    throw DeadlyImportError( "OBJ: File changed between the two passes" );
+                }
+                sink.addFace( mesh, type, &m_corners[ 0 ], static_cast<unsigned int>( m_corners.size() / 3 ) );
             }
             break;
 
-        case '#': // Parse a comment
-            {
-                getComment();
+        default:
+            break;
+        }
+    }
+}
+
+void ObjFileParser::parseBuffer( std::vector<char> &buffer ) {
+    // the buffer is zero-terminated, which keeps the look-ahead of the number parsing in bounds
+    if ( buffer.size() < 2 ) {
+        return;
+    }
+    const char *begin = &buffer[ 0 ];
+    const char *end = begin + buffer.size() - 1;
+
+    // files with other line ends than '\n' can't be split with a newline search
+    if ( findNewLine( begin, end ) == end ) {
+        parseLines( begin, end );
+        return;
+    }
+
+    // Split the file into line-aligned chunks
+    std::vector<const char*> bounds( 1, begin );
+    while ( static_cast<size_t>( end - bounds.back() ) > ChunkSize ) {
+        const char *it = bounds.back() + ChunkSize;
+        for ( ;; ) {
+            const char *nl = findNewLine( it, end );
+            it = nl == end ? end : nl + 1;
+            if ( nl == end || !isContinuedLine( bounds.back(), nl ) ) {
+                break;
             }
+        }
+        if ( it == end ) {
             break;
+        }
+        bounds.push_back( it );
+    }
+    bounds.push_back( end );
+
+    const unsigned int numChunks = static_cast<unsigned int>( bounds.size() - 1 );
+    const unsigned int bytesToProcess = static_cast<unsigned int>( end - begin );
+    for ( unsigned int first = 0; first < numChunks; first += ChunksPerBatch ) {
+        const unsigned int count = std::min( ChunksPerBatch, numChunks - first );
+        std::vector<ObjFile::Chunk*> chunks( count );
+        for ( unsigned int i = 0; i < count; ++i ) {
+            chunks[ i ] = new ObjFile::Chunk( bounds[ first + i ], bounds[ first + i + 1 ] );
+        }
 
-        case 'u': // Parse a material desc. setter
-            {
-                std::string name;
+        try {
+            // the material libraries are read along with the first chunks, the
+            // libraries are needed as soon as the first chunk is merged. Without
+            // a second thread this would be an extra pass over the file. The
+            // IOSystem may only be used from this thread, so the prefetch runs
+            // here while the other threads parse.
+            const bool prefetch = !first && GetParallelThreadCount() > 1;
+            auto parse = [this, &chunks]( unsigned int i ) {
+                parseChunk( *chunks[ i ] );
+            };
+            if ( prefetch ) {
+                ParallelForWithCallerTask( count, parse, [this, begin, end]() {
+                    prefetchMaterialLibs( begin, end );
+                } );
+            } else {
+                ParallelFor( count, parse );
+            }
 
-                getNameNoSpace(m_DataIt, m_DataItEnd, name);
+            // the model state depends on the statement order, so merge sequentially
+            for ( unsigned int i = 0; i < count; ++i ) {
+                mergeChunk( *chunks[ i ] );
+                delete chunks[ i ];
+                chunks[ i ] = NULL;
 
-                size_t nextSpace = name.find(" ");
-                if (nextSpace != std::string::npos)
-                    name = name.substr(0, nextSpace);
+                const unsigned int processed = static_cast<unsigned int>( bounds[ first + i + 1 ] - begin );
+                m_progress->UpdateFileRead( bytesToProcess + processed * 2, 3 * bytesToProcess );
+            }
+        } catch ( ... ) {
+            for ( unsigned int i = 0; i < count; ++i ) {
+                delete chunks[ i ];
+            }
+            throw;
+        }
+    }
+}
 
-                if(name == "usemtl")
-                {
-                    getMaterialDesc();
+void ObjFileParser::parseLines( const char *begin, const char *end ) {
+    const char *it = begin;
+    while ( it < end ) {
+        // read the next data line, line ends after a '\\' are skipped
+        m_lineBuffer.clear();
+        bool continuationFound = false;
+        while ( it < end ) {
+            if ( '\\' == *it ) {
+                continuationFound = true;
+                if ( ++it == end ) {
+                    break;
                 }
             }
-            break;
+            if ( IsLineEnd( *it ) ) {
+                if ( !continuationFound ) {
+                    break;
+                }
+                while ( it < end && *it != '\n' ) {
+                    ++it;
+                }
+                ++it;
+                continuationFound = false;
+                continue;
+            }
+            m_lineBuffer.push_back( *it );
+            ++it;
+        }
+        ++it;
 
-        case 'm': // Parse a material library or merging group ('mg')
+        m_lineBuffer.push_back( '\n' );
+        m_lineBuffer.push_back( '\0' );
+        m_DataIt = &m_lineBuffer[ 0 ];
+        m_DataItEnd = m_DataIt + m_lineBuffer.size();
+        parseLine();
+    }
+}
+
+void ObjFileParser::parseLine() {
+    switch (*m_DataIt) {
+    case 'v': // Parse a vertex texture coordinate
+        {
+            ++m_DataIt;
+            if (*m_DataIt == ' ' || *m_DataIt == '\t') {
+                getVertex(m_pModel->m_Vertices, m_pModel->m_VertexColors);
+            } else if (*m_DataIt == 't') {
+                // read in texture coordinate ( 2D or 3D )
+                ++m_DataIt;
+                getVector( m_pModel->m_TextureCoord );
+            } else if (*m_DataIt == 'n') {
+                // Read in normal vector definition
+                ++m_DataIt;
+                getVector3( m_pModel->m_Normals );
+            }
+        }
+        break;
+
+    case 'p': // Parse a face, line or point statement
+    case 'l':
+    case 'f':
+        {
+            getFace(*m_DataIt == 'f' ? aiPrimitiveType_POLYGON : (*m_DataIt == 'l'
+                ? aiPrimitiveType_LINE : aiPrimitiveType_POINT));
+        }
+        break;
+
+    case '#': // Parse a comment
+        {
+            getComment();
+        }
+        break;
+
+    case 'u': // Parse a material desc. setter
+        {
+            std::string name;
+
+            getNameNoSpace(m_DataIt, m_DataItEnd, name);
+
+            size_t nextSpace = name.find(" ");
+            if (nextSpace != std::string::npos)
+                name = name.substr(0, nextSpace);
+
+            if(name == "usemtl")
             {
-                std::string name;
+                getMaterialDesc();
+            }
+        }
+        break;
+
+    case 'm': // Parse a material library or merging group ('mg')
+        {
+            std::string name;
 
-                getNameNoSpace(m_DataIt, m_DataItEnd, name);
+            getNameNoSpace(m_DataIt, m_DataItEnd, name);
 
-                size_t nextSpace = name.find(" ");
-                if (nextSpace != std::string::npos)
-                    name = name.substr(0, nextSpace);
+            size_t nextSpace = name.find(" ");
+            if (nextSpace != std::string::npos)
+                name = name.substr(0, nextSpace);
 
-                if (name == "mg")
-                    getGroupNumberAndResolution();
-                else if(name == "mtllib")
-                    getMaterialLib();
+            if (name == "mg")
+                getGroupNumberAndResolution();
+            else if(name == "mtllib")
+                getMaterialLib();
 				else
 					goto pf_skip_line;
-            }
-            break;
+        }
+        break;
 
-        case 'g': // Parse group name
-            {
-                getGroupName();
-            }
-            break;
+    case 'g': // Parse group name
+        {
+            getGroupName();
+        }
+        break;
 
-        case 's': // Parse group number
-            {
-                getGroupNumber();
-            }
-            break;
+    case 's': // Parse group number
+        {
+            getGroupNumber();
+        }
+        break;
 
-        case 'o': // Parse object name
-            {
-                getObjectName();
-            }
-            break;
+    case 'o': // Parse object name
+        {
+            getObjectName();
+        }
+        break;
 
-        default:
-            {
+    default:
+        {
 pf_skip_line:
-                m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
-            }
+            m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
+        }
+        break;
+    }
+}
+
+void ObjFileParser::mergeChunk( ObjFile::Chunk &chunk ) {
+    if ( chunk.m_Ambiguous && m_pModel->m_TextureCoord.empty() ) {
+        // the slots of "a/b" face corners depend on the texture coordinates of
+        // the previous chunks, so parse the chunk again in order
+        parseLines( chunk.m_Begin, chunk.m_End );
+        return;
+    }
+
+    for ( std::vector<std::string>::const_iterator it = chunk.m_Errors.begin(); it != chunk.m_Errors.end(); ++it ) {
+        DefaultLogger::get()->error( *it );
+    }
+    if ( !chunk.m_Fatal.empty() ) {
+        throw DeadlyImportError( chunk.m_Fatal );
+    }
+
+    const unsigned int base[ 3 ] = {
+        static_cast<unsigned int>( m_pModel->m_Vertices.size() ),
+        static_cast<unsigned int>( m_pModel->m_TextureCoord.size() ),
+        static_cast<unsigned int>( m_pModel->m_Normals.size() )
+    };
+    m_pModel->m_Vertices.insert( m_pModel->m_Vertices.end(), chunk.m_Vertices.begin(), chunk.m_Vertices.end() );
+    m_pModel->m_VertexColors.insert( m_pModel->m_VertexColors.end(), chunk.m_VertexColors.begin(), chunk.m_VertexColors.end() );
+    m_pModel->m_TextureCoord.insert( m_pModel->m_TextureCoord.end(), chunk.m_TextureCoord.begin(), chunk.m_TextureCoord.end() );
+    m_pModel->m_Normals.insert( m_pModel->m_Normals.end(), chunk.m_Normals.begin(), chunk.m_Normals.end() );
+
+    size_t nextStatement = 0, nextRelative = 0;
+    const unsigned int numFaces = static_cast<unsigned int>( chunk.m_FaceTypes.size() );
+    for ( unsigned int face = 0; face <= numFaces; ++face ) {
+        // replay the statements in front of the face
+        for ( ; nextStatement < chunk.m_Statements.size() && chunk.m_Statements[ nextStatement ].m_Face == face; ++nextStatement ) {
+            const std::string &line = chunk.m_Statements[ nextStatement ].m_Line;
+            m_lineBuffer.assign( line.begin(), line.end() );
+            m_lineBuffer.push_back( '\n' );
+            m_lineBuffer.push_back( '\0' );
+            m_DataIt = &m_lineBuffer[ 0 ];
+            m_DataItEnd = m_DataIt + m_lineBuffer.size();
+            parseLine();
+        }
+        if ( face == numFaces ) {
             break;
         }
+
+        // negative indices are relative to the chunk-local counts
+        unsigned int counts[ 3 ] = { base[ 0 ], base[ 1 ], base[ 2 ] };
+        if ( nextRelative < chunk.m_Relative.size() && chunk.m_Relative[ nextRelative ].m_Face == face ) {
+            for ( unsigned int k = 0; k < 3; ++k ) {
+                counts[ k ] += chunk.m_Relative[ nextRelative ].m_Counts[ k ];
+            }
+            ++nextRelative;
+        }
+
+        const unsigned int first = chunk.m_FaceOffsets[ face ];
+        const unsigned int numCorners = chunk.m_FaceOffsets[ face + 1 ] - first;
+        m_corners.resize( numCorners * 3 );
+        for ( unsigned int i = 0; i < numCorners * 3; ++i ) {
+            m_corners[ i ] = resolveIndex( chunk.m_Corners[ first * 3 + i ], counts[ i % 3 ] );
+        }
+        storeFace( chunk.m_FaceTypes[ face ], &m_corners[ 0 ], numCorners );
     }
 }
 
@@ -298,6 +954,20 @@ size_t ObjFileParser::getNumComponentsInDataDefinition() {
     return numComponents;
 }
 
+void ObjFileParser::getVertex( std::vector<aiVector3D> &vertices, std::vector<aiVector3D> &colors ) {
+    size_t numComponents = getNumComponentsInDataDefinition();
+    if (numComponents == 3) {
+        // read in vertex definition
+        getVector3(vertices);
+    } else if (numComponents == 4) {
+        // read in vertex definition (homogeneous coords)
+        getHomogeneousVector3(vertices);
+    } else if (numComponents == 6) {
+        // read vertex and vertex-color
+        getTwoVectors3(vertices, colors);
+    }
+}
+
 void ObjFileParser::getVector( std::vector<aiVector3D> &point3d_array ) {
     size_t numComponents = getNumComponentsInDataDefinition();
     ai_real x, y, z;
@@ -399,109 +1069,49 @@ void ObjFileParser::getVector2( std::vector<aiVector2D> &point2d_array ) {
     m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
 }
 
-static const std::string DefaultObjName = "defaultobject";
-
 void ObjFileParser::getFace( aiPrimitiveType type ) {
-    m_DataIt = getNextToken<DataArrayIt>( m_DataIt, m_DataItEnd );
-    if ( m_DataIt == m_DataItEnd || *m_DataIt == '\0' ) {
-        return;
-    }
-
-    ObjFile::Face *face = new ObjFile::Face( type );
-    bool hasNormal = false;
-
-    const int vSize = static_cast<unsigned int>(m_pModel->m_Vertices.size());
-    const int vtSize = static_cast<unsigned int>(m_pModel->m_TextureCoord.size());
-    const int vnSize = static_cast<unsigned int>(m_pModel->m_Normals.size());
+    const char *begin = &m_DataIt[ 0 ];
+    const char *end = begin + ( m_DataItEnd - m_DataIt );
 
     const bool vt = (!m_pModel->m_TextureCoord.empty());
     const bool vn = (!m_pModel->m_Normals.empty());
-    int iStep = 0, iPos = 0;
-    while ( m_DataIt != m_DataItEnd ) {
-        iStep = 1;
-
-        if ( IsLineEnd( *m_DataIt ) ) {
-            break;
-        }
-
-        if ( *m_DataIt =='/' ) {
-            if (type == aiPrimitiveType_POINT) {
-                DefaultLogger::get()->error("Obj: Separator unexpected in point statement");
-            }
-            if (iPos == 0) {
-                //if there are no texture coordinates in the file, but normals
-                if (!vt && vn) {
-                    iPos = 1;
-                    iStep++;
-                }
-            }
-            iPos++;
-        } else if( IsSpaceOrNewLine( *m_DataIt ) ) {
-            iPos = 0;
-        } else {
-            //OBJ USES 1 Base ARRAYS!!!!
-            const int iVal( ::atoi( & ( *m_DataIt ) ) );
-
-            // increment iStep position based off of the sign and # of digits
-            int tmp = iVal;
-            if ( iVal < 0 ) {
-                ++iStep;
-            }
-            while ( ( tmp = tmp / 10 ) != 0 ) {
-                ++iStep;
-            }
-
-            if ( iVal > 0 ) {
-                // Store parsed index
-                if ( 0 == iPos ) {
-                    face->m_vertices.push_back( iVal - 1 );
-                } else if ( 1 == iPos ) {
-                    face->m_texturCoords.push_back( iVal - 1 );
-                } else if ( 2 == iPos ) {
-                    face->m_normals.push_back( iVal - 1 );
-                    hasNormal = true;
-                } else {
-                    reportErrorTokenInFace();
-                }
-            } else if ( iVal < 0 ) {
-                // Store relatively index
-                if ( 0 == iPos ) {
-                    face->m_vertices.push_back( vSize + iVal );
-                } else if ( 1 == iPos ) {
-                    face->m_texturCoords.push_back( vtSize + iVal );
-                } else if ( 2 == iPos ) {
-                    face->m_normals.push_back( vnSize + iVal );
-                    hasNormal = true;
-                } else {
-                    reportErrorTokenInFace();
-                }
-            } else {
-                //On error, std::atoi will return 0 which is not a valid value
-                delete face;
-                delete m_pModel;
-                m_pModel = nullptr;
-                throw DeadlyImportError("OBJ: Invalid face indice");
-            }
-
-        }
-        m_DataIt += iStep;
+    std::vector<std::string> errors;
+    bool ambiguous = false;
+    const bool valid = tokenizeFace( begin, end, type, ( !vt && vn ) ? Slash_Normal : Slash_TexCoord,
+        m_rawCorners, errors, ambiguous );
+    for ( std::vector<std::string>::const_iterator it = errors.begin(); it != errors.end(); ++it ) {
+        DefaultLogger::get()->error( *it );
+    }
+    if ( !valid ) {
+        //On error, std::atoi will return 0 which is not a valid value
+        delete m_pModel;
+        m_pModel = nullptr;
+        throw DeadlyImportError("OBJ: Invalid face indice");
     }
 
-    if ( face->m_vertices.empty() ) {
+    if ( m_rawCorners.empty() ) {
         DefaultLogger::get()->error("Obj: Ignoring empty face");
         // skip line and clean up
         m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
-        delete face;
         return;
     }
 
-    // Set active material, if one set
-    if( NULL != m_pModel->m_pCurrentMaterial ) {
-        face->m_pMaterial = m_pModel->m_pCurrentMaterial;
-    } else {
-        face->m_pMaterial = m_pModel->m_pDefaultMaterial;
+    const unsigned int counts[ 3 ] = {
+        static_cast<unsigned int>( m_pModel->m_Vertices.size() ),
+        static_cast<unsigned int>( m_pModel->m_TextureCoord.size() ),
+        static_cast<unsigned int>( m_pModel->m_Normals.size() )
+    };
+    m_corners.resize( m_rawCorners.size() );
+    for ( size_t i = 0; i < m_rawCorners.size(); ++i ) {
+        m_corners[ i ] = resolveIndex( m_rawCorners[ i ], counts[ i % 3 ] );
     }
+    storeFace( type, &m_corners[ 0 ], static_cast<unsigned int>( m_corners.size() / 3 ) );
+
+    // Skip the rest of the line
+    m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
+}
 
+void ObjFileParser::storeFace( aiPrimitiveType type, const unsigned int *corners, unsigned int numCorners ) {
     // Create a default object, if nothing is there
     if( NULL == m_pModel->m_pCurrent ) {
         createObject( DefaultObjName );
@@ -512,15 +1122,22 @@ void ObjFileParser::getFace( aiPrimitiveType type ) {
         createMesh( DefaultObjName );
     }
 
-    // Store the face
-    m_pModel->m_pCurrentMesh->m_Faces.push_back( face );
-    m_pModel->m_pCurrentMesh->m_uiNumIndices += (unsigned int) face->m_vertices.size();
-    m_pModel->m_pCurrentMesh->m_uiUVCoordinates[ 0 ] += (unsigned int) face->m_texturCoords.size();
-    if( !m_pModel->m_pCurrentMesh->m_hasNormals && hasNormal ) {
-        m_pModel->m_pCurrentMesh->m_hasNormals = true;
+    if ( m_countFaces ) {
+        // the current mesh is always the last one created
+        const unsigned int mesh = static_cast<unsigned int>( m_pModel->m_Meshes.size() - 1 );
+        if ( m_meshRuns.empty() || m_meshRuns.back().m_Mesh != mesh ) {
+            MeshRun run;
+            run.m_Face = m_numFaces;
+            run.m_Mesh = mesh;
+            m_meshRuns.push_back( run );
+        }
+        ++m_numFaces;
+        m_pModel->m_pCurrentMesh->countFace( type, corners, numCorners );
+        return;
     }
-    // Skip the rest of the line
-    m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
+
+    // Store the face
+    m_pModel->m_pCurrentMesh->appendFace( type, corners, numCorners );
 }
 
 void ObjFileParser::getMaterialDesc() {
@@ -530,7 +1147,7 @@ void ObjFileParser::getMaterialDesc() {
         return;
     }
 
-    char *pStart = &(*m_DataIt);
+    const char *pStart = &(*m_DataIt);
     while( m_DataIt != m_DataItEnd && !IsLineEnd( *m_DataIt ) ) {
         ++m_DataIt;
     }
@@ -594,7 +1211,7 @@ void ObjFileParser::getMaterialLib() {
         return;
     }
 
-    char *pStart = &(*m_DataIt);
+    const char *pStart = &(*m_DataIt);
     while( m_DataIt != m_DataItEnd && !IsLineEnd( *m_DataIt ) ) {
         ++m_DataIt;
     }
@@ -609,39 +1226,121 @@ void ObjFileParser::getMaterialLib() {
         return;
     }
 
-    if ( m_pIO->StackSize() > 0 ) {
-        std::string path = m_pIO->CurrentDirectory();
-        if ( '/' != *path.rbegin() ) {
-          path += '/';
-        }
-        absName = path + strMatName;
-    } else {
-        absName = strMatName;
+    if ( m_profiler ) {
+        m_profiler->BeginRegion( "OBJ: material library" );
     }
-    IOStream *pFile = m_pIO->Open( absName );
 
-    if (!pFile ) {
+    MaterialLibFile *lib = &loadMaterialLib( getMaterialLibPath( strMatName ) );
+    if ( !lib->m_Found ) {
         DefaultLogger::get()->error("OBJ: Unable to locate material file " + strMatName);
         std::string strMatFallbackName = m_originalObjFileName.substr(0, m_originalObjFileName.length() - 3) + "mtl";
         DefaultLogger::get()->info("OBJ: Opening fallback material file " + strMatFallbackName);
-        pFile = m_pIO->Open(strMatFallbackName);
-        if (!pFile) {
+        lib = &loadMaterialLib( strMatFallbackName );
+        if ( !lib->m_Found ) {
             DefaultLogger::get()->error("OBJ: Unable to locate fallback material file " + strMatFallbackName);
             m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
+            if ( m_profiler ) {
+                m_profiler->EndRegion( "OBJ: material library" );
+            }
             return;
         }
     }
 
-    // Import material library data from file.
-    // Some exporters (e.g. Silo) will happily write out empty
-    // material files if the model doesn't use any materials, so we
-    // allow that.
-    std::vector<char> buffer;
-    BaseImporter::TextFileToBuffer( pFile, buffer, BaseImporter::ALLOW_EMPTY );
-    m_pIO->Close( pFile );
-
     // Importing the material library
-    ObjFileMtlImporter mtlImporter( buffer, strMatName, m_pModel );
+    ObjFileMtlImporter mtlImporter( lib->m_Data, strMatName, m_pModel );
+
+    if ( m_profiler ) {
+        m_profiler->EndRegion( "OBJ: material library" );
+    }
+}
+
+// -------------------------------------------------------------------
+std::string ObjFileParser::getMaterialLibPath( const std::string &strMatName ) const {
+    if ( m_pIO->StackSize() > 0 ) {
+        std::string path = m_pIO->CurrentDirectory();
+        if ( '/' != *path.rbegin() ) {
+          path += '/';
+        }
+        return path + strMatName;
+    }
+    return strMatName;
+}
+
+// -------------------------------------------------------------------
+ObjFileParser::MaterialLibFile &ObjFileParser::loadMaterialLib( const std::string &path ) {
+    std::map<std::string, MaterialLibFile>::iterator it = m_materialLibs.find( path );
+    if ( it != m_materialLibs.end() ) {
+        return it->second;
+    }
+
+    MaterialLibFile lib;
+    lib.m_Found = false;
+    IOStream *pFile = m_pIO->Open( path );
+    if ( pFile ) {
+        // Import material library data from file.
+        // Some exporters (e.g. Silo) will happily write out empty
+        // material files if the model doesn't use any materials, so we
+        // allow that.
+        try {
+            BaseImporter::TextFileToBuffer( pFile, lib.m_Data, BaseImporter::ALLOW_EMPTY );
+        } catch ( ... ) {
+            m_pIO->Close( pFile );
+            throw;
+        }
+        m_pIO->Close( pFile );
+        lib.m_Found = true;
+    }
+
+    MaterialLibFile &cached = m_materialLibs[ path ];
+    cached.m_Found = lib.m_Found;
+    cached.m_Data.swap( lib.m_Data );
+    return cached;
+}
+
+// -------------------------------------------------------------------
+//  Reads the material libraries of all 'mtllib' statements in advance, with
+//  slow IO systems this hides the file access behind the geometry parsing.
+//  Nothing is logged here, getMaterialLib() reports in statement order. Only
+//  called when a second thread is available, the cache is filled on demand else.
+//  Runs on the calling thread of the importer, like all other IOSystem calls.
+void ObjFileParser::prefetchMaterialLibs( const char *begin, const char *end ) {
+    if ( m_profiler ) {
+        m_profiler->BeginRegion( "OBJ: material library prefetch" );
+    }
+
+    static const char token[] = "mtllib";
+    static const size_t tokenLength = sizeof( token ) - 1;
+    for ( const char *it = begin; it < end; ) {
+        const char *lineEnd = findNewLine( it, end );
+        if ( static_cast<size_t>( lineEnd - it ) > tokenLength && 0 == ::strncmp( it, token, tokenLength )
+                && ( ' ' == it[ tokenLength ] || '\t' == it[ tokenLength ] ) ) {
+            const char *pStart = it + tokenLength;
+            while ( pStart < lineEnd && ( ' ' == *pStart || '\t' == *pStart ) ) {
+                ++pStart;
+            }
+            const char *pEnd = pStart;
+            while ( pEnd < lineEnd && !IsLineEnd( *pEnd ) ) {
+                ++pEnd;
+            }
+
+            if ( pStart != pEnd ) {
+                // a failed read is repeated and reported when the statement is parsed
+                try {
+                    const std::string strMatName( pStart, pEnd );
+                    if ( !loadMaterialLib( getMaterialLibPath( strMatName ) ).m_Found ) {
+                        loadMaterialLib( m_originalObjFileName.substr( 0, m_originalObjFileName.length() - 3 ) + "mtl" );
+                    }
+                } catch ( ... ) {
+                    // empty
+                }
+            }
+        }
+        it = lineEnd + 1;
+    }
+
+    if ( m_profiler ) {
+        m_profiler->EndRegion( "OBJ: material library prefetch" );
+    }
 }
 
 // -------------------------------------------------------------------
@@ -653,7 +1352,7 @@ void ObjFileParser::getNewMaterial() {
         return;
     }
 
-    char *pStart = &(*m_DataIt);
+    const char *pStart = &(*m_DataIt);
     std::string strMat( pStart, *m_DataIt );
     while( m_DataIt != m_DataItEnd && IsSpaceOrNewLine( *m_DataIt ) ) {
         ++m_DataIt;
@@ -755,7 +1454,7 @@ void ObjFileParser::getObjectName()
     if( m_DataIt == m_DataItEnd ) {
         return;
     }
-    char *pStart = &(*m_DataIt);
+    const char *pStart = &(*m_DataIt);
     while( m_DataIt != m_DataItEnd && !IsSpaceOrNewLine( *m_DataIt ) ) {
         ++m_DataIt;
     }
@@ -838,7 +1537,7 @@ bool ObjFileParser::needsNewMesh( const std::string &materialName )
         && curMatIdx != matIdx
         // no need create a new mesh if no faces in current
         // lets say 'usemtl' goes straight after 'g'
-        && m_pModel->m_pCurrentMesh->m_Faces.size() > 0 )
+        && m_pModel->m_pCurrentMesh->getNumFaces() > 0 )
     {
         // New material -> only one material per mesh, so we need to create a new
         // material
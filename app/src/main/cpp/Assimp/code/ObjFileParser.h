@@ -57,42 +57,90 @@ namespace ObjFile {
     struct Material;
     struct Point3;
     struct Point2;
+    struct Chunk;
 }
 
 class ObjFileImporter;
 class IOSystem;
 class ProgressHandler;
 
+namespace Profiling {
+    class Profiler;
+}
+
 /// \class  ObjFileParser
 /// \brief  Parser for a obj waveform file
 class ASSIMP_API ObjFileParser {
 public:
     static const size_t Buffersize = 4096;
     typedef std::vector<char> DataArray;
-    typedef std::vector<char>::iterator DataArrayIt;
-    typedef std::vector<char>::const_iterator ConstDataArrayIt;
+    typedef const char *DataArrayIt;
+    typedef const char *ConstDataArrayIt;
+
+    /// @brief  Receives the faces of the second pass of the two-pass import, see parseFaces().
+    class FaceSink {
+    public:
+        virtual ~FaceSink() {}
+        /// @brief  Called for every face in file order.
+        /// @param  meshIndex   Index of the mesh in the model which holds the face.
+        /// @param  corners     Resolved (vertex, texture coordinate, normal) triplets.
+        virtual void addFace( unsigned int meshIndex, aiPrimitiveType type, const unsigned int *corners, unsigned int numCorners ) = 0;
+    };
 
 public:
     /// @brief  The default constructor.
     ObjFileParser();
     /// @brief  Constructor with data array.
-    ObjFileParser( IOStreamBuffer<char> &streamBuffer, const std::string &modelName, IOSystem* io, ProgressHandler* progress, const std::string &originalObjFileName);
+    ///         If countFacesOnly is set, the faces are only counted per mesh as the first
+    ///         pass of the two-pass import, parseFaces() delivers them in the second pass.
+    ObjFileParser( IOStreamBuffer<char> &streamBuffer, const std::string &modelName, IOSystem* io, ProgressHandler* progress, const std::string &originalObjFileName,
+        Profiling::Profiler* profiler = NULL, bool countFacesOnly = false);
+    /// @brief  Constructor with the whole file in memory, the file is parsed in parallel chunks.
+    ///         The material libraries are loaded while the first chunks are parsed.
+    ObjFileParser( std::vector<char> &buffer, const std::string &modelName, IOSystem* io, ProgressHandler* progress, const std::string &originalObjFileName,
+        Profiling::Profiler* profiler = NULL);
     /// @brief  Destructor
     ~ObjFileParser();
     /// @brief  If you want to load in-core data.
     void setBuffer( std::vector<char> &buffer );
     /// @brief  Model getter.
     ObjFile::Model *GetModel() const;
+    /// @brief  Parses the face statements of the file again and hands them to the sink.
+    ///         Only valid after the faces have been counted by the first pass.
+    void parseFaces( IOStreamBuffer<char> &streamBuffer, FaceSink &sink );
 
 protected:
+    /// Contents of a material library file, kept for the whole import
+    struct MaterialLibFile {
+        bool m_Found;
+        std::vector<char> m_Data;
+    };
+    /// First face of a run of faces which belong to the same mesh
+    struct MeshRun {
+        unsigned int m_Face;
+        unsigned int m_Mesh;
+    };
+
+    /// Creates the model instance and its default material.
+    void createModel( const std::string &modelName );
     /// Parse the loaded file
     void parseFile( IOStreamBuffer<char> &streamBuffer );
+    /// Parse a file which is completely loaded into memory
+    void parseBuffer( std::vector<char> &buffer );
+    /// Parse all lines of a memory range one after another
+    void parseLines( const char *begin, const char *end );
+    /// Parse the current line
+    void parseLine();
+    /// Adds the data of a parsed chunk to the model
+    void mergeChunk( ObjFile::Chunk &chunk );
     /// Method to copy the new delimited word in the current line.
     void copyNextWord(char *pBuffer, size_t length);
     /// Method to copy the new line.
 //    void copyNextLine(char *pBuffer, size_t length);
     /// Get the number of components in a line.
     size_t getNumComponentsInDataDefinition();
+    /// Stores the vertex of a 'v' statement, and its color if there is one.
+    void getVertex( std::vector<aiVector3D> &vertices, std::vector<aiVector3D> &colors );
     /// Stores the vector
     void getVector( std::vector<aiVector3D> &point3d_array );
     /// Stores the following 3d vector.
@@ -105,12 +153,20 @@ protected:
     void getVector2(std::vector<aiVector2D> &point2d_array);
     /// Stores the following face.
     void getFace(aiPrimitiveType type);
+    /// Stores a face with resolved (vertex, texture coordinate, normal) corner triplets.
+    void storeFace(aiPrimitiveType type, const unsigned int *corners, unsigned int numCorners);
     /// Reads the material description.
     void getMaterialDesc();
     /// Gets a comment.
     void getComment();
     /// Gets a a material library.
     void getMaterialLib();
+    /// Returns the path of a material library relative to the current directory.
+    std::string getMaterialLibPath( const std::string &strMatName ) const;
+    /// Returns the cached contents of a material library file, the file is read on the first request.
+    MaterialLibFile &loadMaterialLib( const std::string &path );
+    /// Reads all material libraries referenced in a memory range into the cache.
+    void prefetchMaterialLibs( const char *begin, const char *end );
     /// Creates a new material.
     void getNewMaterial();
     /// Gets the group name from file.
@@ -140,9 +196,9 @@ private:
 
     /// Default material name
     static const std::string DEFAULT_MATERIAL;
-    //! Iterator to current position in buffer
+    //! Iterator to current position in the current line
     DataArrayIt m_DataIt;
-    //! Iterator to end position of buffer
+    //! Iterator to end position of the current line
     DataArrayIt m_DataItEnd;
     //! Pointer to model instance
     ObjFile::Model *m_pModel;
@@ -156,6 +212,21 @@ private:
     ProgressHandler* m_progress;
     /// Path to the current model, name of the obj file where the buffer comes from
     const std::string m_originalObjFileName;
+    //! Scratch buffer for lines parsed from memory
+    std::vector<char> m_lineBuffer;
+    //! Scratch buffers for the corners of a face
+    std::vector<int> m_rawCorners;
+    std::vector<unsigned int> m_corners;
+    //! Material library files by path, every path is opened only once per import
+    std::map<std::string, MaterialLibFile> m_materialLibs;
+    //! Optional profiler for the timings of the import stages
+    Profiling::Profiler* m_profiler;
+    //! Faces are only counted, see the streaming constructor
+    bool m_countFaces;
+    //! Number of counted faces
+    unsigned int m_numFaces;
+    //! Mesh changes in the sequence of counted faces
+    std::vector<MeshRun> m_meshRuns;
 };
 
 }   // Namespace Assimp
@@ -0,0 +1,345 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2017, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file OptimizeAnimationsProcess.cpp
+ *  @brief Implementation of the OptimizeAnimationsProcess post processing step
+ */
+
+#ifndef ASSIMP_BUILD_NO_OPTIMIZEANIMATIONS_PROCESS
+
+#include "OptimizeAnimationsProcess.h"
+#include "ParallelHelper.h"
+#include "StringUtils.h"
+#include <assimp/postprocess.h>
+#include <assimp/DefaultLogger.hpp>
+#include <assimp/anim.h>
+#include <assimp/scene.h>
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+using namespace Assimp;
+
+namespace {
+
+// ticks per second assumed if an animation doesn't specify it
+const double DefaultTicksPerSecond = 25.0;
+
+// maximum number of keys removed between two kept keys. Each candidate segment is
+// checked against all keys it spans, so this bounds the work per key.
+const unsigned int MaxSegmentKeys = 64;
+
+// ------------------------------------------------------------------------------------------------
+// Interpolate between two keys at the given time
+aiVector3D Interpolate(const aiVectorKey& a, const aiVectorKey& b, double time)
+{
+    const double span = b.mTime - a.mTime;
+    const ai_real f = span > 0. ? static_cast<ai_real>((time - a.mTime) / span) : ai_real(0);
+    return a.mValue + (b.mValue - a.mValue) * f;
+}
+
+aiQuaternion Interpolate(const aiQuatKey& a, const aiQuatKey& b, double time)
+{
+    const double span = b.mTime - a.mTime;
+    const ai_real f = span > 0. ? static_cast<ai_real>((time - a.mTime) / span) : ai_real(0);
+    aiQuaternion out;
+    aiQuaternion::Interpolate(out,a.mValue,b.mValue,f);
+    return out;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Deviation between two key values. For rotations this is the angle between them.
+ai_real Error(const aiVector3D& a, const aiVector3D& b)
+{
+    return (a - b).Length();
+}
+
+ai_real Error(aiQuaternion a, aiQuaternion b)
+{
+    a.Normalize();
+    b.Normalize();
+
+    // vector part and w of conj(a) * b, atan2 stays precise for small angles
+    const aiVector3D va(a.x,a.y,a.z), vb(b.x,b.y,b.z);
+    const aiVector3D v = vb * a.w - va * b.w - (va ^ vb);
+    const ai_real w = a.w * b.w + va * vb;
+    return 2 * atan2(v.Length(),std::fabs(w));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Sample a track at the given time, keys must be sorted. cursor speeds up ascending lookups.
+template <typename KeyType>
+KeyType Sample(const KeyType* keys, unsigned int num, double time, unsigned int& cursor)
+{
+    KeyType out;
+    out.mTime = time;
+    if (time <= keys[0].mTime) {
+        out.mValue = keys[0].mValue;
+        return out;
+    }
+    if (time >= keys[num-1].mTime) {
+        out.mValue = keys[num-1].mValue;
+        return out;
+    }
+    while (cursor + 1 < num && keys[cursor+1].mTime <= time) {
+        ++cursor;
+    }
+    out.mValue = Interpolate(keys[cursor],keys[cursor+1],time);
+    return out;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Resample a track at a fixed interval, the first and the last key are kept
+template <typename KeyType>
+void Resample(KeyType*& keys, unsigned int& num, double interval)
+{
+    if (num < 2 || interval <= 0.) {
+        return;
+    }
+    const double start = keys[0].mTime, end = keys[num-1].mTime;
+    const unsigned int steps = static_cast<unsigned int>((end - start) / interval + 1e-6);
+
+    std::vector<KeyType> out;
+    out.reserve(steps + 2);
+    unsigned int cursor = 0;
+    for (unsigned int i = 0; i <= steps; ++i) {
+        out.push_back(Sample(keys,num,start + i * interval,cursor));
+    }
+    if (out.back().mTime < end - 1e-6 * interval) {
+        out.push_back(keys[num-1]);
+    }
+
+    delete[] keys;
+    num = static_cast<unsigned int>(out.size());
+    keys = new KeyType[num];
+    std::copy(out.begin(),out.end(),keys);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Remove all keys which can be interpolated from the remaining keys within epsilon. Works in
+// place and returns the new number of keys.
+template <typename KeyType>
+unsigned int ReduceKeys(KeyType* keys, unsigned int num, ai_real epsilon)
+{
+    if (num < 2 || epsilon < 0) {
+        return num;
+    }
+
+    // Greedily extend the segment starting at the last kept key as long as
+    // it reproduces all keys it spans, up to MaxSegmentKeys of them. anchor is
+    // an index into the input, out never passes it, so the keys still to be
+    // read are not overwritten.
+    unsigned int out = 1, anchor = 0;
+    for (unsigned int i = 1; i < num - 1; ++i) {
+        bool redundant = i - anchor <= MaxSegmentKeys;
+        for (unsigned int m = anchor + 1; m <= i && redundant; ++m) {
+            redundant = Error(Interpolate(keys[anchor],keys[i+1],keys[m].mTime),keys[m].mValue) <= epsilon;
+        }
+        if (!redundant) {
+            keys[out++] = keys[i];
+            anchor = i;
+        }
+    }
+    keys[out++] = keys[num-1];
+
+    // a constant track needs only one key
+    if (out == 2 && Error(keys[0].mValue,keys[1].mValue) <= epsilon) {
+        out = 1;
+    }
+    return out;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Shrink a key array to its first num elements
+template <typename KeyType>
+void ShrinkKeys(KeyType*& keys, unsigned int oldNum, unsigned int num)
+{
+    if (num == oldNum) {
+        return;
+    }
+    KeyType* out = new KeyType[num];
+    std::copy(keys,keys + num,out);
+    delete[] keys;
+    keys = out;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Key counts of a channel before and after the optimization
+struct KeyCounts
+{
+    unsigned int mPosition[2], mRotation[2], mScaling[2];
+};
+
+} // end of anonymous namespace
+
+// ------------------------------------------------------------------------------------------------
+// Constructor to be privately used by Importer
+OptimizeAnimationsProcess::OptimizeAnimationsProcess()
+: mPositionEpsilon(AI_OA_DEFAULT_POSITION_EPSILON)
+, mRotationEpsilon(AI_OA_DEFAULT_ROTATION_EPSILON)
+, mScalingEpsilon(AI_OA_DEFAULT_SCALING_EPSILON)
+, mSampleRate(0)
+, mQuantizeBits(0)
+{
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+// Destructor, private as well
+OptimizeAnimationsProcess::~OptimizeAnimationsProcess()
+{
+    // nothing to do here
+}
+
+// ------------------------------------------------------------------------------------------------
+// Returns whether the processing step is present in the given flag field.
+bool OptimizeAnimationsProcess::IsActive( unsigned int pFlags) const
+{
+    return (pFlags & aiProcess_OptimizeAnimations) != 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Setup configuration properties for the step
+void OptimizeAnimationsProcess::SetupProperties(const Importer* pImp)
+{
+    mPositionEpsilon = pImp->GetPropertyFloat(AI_CONFIG_PP_OA_POSITION_EPSILON,AI_OA_DEFAULT_POSITION_EPSILON);
+    mRotationEpsilon = pImp->GetPropertyFloat(AI_CONFIG_PP_OA_ROTATION_EPSILON,AI_OA_DEFAULT_ROTATION_EPSILON);
+    mScalingEpsilon = pImp->GetPropertyFloat(AI_CONFIG_PP_OA_SCALING_EPSILON,AI_OA_DEFAULT_SCALING_EPSILON);
+    mSampleRate = std::max(ai_real(0),pImp->GetPropertyFloat(AI_CONFIG_PP_OA_SAMPLE_RATE,0.f));
+
+    // at least a sign and two bits, at most the mantissa of a float
+    const int bits = pImp->GetPropertyInteger(AI_CONFIG_PP_OA_QUANTIZE_ROTATIONS,0);
+    mQuantizeBits = bits > 0 ? static_cast<unsigned int>(std::min(24,std::max(3,bits))) : 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on the given imported data.
+void OptimizeAnimationsProcess::Execute( aiScene* pScene)
+{
+    DefaultLogger::get()->debug("OptimizeAnimationsProcess begin");
+
+    std::vector<aiNodeAnim*> channels;
+    std::vector<double> ticksPerSecond;
+    for (unsigned int a = 0; a < pScene->mNumAnimations; ++a) {
+        const aiAnimation* anim = pScene->mAnimations[a];
+        for (unsigned int c = 0; c < anim->mNumChannels; ++c) {
+            channels.push_back(anim->mChannels[c]);
+            ticksPerSecond.push_back(anim->mTicksPerSecond > 0. ? anim->mTicksPerSecond : DefaultTicksPerSecond);
+        }
+    }
+
+    // the channels are independent of each other
+    std::vector<KeyCounts> counts(channels.size());
+    ParallelFor(static_cast<unsigned int>(channels.size()),[&](unsigned int i) {
+        const aiNodeAnim* channel = channels[i];
+        KeyCounts& c = counts[i];
+        c.mPosition[0] = channel->mNumPositionKeys;
+        c.mRotation[0] = channel->mNumRotationKeys;
+        c.mScaling[0] = channel->mNumScalingKeys;
+
+        ProcessChannel(channels[i],ticksPerSecond[i]);
+
+        c.mPosition[1] = channel->mNumPositionKeys;
+        c.mRotation[1] = channel->mNumRotationKeys;
+        c.mScaling[1] = channel->mNumScalingKeys;
+    });
+
+    KeyCounts total = {};
+    for (const KeyCounts& c : counts) {
+        for (unsigned int k = 0; k < 2; ++k) {
+            total.mPosition[k] += c.mPosition[k];
+            total.mRotation[k] += c.mRotation[k];
+            total.mScaling[k] += c.mScaling[k];
+        }
+    }
+
+    if (!DefaultLogger::isNullLogger()) {
+        char buffer[1024];
+        ai_snprintf(buffer,1024,"OptimizeAnimationsProcess finished. Reduced %u position, %u rotation "
+            "and %u scaling keys to %u, %u and %u",total.mPosition[0],total.mRotation[0],total.mScaling[0],
+            total.mPosition[1],total.mRotation[1],total.mScaling[1]);
+        DefaultLogger::get()->info(buffer);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Optimizes the keys of a single animation channel
+void OptimizeAnimationsProcess::ProcessChannel( aiNodeAnim* pChannel, double pTicksPerSecond) const
+{
+    if (mSampleRate > 0) {
+        const double interval = pTicksPerSecond / mSampleRate;
+        Resample(pChannel->mPositionKeys,pChannel->mNumPositionKeys,interval);
+        Resample(pChannel->mRotationKeys,pChannel->mNumRotationKeys,interval);
+        Resample(pChannel->mScalingKeys,pChannel->mNumScalingKeys,interval);
+    }
+
+    // snap the components to a signed normalized grid before the reduction,
+    // so the tolerance is checked against the values which are kept. The
+    // largest component of a unit quaternion is at least 0.5, with three or
+    // more bits it never rounds to zero.
+    if (mQuantizeBits) {
+        const ai_real scale = static_cast<ai_real>((1u << (mQuantizeBits - 1)) - 1);
+        for (unsigned int i = 0; i < pChannel->mNumRotationKeys; ++i) {
+            aiQuaternion& q = pChannel->mRotationKeys[i].mValue;
+            q.Normalize();
+            q = aiQuaternion(floor(q.w * scale + ai_real(0.5)) / scale,
+                floor(q.x * scale + ai_real(0.5)) / scale,
+                floor(q.y * scale + ai_real(0.5)) / scale,
+                floor(q.z * scale + ai_real(0.5)) / scale);
+        }
+    }
+
+    unsigned int num = ReduceKeys(pChannel->mPositionKeys,pChannel->mNumPositionKeys,mPositionEpsilon);
+    ShrinkKeys(pChannel->mPositionKeys,pChannel->mNumPositionKeys,num);
+    pChannel->mNumPositionKeys = num;
+
+    num = ReduceKeys(pChannel->mRotationKeys,pChannel->mNumRotationKeys,mRotationEpsilon);
+    ShrinkKeys(pChannel->mRotationKeys,pChannel->mNumRotationKeys,num);
+    pChannel->mNumRotationKeys = num;
+
+    num = ReduceKeys(pChannel->mScalingKeys,pChannel->mNumScalingKeys,mScalingEpsilon);
+    ShrinkKeys(pChannel->mScalingKeys,pChannel->mNumScalingKeys,num);
+    pChannel->mNumScalingKeys = num;
+}
+
+#endif // !! ASSIMP_BUILD_NO_OPTIMIZEANIMATIONS_PROCESS
@@ -0,0 +1,132 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2017, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+
+/** @file OptimizeAnimationsProcess.h
+ *  @brief Defines a post processing step to reduce the keyframes of animations.
+ */
+#ifndef AI_OPTIMIZEANIMATIONSPROCESS_H_INC
+#define AI_OPTIMIZEANIMATIONSPROCESS_H_INC
+
+#include "BaseProcess.h"
+
+struct aiNodeAnim;
+
+namespace Assimp
+{
+
+// default value for AI_CONFIG_PP_OA_POSITION_EPSILON
+#if (!defined AI_OA_DEFAULT_POSITION_EPSILON)
+#   define AI_OA_DEFAULT_POSITION_EPSILON 1e-4f
+#endif
+
+// default value for AI_CONFIG_PP_OA_ROTATION_EPSILON
+#if (!defined AI_OA_DEFAULT_ROTATION_EPSILON)
+#   define AI_OA_DEFAULT_ROTATION_EPSILON 1e-4f
+#endif
+
+// default value for AI_CONFIG_PP_OA_SCALING_EPSILON
+#if (!defined AI_OA_DEFAULT_SCALING_EPSILON)
+#   define AI_OA_DEFAULT_SCALING_EPSILON 1e-4f
+#endif
+
+// ---------------------------------------------------------------------------
+/** The OptimizeAnimationsProcess removes keys of node animation channels
+ *  which can be reconstructed by interpolating their neighbours within a
+ *  given tolerance. Optionally, the channels are resampled to a fixed rate
+ *  first and rotation keys are snapped to a grid so they can be stored in
+ *  fixed point without further loss.
+ */
+class ASSIMP_API OptimizeAnimationsProcess : public BaseProcess
+{
+public:
+
+    OptimizeAnimationsProcess();
+    ~OptimizeAnimationsProcess();
+
+public:
+    // -------------------------------------------------------------------
+    /** Returns whether the processing step is present in the given flag.
+    * @param pFlags The processing flags the importer was called with.
+    *   A bitwise combination of #aiPostProcessSteps.
+    * @return true if the process is present in this flag fields,
+    *   false if not.
+    */
+    bool IsActive( unsigned int pFlags) const;
+
+    // -------------------------------------------------------------------
+    /** Called prior to ExecuteOnScene().
+    * The function is a request to the process to update its configuration
+    * basing on the Importer's configuration property list.
+    */
+    void SetupProperties(const Importer* pImp);
+
+    // -------------------------------------------------------------------
+    /** Executes the post processing step on the given imported data.
+    * At the moment a process is not supposed to fail.
+    * @param pScene The imported data to work at.
+    */
+    void Execute( aiScene* pScene);
+
+private:
+    // -------------------------------------------------------------------
+    /** Optimizes the keys of a single animation channel.
+    * @param pChannel The channel to process.
+    * @param pTicksPerSecond Time base of the channel's animation, must
+    *   not be zero.
+    */
+    void ProcessChannel( aiNodeAnim* pChannel, double pTicksPerSecond) const;
+
+    /** Tolerances for the position, rotation (in radians) and scaling keys */
+    ai_real mPositionEpsilon;
+    ai_real mRotationEpsilon;
+    ai_real mScalingEpsilon;
+
+    /** Keys per second to resample the channels to, 0 to keep the keys */
+    ai_real mSampleRate;
+
+    /** Bits per quaternion component to quantize rotations to, 0 to disable */
+    unsigned int mQuantizeBits;
+};
+
+} // end of namespace Assimp
+
+#endif // AI_OPTIMIZEANIMATIONSPROCESS_H_INC
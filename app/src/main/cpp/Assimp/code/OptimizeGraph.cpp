@@ -51,6 +51,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ProcessHelper.h"
 #include <assimp/SceneCombiner.h>
 #include "Exceptional.h"
+#include <algorithm>
+#include <string>
 #include <stdio.h>
 
 using namespace Assimp;
@@ -76,6 +78,7 @@ OptimizeGraphProcess::OptimizeGraphProcess()
     , nodes_in()
     , nodes_out()
     , count_merged()
+    , configInstanceTables(false)
 {}
 
 // ------------------------------------------------------------------------------------------------
@@ -97,6 +100,9 @@ void OptimizeGraphProcess::SetupProperties(const Importer* pImp)
     // Get value of AI_CONFIG_PP_OG_EXCLUDE_LIST
     std::string tmp = pImp->GetPropertyString(AI_CONFIG_PP_OG_EXCLUDE_LIST,"");
     AddLockedNodeList(tmp);
+
+    // Get value of AI_CONFIG_PP_OG_INSTANCE_TABLES
+    configInstanceTables = (0 != pImp->GetPropertyInteger(AI_CONFIG_PP_OG_INSTANCE_TABLES,0));
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -295,6 +301,12 @@ void OptimizeGraphProcess::Execute( aiScene* pScene)
         locked.insert(AI_OG_GETKEY(lgh->mName));
     }
 
+    // Move repeated mesh references into instance tables before the graph is
+    // collapsed, the nodes which only placed the copies can go away then
+    if (configInstanceTables) {
+        BuildInstanceTables();
+    }
+
     // Insert a dummy master node and make it read-only
     aiNode* dummy_root = new aiNode(AI_RESERVED_NODE_NAME);
     locked.insert(AI_OG_GETKEY(dummy_root->mName));
@@ -347,6 +359,125 @@ void OptimizeGraphProcess::Execute( aiScene* pScene)
     locked.clear();
 }
 
+// ------------------------------------------------------------------------------------------------
+// Collect all references to meshes which may be moved into an instance table
+void OptimizeGraphProcess::CollectInstanceRefs(aiNode* nd, const aiMatrix4x4& trafo, bool isLocked,
+    std::vector< std::vector<InstanceRef> >& refs, std::vector<bool>& blocked)
+{
+    for (unsigned int i = 0; i < nd->mNumMeshes;++i) {
+
+        // A locked node on the path may move or keep the mesh on its own,
+        // the mesh needs to stay where it is then.
+        const unsigned int m = nd->mMeshes[i];
+        if (isLocked) {
+            blocked[m] = true;
+            continue;
+        }
+
+        InstanceRef ref;
+        ref.node = nd;
+        ref.slot = i;
+        ref.trafo = trafo;
+        refs[m].push_back(ref);
+    }
+
+    for (unsigned int i = 0; i < nd->mNumChildren; ++i) {
+        aiNode* child = nd->mChildren[i];
+        CollectInstanceRefs(child,trafo * child->mTransformation,
+            isLocked || locked.find(AI_OG_GETKEY(child->mName)) != locked.end(),refs,blocked);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Move repeated mesh references into instance tables
+void OptimizeGraphProcess::BuildInstanceTables()
+{
+    // The instance table of a mesh is relative to the new node referencing it, which is
+    // placed directly below the root node. So the references of the root node itself can
+    // always be moved, even if the root is locked.
+    std::vector< std::vector<InstanceRef> > refs(mScene->mNumMeshes);
+    std::vector<bool> blocked(mScene->mNumMeshes,false);
+    CollectInstanceRefs(mScene->mRootNode,aiMatrix4x4(),false,refs,blocked);
+
+    static const unsigned int Removed = 0xffffffff;
+    std::vector<aiNode*> added;
+    std::vector<aiNode*> touched;
+
+    for (unsigned int i = 0; i < mScene->mNumMeshes; ++i) {
+        aiMesh* mesh = mScene->mMeshes[i];
+        const std::vector<InstanceRef>& r = refs[i];
+
+        // Skinned meshes are placed by their bones, not by the nodes referencing them
+        if (blocked[i] || r.size() < 2 || mesh->HasBones() || mesh->HasInstances()) {
+            continue;
+        }
+
+        mesh->mNumInstances = static_cast<unsigned int>(r.size());
+        mesh->mInstanceTransforms = new aiMatrix4x4[mesh->mNumInstances];
+        for (unsigned int n = 0; n < mesh->mNumInstances; ++n) {
+            mesh->mInstanceTransforms[n] = r[n].trafo;
+
+            r[n].node->mMeshes[r[n].slot] = Removed;
+            touched.push_back(r[n].node);
+        }
+
+        aiNode* node = new aiNode();
+        if (mesh->mName.length) {
+            // too long names are cut at the end
+            std::string name = std::string("$Instances_") + mesh->mName.data;
+            name.resize(std::min<size_t>(name.length(),MAXLEN - 1));
+            node->mName.Set(name);
+        }
+        else {
+            ::ai_snprintf(node->mName.data,MAXLEN,"$Instances_%u",i);
+            node->mName.length = ::strlen(node->mName.data);
+        }
+
+        node->mParent = mScene->mRootNode;
+        node->mNumMeshes = 1;
+        node->mMeshes = new unsigned int[1];
+        node->mMeshes[0] = i;
+        added.push_back(node);
+    }
+
+    if (added.empty()) {
+        return;
+    }
+
+    // Remove the moved references from their nodes
+    for (std::vector<aiNode*>::iterator it = touched.begin(); it != touched.end(); ++it) {
+        aiNode* nd = *it;
+        unsigned int out = 0;
+        for (unsigned int n = 0; n < nd->mNumMeshes; ++n) {
+            if (nd->mMeshes[n] != Removed) {
+                nd->mMeshes[out++] = nd->mMeshes[n];
+            }
+        }
+        nd->mNumMeshes = out;
+        if (!out) {
+            delete[] nd->mMeshes;
+            nd->mMeshes = NULL;
+        }
+    }
+
+    // and attach the new nodes to the root node
+    aiNode* root = mScene->mRootNode;
+    aiNode** children = new aiNode*[root->mNumChildren + added.size()];
+    std::copy(root->mChildren,root->mChildren + root->mNumChildren,children);
+    std::copy(added.begin(),added.end(),children + root->mNumChildren);
+
+    delete[] root->mChildren;
+    root->mChildren = children;
+    root->mNumChildren += static_cast<unsigned int>(added.size());
+
+    if (!DefaultLogger::isNullLogger()) {
+        char buf[512];
+        ::ai_snprintf(buf,512,"OptimizeGraphProcess: Built instance tables for %u meshes",
+            static_cast<unsigned int>(added.size()));
+        DefaultLogger::get()->info(buf);
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 // Buidl a LUT of all instanced meshes
 void OptimizeGraphProcess::FindInstancedMeshes (aiNode* pNode)
@@ -114,6 +114,17 @@ protected:
     void CollectNewChildren(aiNode* nd, std::list<aiNode*>& nodes);
     void FindInstancedMeshes (aiNode* pNode);
 
+    //! A reference to a mesh which may be moved into an instance table
+    struct InstanceRef {
+        aiNode* node;
+        unsigned int slot;
+        aiMatrix4x4 trafo;
+    };
+
+    void CollectInstanceRefs(aiNode* nd, const aiMatrix4x4& trafo, bool isLocked,
+        std::vector< std::vector<InstanceRef> >& refs, std::vector<bool>& blocked);
+    void BuildInstanceTables();
+
 private:
 
 #ifdef AI_OG_USE_HASHING
@@ -137,6 +148,9 @@ private:
 
     //! Reference counters for meshes
     std::vector<unsigned int> meshes;
+
+    //! Configuration option: build instance tables for meshes referenced multiple times
+    bool configInstanceTables;
 };
 
 } // end of namespace Assimp
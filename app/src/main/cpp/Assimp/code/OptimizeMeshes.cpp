@@ -225,6 +225,10 @@ bool OptimizeMeshesProcess::CanJoin ( unsigned int a, unsigned int b, unsigned i
     if (ma->mMaterialIndex != mb->mMaterialIndex || ma->HasBones() != mb->HasBones())
         return false;
 
+    // Instance tables apply to the whole mesh, never merge instanced meshes
+    if (ma->HasInstances() || mb->HasInstances())
+        return false;
+
     // Never merge meshes with different kinds of primitives if SortByPType did already
     // do its work. We would destroy everything again ...
     if (pts && ma->mPrimitiveTypes != mb->mPrimitiveTypes)
@@ -0,0 +1,216 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2017, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file PackSkinningProcess.cpp
+ *  @brief Implementation of the PackSkinningProcess post processing step
+ */
+
+#ifndef ASSIMP_BUILD_NO_PACKSKINNING_PROCESS
+
+#include "PackSkinningProcess.h"
+#include "ProcessHelper.h"
+#include <assimp/postprocess.h>
+#include <assimp/DefaultLogger.hpp>
+#include <assimp/scene.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+using namespace Assimp;
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Orders influences by descending weight, ties by bone index to keep the output deterministic
+bool CompareInfluences(const PerVertexWeight& a, const PerVertexWeight& b)
+{
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+}
+
+} // ! anon namespace
+
+// ------------------------------------------------------------------------------------------------
+// Constructor to be privately used by Importer
+PackSkinningProcess::PackSkinningProcess()
+: mMaxInfluences(AI_PS_DEFAULT_MAX_INFLUENCES)
+, mUnorm8Weights(false)
+{
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+// Destructor, private as well
+PackSkinningProcess::~PackSkinningProcess()
+{
+    // nothing to do here
+}
+
+// ------------------------------------------------------------------------------------------------
+// Returns whether the processing step is present in the given flag field.
+bool PackSkinningProcess::IsActive( unsigned int pFlags) const
+{
+    return (pFlags & aiProcess_PackSkinning) != 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Setup configuration properties for the step
+void PackSkinningProcess::SetupProperties(const Importer* pImp)
+{
+    mMaxInfluences = std::max(1,pImp->GetPropertyInteger(AI_CONFIG_PP_PS_MAX_INFLUENCES,AI_PS_DEFAULT_MAX_INFLUENCES));
+    mUnorm8Weights = pImp->GetPropertyInteger(AI_CONFIG_PP_PS_UNORM8_WEIGHTS,0) != 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on the given imported data.
+void PackSkinningProcess::Execute( aiScene* pScene)
+{
+    DefaultLogger::get()->debug("PackSkinningProcess begin");
+
+    unsigned int truncated = 0;
+    for( unsigned int a = 0; a < pScene->mNumMeshes; a++) {
+        if (IsMeshDirty(a)) {
+            truncated += ProcessMesh( pScene->mMeshes[a]);
+        }
+    }
+
+    if (truncated && !DefaultLogger::isNullLogger()) {
+        char buffer[1024];
+        ai_snprintf(buffer,1024,"PackSkinningProcess: %u vertices are affected by more than %u bones, "
+            "dropped the weakest influences",truncated,mMaxInfluences);
+        DefaultLogger::get()->info(buffer);
+    }
+    DefaultLogger::get()->debug("PackSkinningProcess end");
+}
+
+// ------------------------------------------------------------------------------------------------
+// Packs the bone weights of a single mesh
+unsigned int PackSkinningProcess::ProcessMesh( aiMesh* pMesh) const
+{
+    // drop streams of a previous run, they might be out of date
+    delete[] pMesh->mPackedBoneIndices;
+    delete[] pMesh->mPackedBoneWeights;
+    pMesh->mPackedBoneIndices = pMesh->mPackedBoneWeights = NULL;
+    pMesh->mNumBoneInfluences = pMesh->mPackedBoneIndexSize = pMesh->mPackedBoneWeightSize = 0;
+
+    if (!pMesh->HasBones()) {
+        return 0;
+    }
+    if (pMesh->mNumBones > 0x10000) {
+        DefaultLogger::get()->warn("PackSkinningProcess: Too many bones for 16 bit indices, skipping mesh");
+        return 0;
+    }
+
+    // one CSR pass to get the weights per vertex
+    VertexBoneWeights table;
+    ComputeVertexBoneWeights(pMesh,table);
+
+    const unsigned int slots = mMaxInfluences;
+    const unsigned int indexSize = pMesh->mNumBones <= 0x100 ? 1 : 2;
+    const unsigned int weightSize = mUnorm8Weights ? 1 : sizeof(float);
+    const size_t numEntries = static_cast<size_t>(pMesh->mNumVertices)*slots;
+
+    unsigned char* const indices = new unsigned char[numEntries*indexSize];
+    unsigned char* const weights = new unsigned char[numEntries*weightSize];
+    ::memset(indices,0,numEntries*indexSize);
+    ::memset(weights,0,numEntries*weightSize);
+
+    unsigned int truncated = 0;
+    for (unsigned int v = 0; v < pMesh->mNumVertices; ++v) {
+        const unsigned int cnt = table.GetNumWeights(v);
+        if (!cnt) {
+            continue;
+        }
+
+        // bring the strongest influences to the front
+        PerVertexWeight* const w = table.GetWeights(v);
+        const unsigned int kept = std::min(cnt,slots);
+        std::partial_sort(w,w+kept,w+cnt,CompareInfluences);
+        if (kept < cnt) {
+            ++truncated;
+        }
+
+        float sum = 0.f;
+        for (unsigned int i = 0; i < kept; ++i) {
+            sum += w[i].second;
+        }
+        const float invSum = sum > 0.f ? 1.f/sum : 0.f;
+
+        const size_t base = static_cast<size_t>(v)*slots;
+        for (unsigned int i = 0; i < kept; ++i) {
+            if (indexSize == 1) {
+                indices[base+i] = static_cast<unsigned char>(w[i].first);
+            }
+            else {
+                reinterpret_cast<unsigned short*>(indices)[base+i] = static_cast<unsigned short>(w[i].first);
+            }
+        }
+
+        if (!mUnorm8Weights) {
+            float* const out = reinterpret_cast<float*>(weights)+base;
+            for (unsigned int i = 0; i < kept; ++i) {
+                out[i] = w[i].second*invSum;
+            }
+            continue;
+        }
+
+        // quantize and hand the rounding error to the strongest influence,
+        // so the weights still sum up to exactly 255
+        if (invSum > 0.f) {
+            unsigned char* const out = weights+base;
+            int total = 0;
+            for (unsigned int i = 0; i < kept; ++i) {
+                out[i] = static_cast<unsigned char>(w[i].second*invSum*255.f+0.5f);
+                total += out[i];
+            }
+            out[0] = static_cast<unsigned char>(std::max(0,std::min(255,out[0]+255-total)));
+        }
+    }
+
+    pMesh->mNumBoneInfluences = slots;
+    pMesh->mPackedBoneIndexSize = indexSize;
+    pMesh->mPackedBoneWeightSize = weightSize;
+    pMesh->mPackedBoneIndices = indices;
+    pMesh->mPackedBoneWeights = weights;
+    return truncated;
+}
+
+#endif // !! ASSIMP_BUILD_NO_PACKSKINNING_PROCESS
@@ -0,0 +1,119 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2017, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file PackSkinningProcess.h
+ *  @brief Defines a post processing step to store the bone weights of a
+ *    mesh vertex-major in fixed size per-vertex slots.
+ */
+#ifndef AI_PACKSKINNINGPROCESS_H_INC
+#define AI_PACKSKINNINGPROCESS_H_INC
+
+#include "BaseProcess.h"
+
+struct aiMesh;
+
+namespace Assimp
+{
+
+// default value for AI_CONFIG_PP_PS_MAX_INFLUENCES
+#if (!defined AI_PS_DEFAULT_MAX_INFLUENCES)
+#   define AI_PS_DEFAULT_MAX_INFLUENCES 4
+#endif
+
+// ---------------------------------------------------------------------------
+/** The PackSkinningProcess transposes the bone weights of each mesh into
+ *  the packed per-vertex streams aiMesh::mPackedBoneIndices and
+ *  aiMesh::mPackedBoneWeights. Each vertex gets a fixed number of slots;
+ *  if a vertex is affected by more bones, only the strongest influences
+ *  are kept and their weights are renormalized.
+ */
+class ASSIMP_API PackSkinningProcess : public BaseProcess
+{
+public:
+
+    PackSkinningProcess();
+    ~PackSkinningProcess();
+
+public:
+    // -------------------------------------------------------------------
+    /** Returns whether the processing step is present in the given flag.
+    * @param pFlags The processing flags the importer was called with.
+    *   A bitwise combination of #aiPostProcessSteps.
+    * @return true if the process is present in this flag fields,
+    *   false if not.
+    */
+    bool IsActive( unsigned int pFlags) const;
+
+    // -------------------------------------------------------------------
+    /** Called prior to ExecuteOnScene().
+    * The function is a request to the process to update its configuration
+    * basing on the Importer's configuration property list.
+    */
+    void SetupProperties(const Importer* pImp);
+
+    // -------------------------------------------------------------------
+    /** Executes the post processing step on the given imported data.
+    * At the moment a process is not supposed to fail.
+    * @param pScene The imported data to work at.
+    */
+    void Execute( aiScene* pScene);
+
+public:
+    // -------------------------------------------------------------------
+    /** Generates the packed skinning streams for a single mesh.
+    * @param pMesh The mesh to process.
+    * @return Number of vertices which lost influences because they are
+    *   affected by more bones than there are slots.
+    */
+    unsigned int ProcessMesh( aiMesh* pMesh) const;
+
+public:
+
+    /** Number of influences per vertex */
+    unsigned int mMaxInfluences;
+
+    /** Store weights as unsigned normalized 8 bit values? */
+    bool mUnorm8Weights;
+};
+
+} // end of namespace Assimp
+
+#endif // AI_PACKSKINNINGPROCESS_H_INC
@@ -0,0 +1,308 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2017, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file ParallelHelper.h
+ *  @brief Minimal helper to run independent work items concurrently.
+ *
+ *  If assimp is built with ASSIMP_BUILD_SINGLETHREADED, or only a single
+ *  hardware thread is available, all work items are processed in order
+ *  on the calling thread.
+ */
+#ifndef AI_PARALLELHELPER_H_INC
+#define AI_PARALLELHELPER_H_INC
+
+#include <assimp/defs.h>
+
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+#   include <assimp/DefaultLogger.hpp>
+#   include <thread>
+#   include <atomic>
+#   include <mutex>
+#   include <exception>
+#   include <string>
+#   include <vector>
+#   include <algorithm>
+#endif
+
+namespace Assimp {
+
+// ------------------------------------------------------------------------------------------------
+/** @brief Returns the number of threads ParallelFor() uses at most.
+ *
+ *  Callers can check this to skip splitting work which only pays off if
+ *  it really runs concurrently. */
+inline unsigned int GetParallelThreadCount()
+{
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+    return std::max(1u, std::thread::hardware_concurrency());
+#else
+    return 1;
+#endif
+}
+
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+
+// ------------------------------------------------------------------------------------------------
+/** @brief Logger of the ParallelFor() work item running on this thread, NULL if there is none.
+ *
+ *  DefaultLogger::get() returns it instead of the real logger, so the
+ *  loggers and log streams set by the application are never called from
+ *  a worker thread. */
+inline Logger*& GetWorkItemLogger()
+{
+    static thread_local Logger* logger = NULL;
+    return logger;
+}
+
+// ------------------------------------------------------------------------------------------------
+/** @brief Collects the messages of the work items run by one thread. They are
+ *  passed to the real logger on the calling thread of ParallelFor(). */
+class WorkItemLogger : public Logger
+{
+public:
+    struct Message {
+        Message(ErrorSeverity severity, const char* text)
+        : mSeverity(severity), mText(text) {}
+
+        ErrorSeverity mSeverity;
+        std::string mText;
+    };
+
+    WorkItemLogger()
+    : Logger(VERBOSE), mMessages() {}
+
+    /** Sets the list the messages of the next work item go to */
+    void SetTarget(std::vector<Message>* messages)
+        { mMessages = messages; }
+
+    /** Writes the messages to the given logger, in the order they were logged */
+    static void Flush(const std::vector<Message>& messages, Logger* logger)
+    {
+        for (std::vector<Message>::const_iterator it = messages.begin(); it != messages.end(); ++it) {
+            switch ((*it).mSeverity) {
+            case Debugging:
+                logger->debug((*it).mText);
+                break;
+            case Info:
+                logger->info((*it).mText);
+                break;
+            case Warn:
+                logger->warn((*it).mText);
+                break;
+            default:
+                logger->error((*it).mText);
+                break;
+            }
+        }
+    }
+
+    bool attachStream(LogStream*, unsigned int)
+        { return false; }
+    bool detatchStream(LogStream*, unsigned int)
+        { return false; }
+
+protected:
+    void OnDebug(const char* message)
+        { mMessages->push_back(Message(Debugging,message)); }
+    void OnInfo(const char* message)
+        { mMessages->push_back(Message(Info,message)); }
+    void OnWarn(const char* message)
+        { mMessages->push_back(Message(Warn,message)); }
+    void OnError(const char* message)
+        { mMessages->push_back(Message(Err,message)); }
+
+private:
+    std::vector<Message>* mMessages;
+};
+
+#endif // !ASSIMP_BUILD_SINGLETHREADED
+
+// ------------------------------------------------------------------------------------------------
+/** @brief Shared implementation of ParallelFor() and ParallelForWithCallerTask(), the
+ *  calling thread runs callerTask first if hasCallerTask is set. */
+template <typename Func, typename CallerTask>
+inline void ParallelForImpl(unsigned int count, Func func, CallerTask callerTask,
+    bool hasCallerTask, unsigned int maxThreads)
+{
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+    unsigned int numThreads = maxThreads ? maxThreads : GetParallelThreadCount();
+    numThreads = std::min(numThreads,count + (hasCallerTask ? 1 : 0));
+
+    if (numThreads > 1) {
+        std::atomic<unsigned int> nextItem(0);
+        std::exception_ptr error;
+        unsigned int errorItem = count;
+        std::mutex errorMutex;
+
+        // work items nested into another one log to its collector, nothing
+        // needs to be collected if the messages are dropped anyway
+        Logger* const logger = DefaultLogger::get();
+        std::vector< std::vector<WorkItemLogger::Message> > messages;
+        if (!DefaultLogger::isNullLogger() || GetWorkItemLogger()) {
+            messages.resize(count);
+        }
+
+        auto worker = [&]() {
+            WorkItemLogger collector;
+            Logger* const previous = GetWorkItemLogger();
+            if (!messages.empty()) {
+                GetWorkItemLogger() = &collector;
+            }
+
+            for (unsigned int i; (i = nextItem++) < count; ) {
+                try {
+                    if (!messages.empty()) {
+                        collector.SetTarget(&messages[i]);
+                    }
+                    func(i);
+                }
+                catch (...) {
+                    // items are handed out in order, so all items before
+                    // this one have been started already
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (i < errorItem) {
+                        errorItem = i;
+                        error = std::current_exception();
+                    }
+                    nextItem = count;
+                }
+            }
+            GetWorkItemLogger() = previous;
+        };
+
+        // the calling thread takes part in the work, too. If no more threads
+        // can be started, the ones running and the calling thread do the rest.
+        std::vector<std::thread> threads;
+        threads.reserve(numThreads-1);
+        for (unsigned int t = 1; t < numThreads; ++t) {
+            try {
+                threads.push_back(std::thread(worker));
+            }
+            catch (...) {
+                break;
+            }
+        }
+        std::exception_ptr callerError;
+        if (hasCallerTask) {
+            try {
+                callerTask();
+            }
+            catch (...) {
+                callerError = std::current_exception();
+                nextItem = count;
+            }
+        }
+        worker();
+        for (std::vector<std::thread>::iterator it = threads.begin(); it != threads.end(); ++it) {
+            it->join();
+        }
+
+        if (!messages.empty()) {
+            const unsigned int numLogged = error ? errorItem+1 : count;
+            for (unsigned int i = 0; i < numLogged; ++i) {
+                WorkItemLogger::Flush(messages[i],logger);
+            }
+        }
+        if (callerError) {
+            std::rethrow_exception(callerError);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return;
+    }
+#else
+    (void)maxThreads;
+#endif
+    if (hasCallerTask) {
+        callerTask();
+    }
+    for (unsigned int i = 0; i < count; ++i) {
+        func(i);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+/** @brief Calls func(i) for all i in [0,count).
+ *
+ *  Work items are handed out dynamically to up to maxThreads threads (0
+ *  selects the number of hardware threads), so callers must not rely on
+ *  the order in which they run. Each work item should only write data
+ *  owned by itself.
+ *
+ *  The results match a serial loop: the messages logged by the work items
+ *  are passed to the logger on the calling thread in item order. If work
+ *  items throw, the exception of the first of them is rethrown once all
+ *  threads have finished, and only the messages of the items before it
+ *  and of itself are logged.
+ *  @param count Number of work items
+ *  @param func Callable with the signature void(unsigned int)
+ *  @param maxThreads Maximum number of threads to use, 0 for automatic */
+template <typename Func>
+inline void ParallelFor(unsigned int count, Func func, unsigned int maxThreads = 0)
+{
+    ParallelForImpl(count,func,[]() {},false,maxThreads);
+}
+
+// ------------------------------------------------------------------------------------------------
+/** @brief Like ParallelFor(), but the calling thread runs callerTask() while the
+ *  other threads start on the work items, and joins them once it returns.
+ *
+ *  Use this for work which must stay on the calling thread, e.g. anything
+ *  using the IOSystem: the one of jassimp is bound to the JNI environment of
+ *  the thread which called the importer. callerTask() logs directly to the
+ *  logger. If it throws, no further work items are started and its exception
+ *  is rethrown once all threads have finished. Without a second thread it
+ *  runs before all work items.
+ *  @param count Number of work items
+ *  @param func Callable with the signature void(unsigned int)
+ *  @param callerTask Callable with the signature void()
+ *  @param maxThreads Maximum number of threads to use, 0 for automatic */
+template <typename Func, typename CallerTask>
+inline void ParallelForWithCallerTask(unsigned int count, Func func, CallerTask callerTask,
+    unsigned int maxThreads = 0)
+{
+    ParallelForImpl(count,func,callerTask,true,maxThreads);
+}
+
+} // end of namespace Assimp
+
+#endif // !! AI_PARALLELHELPER_H_INC
@@ -48,11 +48,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // internal headers
 #include "PlyLoader.h"
 #include "IOStreamBuffer.h"
+#include "MemoryIOWrapper.h"
 #include "Macros.h"
 #include <memory>
 #include <assimp/IOSystem.hpp>
 #include <assimp/scene.h>
 #include <assimp/importerdesc.h>
+#include <assimp/Importer.hpp>
+#include <assimp/config.h>
 
 using namespace Assimp;
 
@@ -85,15 +88,140 @@ namespace
 
     return props[idx];
   }
+
+  // ------------------------------------------------------------------------------------------------
+  // Position and type of a scalar property within a binary element instance
+  struct BinarySlot
+  {
+    BinarySlot()
+      : iOffset(0xFFFFFFFF)
+      , eType(PLY::EDT_Char)
+    {}
+
+    bool IsValid() const {
+      return 0xFFFFFFFF != iOffset;
+    }
+
+    unsigned int iOffset;
+    PLY::EDataType eType;
+  };
+
+  // ------------------------------------------------------------------------------------------------
+  // Decodes a slot of a binary element instance to a real value
+  inline ai_real ReadReal(const char* pInstance, const BinarySlot& slot, bool p_bBE)
+  {
+    return PLY::PropertyInstance::ConvertTo<ai_real>(
+      PLY::PropertyInstance::ReadValueBinary(pInstance + slot.iOffset, slot.eType, p_bBE), slot.eType);
+  }
+
+  // ------------------------------------------------------------------------------------------------
+  // Compiles the property layout of a binary vertex element, slots are indexed by semantic.
+  // Returns the number of known slots
+  unsigned int CompileVertexLayout(const PLY::Element* pcElement, BinarySlot* aSlots)
+  {
+    unsigned int iOffset(0), cnt(0);
+    for (std::vector<PLY::Property>::const_iterator a = pcElement->alProperties.begin();
+            a != pcElement->alProperties.end(); ++a) {
+        if ((*a).Semantic <= PLY::EST_Alpha) {
+            ++cnt;
+            aSlots[(*a).Semantic].iOffset = iOffset;
+            aSlots[(*a).Semantic].eType = (*a).eType;
+        }
+        iOffset += PLY::PropertyInstance::GetTypeSize((*a).eType);
+    }
+    return cnt;
+  }
+
+  // ------------------------------------------------------------------------------------------------
+  // Checks whether three slots are packed native floats which can be copied to an aiVector3D
+  bool IsPackedVector(const BinarySlot* slots, bool p_bBE)
+  {
+    if (p_bBE || sizeof(ai_real) != sizeof(float)) {
+      return false;
+    }
+    for (unsigned int i = 0; i < 3; ++i) {
+      if (!slots[i].IsValid() || PLY::EDT_Float != slots[i].eType || slots[i].iOffset != slots[0].iOffset + i * 4) {
+        return false;
+      }
+    }
+    return true;
+  }
 }
 
 
+// ------------------------------------------------------------------------------------------------
+// State of an incremental import
+struct PLYImporter::IncrementalState
+{
+  IncrementalState()
+    : mHeaderDone(false)
+    , mHeaderScan(0)
+    , mBinary(false)
+    , mBE(false)
+    , mElement(0)
+    , mInstance(0)
+    , mStarted(false)
+    , mFastPath(false)
+    , mFaceProperty(0xFFFFFFFF)
+  {}
+
+  // data which is not parsed yet
+  std::vector<char> mPending;
+
+  // the header is parsed once its 'end_header' line is complete,
+  // mHeaderScan is the offset of the first line not searched yet
+  bool mHeaderDone;
+  size_t mHeaderScan;
+
+  PLY::DOM mDOM;
+  bool mBinary;
+  bool mBE;
+
+  // next element instance to load
+  unsigned int mElement;
+  unsigned int mInstance;
+
+  // set once the current element is set up
+  bool mStarted;
+
+  // the current binary element is decoded without building instances
+  bool mFastPath;
+  unsigned int mFaceProperty;
+
+  // the mesh built so far, it is lent to mGeneratedMesh while loading
+  std::unique_ptr<aiMesh> mMesh;
+};
+
+// ------------------------------------------------------------------------------------------------
+// Lends the mesh of an incremental import to mGeneratedMesh for the duration
+// of a call. The mesh returns to the state also if the call throws.
+struct PLYImporter::MeshLoan
+{
+  MeshLoan(aiMesh*& target, std::unique_ptr<aiMesh>& owner)
+    : mTarget(target)
+    , mOwner(owner)
+  {
+    mTarget = mOwner.release();
+  }
+
+  ~MeshLoan()
+  {
+    mOwner.reset(mTarget);
+    mTarget = NULL;
+  }
+
+  aiMesh*& mTarget;
+  std::unique_ptr<aiMesh>& mOwner;
+};
+
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 PLYImporter::PLYImporter()
   : mBuffer()
   , pcDOM()
-  , mGeneratedMesh(NULL){
+  , mGeneratedMesh(NULL)
+  , mStreamWindowSize(0)
+  , mIncremental(){
   // empty
 }
 
@@ -103,6 +231,13 @@ PLYImporter::~PLYImporter() {
   // empty
 }
 
+// ------------------------------------------------------------------------------------------------
+// Setup configuration properties for the loader
+void PLYImporter::SetupProperties(const Importer* pImp)
+{
+  mStreamWindowSize = static_cast<unsigned int>(std::max(0, pImp->GetPropertyInteger(AI_CONFIG_IMPORT_STREAM_WINDOW_SIZE, 0)));
+}
+
 // ------------------------------------------------------------------------------------------------
 // Returns whether the class can handle the format of the given file.
 bool PLYImporter::CanRead(const std::string& pFile, IOSystem* pIOHandler, bool checkSig) const
@@ -151,6 +286,12 @@ static bool isBigEndian(const char* szMe) {
 void PLYImporter::InternReadFile(const std::string& pFile,
   aiScene* pScene, IOSystem* pIOHandler)
 {
+  // the previous mesh is owned by the scene it was imported into
+  mGeneratedMesh = NULL;
+
+  // a file import ends an unfinished incremental import
+  mIncremental.reset();
+
   static const std::string mode = "rb";
   std::unique_ptr<IOStream> fileStream(pIOHandler->Open(pFile, mode));
   if (!fileStream.get()) {
@@ -163,7 +304,7 @@ void PLYImporter::InternReadFile(const std::string& pFile,
       throw DeadlyImportError("File " + pFile + " is empty.");
   }
 
-  IOStreamBuffer<char> streamedBuffer(1024 * 1024);
+  IOStreamBuffer<char> streamedBuffer(mStreamWindowSize ? mStreamWindowSize : 1024 * 1024);
   streamedBuffer.open(fileStream.get());
 
   // the beginning of the file must be PLY - magic, magic
@@ -239,6 +380,332 @@ void PLYImporter::InternReadFile(const std::string& pFile,
   //free the file buffer
   streamedBuffer.close();
 
+  CreateScene(pScene);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Starts an incremental import
+void PLYImporter::InternBeginIncremental()
+{
+  // the previous mesh is owned by the scene it was imported into, the
+  // one of an unfinished incremental import is freed with its state
+  mGeneratedMesh = NULL;
+  mIncremental.reset(new IncrementalState());
+}
+
+// ------------------------------------------------------------------------------------------------
+// Loads the complete element instances passed so far
+void PLYImporter::InternFeedIncremental(const char* pData, size_t pLength)
+{
+  ai_assert(mIncremental);
+  IncrementalState& state = *mIncremental;
+
+  // data behind the last element is ignored
+  if (state.mHeaderDone && !NextIncrementalElement(state)) {
+    return;
+  }
+
+  try {
+    state.mPending.insert(state.mPending.end(), pData, pData + pLength);
+
+    if (!state.mHeaderDone && !ParseIncrementalHeader(state)) {
+      return;
+    }
+
+    MeshLoan loan(mGeneratedMesh, state.mMesh);
+    if (state.mBinary) {
+      LoadIncrementalBinary(state);
+    } else {
+      LoadIncrementalASCII(state, false);
+    }
+  } catch (...) {
+    // the import can't be continued after an error
+    mIncremental.reset();
+    throw;
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Loads the rest of the data and builds the scene
+void PLYImporter::InternFinishIncremental(aiScene* pScene)
+{
+  ai_assert(mIncremental);
+
+  // the import ends here, also if it fails
+  std::unique_ptr<IncrementalState> pState(std::move(mIncremental));
+  IncrementalState& state = *pState;
+
+  if (!state.mHeaderDone) {
+    throw DeadlyImportError("Invalid .ply file: The header is incomplete");
+  }
+
+  {
+    MeshLoan loan(mGeneratedMesh, state.mMesh);
+    if (state.mBinary) {
+      LoadIncrementalBinary(state);
+    } else {
+      LoadIncrementalASCII(state, true);
+    }
+  }
+
+  // the file ended before all element instances were read
+  if (NextIncrementalElement(state)) {
+    throw DeadlyImportError("Invalid .ply file: File corrupted");
+  }
+
+  // the mesh is owned by the scene from here on
+  mGeneratedMesh = state.mMesh.release();
+  CreateScene(pScene);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Parses the header of an incremental import once it is complete
+bool PLYImporter::ParseIncrementalHeader(IncrementalState& state)
+{
+  std::vector<char>& pending = state.mPending;
+  if (pending.empty()) {
+    return false;
+  }
+
+  // search the 'end_header' line, the header ends behind its line end
+  for (;;)
+  {
+    const char* begin = &pending[0];
+    const char* end = begin + pending.size();
+    const char* line = begin + state.mHeaderScan;
+    const char* lineEnd = FindLineEnd(line, end);
+    if (lineEnd == end) {
+      return false;
+    }
+    state.mHeaderScan = static_cast<size_t>(lineEnd + 1 - begin);
+
+    // reject other data as soon as its first line is there
+    if (line == begin && lineEnd != line &&
+        (lineEnd - line < 3 ||
+        (line[0] != 'P' && line[0] != 'p') ||
+        (line[1] != 'L' && line[1] != 'l') ||
+        (line[2] != 'Y' && line[2] != 'y')))
+    {
+      throw DeadlyImportError("Invalid .ply file: Magic number \'ply\' is no there");
+    }
+
+    SkipSpaces(&line);
+    if (!::strncmp(line, "end_header", 10) && IsSpaceOrNewLine(line[10])) {
+      break;
+    }
+  }
+
+  // the header is parsed by the stream buffer like a whole file
+  const size_t headerSize = state.mHeaderScan;
+  MemoryIOStream stream(reinterpret_cast<const uint8_t*>(&pending[0]), headerSize);
+  IOStreamBuffer<char> streamedBuffer(headerSize);
+  streamedBuffer.open(&stream);
+
+  std::vector<char> headerCheck;
+  streamedBuffer.getNextLine(headerCheck);
+  if ((headerCheck.size() < 3) ||
+      (headerCheck[0] != 'P' && headerCheck[0] != 'p') ||
+      (headerCheck[1] != 'L' && headerCheck[1] != 'l') ||
+      (headerCheck[2] != 'Y' && headerCheck[2] != 'y') )
+  {
+    throw DeadlyImportError("Invalid .ply file: Magic number \'ply\' is no there");
+  }
+
+  std::vector<char> mBuffer2;
+  streamedBuffer.getNextLine(mBuffer2);
+  char* szMe = &mBuffer2[0];
+  SkipSpacesAndLineEnd(szMe, (const char**)&szMe);
+
+  if (!TokenMatch(szMe, "format", 6)) {
+    throw DeadlyImportError("Invalid .ply file: Missing format specification");
+  }
+  if (TokenMatch(szMe, "ascii", 5)) {
+    state.mBinary = false;
+  } else if (!::strncmp(szMe, "binary_", 7)) {
+    state.mBinary = true;
+    state.mBE = isBigEndian(szMe + 7);
+  } else {
+    throw DeadlyImportError("Invalid .ply file: Unknown file format");
+  }
+
+  if (!PLY::DOM::ParseInstanceHeader(streamedBuffer, &state.mDOM, state.mBinary)) {
+    throw DeadlyImportError(state.mBinary ? "Invalid .ply file: Unable to build DOM (#2)" :
+      "Invalid .ply file: Unable to build DOM (#1)");
+  }
+  streamedBuffer.close();
+  this->pcDOM = &state.mDOM;
+
+  pending.erase(pending.begin(), pending.begin() + headerSize);
+  state.mHeaderDone = true;
+  return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Moves on to the next element with instances left to load
+bool PLYImporter::NextIncrementalElement(IncrementalState& state)
+{
+  const std::vector<PLY::Element>& alElements = state.mDOM.alElements;
+  while (state.mElement < alElements.size())
+  {
+    const PLY::Element* pcElement = &alElements[state.mElement];
+    if (state.mInstance < pcElement->NumOccur)
+    {
+      if (!state.mStarted)
+      {
+        // vertices and faces go straight to the mesh, as in ParseInstanceList()
+        if (pcElement->eSemantic != EEST_Vertex && pcElement->eSemantic != EEST_Face && pcElement->eSemantic != EEST_TriStrip)
+          state.mDOM.alElementData[state.mElement].alInstances.resize(pcElement->NumOccur);
+
+        state.mFastPath = false;
+        if (state.mBinary && pcElement->eSemantic == EEST_Vertex)
+          state.mFastPath = BeginVerticesBinary(pcElement);
+        else if (state.mBinary && pcElement->eSemantic == EEST_Face)
+          state.mFastPath = BeginFacesBinary(pcElement, state.mFaceProperty);
+        state.mStarted = true;
+      }
+      return true;
+    }
+    ++state.mElement;
+    state.mInstance = 0;
+    state.mStarted = false;
+  }
+  return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Loads the complete lines of an ASCII body
+void PLYImporter::LoadIncrementalASCII(IncrementalState& state, bool bFinal)
+{
+  std::vector<char>& pending = state.mPending;
+
+  // the piece ends behind the first line end after the last complete line,
+  // so the stream buffer splits the lines like those of the whole file
+  size_t cut = pending.size();
+  if (!bFinal)
+  {
+    while (cut && !IsLineEnd(pending[cut - 1]))
+      --cut;
+    while (cut && IsLineEnd(pending[cut - 1]))
+      --cut;
+    if (!cut)
+      return;
+    ++cut;
+  }
+  if (!cut)
+    return;
+
+  MemoryIOStream stream(reinterpret_cast<const uint8_t*>(&pending[0]), cut);
+  IOStreamBuffer<char> streamedBuffer(cut);
+  streamedBuffer.open(&stream);
+
+  IOStreamBuffer<char>::LineView line;
+  while (NextIncrementalElement(state) && streamedBuffer.getNextLineView(line))
+  {
+    const PLY::Element* pcElement = &state.mDOM.alElements[state.mElement];
+    const char* pCur = line.begin;
+
+    // lines of unknown elements are skipped
+    if (EEST_INVALID == pcElement->eSemantic || pcElement->alProperties.empty())
+    {
+    }
+    else if (pcElement->eSemantic == EEST_Vertex || pcElement->eSemantic == EEST_Face || pcElement->eSemantic == EEST_TriStrip)
+    {
+      PLY::ElementInstance elt;
+      PLY::ElementInstance::ParseInstance(pCur, line.end, pcElement, &elt);
+      if (pcElement->eSemantic == EEST_Vertex)
+        LoadVertex(pcElement, &elt, state.mInstance);
+      else
+        LoadFace(pcElement, &elt, state.mInstance);
+    }
+    else
+    {
+      PLY::ElementInstance::ParseInstance(pCur, line.end, pcElement,
+        &state.mDOM.alElementData[state.mElement].alInstances[state.mInstance]);
+    }
+    ++state.mInstance;
+  }
+  streamedBuffer.close();
+
+  // the lines behind the last element are not needed
+  if (!NextIncrementalElement(state))
+    pending.clear();
+  else
+    pending.erase(pending.begin(), pending.begin() + cut);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Loads the complete element instances of a binary body
+void PLYImporter::LoadIncrementalBinary(IncrementalState& state)
+{
+  std::vector<char>& pending = state.mPending;
+  const char* pBegin = pending.empty() ? NULL : &pending[0];
+  const char* pCur = pBegin;
+  unsigned int bufferSize = static_cast<unsigned int>(pending.size());
+
+  // the instances are complete, so the stream is never read
+  IOStreamBuffer<char> noStream;
+  std::vector<char> noBuffer;
+
+  while (NextIncrementalElement(state))
+  {
+    const PLY::Element* pcElement = &state.mDOM.alElements[state.mElement];
+    if (state.mFastPath && pcElement->eSemantic == EEST_Vertex)
+    {
+      const unsigned int iStride = pcElement->GetBinaryStride();
+      const unsigned int iNum = std::min(pcElement->NumOccur - state.mInstance, bufferSize / iStride);
+      if (!iNum)
+        break;
+
+      DecodeVerticesBinary(pCur, state.mInstance, iNum, pcElement, state.mBE);
+      pCur += iNum * iStride;
+      bufferSize -= iNum * iStride;
+      state.mInstance += iNum;
+      continue;
+    }
+
+    unsigned int iSize;
+    if (!PLY::ElementInstance::GetBinarySize(pCur, bufferSize, pcElement, state.mBE, iSize))
+      break;
+
+    if (state.mFastPath)
+    {
+      DecodeFaceBinary(pCur, state.mInstance, pcElement, state.mFaceProperty, state.mBE);
+    }
+    else
+    {
+      const char* pInstance = pCur;
+      unsigned int iInstanceSize = iSize;
+      if (pcElement->eSemantic == EEST_Vertex || pcElement->eSemantic == EEST_Face || pcElement->eSemantic == EEST_TriStrip)
+      {
+        PLY::ElementInstance elt;
+        PLY::ElementInstance::ParseInstanceBinary(noStream, noBuffer, pInstance, iInstanceSize, pcElement, &elt, state.mBE);
+        if (pcElement->eSemantic == EEST_Vertex)
+          LoadVertex(pcElement, &elt, state.mInstance);
+        else
+          LoadFace(pcElement, &elt, state.mInstance);
+      }
+      else
+      {
+        PLY::ElementInstance::ParseInstanceBinary(noStream, noBuffer, pInstance, iInstanceSize, pcElement,
+          &state.mDOM.alElementData[state.mElement].alInstances[state.mInstance], state.mBE);
+      }
+    }
+    pCur += iSize;
+    bufferSize -= iSize;
+    ++state.mInstance;
+  }
+
+  // the data behind the last element is not needed
+  if (!NextIncrementalElement(state))
+    pending.clear();
+  else
+    pending.erase(pending.begin(), pending.begin() + (pCur - pBegin));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Builds the output scene
+void PLYImporter::CreateScene(aiScene* pScene)
+{
   if (mGeneratedMesh == NULL)
   {
     throw DeadlyImportError("Invalid .ply file: Unable to extract mesh data ");
@@ -251,10 +718,9 @@ void PLYImporter::InternReadFile(const std::string& pFile,
   {
     if (mGeneratedMesh->mNumVertices < 3)
     {
-      if (mGeneratedMesh != NULL)
-        delete(mGeneratedMesh);
+      delete(mGeneratedMesh);
+      mGeneratedMesh = NULL;
 
-      streamedBuffer.close();
       throw DeadlyImportError("Invalid .ply file: Not enough "
         "vertices to build a proper face list. ");
     }
@@ -502,6 +968,147 @@ void PLYImporter::LoadVertex(const PLY::Element* pcElement, const PLY::ElementIn
 }
 
 
+// ------------------------------------------------------------------------------------------------
+bool PLYImporter::LoadVerticesBinary(IOStreamBuffer<char> &streamBuffer, std::vector<char> &buffer,
+    const char* &pCur, unsigned int &bufferSize, const PLY::Element* pcElement, bool p_bBE)
+{
+    ai_assert(NULL != pcElement);
+    if (!BeginVerticesBinary(pcElement)) {
+        return false;
+    }
+
+    const unsigned int iStride = pcElement->GetBinaryStride();
+    for (unsigned int pos = 0; pos < pcElement->NumOccur; ) {
+        PLY::PropertyInstance::RequestBinaryData(streamBuffer, buffer, pCur, bufferSize, iStride);
+        const unsigned int iNum = std::min(pcElement->NumOccur - pos, bufferSize / iStride);
+
+        DecodeVerticesBinary(pCur, pos, iNum, pcElement, p_bBE);
+
+        pCur += iNum * iStride;
+        bufferSize -= iNum * iStride;
+        pos += iNum;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool PLYImporter::BeginVerticesBinary(const PLY::Element* pcElement)
+{
+    ai_assert(NULL != pcElement);
+
+    // only elements without lists have a fixed size. Further vertex
+    // elements are merged into the existing mesh by LoadVertex()
+    if (0 == pcElement->GetBinaryStride() || nullptr != mGeneratedMesh) {
+        return false;
+    }
+
+    BinarySlot aSlots[PLY::EST_Alpha + 1];
+    const unsigned int cnt = CompileVertexLayout(pcElement, aSlots);
+
+    const BinarySlot* aNormal = aSlots + PLY::EST_XNormal;
+    const BinarySlot* aColors = aSlots + PLY::EST_Red;
+    const BinarySlot* aTexcoord = aSlots + PLY::EST_UTextureCoord;
+
+    if (0 != cnt && 0 != pcElement->NumOccur) {
+        mGeneratedMesh = new aiMesh();
+        mGeneratedMesh->mMaterialIndex = 0;
+        mGeneratedMesh->mNumVertices = pcElement->NumOccur;
+        mGeneratedMesh->mVertices = new aiVector3D[mGeneratedMesh->mNumVertices];
+
+        if (aNormal[0].IsValid() || aNormal[1].IsValid() || aNormal[2].IsValid()) {
+            mGeneratedMesh->mNormals = new aiVector3D[mGeneratedMesh->mNumVertices];
+        }
+        if (aColors[0].IsValid() || aColors[1].IsValid() || aColors[2].IsValid() || aColors[3].IsValid()) {
+            mGeneratedMesh->mColors[0] = new aiColor4D[mGeneratedMesh->mNumVertices];
+        }
+        if (aTexcoord[0].IsValid() || aTexcoord[1].IsValid()) {
+            mGeneratedMesh->mNumUVComponents[0] = 2;
+            mGeneratedMesh->mTextureCoords[0] = new aiVector3D[mGeneratedMesh->mNumVertices];
+        }
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void PLYImporter::DecodeVerticesBinary(const char* pCur, unsigned int first, unsigned int iNum,
+    const PLY::Element* pcElement, bool p_bBE)
+{
+    // no known vertex components, skip the data
+    if (nullptr == mGeneratedMesh) {
+        return;
+    }
+
+    BinarySlot aSlots[PLY::EST_Alpha + 1];
+    const unsigned int cnt = CompileVertexLayout(pcElement, aSlots);
+    const unsigned int iStride = pcElement->GetBinaryStride();
+
+    const BinarySlot* aPositions = aSlots + PLY::EST_XCoord;
+    const BinarySlot* aNormal = aSlots + PLY::EST_XNormal;
+    const BinarySlot* aColors = aSlots + PLY::EST_Red;
+    const BinarySlot* aTexcoord = aSlots + PLY::EST_UTextureCoord;
+
+    // native float vectors are copied as they are, a file holding
+    // nothing but positions is copied as a whole
+    const bool bPackedPositions = IsPackedVector(aPositions, p_bBE);
+    const bool bPackedNormals = IsPackedVector(aNormal, p_bBE);
+    const bool bPositionsOnly = bPackedPositions && 3 == cnt && 3 * sizeof(float) == iStride;
+
+    if (bPositionsOnly) {
+        ::memcpy(&mGeneratedMesh->mVertices[first].x, pCur, iNum * iStride);
+        return;
+    }
+
+    for (unsigned int i = 0; i < iNum; ++i) {
+        const char* pInstance = pCur + i * iStride;
+        const unsigned int iVertex = first + i;
+
+        aiVector3D& vOut = mGeneratedMesh->mVertices[iVertex];
+        if (bPackedPositions) {
+            ::memcpy(&vOut.x, pInstance + aPositions[0].iOffset, sizeof(aiVector3D));
+        } else {
+            for (unsigned int c = 0; c < 3; ++c) {
+                if (aPositions[c].IsValid()) {
+                    vOut[c] = ReadReal(pInstance, aPositions[c], p_bBE);
+                }
+            }
+        }
+
+        if (mGeneratedMesh->mNormals) {
+            aiVector3D& nOut = mGeneratedMesh->mNormals[iVertex];
+            if (bPackedNormals) {
+                ::memcpy(&nOut.x, pInstance + aNormal[0].iOffset, sizeof(aiVector3D));
+            } else {
+                for (unsigned int c = 0; c < 3; ++c) {
+                    if (aNormal[c].IsValid()) {
+                        nOut[c] = ReadReal(pInstance, aNormal[c], p_bBE);
+                    }
+                }
+            }
+        }
+
+        if (mGeneratedMesh->mColors[0]) {
+            // assume 1.0 for the alpha channel if it is not set
+            ai_real aChannels[4] = { 0.0, 0.0, 0.0, 1.0 };
+            for (unsigned int c = 0; c < 4; ++c) {
+                if (aColors[c].IsValid()) {
+                    aChannels[c] = NormalizeColorValue(PLY::PropertyInstance::ReadValueBinary(
+                        pInstance + aColors[c].iOffset, aColors[c].eType, p_bBE), aColors[c].eType);
+                }
+            }
+            mGeneratedMesh->mColors[0][iVertex] = aiColor4D(aChannels[0], aChannels[1], aChannels[2], aChannels[3]);
+        }
+
+        if (mGeneratedMesh->mTextureCoords[0]) {
+            aiVector3D& tOut = mGeneratedMesh->mTextureCoords[0][iVertex];
+            for (unsigned int c = 0; c < 2; ++c) {
+                if (aTexcoord[c].IsValid()) {
+                    tOut[c] = ReadReal(pInstance, aTexcoord[c], p_bBE);
+                }
+            }
+        }
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 // Convert a color component to [0...1]
 ai_real PLYImporter::NormalizeColorValue(PLY::PropertyInstance::ValueUnion val,
@@ -728,6 +1335,117 @@ void PLYImporter::LoadFace(const PLY::Element* pcElement, const PLY::ElementInst
   }
 }
 
+// ------------------------------------------------------------------------------------------------
+bool PLYImporter::LoadFacesBinary(IOStreamBuffer<char> &streamBuffer, std::vector<char> &buffer,
+  const char* &pCur, unsigned int &bufferSize, const PLY::Element* pcElement, bool p_bBE)
+{
+  ai_assert(NULL != pcElement);
+
+  unsigned int iProperty;
+  if (!BeginFacesBinary(pcElement, iProperty))
+    return false;
+
+  for (unsigned int pos = 0; pos < pcElement->NumOccur; ++pos)
+  {
+    // make sure the whole face is in the buffer
+    unsigned int iSize;
+    while (!PLY::ElementInstance::GetBinarySize(pCur, bufferSize, pcElement, p_bBE, iSize))
+    {
+      PLY::PropertyInstance::RequestBinaryData(streamBuffer, buffer, pCur, bufferSize, iSize);
+    }
+
+    DecodeFaceBinary(pCur, pos, pcElement, iProperty, p_bBE);
+
+    pCur += iSize;
+    bufferSize -= iSize;
+  }
+  return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool PLYImporter::BeginFacesBinary(const PLY::Element* pcElement, unsigned int &iProperty)
+{
+  ai_assert(NULL != pcElement);
+
+  // faces carrying texture coordinates and further face elements
+  // are handled by LoadFace()
+  if (mGeneratedMesh == NULL || mGeneratedMesh->mFaces != NULL)
+    return false;
+
+  // find the vertex index list and make sure all sizes are known
+  iProperty = 0xFFFFFFFF;
+  unsigned int _a = 0;
+  for (std::vector<PLY::Property>::const_iterator a = pcElement->alProperties.begin();
+    a != pcElement->alProperties.end(); ++a, ++_a)
+  {
+    if (0 == PLY::PropertyInstance::GetTypeSize((*a).eType))
+      return false;
+
+    if (!(*a).bIsList)
+      continue;
+
+    if (0 == PLY::PropertyInstance::GetTypeSize((*a).eFirstType))
+      return false;
+
+    if (PLY::EST_VertexIndex == (*a).Semantic)
+      iProperty = _a;
+    else if (PLY::EST_TextureCoordinates == (*a).Semantic)
+      return false;
+  }
+
+  if (0xFFFFFFFF == iProperty)
+    return false;
+
+  if (0 == pcElement->NumOccur)
+    return true;
+
+  mGeneratedMesh->mNumFaces = pcElement->NumOccur;
+  mGeneratedMesh->mFaces = new aiFace[mGeneratedMesh->mNumFaces];
+  return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void PLYImporter::DecodeFaceBinary(const char* pCur, unsigned int pos, const PLY::Element* pcElement,
+  unsigned int iProperty, bool p_bBE)
+{
+  unsigned int _a = 0;
+  for (std::vector<PLY::Property>::const_iterator a = pcElement->alProperties.begin();
+    a != pcElement->alProperties.end(); ++a, ++_a)
+  {
+    unsigned int iNum = 1;
+    if ((*a).bIsList)
+    {
+      // read the number of elements in the list
+      iNum = PLY::PropertyInstance::ConvertTo<unsigned int>(
+        PLY::PropertyInstance::ReadValueBinary(pCur, (*a).eFirstType, p_bBE), (*a).eFirstType);
+      pCur += PLY::PropertyInstance::GetTypeSize((*a).eFirstType);
+    }
+
+    const unsigned int iSize = PLY::PropertyInstance::GetTypeSize((*a).eType);
+    if (_a == iProperty)
+    {
+      aiFace& face = mGeneratedMesh->mFaces[pos];
+      face.mNumIndices = iNum;
+      face.mIndices = new unsigned int[iNum];
+
+      // native 32 bit indices are copied as they are
+      if (!p_bBE && (EDT_Int == (*a).eType || EDT_UInt == (*a).eType))
+      {
+        ::memcpy(face.mIndices, pCur, iNum * sizeof(unsigned int));
+      }
+      else
+      {
+        for (unsigned int i = 0; i < iNum; ++i)
+        {
+          face.mIndices[i] = PLY::PropertyInstance::ConvertTo<unsigned int>(
+            PLY::PropertyInstance::ReadValueBinary(pCur + i * iSize, (*a).eType, p_bBE), (*a).eType);
+        }
+      }
+    }
+    pCur += iNum * iSize;
+  }
+}
+
 // ------------------------------------------------------------------------------------------------
 // Get a RGBA color in [0...1] range
 void PLYImporter::GetMaterialColor(const std::vector<PLY::PropertyInstance>& avList,
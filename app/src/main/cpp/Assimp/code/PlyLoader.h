@@ -48,6 +48,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "BaseImporter.h"
 #include <assimp/types.h>
 #include "PlyParser.h"
+#include <memory>
 #include <vector>
 
 struct aiNode;
@@ -87,6 +88,57 @@ public:
     */
     void LoadFace(const PLY::Element* pcElement, const PLY::ElementInstance* instElement, unsigned int pos);
 
+    // -------------------------------------------------------------------
+    /** Read all vertices of a binary element straight from the stream.
+     *  The property layout of the element is compiled once, each vertex
+     *  is then decoded from its fixed offsets without building a DOM
+     *  instance. Returns false if the layout is not supported, the
+     *  caller falls back to LoadVertex() in this case.
+    */
+    bool LoadVerticesBinary(IOStreamBuffer<char> &streamBuffer, std::vector<char> &buffer,
+        const char* &pCur, unsigned int &bufferSize, const PLY::Element* pcElement, bool p_bBE);
+
+    // -------------------------------------------------------------------
+    /** Set up the mesh for a binary vertex element which is decoded by
+     *  DecodeVerticesBinary(). Returns false if the layout is not supported.
+    */
+    bool BeginVerticesBinary(const PLY::Element* pcElement);
+
+    // -------------------------------------------------------------------
+    /** Decode iNum binary vertices starting with the vertex 'first' from
+     *  pCur, see LoadVerticesBinary().
+    */
+    void DecodeVerticesBinary(const char* pCur, unsigned int first, unsigned int iNum,
+        const PLY::Element* pcElement, bool p_bBE);
+
+    // -------------------------------------------------------------------
+    /** Read all faces of a binary element straight from the stream.
+     *  Returns false if the layout is not supported, the caller falls
+     *  back to LoadFace() in this case.
+    */
+    bool LoadFacesBinary(IOStreamBuffer<char> &streamBuffer, std::vector<char> &buffer,
+        const char* &pCur, unsigned int &bufferSize, const PLY::Element* pcElement, bool p_bBE);
+
+    // -------------------------------------------------------------------
+    /** Set up the faces for a binary face element which is decoded by
+     *  DecodeFaceBinary(). Returns false if the layout is not supported,
+     *  iProperty is the index of the vertex index list otherwise.
+    */
+    bool BeginFacesBinary(const PLY::Element* pcElement, unsigned int &iProperty);
+
+    // -------------------------------------------------------------------
+    /** Decode the binary face at pCur, the whole face must be in memory.
+    */
+    void DecodeFaceBinary(const char* pCur, unsigned int pos, const PLY::Element* pcElement,
+        unsigned int iProperty, bool p_bBE);
+
+    // -------------------------------------------------------------------
+    /** Called prior to ReadFile().
+     * The function is a request to the importer to update its configuration
+     * basing on the Importer's configuration property list.
+     */
+    void SetupProperties(const Importer* pImp);
+
 protected:
 
     // -------------------------------------------------------------------
@@ -102,7 +154,59 @@ protected:
     void InternReadFile( const std::string& pFile, aiScene* pScene,
         IOSystem* pIOHandler);
 
+    // -------------------------------------------------------------------
+    /** Start an incremental import.
+    * See BaseImporter::InternBeginIncremental() for details
+    */
+    void InternBeginIncremental();
+
+    // -------------------------------------------------------------------
+    /** Parse the header as soon as it is complete, then load all complete
+    * element instances.
+    * See BaseImporter::InternFeedIncremental() for details
+    */
+    void InternFeedIncremental(const char* pData, size_t pLength);
+
+    // -------------------------------------------------------------------
+    /** Finish an incremental import.
+    * See BaseImporter::InternFinishIncremental() for details
+    */
+    void InternFinishIncremental(aiScene* pScene);
+
 protected:
+    /** State of an incremental import */
+    struct IncrementalState;
+    /** Lends the mesh of an incremental import to mGeneratedMesh */
+    struct MeshLoan;
+
+    // -------------------------------------------------------------------
+    /** Parse the header of an incremental import once its 'end_header'
+    *  line is complete. Returns false if the header is not complete yet.
+    */
+    bool ParseIncrementalHeader(IncrementalState& state);
+
+    // -------------------------------------------------------------------
+    /** Move on to the next element of an incremental import once all
+    *  instances of the current one are loaded. Returns false if all
+    *  elements are loaded.
+    */
+    bool NextIncrementalElement(IncrementalState& state);
+
+    // -------------------------------------------------------------------
+    /** Load the complete lines of an ASCII body, all lines if bFinal is set
+    */
+    void LoadIncrementalASCII(IncrementalState& state, bool bFinal);
+
+    // -------------------------------------------------------------------
+    /** Load the complete element instances of a binary body
+    */
+    void LoadIncrementalBinary(IncrementalState& state);
+
+    // -------------------------------------------------------------------
+    /** Build the output scene from the generated mesh and the DOM
+    */
+    void CreateScene(aiScene* pScene);
+
     // -------------------------------------------------------------------
     /** Extract a material list from the DOM
     */
@@ -133,6 +237,12 @@ protected:
 
     /** Mesh generated by loader */
     aiMesh* mGeneratedMesh;
+
+    /** Window size of the stream buffer, 0 for the default */
+    unsigned int mStreamWindowSize;
+
+    /** State of the running incremental import, it owns the mesh */
+    std::unique_ptr<IncrementalState> mIncremental;
 };
 
 } // end of namespace Assimp
@@ -51,6 +51,58 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 using namespace Assimp;
 
+// Maximum number of float properties read at once
+#define AI_PLY_FLOAT_RUN 16
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Reads the integers of a list property in chunks, up to the first token which isn't a plain
+// number. Returns the number of values read, the others are left to ParseValue().
+unsigned int ParseIntegerList(const char* &pCur, const char* pEnd, PLY::EDataType eType,
+  PLY::PropertyInstance::ValueUnion* out, unsigned int num)
+{
+  const unsigned int chunkSize = 16;
+  unsigned int i = 0;
+  switch (eType)
+  {
+  case PLY::EDT_UInt:
+  case PLY::EDT_UShort:
+  case PLY::EDT_UChar:
+    while (i < num && pCur < pEnd)
+    {
+      unsigned int values[chunkSize];
+      const unsigned int cnt = std::min(num - i, chunkSize);
+      const size_t read = strtoul10_n(pCur, pEnd, values, cnt, &pCur);
+      for (size_t k = 0; k < read; ++k)
+        out[i++].iUInt = values[k];
+      if (read != cnt)
+        break;
+    }
+    break;
+
+  case PLY::EDT_Int:
+  case PLY::EDT_Short:
+  case PLY::EDT_Char:
+    while (i < num && pCur < pEnd)
+    {
+      int values[chunkSize];
+      const unsigned int cnt = std::min(num - i, chunkSize);
+      const size_t read = strtol10_n(pCur, pEnd, values, cnt, &pCur);
+      for (size_t k = 0; k < read; ++k)
+        out[i++].iInt = values[k];
+      if (read != cnt)
+        break;
+    }
+    break;
+
+  default:;
+  };
+  return i;
+}
+
+} // end of anonymous namespace
+
 // ------------------------------------------------------------------------------------------------
 PLY::EDataType PLY::Property::ParseDataType(std::vector<char> &buffer) {
   ai_assert(!buffer.empty());
@@ -414,6 +466,21 @@ bool PLY::Element::ParseElement(IOStreamBuffer<char> &streamBuffer, std::vector<
   return true;
 }
 
+// ------------------------------------------------------------------------------------------------
+unsigned int PLY::Element::GetBinaryStride() const
+{
+  unsigned int iStride = 0;
+  for (std::vector<PLY::Property>::const_iterator a = alProperties.begin(); a != alProperties.end(); ++a)
+  {
+    const unsigned int iSize = PLY::PropertyInstance::GetTypeSize((*a).eType);
+    if ((*a).bIsList || 0 == iSize)
+      return 0;
+
+    iStride += iSize;
+  }
+  return iStride;
+}
+
 // ------------------------------------------------------------------------------------------------
 bool PLY::DOM::SkipSpaces(std::vector<char> &buffer)
 {
@@ -662,6 +729,23 @@ bool PLY::DOM::ParseInstance(IOStreamBuffer<char> &streamBuffer, DOM* p_pcOut, P
   return true;
 }
 
+// ------------------------------------------------------------------------------------------------
+bool PLY::DOM::ParseInstanceHeader(IOStreamBuffer<char> &streamBuffer, DOM* p_pcOut, bool isBinary)
+{
+  ai_assert(NULL != p_pcOut);
+
+  std::vector<char> buffer;
+  streamBuffer.getNextLine(buffer);
+
+  if (!p_pcOut->ParseHeader(streamBuffer, buffer, isBinary))
+  {
+    DefaultLogger::get()->debug("PLY::DOM::ParseInstanceHeader() failure");
+    return false;
+  }
+  p_pcOut->alElementData.resize(p_pcOut->alElements.size());
+  return true;
+}
+
 // ------------------------------------------------------------------------------------------------
 bool PLY::ElementInstanceList::ParseInstanceList(
   IOStreamBuffer<char> &streamBuffer,
@@ -687,15 +771,17 @@ bool PLY::ElementInstanceList::ParseInstanceList(
   else
   {
     const char* pCur = (const char*)&buffer[0];
+    const char* pEnd = pCur + strlen(pCur);
+    IOStreamBuffer<char>::LineView line;
     // be sure to have enough storage
     for (unsigned int i = 0; i < pcElement->NumOccur; ++i)
     {
       if (p_pcOut)
-        PLY::ElementInstance::ParseInstance(pCur, pcElement, &p_pcOut->alInstances[i]);
+        PLY::ElementInstance::ParseInstance(pCur, pEnd, pcElement, &p_pcOut->alInstances[i]);
       else
       {
         ElementInstance elt;
-        PLY::ElementInstance::ParseInstance(pCur, pcElement, &elt);
+        PLY::ElementInstance::ParseInstance(pCur, pEnd, pcElement, &elt);
 
         // Create vertex or face
         if (pcElement->eSemantic == EEST_Vertex)
@@ -715,8 +801,19 @@ bool PLY::ElementInstanceList::ParseInstanceList(
         }
       }
 
-      streamBuffer.getNextLine(buffer);
-      pCur = (buffer.empty()) ? NULL : (const char*)&buffer[0];
+      // the lines of the instances are parsed in the window of the stream buffer,
+      // only the line behind the element is copied for the next element
+      if (i + 1 < pcElement->NumOccur && streamBuffer.getNextLineView(line))
+      {
+        pCur = line.begin;
+        pEnd = line.end;
+      }
+      else
+      {
+        streamBuffer.getNextLine(buffer);
+        pCur = (buffer.empty()) ? NULL : (const char*)&buffer[0];
+        pEnd = (buffer.empty()) ? NULL : pCur + strlen(pCur);
+      }
     }
   }
   return true;
@@ -739,6 +836,18 @@ bool PLY::ElementInstanceList::ParseInstanceListBinary(
   // we can't skip it as a whole block (we don't know its exact size
   // due to the fact that lists could be contained in the property list
   // of the unknown element)
+  // vertices and faces in common layouts are decoded by the loader
+  // straight from the stream into the output mesh, without building
+  // an instance for each of them
+  if (!p_pcOut)
+  {
+    if (pcElement->eSemantic == EEST_Vertex && loader->LoadVerticesBinary(streamBuffer, buffer, pCur, bufferSize, pcElement, p_bBE))
+      return true;
+
+    if (pcElement->eSemantic == EEST_Face && loader->LoadFacesBinary(streamBuffer, buffer, pCur, bufferSize, pcElement, p_bBE))
+      return true;
+  }
+
   for (unsigned int i = 0; i < pcElement->NumOccur; ++i)
   {
     if (p_pcOut)
@@ -771,6 +880,7 @@ bool PLY::ElementInstanceList::ParseInstanceListBinary(
 
 // ------------------------------------------------------------------------------------------------
 bool PLY::ElementInstance::ParseInstance(const char* &pCur,
+  const char* pEnd,
   const PLY::Element* pcElement,
   PLY::ElementInstance* p_pcOut)
 {
@@ -784,7 +894,35 @@ bool PLY::ElementInstance::ParseInstance(const char* &pCur,
   std::vector<PLY::Property>::const_iterator  a = pcElement->alProperties.begin();
   for (; i != p_pcOut->alProperties.end(); ++i, ++a)
   {
-    if (!(PLY::PropertyInstance::ParseInstance(pCur, &(*a), &(*i))))
+    // runs of float properties, usually positions, normals and texture coordinates,
+    // are read at once. Whatever isn't a plain number is parsed one by one below.
+    if (pEnd && pCur < pEnd && !(*a).bIsList && EDT_Float == (*a).eType)
+    {
+      ai_real values[AI_PLY_FLOAT_RUN];
+      size_t run = 1;
+      while (run < AI_PLY_FLOAT_RUN && a + run != pcElement->alProperties.end() &&
+        !a[run].bIsList && EDT_Float == a[run].eType)
+      {
+        ++run;
+      }
+
+      const size_t num = fast_atoreal_n<ai_real>(pCur, pEnd, values, run, &pCur);
+      if (num)
+      {
+        for (size_t k = 0; k < num; ++k)
+        {
+          PLY::PropertyInstance::ValueUnion v;
+          v.fFloat = values[k];
+          i[k].avList.push_back(v);
+        }
+        SkipSpacesAndLineEnd(&pCur);
+        i += num - 1;
+        a += num - 1;
+        continue;
+      }
+    }
+
+    if (!(PLY::PropertyInstance::ParseInstance(pCur, pEnd, &(*a), &(*i))))
     {
       DefaultLogger::get()->warn("Unable to parse property instance. "
         "Skipping this element instance");
@@ -827,8 +965,48 @@ bool PLY::ElementInstance::ParseInstanceBinary(
   return true;
 }
 
+// ------------------------------------------------------------------------------------------------
+bool PLY::ElementInstance::GetBinarySize(const char* pCur,
+  unsigned int bufferSize,
+  const PLY::Element* pcElement,
+  bool p_bBE,
+  unsigned int &iSize)
+{
+  ai_assert(NULL != pcElement);
+
+  // the list lengths are read in place, the bytes behind them are only counted
+  uint64_t iTotal = 0;
+  for (std::vector<PLY::Property>::const_iterator a = pcElement->alProperties.begin();
+    a != pcElement->alProperties.end(); ++a)
+  {
+    uint64_t iNum = 1;
+    if ((*a).bIsList)
+    {
+      const unsigned int iFirstSize = PLY::PropertyInstance::GetTypeSize((*a).eFirstType);
+      if (0 == iFirstSize)
+        throw DeadlyImportError("Invalid .ply file: Unknown type of a list length");
+
+      if (iTotal + iFirstSize > bufferSize)
+      {
+        iSize = static_cast<unsigned int>(iTotal + iFirstSize);
+        return false;
+      }
+      iNum = PLY::PropertyInstance::ConvertTo<unsigned int>(
+        PLY::PropertyInstance::ReadValueBinary(pCur + iTotal, (*a).eFirstType, p_bBE), (*a).eFirstType);
+      iTotal += iFirstSize;
+    }
+    iTotal += iNum * PLY::PropertyInstance::GetTypeSize((*a).eType);
+    if (iTotal > 0xFFFFFFFF)
+      throw DeadlyImportError("Invalid .ply file: List is too long");
+  }
+
+  iSize = static_cast<unsigned int>(iTotal);
+  return iSize <= bufferSize;
+}
+
 // ------------------------------------------------------------------------------------------------
 bool PLY::PropertyInstance::ParseInstance(const char* &pCur,
+  const char* pEnd,
   const PLY::Property* prop, PLY::PropertyInstance* p_pcOut)
 {
   ai_assert(NULL != prop);
@@ -849,9 +1027,14 @@ bool PLY::PropertyInstance::ParseInstance(const char* &pCur,
     // convert to unsigned int
     unsigned int iNum = PLY::PropertyInstance::ConvertTo<unsigned int>(v, prop->eFirstType);
 
-    // parse all list elements
+    // parse all list elements, integers as a whole first
     p_pcOut->avList.resize(iNum);
-    for (unsigned int i = 0; i < iNum; ++i)
+    unsigned int i = 0;
+    if (pEnd && iNum)
+    {
+      i = ParseIntegerList(pCur, pEnd, prop->eType, &p_pcOut->avList[0], iNum);
+    }
+    for (; i < iNum; ++i)
     {
       if (!SkipSpaces(&pCur))
         return false;
@@ -991,62 +1174,37 @@ bool PLY::PropertyInstance::ParseValueBinary(IOStreamBuffer<char> &streamBuffer,
   ai_assert(NULL != out);
 
   //calc element size
-  unsigned int lsize = 0;
-  switch (eType)
+  const unsigned int lsize = GetTypeSize(eType);
+  if (0 == lsize)
   {
-  case EDT_Char:
-  case EDT_UChar:
-    lsize = 1;
-    break;
-
-  case EDT_UShort:
-  case EDT_Short:
-    lsize = 2;
-    break;
+    return false;
+  }
 
-  case EDT_UInt:
-  case EDT_Int:
-  case EDT_Float:
-    lsize = 4;
-    break;
+  //read the next file block if needed
+  RequestBinaryData(streamBuffer, buffer, pCur, bufferSize, lsize);
 
-  case EDT_Double:
-    lsize = 8;
-    break;
+  *out = ReadValueBinary(pCur, eType, p_bBE);
+  pCur += lsize;
+  bufferSize -= lsize;
 
-  case EDT_INVALID:
-  default:
-      break;
-  }
+  return true;
+}
 
-  //read the next file block if needed
-  if (bufferSize < lsize)
-  {
-    std::vector<char> nbuffer;
-    if (streamBuffer.getNextBlock(nbuffer))
-    {
-      //concat buffer contents
-      buffer = std::vector<char>(buffer.end() - bufferSize, buffer.end());
-      buffer.insert(buffer.end(), nbuffer.begin(), nbuffer.end());
-      nbuffer.clear();
-      bufferSize = static_cast<unsigned int>(buffer.size());
-      pCur = (char*)&buffer[0];
-    }
-    else
-    {
-      throw DeadlyImportError("Invalid .ply file: File corrupted");
-    }
-  }
+// ------------------------------------------------------------------------------------------------
+PLY::PropertyInstance::ValueUnion PLY::PropertyInstance::ReadValueBinary(const char* pCur,
+  PLY::EDataType eType,
+  bool p_bBE)
+{
+  ai_assert(NULL != pCur);
 
-  bool ret = true;
+  PLY::PropertyInstance::ValueUnion out;
   switch (eType)
   {
   case EDT_UInt:
-    out->iUInt = (uint32_t)*((uint32_t*)pCur);
-    pCur += 4;
+    out.iUInt = (uint32_t)*((uint32_t*)pCur);
 
     // Swap endianness
-    if (p_bBE)ByteSwap::Swap((int32_t*)&out->iUInt);
+    if (p_bBE)ByteSwap::Swap((int32_t*)&out.iUInt);
     break;
 
   case EDT_UShort:
@@ -1055,24 +1213,19 @@ bool PLY::PropertyInstance::ParseValueBinary(IOStreamBuffer<char> &streamBuffer,
 
     // Swap endianness
     if (p_bBE)ByteSwap::Swap(&i);
-    out->iUInt = (uint32_t)i;
-    pCur += 2;
+    out.iUInt = (uint32_t)i;
     break;
   }
 
   case EDT_UChar:
-  {
-    out->iUInt = (uint32_t)(*((uint8_t*)pCur));
-    pCur++;
+    out.iUInt = (uint32_t)(*((uint8_t*)pCur));
     break;
-  }
 
   case EDT_Int:
-    out->iInt = *((int32_t*)pCur);
-    pCur += 4;
+    out.iInt = *((int32_t*)pCur);
 
     // Swap endianness
-    if (p_bBE)ByteSwap::Swap(&out->iInt);
+    if (p_bBE)ByteSwap::Swap(&out.iInt);
     break;
 
   case EDT_Short:
@@ -1081,41 +1234,83 @@ bool PLY::PropertyInstance::ParseValueBinary(IOStreamBuffer<char> &streamBuffer,
 
     // Swap endianness
     if (p_bBE)ByteSwap::Swap(&i);
-    out->iInt = (int32_t)i;
-    pCur += 2;
+    out.iInt = (int32_t)i;
     break;
   }
 
   case EDT_Char:
-    out->iInt = (int32_t)*((int8_t*)pCur);
-    pCur++;
+    out.iInt = (int32_t)*((int8_t*)pCur);
     break;
 
   case EDT_Float:
-  {
-    out->fFloat = *((float*)pCur);
+    out.fFloat = *((float*)pCur);
 
     // Swap endianness
-    if (p_bBE)ByteSwap::Swap((int32_t*)&out->fFloat);
-    pCur += 4;
+    if (p_bBE)ByteSwap::Swap((int32_t*)&out.fFloat);
     break;
-  }
+
   case EDT_Double:
-  {
-    out->fDouble = *((double*)pCur);
+    out.fDouble = *((double*)pCur);
 
     // Swap endianness
-    if (p_bBE)ByteSwap::Swap((int64_t*)&out->fDouble);
-    pCur += 8;
+    if (p_bBE)ByteSwap::Swap((int64_t*)&out.fDouble);
     break;
-  }
+
   default:
-    ret = false;
+    out.iUInt = 0;
+    break;
   }
+  return out;
+}
 
-  bufferSize -= lsize;
+// ------------------------------------------------------------------------------------------------
+void PLY::PropertyInstance::RequestBinaryData(IOStreamBuffer<char> &streamBuffer,
+  std::vector<char> &buffer,
+  const char* &pCur,
+  unsigned int &bufferSize,
+  unsigned int iSize)
+{
+  // concat the remaining bytes with as many file blocks as needed
+  while (bufferSize < iSize)
+  {
+    std::vector<char> nbuffer;
+    if (!streamBuffer.getNextBlock(nbuffer))
+    {
+      throw DeadlyImportError("Invalid .ply file: File corrupted");
+    }
+    buffer = std::vector<char>(buffer.end() - bufferSize, buffer.end());
+    buffer.insert(buffer.end(), nbuffer.begin(), nbuffer.end());
+    bufferSize = static_cast<unsigned int>(buffer.size());
+    pCur = (char*)&buffer[0];
+  }
+}
 
-  return ret;
+// ------------------------------------------------------------------------------------------------
+unsigned int PLY::PropertyInstance::GetTypeSize(PLY::EDataType eType)
+{
+  switch (eType)
+  {
+  case EDT_Char:
+  case EDT_UChar:
+    return 1;
+
+  case EDT_UShort:
+  case EDT_Short:
+    return 2;
+
+  case EDT_UInt:
+  case EDT_Int:
+  case EDT_Float:
+    return 4;
+
+  case EDT_Double:
+    return 8;
+
+  case EDT_INVALID:
+  default:
+    break;
+  }
+  return 0;
 }
 
 #endif // !! ASSIMP_BUILD_NO_PLY_IMPORTER
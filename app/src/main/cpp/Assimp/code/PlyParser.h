@@ -293,6 +293,12 @@ public:
     // -------------------------------------------------------------------
     //! Parse a semantic from a string
     static EElementSemantic ParseSemantic(std::vector<char> &buffer);
+
+    // -------------------------------------------------------------------
+    //! Get the size of one binary instance of the element in bytes.
+    //! Returns 0 if the size varies, i.e. if a list property is
+    //! contained in the element.
+    unsigned int GetBinaryStride() const;
 };
 
 // ---------------------------------------------------------------------------------
@@ -331,8 +337,9 @@ public:
     std::vector<ValueUnion> avList;
 
     // -------------------------------------------------------------------
-    //! Parse a property instance
-    static bool ParseInstance(const char* &pCur,
+    //! Parse a property instance. pEnd is the end of the line at
+    //! pCur, numbers are read in bulk up to it. May be NULL.
+    static bool ParseInstance(const char* &pCur, const char* pEnd,
         const Property* prop, PropertyInstance* p_pcOut);
 
     // -------------------------------------------------------------------
@@ -353,6 +360,21 @@ public:
     static bool ParseValueBinary(IOStreamBuffer<char> &streamBuffer, std::vector<char> &buffer,
         const char* &pCur, unsigned int &bufferSize, EDataType eType, ValueUnion* out, bool p_bBE);
 
+    // -------------------------------------------------------------------
+    //! Decode a binary value at the given position. The caller must
+    //! make sure that enough bytes are available.
+    static ValueUnion ReadValueBinary(const char* pCur, EDataType eType, bool p_bBE);
+
+    // -------------------------------------------------------------------
+    //! Make sure that at least iSize bytes are available at pCur,
+    //! reading further file blocks if needed.
+    static void RequestBinaryData(IOStreamBuffer<char> &streamBuffer, std::vector<char> &buffer,
+        const char* &pCur, unsigned int &bufferSize, unsigned int iSize);
+
+    // -------------------------------------------------------------------
+    //! Get the size of a binary value of the given type in bytes
+    static unsigned int GetTypeSize(EDataType eType);
+
     // -------------------------------------------------------------------
     //! Convert a property value to a given type TYPE
     template <typename TYPE>
@@ -374,14 +396,21 @@ public:
     std::vector< PropertyInstance > alProperties;
 
     // -------------------------------------------------------------------
-    //! Parse an element instance
-    static bool ParseInstance(const char* &pCur,
+    //! Parse an element instance, see PropertyInstance::ParseInstance()
+    static bool ParseInstance(const char* &pCur, const char* pEnd,
         const Element* pcElement, ElementInstance* p_pcOut);
 
     // -------------------------------------------------------------------
     //! Parse a binary element instance
     static bool ParseInstanceBinary(IOStreamBuffer<char> &streamBuffer, std::vector<char> &buffer,
         const char* &pCur, unsigned int &bufferSize, const Element* pcElement, ElementInstance* p_pcOut, bool p_bBE);
+
+    // -------------------------------------------------------------------
+    //! Get the size of the binary element instance at pCur. Returns false
+    //! if the instance does not fit into the bufferSize bytes at pCur,
+    //! iSize is the number of bytes needed to go on then.
+    static bool GetBinarySize(const char* pCur, unsigned int bufferSize,
+        const Element* pcElement, bool p_bBE, unsigned int &iSize);
 };
 
 // ---------------------------------------------------------------------------------
@@ -431,6 +460,10 @@ public:
     static bool ParseInstance(IOStreamBuffer<char> &streamBuffer, DOM* p_pcOut, PLYImporter* loader);
     static bool ParseInstanceBinary(IOStreamBuffer<char> &streamBuffer, DOM* p_pcOut, PLYImporter* loader, bool p_bBE);
 
+    //! Parse the element descriptions of the header only, up to 'end_header'.
+    //! The instances are then passed to the loader by the caller
+    static bool ParseInstanceHeader(IOStreamBuffer<char> &streamBuffer, DOM* p_pcOut, bool isBinary);
+
     //! Skip all comment lines after this
     static bool SkipComments(std::vector<char> &buffer);
 
@@ -121,6 +121,21 @@ corresponding preprocessor flag to selectively disable steps.
 #ifndef ASSIMP_BUILD_NO_DEBONE_PROCESS
 #   include "DeboneProcess.h"
 #endif
+#ifndef ASSIMP_BUILD_NO_PACKSKINNING_PROCESS
+#   include "PackSkinningProcess.h"
+#endif
+#ifndef ASSIMP_BUILD_NO_GENMESHLETS_PROCESS
+#   include "GenMeshletsProcess.h"
+#endif
+#ifndef ASSIMP_BUILD_NO_GENBOUNDINGBOXES_PROCESS
+#   include "GenBoundingBoxesProcess.h"
+#endif
+#ifndef ASSIMP_BUILD_NO_TEXTUREATLAS_PROCESS
+#   include "TextureAtlasProcess.h"
+#endif
+#ifndef ASSIMP_BUILD_NO_OPTIMIZEANIMATIONS_PROCESS
+#   include "OptimizeAnimationsProcess.h"
+#endif
 
 namespace Assimp {
 
@@ -132,10 +147,13 @@ void GetPostProcessingStepInstanceList(std::vector< BaseProcess* >& out)
     // of sequence it is executed. Steps that are added here are not
     // validated - as RegisterPPStep() does - all dependencies must be given.
     // ----------------------------------------------------------------------------
-    out.reserve(25);
+    out.reserve(30);
 #if (!defined ASSIMP_BUILD_NO_MAKELEFTHANDED_PROCESS)
     out.push_back( new MakeLeftHandedProcess());
 #endif
+#if (!defined ASSIMP_BUILD_NO_TEXTUREATLAS_PROCESS)
+    out.push_back( new TextureAtlasProcess());
+#endif
 #if (!defined ASSIMP_BUILD_NO_FLIPUVS_PROCESS)
     out.push_back( new FlipUVsProcess());
 #endif
@@ -175,6 +193,9 @@ void GetPostProcessingStepInstanceList(std::vector< BaseProcess* >& out)
 #if (!defined ASSIMP_BUILD_NO_FINDINVALIDDATA_PROCESS)
     out.push_back( new FindInvalidDataProcess());
 #endif
+#if (!defined ASSIMP_BUILD_NO_OPTIMIZEANIMATIONS_PROCESS)
+    out.push_back( new OptimizeAnimationsProcess());
+#endif
 #if (!defined ASSIMP_BUILD_NO_OPTIMIZEMESHES_PROCESS)
     out.push_back( new OptimizeMeshesProcess());
 #endif
@@ -225,6 +246,15 @@ void GetPostProcessingStepInstanceList(std::vector< BaseProcess* >& out)
 #if (!defined ASSIMP_BUILD_NO_IMPROVECACHELOCALITY_PROCESS)
     out.push_back( new ImproveCacheLocalityProcess());
 #endif
+#if (!defined ASSIMP_BUILD_NO_GENMESHLETS_PROCESS)
+    out.push_back( new GenMeshletsProcess());
+#endif
+#if (!defined ASSIMP_BUILD_NO_PACKSKINNING_PROCESS)
+    out.push_back( new PackSkinningProcess());
+#endif
+#if (!defined ASSIMP_BUILD_NO_GENBOUNDINGBOXES_PROCESS)
+    out.push_back( new GenBoundingBoxesProcess());
+#endif
 }
 
 }
@@ -436,6 +436,54 @@ void PretransformVertices::BuildMeshRefCountArray(aiNode* nd, unsigned int * ref
         BuildMeshRefCountArray(nd->mChildren[i],refs);
 }
 
+// ------------------------------------------------------------------------------------------------
+// Replace the instance tables of the meshes by one child node per instance
+void PretransformVertices::ExpandInstanceTables(aiScene* pcScene, aiNode* pcNode)
+{
+    // call children first, the new nodes don't need to be visited
+    for (unsigned int i = 0; i < pcNode->mNumChildren;++i)
+        ExpandInstanceTables(pcScene,pcNode->mChildren[i]);
+
+    std::vector<unsigned int> meshes;
+    std::vector<aiNode*> instances;
+    for (unsigned int i = 0; i < pcNode->mNumMeshes;++i)    {
+        const aiMesh* mesh = pcScene->mMeshes[pcNode->mMeshes[i]];
+        if (!mesh->HasInstances())  {
+            meshes.push_back(pcNode->mMeshes[i]);
+            continue;
+        }
+
+        // the instance transformation is applied before the one of the node
+        for (unsigned int n = 0; n < mesh->mNumInstances;++n)   {
+            aiNode* child = new aiNode();
+            child->mName.length = ::ai_snprintf(child->mName.data,MAXLEN,"$Instance_%u",n);
+            child->mParent = pcNode;
+            child->mTransformation = mesh->mInstanceTransforms[n];
+            child->mNumMeshes = 1;
+            child->mMeshes = new unsigned int[1];
+            child->mMeshes[0] = pcNode->mMeshes[i];
+            instances.push_back(child);
+        }
+    }
+    if (instances.empty())
+        return;
+
+    delete[] pcNode->mMeshes;
+    pcNode->mMeshes = NULL;
+    pcNode->mNumMeshes = static_cast<unsigned int>(meshes.size());
+    if (!meshes.empty())    {
+        pcNode->mMeshes = new unsigned int[meshes.size()];
+        std::copy(meshes.begin(),meshes.end(),pcNode->mMeshes);
+    }
+
+    aiNode** children = new aiNode*[pcNode->mNumChildren + instances.size()];
+    std::copy(pcNode->mChildren,pcNode->mChildren + pcNode->mNumChildren,children);
+    std::copy(instances.begin(),instances.end(),children + pcNode->mNumChildren);
+    delete[] pcNode->mChildren;
+    pcNode->mChildren = children;
+    pcNode->mNumChildren += static_cast<unsigned int>(instances.size());
+}
+
 // ------------------------------------------------------------------------------------------------
 // Executes the post processing step on the given imported data.
 void PretransformVertices::Execute( aiScene* pScene)
@@ -446,6 +494,16 @@ void PretransformVertices::Execute( aiScene* pScene)
     if (!pScene->mNumMeshes)
         return;
 
+    // Meshes drawn from an instance table are handled like meshes referenced
+    // by multiple nodes, so each instance is transformed on its own.
+    ExpandInstanceTables(pScene,pScene->mRootNode);
+    for (unsigned int i = 0; i < pScene->mNumMeshes;++i)    {
+        aiMesh* mesh = pScene->mMeshes[i];
+        delete[] mesh->mInstanceTransforms;
+        mesh->mInstanceTransforms = NULL;
+        mesh->mNumInstances = 0;
+    }
+
     const unsigned int iOldMeshes = pScene->mNumMeshes;
     const unsigned int iOldAnimationChannels = pScene->mNumAnimations;
     const unsigned int iOldNodes = CountNodes(pScene->mRootNode);
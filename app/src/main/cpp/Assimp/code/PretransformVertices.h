@@ -153,6 +153,10 @@ private:
     // Build reference counters for all meshes
     void BuildMeshRefCountArray(aiNode* nd, unsigned int * refs);
 
+    // -------------------------------------------------------------------
+    // Replace the instance tables of the meshes by one child node per instance
+    void ExpandInstanceTables(aiScene* pcScene, aiNode* pcNode);
+
 
 
     //! Configuration option: keep scene hierarchy as long as possible
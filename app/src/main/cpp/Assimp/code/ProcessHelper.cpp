@@ -175,6 +175,92 @@ ai_real ComputePositionEpsilon(const aiMesh* const* pMeshes, size_t num)
 }
 
 
+// -------------------------------------------------------------------------------
+PositionNeighbours::PositionNeighbours(const SpatialSort& finder, const aiVector3D* pPositions,
+    unsigned int pNumPositions, ai_real pRadius)
+: mFinder(finder)
+, mPositions(pPositions)
+, mRadius(pRadius)
+{
+    ai_assert( NULL != pPositions );
+
+    // more results than this mean the radius is much larger than the
+    // spacing of the vertices, leave the rest to on-demand lookups then
+    const size_t maxResults = static_cast<size_t>(pNumPositions) * 8;
+
+    mLookup.assign(pNumPositions,UINT_MAX);
+    mOffsets.push_back(0);
+    mResults.reserve(pNumPositions);
+
+    // positions looked up last. Vertices at identical positions are
+    // neighbours in the sort order, unless other positions happen to
+    // have exactly the same distance to the sorting plane.
+    static const unsigned int numRecent = 4;
+    aiVector3D recentPositions[numRecent];
+    unsigned int recentLookups[numRecent];
+    unsigned int recent = 0;
+
+    std::vector<unsigned int> verticesFound;
+    const std::vector<unsigned int>& order = finder.GetSortedIndices();
+    for (std::vector<unsigned int>::const_iterator it = order.begin(); it != order.end(); ++it) {
+        const unsigned int v = *it;
+        if (v >= pNumPositions) {
+            continue;
+        }
+
+        const aiVector3D& pos = pPositions[v];
+        unsigned int r = 0;
+        for (; r < std::min(recent,numRecent); ++r) {
+            if (recentPositions[r] == pos) {
+                break;
+            }
+        }
+        if (r < std::min(recent,numRecent)) {
+            mLookup[v] = recentLookups[r];
+            continue;
+        }
+
+        unsigned int lookup = UINT_MAX;
+        finder.FindPositions(pos,pRadius,verticesFound);
+        if (mResults.size() + verticesFound.size() <= maxResults) {
+            lookup = static_cast<unsigned int>(mOffsets.size() - 1);
+            mResults.insert(mResults.end(),verticesFound.begin(),verticesFound.end());
+            mOffsets.push_back(static_cast<unsigned int>(mResults.size()));
+        }
+        recentPositions[recent % numRecent] = pos;
+        recentLookups[recent % numRecent] = lookup;
+        ++recent;
+
+        mLookup[v] = lookup;
+    }
+}
+
+// -------------------------------------------------------------------------------
+void PositionNeighbours::FindPositions(unsigned int pVertex, std::vector<unsigned int>& poResults) const
+{
+    const unsigned int lookup = mLookup[pVertex];
+    if (lookup == UINT_MAX) {
+        mFinder.FindPositions(mPositions[pVertex],mRadius,poResults);
+        return;
+    }
+    poResults.assign(mResults.begin() + mOffsets[lookup],mResults.begin() + mOffsets[lookup+1]);
+}
+
+// -------------------------------------------------------------------------------
+void CopyInstanceTable(const aiMesh* pSrc, aiMesh* pDest)
+{
+    ai_assert(NULL != pSrc && NULL != pDest);
+
+    if (!pSrc->HasInstances()) {
+        return;
+    }
+    delete[] pDest->mInstanceTransforms;
+    pDest->mNumInstances = pSrc->mNumInstances;
+    pDest->mInstanceTransforms = new aiMatrix4x4[pSrc->mNumInstances];
+    std::copy(pSrc->mInstanceTransforms,pSrc->mInstanceTransforms + pSrc->mNumInstances,
+        pDest->mInstanceTransforms);
+}
+
 // -------------------------------------------------------------------------------
 unsigned int GetMeshVFormatUnique(const aiMesh* pcMesh)
 {
@@ -229,6 +315,35 @@ VertexWeightTable* ComputeVertexBoneWeightTable(const aiMesh* pMesh)
     return avPerVertexWeights;
 }
 
+// -------------------------------------------------------------------------------
+void ComputeVertexBoneWeights(const aiMesh* pMesh, VertexBoneWeights& out)
+{
+    ai_assert(NULL != pMesh);
+
+    // first pass: count the weights per vertex
+    out.mOffsets.assign(pMesh->mNumVertices+1,0);
+    for (unsigned int i = 0; i < pMesh->mNumBones; ++i) {
+        const aiBone* bone = pMesh->mBones[i];
+        for (unsigned int a = 0; a < bone->mNumWeights; ++a) {
+            ++out.mOffsets[bone->mWeights[a].mVertexId+1];
+        }
+    }
+    for (unsigned int v = 0; v < pMesh->mNumVertices; ++v) {
+        out.mOffsets[v+1] += out.mOffsets[v];
+    }
+
+    // second pass: scatter the weights, bone by bone
+    out.mWeights.resize(out.mOffsets[pMesh->mNumVertices]);
+    std::vector<unsigned int> cur(out.mOffsets.begin(),out.mOffsets.end()-1);
+    for (unsigned int i = 0; i < pMesh->mNumBones; ++i) {
+        const aiBone* bone = pMesh->mBones[i];
+        for (unsigned int a = 0; a < bone->mNumWeights; ++a) {
+            const aiVertexWeight& weight = bone->mWeights[a];
+            out.mWeights[cur[weight.mVertexId]++] = PerVertexWeight(i,weight.mWeight);
+        }
+    }
+}
+
 
 // -------------------------------------------------------------------------------
 const char* TextureTypeToString(aiTextureType in)
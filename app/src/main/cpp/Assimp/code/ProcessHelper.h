@@ -302,6 +302,47 @@ ai_real ComputePositionEpsilon(const aiMesh* pMesh);
 ai_real ComputePositionEpsilon(const aiMesh* const* pMeshes, size_t num);
 
 
+// -------------------------------------------------------------------------------
+/** @brief Results of SpatialSort::FindPositions() for all vertices of an array.
+ *
+ *  Vertices at identical positions share one lookup, and the lookups are made
+ *  in the order of the SpatialSort so consecutive ones search neighbouring
+ *  entries. FindPositions() returns exactly what the SpatialSort returns for
+ *  the position of the vertex. If the results grow too large to be stored,
+ *  the remaining vertices are looked up on demand. */
+class PositionNeighbours
+{
+public:
+    /** @param finder SpatialSort filled with the positions, must outlive this object
+     *  @param pPositions Positions of the vertices
+     *  @param pNumPositions Number of positions
+     *  @param pRadius Maximal distance of two positions to be neighbours */
+    PositionNeighbours(const SpatialSort& finder, const aiVector3D* pPositions,
+        unsigned int pNumPositions, ai_real pRadius);
+
+    /** Stores the indices of all vertices within the radius around the given one
+     *  in poResults, same as SpatialSort::FindPositions() for its position. */
+    void FindPositions(unsigned int pVertex, std::vector<unsigned int>& poResults) const;
+
+private:
+    const SpatialSort& mFinder;
+    const aiVector3D* mPositions;
+    ai_real mRadius;
+
+    // results of lookup l are mResults[mOffsets[l]] ... mResults[mOffsets[l+1]-1],
+    // mLookup maps each vertex to its lookup or to UINT_MAX if it was not stored
+    std::vector<unsigned int> mLookup;
+    std::vector<unsigned int> mOffsets;
+    std::vector<unsigned int> mResults;
+};
+
+
+// -------------------------------------------------------------------------------
+// Copy the instance table of a mesh to a mesh built from a part of it, e.g. by
+// splitting it. Nothing happens if the source mesh is not instanced.
+void CopyInstanceTable(const aiMesh* pSrc, aiMesh* pDest);
+
+
 // -------------------------------------------------------------------------------
 // Compute an unique value for the vertex format of a mesh
 unsigned int GetMeshVFormatUnique(const aiMesh* pcMesh);
@@ -316,6 +357,38 @@ typedef std::vector <PerVertexWeight> VertexWeightTable;
 VertexWeightTable* ComputeVertexBoneWeightTable(const aiMesh* pMesh);
 
 
+// -------------------------------------------------------------------------------
+/** @brief Flat (CSR) table of the bone weights affecting each vertex of a mesh.
+ *
+ *  The weights of vertex v are mWeights[mOffsets[v]] ... mWeights[mOffsets[v+1]-1],
+ *  sorted by bone index. Unlike #ComputeVertexBoneWeightTable() this needs
+ *  just two allocations regardless of the vertex count. */
+struct VertexBoneWeights
+{
+    std::vector<unsigned int> mOffsets;
+    std::vector<PerVertexWeight> mWeights;
+
+    unsigned int GetNumWeights(unsigned int pVertex) const {
+        return mOffsets[pVertex+1] - mOffsets[pVertex];
+    }
+
+    PerVertexWeight* GetWeights(unsigned int pVertex) {
+        return mWeights.empty() ? NULL : &mWeights[mOffsets[pVertex]];
+    }
+
+    const PerVertexWeight* GetWeights(unsigned int pVertex) const {
+        return mWeights.empty() ? NULL : &mWeights[mOffsets[pVertex]];
+    }
+};
+
+// -------------------------------------------------------------------------------
+/** @brief Transpose the bone-major weights of a mesh into a vertex-major table
+ *  @param pMesh Mesh to work on
+ *  @param[out] out Receives the weights, one entry per vertex even if the
+ *    mesh has no bones */
+void ComputeVertexBoneWeights(const aiMesh* pMesh, VertexBoneWeights& out);
+
+
 // -------------------------------------------------------------------------------
 // Get a string for a given aiTextureType
 const char* TextureTypeToString(aiTextureType in);
@@ -353,6 +426,10 @@ class ComputeSpatialSortProcess : public BaseProcess
         std::vector<_Type>::iterator it = p->begin();
 
         for (unsigned int i = 0; i < pScene->mNumMeshes; ++i, ++it) {
+            // unmodified meshes are skipped by all steps using the spatial sort
+            if (!IsMeshDirty(i)) {
+                continue;
+            }
             aiMesh* mesh = pScene->mMeshes[i];
             _Type& blubb = *it;
             blubb.first.Fill(mesh->mVertices,mesh->mNumVertices,sizeof(aiVector3D));
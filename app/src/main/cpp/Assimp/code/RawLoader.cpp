@@ -50,6 +50,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // internal headers
 #include "RawLoader.h"
 #include "ParsingUtils.h"
+#include "TextCursor.h"
 #include "fast_atof.h"
 #include <memory>
 #include <assimp/IOSystem.hpp>
@@ -111,15 +112,15 @@ void RAWImporter::InternReadFile( const std::string& pFile,
     // (terminate it with zero)
     std::vector<char> mBuffer2;
     TextFileToBuffer(file.get(),mBuffer2);
-    const char* buffer = &mBuffer2[0];
+    TextCursor cursor(&mBuffer2[0],&mBuffer2.back());
 
     // list of groups loaded from the file
     std::vector< GroupInformation > outGroups(1,GroupInformation("<default>"));
     std::vector< GroupInformation >::iterator curGroup = outGroups.begin();
 
     // now read all lines
-    char line[4096];
-    while (GetNextLine(buffer,line))
+    const char* line;
+    while (cursor.NextLine(line))
     {
         // if the line starts with a non-numeric identifier, it marks
         // the beginning of a new group
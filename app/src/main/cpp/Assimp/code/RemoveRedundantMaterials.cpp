@@ -50,13 +50,15 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ProcessHelper.h"
 #include "MaterialSystem.h"
 #include <stdio.h>
+#include <unordered_map>
 
 using namespace Assimp;
 
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 RemoveRedundantMatsProcess::RemoveRedundantMatsProcess()
-: configFixedMaterials() {
+: configFixedMaterials()
+, configEpsilon(AI_RRM_DEFAULT_EPSILON) {
     // nothing to do here
 }
 
@@ -80,6 +82,9 @@ void RemoveRedundantMatsProcess::SetupProperties(const Importer* pImp)
 {
     // Get value of AI_CONFIG_PP_RRM_EXCLUDE_LIST
     configFixedMaterials = pImp->GetPropertyString(AI_CONFIG_PP_RRM_EXCLUDE_LIST,"");
+
+    // Get value of AI_CONFIG_PP_RRM_EPSILON
+    configEpsilon = pImp->GetPropertyFloat(AI_CONFIG_PP_RRM_EPSILON,AI_RRM_DEFAULT_EPSILON);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -97,8 +102,8 @@ void RemoveRedundantMatsProcess::Execute( aiScene* pScene)
             abReferenced[pScene->mMeshes[i]->mMaterialIndex] = true;
 
         // If a list of materials to be excluded was given, match the list with
-        // our imported materials and 'salt' all positive matches to ensure that
-        // we get unique hashes later.
+        // our imported materials. Positive matches are never merged.
+        std::vector<bool> abFixed(pScene->mNumMaterials,false);
         if (configFixedMaterials.length()) {
 
             std::list<std::string> strings;
@@ -113,11 +118,7 @@ void RemoveRedundantMatsProcess::Execute( aiScene* pScene)
                 if (name.length) {
                     std::list<std::string>::const_iterator it = std::find(strings.begin(), strings.end(), name.data);
                     if (it != strings.end()) {
-
-                        // Our brilliant 'salt': A single material property with ~ as first
-                        // character to mark it as internal and temporary.
-                        const int dummy = 1;
-                        ((aiMaterial*)mat)->AddProperty(&dummy,1,"~RRM.UniqueMaterial",0,0);
+                        abFixed[i] = true;
 
                         // Keep this material even if no mesh references it
                         abReferenced[i] = true;
@@ -134,11 +135,11 @@ void RemoveRedundantMatsProcess::Execute( aiScene* pScene)
         }
         unsigned int iNewNum = 0;
 
-        // Iterate through all materials and calculate a hash for them
-        // store all hashes in a list and so a quick search whether
-        // we do already have a specific hash. This allows us to
-        // determine which materials are identical.
-        uint32_t *aiHashes = new uint32_t[ pScene->mNumMaterials ];;
+        // Iterate through all materials and calculate a fingerprint for them.
+        // Materials with equal fingerprints are identical, so a hash map
+        // from the fingerprint to the first of them finds all duplicates.
+        std::unordered_map<std::string, unsigned int> fingerprints;
+        fingerprints.reserve(pScene->mNumMaterials);
         for (unsigned int i = 0; i < pScene->mNumMaterials;++i)
         {
             // No mesh is referencing this material, remove it.
@@ -149,24 +150,21 @@ void RemoveRedundantMatsProcess::Execute( aiScene* pScene)
                 continue;
             }
 
-            // Check all previously mapped materials for a matching hash.
+            // Check for a previously mapped material with the same fingerprint.
             // On a match we can delete this material and just make it ref to the same index.
-            uint32_t me = aiHashes[i] = ComputeMaterialHash(pScene->mMaterials[i]);
-            for (unsigned int a = 0; a < i;++a)
-            {
-                if (abReferenced[a] && me == aiHashes[a]) {
+            if (!abFixed[i]) {
+                const std::pair<std::unordered_map<std::string, unsigned int>::iterator, bool> res =
+                    fingerprints.insert(std::make_pair(ComputeMaterialFingerprint(pScene->mMaterials[i],configEpsilon),iNewNum));
+                if (!res.second) {
                     ++redundantRemoved;
-                    me = 0;
-                    aiMappingTable[i] = aiMappingTable[a];
+                    aiMappingTable[i] = res.first->second;
                     delete pScene->mMaterials[i];
                     pScene->mMaterials[i] = nullptr;
-                    break;
+                    continue;
                 }
             }
             // This is a new material that is referenced, add to the map.
-            if (me) {
-                aiMappingTable[i] = iNewNum++;
-            }
+            aiMappingTable[i] = iNewNum++;
         }
         // If the new material count differs from the original,
         // we need to rebuild the material list and remap mesh material indexes.
@@ -205,7 +203,6 @@ void RemoveRedundantMatsProcess::Execute( aiScene* pScene)
             pScene->mNumMaterials = iNewNum;
         }
         // delete temporary storage
-        delete[] aiHashes;
         delete[] aiMappingTable;
     }
     if (redundantRemoved == 0 && unreferencedRemoved == 0)
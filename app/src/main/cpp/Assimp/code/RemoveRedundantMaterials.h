@@ -51,6 +51,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 class RemoveRedundantMatsTest;
 namespace Assimp    {
 
+// default value for AI_CONFIG_PP_RRM_EPSILON
+#if (!defined AI_RRM_DEFAULT_EPSILON)
+#   define AI_RRM_DEFAULT_EPSILON 1e-6f
+#endif
+
 // ---------------------------------------------------------------------------
 /** RemoveRedundantMatsProcess: Post-processing step to remove redundant
  *  materials from the imported scene.
@@ -98,6 +103,9 @@ private:
 
     //! Configuration option: list of all fixed materials
     std::string configFixedMaterials;
+
+    //! Configuration option: tolerance for floating-point properties
+    ai_real configEpsilon;
 };
 
 } // end of namespace Assimp
@@ -966,35 +966,48 @@ void SMDImporter::ParseSkeletonElement(const char* szCurrent,
     SMD::Bone::Animation::MatrixKey& key = bone.sAnim.asKeys.back();
 
     key.dTime = (double)iTime;
-    if(!ParseFloat(szCurrent,&szCurrent,(float&)vPos.x))
-    {
-        LogErrorNoThrow("Unexpected EOF/EOL while parsing bone.pos.x");
-        SMDI_PARSE_RETURN;
-    }
-    if(!ParseFloat(szCurrent,&szCurrent,(float&)vPos.y))
-    {
-        LogErrorNoThrow("Unexpected EOF/EOL while parsing bone.pos.y");
-        SMDI_PARSE_RETURN;
-    }
-    if(!ParseFloat(szCurrent,&szCurrent,(float&)vPos.z))
-    {
-        LogErrorNoThrow("Unexpected EOF/EOL while parsing bone.pos.z");
-        SMDI_PARSE_RETURN;
-    }
-    if(!ParseFloat(szCurrent,&szCurrent,(float&)vRot.x))
-    {
-        LogErrorNoThrow("Unexpected EOF/EOL while parsing bone.rot.x");
-        SMDI_PARSE_RETURN;
-    }
-    if(!ParseFloat(szCurrent,&szCurrent,(float&)vRot.y))
+
+    // position and rotation are usually a single run of numbers
+    float data[6];
+    const char* szBatch;
+    if (fast_atoreal_n<float>(szCurrent,&mBuffer.back(),data,6,&szBatch) == 6)
     {
-        LogErrorNoThrow("Unexpected EOF/EOL while parsing bone.rot.y");
-        SMDI_PARSE_RETURN;
+        szCurrent = szBatch;
+        vPos = aiVector3D(data[0],data[1],data[2]);
+        vRot = aiVector3D(data[3],data[4],data[5]);
     }
-    if(!ParseFloat(szCurrent,&szCurrent,(float&)vRot.z))
+    else
     {
-        LogErrorNoThrow("Unexpected EOF/EOL while parsing bone.rot.z");
-        SMDI_PARSE_RETURN;
+        if(!ParseFloat(szCurrent,&szCurrent,(float&)vPos.x))
+        {
+            LogErrorNoThrow("Unexpected EOF/EOL while parsing bone.pos.x");
+            SMDI_PARSE_RETURN;
+        }
+        if(!ParseFloat(szCurrent,&szCurrent,(float&)vPos.y))
+        {
+            LogErrorNoThrow("Unexpected EOF/EOL while parsing bone.pos.y");
+            SMDI_PARSE_RETURN;
+        }
+        if(!ParseFloat(szCurrent,&szCurrent,(float&)vPos.z))
+        {
+            LogErrorNoThrow("Unexpected EOF/EOL while parsing bone.pos.z");
+            SMDI_PARSE_RETURN;
+        }
+        if(!ParseFloat(szCurrent,&szCurrent,(float&)vRot.x))
+        {
+            LogErrorNoThrow("Unexpected EOF/EOL while parsing bone.rot.x");
+            SMDI_PARSE_RETURN;
+        }
+        if(!ParseFloat(szCurrent,&szCurrent,(float&)vRot.y))
+        {
+            LogErrorNoThrow("Unexpected EOF/EOL while parsing bone.rot.y");
+            SMDI_PARSE_RETURN;
+        }
+        if(!ParseFloat(szCurrent,&szCurrent,(float&)vRot.z))
+        {
+            LogErrorNoThrow("Unexpected EOF/EOL while parsing bone.rot.z");
+            SMDI_PARSE_RETURN;
+        }
     }
     // build the transformation matrix of the key
     key.matrix.FromEulerAnglesXYZ(vRot.x,vRot.y,vRot.z);
@@ -1094,48 +1107,65 @@ void SMDImporter::ParseVertex(const char* szCurrent,
         LogErrorNoThrow("Unexpected EOF/EOL while parsing vertex.parent");
         SMDI_PARSE_RETURN;
     }
-    if(!ParseFloat(szCurrent,&szCurrent,(float&)vertex.pos.x))
-    {
-        LogErrorNoThrow("Unexpected EOF/EOL while parsing vertex.pos.x");
-        SMDI_PARSE_RETURN;
-    }
-    if(!ParseFloat(szCurrent,&szCurrent,(float&)vertex.pos.y))
-    {
-        LogErrorNoThrow("Unexpected EOF/EOL while parsing vertex.pos.y");
-        SMDI_PARSE_RETURN;
-    }
-    if(!ParseFloat(szCurrent,&szCurrent,(float&)vertex.pos.z))
-    {
-        LogErrorNoThrow("Unexpected EOF/EOL while parsing vertex.pos.z");
-        SMDI_PARSE_RETURN;
-    }
-    if(!ParseFloat(szCurrent,&szCurrent,(float&)vertex.nor.x))
-    {
-        LogErrorNoThrow("Unexpected EOF/EOL while parsing vertex.nor.x");
-        SMDI_PARSE_RETURN;
-    }
-    if(!ParseFloat(szCurrent,&szCurrent,(float&)vertex.nor.y))
+
+    // position, normal and texture coordinates are usually a single run of numbers
+    const unsigned int numFloats = bVASection ? 6 : 8;
+    float data[8];
+    const char* szBatch;
+    if (fast_atoreal_n<float>(szCurrent,&mBuffer.back(),data,numFloats,&szBatch) == numFloats)
     {
-        LogErrorNoThrow("Unexpected EOF/EOL while parsing vertex.nor.y");
-        SMDI_PARSE_RETURN;
+        szCurrent = szBatch;
+        vertex.pos = aiVector3D(data[0],data[1],data[2]);
+        vertex.nor = aiVector3D(data[3],data[4],data[5]);
+        if (bVASection)SMDI_PARSE_RETURN;
+        vertex.uv.x = data[6];
+        vertex.uv.y = data[7];
     }
-    if(!ParseFloat(szCurrent,&szCurrent,(float&)vertex.nor.z))
+    else
     {
-        LogErrorNoThrow("Unexpected EOF/EOL while parsing vertex.nor.z");
-        SMDI_PARSE_RETURN;
-    }
+        if(!ParseFloat(szCurrent,&szCurrent,(float&)vertex.pos.x))
+        {
+            LogErrorNoThrow("Unexpected EOF/EOL while parsing vertex.pos.x");
+            SMDI_PARSE_RETURN;
+        }
+        if(!ParseFloat(szCurrent,&szCurrent,(float&)vertex.pos.y))
+        {
+            LogErrorNoThrow("Unexpected EOF/EOL while parsing vertex.pos.y");
+            SMDI_PARSE_RETURN;
+        }
+        if(!ParseFloat(szCurrent,&szCurrent,(float&)vertex.pos.z))
+        {
+            LogErrorNoThrow("Unexpected EOF/EOL while parsing vertex.pos.z");
+            SMDI_PARSE_RETURN;
+        }
+        if(!ParseFloat(szCurrent,&szCurrent,(float&)vertex.nor.x))
+        {
+            LogErrorNoThrow("Unexpected EOF/EOL while parsing vertex.nor.x");
+            SMDI_PARSE_RETURN;
+        }
+        if(!ParseFloat(szCurrent,&szCurrent,(float&)vertex.nor.y))
+        {
+            LogErrorNoThrow("Unexpected EOF/EOL while parsing vertex.nor.y");
+            SMDI_PARSE_RETURN;
+        }
+        if(!ParseFloat(szCurrent,&szCurrent,(float&)vertex.nor.z))
+        {
+            LogErrorNoThrow("Unexpected EOF/EOL while parsing vertex.nor.z");
+            SMDI_PARSE_RETURN;
+        }
 
-    if (bVASection)SMDI_PARSE_RETURN;
+        if (bVASection)SMDI_PARSE_RETURN;
 
-    if(!ParseFloat(szCurrent,&szCurrent,(float&)vertex.uv.x))
-    {
-        LogErrorNoThrow("Unexpected EOF/EOL while parsing vertex.uv.x");
-        SMDI_PARSE_RETURN;
-    }
-    if(!ParseFloat(szCurrent,&szCurrent,(float&)vertex.uv.y))
-    {
-        LogErrorNoThrow("Unexpected EOF/EOL while parsing vertex.uv.y");
-        SMDI_PARSE_RETURN;
+        if(!ParseFloat(szCurrent,&szCurrent,(float&)vertex.uv.x))
+        {
+            LogErrorNoThrow("Unexpected EOF/EOL while parsing vertex.uv.x");
+            SMDI_PARSE_RETURN;
+        }
+        if(!ParseFloat(szCurrent,&szCurrent,(float&)vertex.uv.y))
+        {
+            LogErrorNoThrow("Unexpected EOF/EOL while parsing vertex.uv.y");
+            SMDI_PARSE_RETURN;
+        }
     }
 
     // now read the number of bones affecting this vertex
@@ -49,8 +49,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "STLLoader.h"
 #include "ParsingUtils.h"
 #include "fast_atof.h"
+#include "Hash.h"
+#include "ParallelHelper.h"
+#include <algorithm>
 #include <memory>
+#include <unordered_map>
 #include <assimp/IOSystem.hpp>
+#include <assimp/Importer.hpp>
+#include <assimp/config.h>
 #include <assimp/scene.h>
 #include <assimp/DefaultLogger.hpp>
 #include <assimp/importerdesc.h>
@@ -119,14 +125,447 @@ static bool IsAsciiSTL(const char* buffer, unsigned int fileSize) {
     }
     return isASCII;
 }
+
+// Decides on the storage of a file which is passed in pieces, its size is not known
+// then. ASCII files begin with "solid", binary headers may do so as well but are
+// usually padded with zeros and the face count holds control characters, the
+// upper byte is zero for any sane count.
+static bool IsBinarySTLHeader(const char* header) {
+    const char* const headerEnd = header + 84;
+    const char* sz = header;
+    while (sz < headerEnd && IsSpace(*sz)) {
+        ++sz;
+    }
+    if (headerEnd - sz <= 5 || strncmp(sz, "solid", 5) != 0) {
+        return true;
+    }
+    for (sz = header; sz < headerEnd; ++sz) {
+        if (static_cast<unsigned char>(*sz) < 32 && !IsSpace(*sz) && '\r' != *sz && '\n' != *sz) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Size of the chunks the facets of an ASCII solid are split into
+static const size_t ChunkSize = 1024 * 1024;
+
+// Number of binary facets converted per block
+static const unsigned int FacetsPerBlock = 64 * 1024;
+
+// Number of facets each task of a binary block converts
+static const unsigned int FacetsPerTask = 4 * 1024;
+
+// Size of a binary facet: normal, three vertices and the attribute word
+static const unsigned int FacetSize = 50;
+
+// Facets parsed from one chunk of an ASCII solid
+struct FacetChunk {
+    FacetChunk( const char *begin, const char *end )
+        : mBegin( begin )
+        , mEnd( end )
+        , mAmbiguous( false ) {
+        // empty
+    }
+
+    const char *mBegin;
+    const char *mEnd;
+    std::vector<aiVector3D> mPositions;
+    std::vector<aiVector3D> mNormals;
+
+    // set if the chunk is not made of complete, well-formed facets. The
+    // solid is parsed sequentially then to keep warnings and recovery as is
+    bool mAmbiguous;
+};
+
+// Finds the first occurrence of a token in [begin, end)
+static const char *findToken( const char *begin, const char *end, const char *token, size_t len ) {
+    const char *it = std::search( begin, end, token, token + len );
+    return it == end ? NULL : it;
+}
+
+// Finds the first 'endsolid' in [begin, end). 's' is rare in facet data, so scan for it
+static const char *findEndSolid( const char *begin, const char *end ) {
+    for ( const char *it = begin + 3; it < end; ++it ) {
+        it = static_cast<const char*>( ::memchr( it, 's', end - it ) );
+        if ( NULL == it ) {
+            return NULL;
+        }
+        if ( it + 5 <= end && !::strncmp( it - 3, "endsolid", 8 ) ) {
+            return it - 3;
+        }
+    }
+    return NULL;
+}
+
+// Checks whether sz starts with the given keyword followed by a separator
+static bool isKeyword( const char *sz, const char *keyword, size_t len ) {
+    return !::strncmp( sz, keyword, len ) && IsSpaceOrNewLine( sz[ len ] ) && sz[ len ] != '\0';
+}
+
+// Reads the three components of a vector, the buffer ends at end
+static const char *readVector( const char *sz, const char *end, aiVector3D &v ) {
+    const char *next;
+    if ( sz <= end && 3 == fast_atoreal_n<ai_real>( sz, end, &v.x, 3, &next ) ) {
+        return next;
+    }
+    sz = fast_atoreal_move<ai_real>( sz, (ai_real&)v.x );
+    SkipSpaces( &sz );
+    sz = fast_atoreal_move<ai_real>( sz, (ai_real&)v.y );
+    SkipSpaces( &sz );
+    return fast_atoreal_move<ai_real>( sz, (ai_real&)v.z );
+}
+
+// Parses the facets of a chunk, mirroring the sequential parser for well-formed input
+static void parseFacets( FacetChunk &chunk ) {
+    const char *sz = chunk.mBegin;
+
+    // assume 160 bytes for each face, like the sequential parser
+    const size_t sizeEstimate = std::max<size_t>( 1, ( chunk.mEnd - chunk.mBegin ) / 160 ) * 3;
+    chunk.mPositions.reserve( sizeEstimate );
+    chunk.mNormals.reserve( sizeEstimate );
+
+    unsigned int faceVertexCounter = 3;
+    bool bComplete = false;
+    for ( ;; ) {
+        if ( !SkipSpacesAndLineEnd( &sz ) || sz >= chunk.mEnd ) {
+            bComplete = true;
+            break;
+        }
+        if ( isKeyword( sz, "facet", 5 ) ) {
+            if ( faceVertexCounter != 3 ) {
+                break;
+            }
+            faceVertexCounter = 0;
+            sz += 6;
+            SkipSpaces( &sz );
+            if ( ::strncmp( sz, "normal", 6 ) || sz[ 6 ] == '\0' ) {
+                break;
+            }
+            sz += 7;
+            SkipSpaces( &sz );
+
+            aiVector3D vn;
+            sz = readVector( sz, chunk.mEnd, vn );
+            chunk.mNormals.insert( chunk.mNormals.end(), 3, vn );
+        } else if ( isKeyword( sz, "vertex", 6 ) ) {
+            if ( faceVertexCounter >= 3 ) {
+                break;
+            }
+            sz += 7;
+            SkipSpaces( &sz );
+
+            chunk.mPositions.push_back( aiVector3D() );
+            sz = readVector( sz, chunk.mEnd, chunk.mPositions.back() );
+            ++faceVertexCounter;
+        } else if ( isKeyword( sz, "outer", 5 ) || isKeyword( sz, "loop", 4 ) ||
+                isKeyword( sz, "endloop", 7 ) || isKeyword( sz, "endfacet", 8 ) ) {
+            do {
+                ++sz;
+            } while ( !IsSpaceOrNewLine( *sz ) );
+        } else {
+            break;
+        }
+
+        // a token running into the next chunk
+        if ( sz > chunk.mEnd ) {
+            break;
+        }
+    }
+
+    chunk.mAmbiguous = !bComplete || faceVertexCounter != 3;
+}
+
+// Parses the facets of an ASCII solid in parallel chunks split at 'endfacet'. On
+// success sz points to the terminating 'endsolid', otherwise nothing is changed
+// and the caller parses the solid sequentially.
+static bool parseSolidParallel( const char *&sz, const char *bufferEnd,
+        std::vector<aiVector3D> &positionBuffer, std::vector<aiVector3D> &normalBuffer ) {
+    // the chunks only pay off if they are parsed concurrently
+    if ( GetParallelThreadCount() < 2 ) {
+        return false;
+    }
+
+    const char *begin = sz;
+    const char *end = findEndSolid( begin, bufferEnd );
+    if ( NULL == end || ( end != begin && !IsSpaceOrNewLine( *( end - 1 ) ) ) ) {
+        return false;
+    }
+
+    // split the solid into chunks ending behind an 'endfacet' line
+    std::vector<FacetChunk> chunks;
+    while ( static_cast<size_t>( end - begin ) > ChunkSize ) {
+        const char *it = findToken( begin + ChunkSize, end, "endfacet", 8 );
+        if ( NULL == it ) {
+            break;
+        }
+        while ( it != end && !IsLineEnd( *it ) ) {
+            ++it;
+        }
+        chunks.push_back( FacetChunk( begin, it ) );
+        begin = it;
+    }
+    chunks.push_back( FacetChunk( begin, end ) );
+    if ( chunks.size() < 2 ) {
+        return false;
+    }
+
+    ParallelFor( static_cast<unsigned int>( chunks.size() ), [&chunks]( unsigned int i ) {
+        parseFacets( chunks[ i ] );
+    } );
+
+    size_t numVertices = positionBuffer.size();
+    for ( size_t i = 0; i < chunks.size(); ++i ) {
+        if ( chunks[ i ].mAmbiguous ) {
+            return false;
+        }
+        numVertices += chunks[ i ].mPositions.size();
+    }
+
+    positionBuffer.reserve( numVertices );
+    normalBuffer.reserve( numVertices );
+    for ( size_t i = 0; i < chunks.size(); ++i ) {
+        positionBuffer.insert( positionBuffer.end(), chunks[ i ].mPositions.begin(), chunks[ i ].mPositions.end() );
+        normalBuffer.insert( normalBuffer.end(), chunks[ i ].mNormals.begin(), chunks[ i ].mNormals.end() );
+    }
+    sz = end;
+    return true;
+}
+
+// Searches the header of a binary file for the default color of Materialise files
+static bool readMaterialiseColor( const unsigned char *sz2, aiColor4D &clrColorDefault ) {
+    const unsigned char* const szEnd = sz2+80;
+    while (sz2 < szEnd) {
+
+        if ('C' == *sz2++ && 'O' == *sz2++ && 'L' == *sz2++ &&
+            'O' == *sz2++ && 'R' == *sz2++ && '=' == *sz2++)    {
+
+            // read the default vertex color for facets
+            DefaultLogger::get()->info("STL: Taking code path for Materialise files");
+            const ai_real invByte = (ai_real)1.0 / ( ai_real )255.0;
+            clrColorDefault.r = (*sz2++) * invByte;
+            clrColorDefault.g = (*sz2++) * invByte;
+            clrColorDefault.b = (*sz2++) * invByte;
+            clrColorDefault.a = (*sz2++) * invByte;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Checks whether one of the given binary facets has a color
+static bool hasFacetColors( const unsigned char *sz, unsigned int count ) {
+    for ( unsigned int i = 0; i < count; ++i ) {
+        if ( sz[ i * FacetSize + FacetSize - 1 ] & 0x80 ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Converts a range of binary facets, colors is NULL if no facet has a color
+static void convertFacets( const unsigned char *sz, unsigned int first, unsigned int count,
+        aiVector3D *vertices, aiVector3D *normals, aiColor4D *colors, bool bIsMaterialise ) {
+    for ( unsigned int i = first; i < first + count; ++i, sz += FacetSize ) {
+        // NOTE: Blender sometimes writes empty normals ... this is not
+        // our fault ... the RemoveInvalidData helper step should fix that
+        aiVector3D *vn = &normals[ i * 3 ];
+        ::memcpy( &vn->x, sz, sizeof( aiVector3D ) );
+        *( vn + 1 ) = *vn;
+        *( vn + 2 ) = *vn;
+
+        // the three vertices are stored packed
+        ::memcpy( &vertices[ i * 3 ].x, sz + sizeof( aiVector3D ), 3 * sizeof( aiVector3D ) );
+
+        uint16_t color;
+        ::memcpy( &color, sz + 4 * sizeof( aiVector3D ), sizeof( uint16_t ) );
+        if ( colors && ( color & ( 1 << 15 ) ) ) {
+            aiColor4D *clr = &colors[ i * 3 ];
+            clr->a = 1.0;
+            const ai_real invVal( (ai_real)1.0 / ( ai_real )31.0 );
+            if ( bIsMaterialise ) { // this is reversed
+                clr->r = ( color & 0x31u ) * invVal;
+                clr->g = ( ( color & ( 0x31u << 5 ) ) >> 5u ) * invVal;
+                clr->b = ( ( color & ( 0x31u << 10 ) ) >> 10u ) * invVal;
+            } else {
+                clr->b = ( color & 0x31u ) * invVal;
+                clr->g = ( ( color & ( 0x31u << 5 ) ) >> 5u ) * invVal;
+                clr->r = ( ( color & ( 0x31u << 10 ) ) >> 10u ) * invVal;
+            }
+            // assign the color to all vertices of the face
+            *( clr + 1 ) = *clr;
+            *( clr + 2 ) = *clr;
+        }
+    }
+}
+
+// Converts a block of binary facets, split into tasks
+static void convertBlock( const unsigned char *data, unsigned int first, unsigned int count,
+        aiVector3D *vertices, aiVector3D *normals, aiColor4D *colors, bool bIsMaterialise ) {
+    const unsigned int numTasks = ( count + FacetsPerTask - 1 ) / FacetsPerTask;
+    ParallelFor( numTasks, [ = ]( unsigned int task ) {
+        const unsigned int offset = task * FacetsPerTask;
+        convertFacets( data + offset * FacetSize, first + offset,
+            std::min( FacetsPerTask, count - offset ), vertices, normals, colors, bIsMaterialise );
+    } );
+}
+
+// All components of an STL vertex
+struct VertexKey {
+    aiVector3D mPosition;
+    aiVector3D mNormal;
+    aiColor4D mColor;
+
+    bool operator == ( const VertexKey &other ) const {
+        return !::memcmp( this, &other, sizeof( VertexKey ) );
+    }
+};
+
+struct VertexKeyHash {
+    size_t operator() ( const VertexKey &key ) const {
+        return SuperFastHash( reinterpret_cast<const char*>( &key ), sizeof( VertexKey ) );
+    }
+};
+
+// Reallocates an array to hold the first num elements only
+template <typename T>
+static void shrinkArray( T *&array, unsigned int num ) {
+    if ( NULL == array ) {
+        return;
+    }
+    T *shrunk = new T[ num ];
+    std::copy( array, array + num, shrunk );
+    delete[] array;
+    array = shrunk;
+}
+
+// Merges the bitwise identical vertices of a mesh, keeping them in first-use order
+static void weldVertices( aiMesh *pMesh ) {
+    std::vector<unsigned int> remap( pMesh->mNumVertices );
+    std::unordered_map<VertexKey, unsigned int, VertexKeyHash> vertices;
+    vertices.reserve( pMesh->mNumVertices );
+
+    unsigned int numVertices = 0;
+    for ( unsigned int i = 0; i < pMesh->mNumVertices; ++i ) {
+        VertexKey key;
+        key.mPosition = pMesh->mVertices[ i ];
+        key.mNormal = pMesh->mNormals ? pMesh->mNormals[ i ] : aiVector3D();
+        key.mColor = pMesh->mColors[ 0 ] ? pMesh->mColors[ 0 ][ i ] : aiColor4D();
+
+        const std::pair<std::unordered_map<VertexKey, unsigned int, VertexKeyHash>::iterator, bool> res =
+            vertices.insert( std::make_pair( key, numVertices ) );
+        if ( res.second ) {
+            // the unique vertices are compacted in place, numVertices <= i
+            pMesh->mVertices[ numVertices ] = pMesh->mVertices[ i ];
+            if ( pMesh->mNormals ) {
+                pMesh->mNormals[ numVertices ] = pMesh->mNormals[ i ];
+            }
+            if ( pMesh->mColors[ 0 ] ) {
+                pMesh->mColors[ 0 ][ numVertices ] = pMesh->mColors[ 0 ][ i ];
+            }
+            ++numVertices;
+        }
+        remap[ i ] = res.first->second;
+    }
+
+    for ( unsigned int i = 0; i < pMesh->mNumFaces; ++i ) {
+        aiFace &face = pMesh->mFaces[ i ];
+        for ( unsigned int o = 0; o < face.mNumIndices; ++o ) {
+            face.mIndices[ o ] = remap[ face.mIndices[ o ] ];
+        }
+    }
+
+    pMesh->mNumVertices = numVertices;
+    shrinkArray( pMesh->mVertices, numVertices );
+    shrinkArray( pMesh->mNormals, numVertices );
+    shrinkArray( pMesh->mColors[ 0 ], numVertices );
+}
 } // namespace
 
+// ------------------------------------------------------------------------------------------------
+// State of an ASCII parse. The meshes and nodes are owned by the state until they are moved
+// to the output scene
+struct STLImporter::AsciiState {
+    AsciiState()
+        : mInSolid( false )
+        , mFaceVertexCounter( 3 )
+        , mUnnamed( false )
+        , mDone( false ) {
+        // empty
+    }
+
+    ~AsciiState() {
+        for ( size_t i = 0; i < mMeshes.size(); ++i ) {
+            delete mMeshes[ i ];
+        }
+        for ( size_t i = 0; i < mNodes.size(); ++i ) {
+            delete mNodes[ i ];
+        }
+    }
+
+    std::vector<aiMesh*> mMeshes;
+    std::vector<aiNode*> mNodes;
+    std::vector<aiVector3D> mPositions;
+    std::vector<aiVector3D> mNormals;
+
+    // set between 'solid' and 'endsolid'
+    bool mInSolid;
+    unsigned int mFaceVertexCounter;
+
+    // set if a solid has no name
+    bool mUnnamed;
+
+    // set if the text behind the last solid is no solid, it is ignored then
+    bool mDone;
+};
+
+// ------------------------------------------------------------------------------------------------
+// State of an incremental import
+struct STLImporter::IncrementalState {
+    enum Format {
+        Format_Unknown,
+        Format_Binary,
+        Format_ASCII
+    };
+
+    IncrementalState()
+        : mFormat( Format_Unknown )
+        , mSize( 0 )
+        , mNumFaces( 0 )
+        , mNumConverted( 0 )
+        , mIsMaterialise( false ) {
+        // empty
+    }
+
+    // storage representation, known as soon as the header is complete
+    Format mFormat;
+
+    // data which is not parsed yet, the beginning of a facet or line
+    std::vector<char> mPending;
+
+    // number of bytes passed so far
+    size_t mSize;
+
+    // facets of a binary file
+    unsigned int mNumFaces;
+    unsigned int mNumConverted;
+    bool mIsMaterialise;
+    std::vector<aiVector3D> mVertices;
+    std::vector<aiVector3D> mNormals;
+    std::vector<aiColor4D> mColors;
+
+    // solids of an ASCII file
+    AsciiState mAscii;
+};
+
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 STLImporter::STLImporter()
     : mBuffer(),
     fileSize(),
-    pScene()
+    pScene(),
+    mWeldVertices( false ),
+    mIncremental()
 {}
 
 // ------------------------------------------------------------------------------------------------
@@ -153,6 +592,11 @@ bool STLImporter::CanRead( const std::string& pFile, IOSystem* pIOHandler, bool
     return false;
 }
 
+// ------------------------------------------------------------------------------------------------
+void STLImporter::SetupProperties( const Importer* pImp ) {
+    mWeldVertices = pImp->GetPropertyBool( AI_CONFIG_IMPORT_STL_WELD_VERTICES, false );
+}
+
 // ------------------------------------------------------------------------------------------------
 const aiImporterDesc* STLImporter::GetInfo () const {
     return &desc;
@@ -175,6 +619,9 @@ void addFacesToMesh(aiMesh* pMesh)
 // Imports the given file into the given scene structure.
 void STLImporter::InternReadFile( const std::string& pFile, aiScene* pScene, IOSystem* pIOHandler )
 {
+    // a file import ends an unfinished incremental import
+    mIncremental.reset();
+
     std::unique_ptr<IOStream> file( pIOHandler->Open( pFile, "rb"));
 
     // Check whether we can read from the file
@@ -184,10 +631,27 @@ void STLImporter::InternReadFile( const std::string& pFile, aiScene* pScene, IOS
 
     fileSize = (unsigned int)file->FileSize();
 
-    // allocate storage and copy the contents of the file to a memory buffer
-    // (terminate it with zero)
+    // binary files are converted straight from the stream, so only read
+    // the header first
     std::vector<char> mBuffer2;
-    TextFileToBuffer(file.get(),mBuffer2);
+    if (fileSize >= 84) {
+        mBuffer2.resize(84);
+        if (84 != file->Read(&mBuffer2[0], 1, 84)) {
+            throw DeadlyImportError( "Failed to read STL file " + pFile + ".");
+        }
+        if (!IsBinarySTL(&mBuffer2[0], fileSize)) {
+            mBuffer2.clear();
+            if (aiReturn_SUCCESS != file->Seek(0, aiOrigin_SET)) {
+                throw DeadlyImportError( "Failed to seek in STL file " + pFile + ".");
+            }
+        }
+    }
+
+    // otherwise copy the contents of the file to a memory buffer
+    // (terminate it with zero)
+    if (mBuffer2.empty()) {
+        TextFileToBuffer(file.get(),mBuffer2);
+    }
 
     this->pScene = pScene;
     this->mBuffer = &mBuffer2[0];
@@ -201,13 +665,186 @@ void STLImporter::InternReadFile( const std::string& pFile, aiScene* pScene, IOS
     bool bMatClr = false;
 
     if (IsBinarySTL(mBuffer, fileSize)) {
-        bMatClr = LoadBinaryFile();
+        bMatClr = LoadBinaryFile(file.get());
     } else if (IsAsciiSTL(mBuffer, fileSize)) {
         LoadASCIIFile( pScene->mRootNode );
     } else {
         throw DeadlyImportError( "Failed to determine STL storage representation for " + pFile + ".");
     }
 
+    FinishScene(bMatClr);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Starts an incremental import
+void STLImporter::InternBeginIncremental()
+{
+    mIncremental.reset(new IncrementalState());
+
+    // the default vertex color is light gray.
+    clrColorDefault.r = clrColorDefault.g = clrColorDefault.b = clrColorDefault.a = (ai_real) 0.6;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Parses the complete facets or lines passed so far
+void STLImporter::InternFeedIncremental( const char* pData, size_t pLength )
+{
+    ai_assert(mIncremental);
+    IncrementalState& state = *mIncremental;
+    std::vector<char>& pending = state.mPending;
+    state.mSize += pLength;
+
+    if (state.mAscii.mDone) {
+        return;
+    }
+
+    try {
+        pending.insert(pending.end(), pData, pData + pLength);
+
+        if (IncrementalState::Format_Unknown == state.mFormat) {
+            if (pending.size() < 84) {
+                return;
+            }
+            if (!IsBinarySTLHeader(&pending[0])) {
+                state.mFormat = IncrementalState::Format_ASCII;
+            } else {
+                state.mFormat = IncrementalState::Format_Binary;
+                state.mIsMaterialise = readMaterialiseColor((const unsigned char*)&pending[0], clrColorDefault);
+                ::memcpy(&state.mNumFaces, &pending[80], sizeof(uint32_t));
+                pending.erase(pending.begin(), pending.begin() + 84);
+            }
+        }
+
+        if (IncrementalState::Format_Binary == state.mFormat) {
+            // convert the complete facets, data behind the last facet is only counted
+            const unsigned int count = static_cast<unsigned int>(std::min<size_t>(
+                state.mNumFaces - state.mNumConverted, pending.size() / FacetSize));
+            if (count) {
+                const unsigned char* data = (const unsigned char*)&pending[0];
+                const size_t numVertices = (state.mNumConverted + static_cast<size_t>(count)) * 3;
+
+                // vertex colors are allocated as soon as a facet uses them
+                if (state.mColors.empty()) {
+                    if (hasFacetColors(data, count)) {
+                        state.mColors.assign(numVertices, clrColorDefault);
+                        DefaultLogger::get()->info("STL: Mesh has vertex colors");
+                    }
+                } else {
+                    state.mColors.resize(numVertices, clrColorDefault);
+                }
+                state.mVertices.resize(numVertices);
+                state.mNormals.resize(numVertices);
+
+                convertBlock(data, state.mNumConverted, count, &state.mVertices[0], &state.mNormals[0],
+                    state.mColors.empty() ? NULL : &state.mColors[0], state.mIsMaterialise);
+                state.mNumConverted += count;
+            }
+            if (state.mNumConverted == state.mNumFaces) {
+                pending.clear();
+            } else {
+                pending.erase(pending.begin(), pending.begin() + count * FacetSize);
+            }
+        } else if (IncrementalState::Format_ASCII == state.mFormat) {
+            // parse the text up to the last line end, the rest is kept for the next piece
+            size_t cut = pending.size();
+            while (cut && '\n' != pending[cut - 1] && '\r' != pending[cut - 1]) {
+                --cut;
+            }
+            if (!cut) {
+                return;
+            }
+            pending.push_back('\0');
+            const char saved = pending[cut];
+            pending[cut] = '\0';
+            const char* begin = &pending[0];
+            const char* sz = ParseASCII(state.mAscii, begin, begin + cut, false);
+            pending[cut] = saved;
+            pending.pop_back();
+            pending.erase(pending.begin(), pending.begin() + (sz - begin));
+        }
+    } catch (...) {
+        // the import can't be continued after an error
+        mIncremental.reset();
+        throw;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Parses the rest of the data and builds the scene
+void STLImporter::InternFinishIncremental( aiScene* pScene )
+{
+    ai_assert(mIncremental);
+    std::unique_ptr<IncrementalState> state(std::move(mIncremental));
+    std::vector<char>& pending = state->mPending;
+    pending.push_back('\0');
+
+    // a file shorter than a binary header can only be a text file
+    if (IncrementalState::Format_Unknown == state->mFormat) {
+        if (!IsAsciiSTL(&pending[0], static_cast<unsigned int>(state->mSize))) {
+            throw DeadlyImportError( "Failed to determine STL storage representation of the incremental data.");
+        }
+        state->mFormat = IncrementalState::Format_ASCII;
+    }
+
+    this->pScene = pScene;
+    pScene->mRootNode = new aiNode();
+
+    bool bMatClr = false;
+    if (IncrementalState::Format_ASCII == state->mFormat) {
+        if (!state->mAscii.mDone) {
+            ParseASCII(state->mAscii, &pending[0], &pending[0] + pending.size() - 1, true);
+        }
+        AddASCIIMeshes(state->mAscii, pScene->mRootNode);
+    } else {
+        // binary files are recognized by their size
+        if (state->mSize != 84 + static_cast<size_t>(state->mNumFaces) * FacetSize) {
+            throw DeadlyImportError( "Failed to determine STL storage representation of the incremental data.");
+        }
+        if (!state->mNumFaces) {
+            throw DeadlyImportError("STL: file is empty. There are no facets defined");
+        }
+
+        // allocate one mesh
+        pScene->mNumMeshes = 1;
+        pScene->mMeshes = new aiMesh*[1];
+        aiMesh* pMesh = pScene->mMeshes[0] = new aiMesh();
+        pMesh->mMaterialIndex = 0;
+        pScene->mRootNode->mName.Set("<STL_BINARY>");
+
+        pMesh->mNumFaces = state->mNumFaces;
+        pMesh->mNumVertices = pMesh->mNumFaces*3;
+        pMesh->mVertices = new aiVector3D[pMesh->mNumVertices];
+        std::copy(state->mVertices.begin(), state->mVertices.end(), pMesh->mVertices);
+        pMesh->mNormals = new aiVector3D[pMesh->mNumVertices];
+        std::copy(state->mNormals.begin(), state->mNormals.end(), pMesh->mNormals);
+        if (!state->mColors.empty()) {
+            pMesh->mColors[0] = new aiColor4D[pMesh->mNumVertices];
+            std::copy(state->mColors.begin(), state->mColors.end(), pMesh->mColors[0]);
+        }
+        addFacesToMesh(pMesh);
+
+        pScene->mRootNode->mNumMeshes = 1;
+        pScene->mRootNode->mMeshes = new unsigned int[1];
+        pScene->mRootNode->mMeshes[0] = 0;
+
+        // use the color as diffuse material color
+        bMatClr = state->mIsMaterialise && state->mColors.empty();
+    }
+
+    FinishScene(bMatClr);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Welds the vertices and adds the default material
+void STLImporter::FinishScene( bool bMatClr )
+{
+    // STL has no index buffer, share identical vertices if requested
+    if (mWeldVertices) {
+        for (unsigned int i = 0; i < pScene->mNumMeshes; ++i) {
+            weldVertices(pScene->mMeshes[i]);
+        }
+    }
+
     // create a single default material, using a white diffuse color for consistency with
     // other geometric types (e.g., PLY).
     aiMaterial* pcMat = new aiMaterial();
@@ -232,58 +869,87 @@ void STLImporter::InternReadFile( const std::string& pFile, aiScene* pScene, IOS
 // ------------------------------------------------------------------------------------------------
 // Read an ASCII STL file
 void STLImporter::LoadASCIIFile( aiNode *root ) {
-    std::vector<aiMesh*> meshes;
-    std::vector<aiNode*> nodes;
-    const char* sz = mBuffer;
-    const char* bufferEnd = mBuffer + fileSize;
-    std::vector<aiVector3D> positionBuffer;
-    std::vector<aiVector3D> normalBuffer;
+    AsciiState state;
 
     // try to guess how many vertices we could have
     // assume we'll need 160 bytes for each face
     size_t sizeEstimate = std::max(1u, fileSize / 160u ) * 3;
-    positionBuffer.reserve(sizeEstimate);
-    normalBuffer.reserve(sizeEstimate);
+    state.mPositions.reserve(sizeEstimate);
+    state.mNormals.reserve(sizeEstimate);
 
-    while (IsAsciiSTL(sz, static_cast<unsigned int>(bufferEnd - sz))) {
-        std::vector<unsigned int> meshIndices;
-        aiMesh* pMesh = new aiMesh();
-        pMesh->mMaterialIndex = 0;
-        meshIndices.push_back((unsigned int) meshes.size() );
-        meshes.push_back(pMesh);
-        aiNode *node = new aiNode;
-        node->mParent = root;
-        nodes.push_back( node );
-        SkipSpaces(&sz);
-        ai_assert(!IsLineEnd(sz));
-
-        sz += 5; // skip the "solid"
-        SkipSpaces(&sz);
-        const char* szMe = sz;
-        while (!::IsSpaceOrNewLine(*sz)) {
-            sz++;
-        }
-
-        size_t temp;
-        // setup the name of the node
-        if ((temp = (size_t)(sz-szMe))) {
-            if (temp >= MAXLEN) {
-                throw DeadlyImportError( "STL: Node name too long" );
+    ParseASCII(state, mBuffer, mBuffer + fileSize, true);
+    AddASCIIMeshes(state, root);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Parse the solids of an ASCII text
+const char* STLImporter::ParseASCII( AsciiState &state, const char* sz, const char* bufferEnd, bool bFinal ) {
+    std::vector<aiVector3D>& positionBuffer = state.mPositions;
+    std::vector<aiVector3D>& normalBuffer = state.mNormals;
+
+    for ( ;; ) {
+        if (!state.mInSolid) {
+            if (bFinal) {
+                if (!IsAsciiSTL(sz, static_cast<unsigned int>(bufferEnd - sz))) {
+                    return sz;
+                }
+            } else {
+                // wait for the next line if the text ends here
+                SkipSpacesAndLineEnd(&sz);
+                if (sz + 5 >= bufferEnd) {
+                    return sz;
+                }
+                if (strncmp(sz, "solid", 5)) {
+                    state.mDone = true;
+                    return bufferEnd;
+                }
+            }
+
+            aiMesh* pMesh = new aiMesh();
+            pMesh->mMaterialIndex = 0;
+            state.mMeshes.push_back(pMesh);
+            aiNode *node = new aiNode;
+            state.mNodes.push_back( node );
+            SkipSpaces(&sz);
+            ai_assert(!IsLineEnd(sz));
+
+            sz += 5; // skip the "solid"
+            SkipSpaces(&sz);
+            const char* szMe = sz;
+            while (!::IsSpaceOrNewLine(*sz)) {
+                sz++;
+            }
+
+            size_t temp;
+            // setup the name of the node
+            if ((temp = (size_t)(sz-szMe))) {
+                if (temp >= MAXLEN) {
+                    throw DeadlyImportError( "STL: Node name too long" );
+                }
+                std::string name( szMe, temp );
+                node->mName.Set( name.c_str() );
+            } else {
+                state.mUnnamed = true;
+            }
+
+            state.mInSolid = true;
+            state.mFaceVertexCounter = 3;
+
+            // well-formed solids are parsed in parallel, this stops at 'endsolid'
+            if (bFinal) {
+                parseSolidParallel(sz, bufferEnd, positionBuffer, normalBuffer);
             }
-            std::string name( szMe, temp );
-            node->mName.Set( name.c_str() );
-            //pScene->mRootNode->mName.length = temp;
-            //memcpy(pScene->mRootNode->mName.data,szMe,temp);
-            //pScene->mRootNode->mName.data[temp] = '\0';
-        } else {
-            pScene->mRootNode->mName.Set("<STL_ASCII>");
         }
 
-        unsigned int faceVertexCounter = 3;
+        unsigned int& faceVertexCounter = state.mFaceVertexCounter;
         for ( ;; ) {
             // go to the next token
             if(!SkipSpacesAndLineEnd(&sz))
             {
+                // the next piece continues the solid
+                if (!bFinal && sz == bufferEnd) {
+                    return sz;
+                }
                 // seems we're finished although there was no end marker
                 DefaultLogger::get()->warn("STL: unexpected EOF. \'endsolid\' keyword was expected");
                 break;
@@ -308,13 +974,11 @@ void STLImporter::LoadASCIIFile( aiNode *root ) {
                     }
                     sz += 7;
                     SkipSpaces(&sz);
-                    sz = fast_atoreal_move<ai_real>(sz, (ai_real&)vn->x );
-                    SkipSpaces(&sz);
-                    sz = fast_atoreal_move<ai_real>(sz, (ai_real&)vn->y );
-                    SkipSpaces(&sz);
-                    sz = fast_atoreal_move<ai_real>(sz, (ai_real&)vn->z );
-                    normalBuffer.push_back(*vn);
-                    normalBuffer.push_back(*vn);
+                    sz = readVector(sz, bufferEnd, *vn);
+                    // copy the normal first, pushing it may move the buffer
+                    const aiVector3D normal = *vn;
+                    normalBuffer.push_back(normal);
+                    normalBuffer.push_back(normal);
                 }
             } else if (!strncmp(sz,"vertex",6) && ::IsSpaceOrNewLine(*(sz+6))) { // vertex 1.50000 1.50000 0.00000
                 if (faceVertexCounter >= 3) {
@@ -328,11 +992,7 @@ void STLImporter::LoadASCIIFile( aiNode *root ) {
                     SkipSpaces(&sz);
                     positionBuffer.push_back(aiVector3D());
                     aiVector3D* vn = &positionBuffer.back();
-                    sz = fast_atoreal_move<ai_real>(sz, (ai_real&)vn->x );
-                    SkipSpaces(&sz);
-                    sz = fast_atoreal_move<ai_real>(sz, (ai_real&)vn->y );
-                    SkipSpaces(&sz);
-                    sz = fast_atoreal_move<ai_real>(sz, (ai_real&)vn->z );
+                    sz = readVector(sz, bufferEnd, *vn);
                     faceVertexCounter++;
                 }
             } else if (!::strncmp(sz,"endsolid",8))    {
@@ -349,6 +1009,7 @@ void STLImporter::LoadASCIIFile( aiNode *root ) {
             }
         }
 
+        aiMesh* pMesh = state.mMeshes.back();
         if (positionBuffer.empty())    {
             pMesh->mNumFaces = 0;
             throw DeadlyImportError("STL: ASCII file is empty or invalid; no data loaded");
@@ -374,26 +1035,39 @@ void STLImporter::LoadASCIIFile( aiNode *root ) {
         addFacesToMesh(pMesh);
 
         // assign the meshes to the current node
-        pushMeshesToNode( meshIndices, node );
+        std::vector<unsigned int> meshIndices(1, static_cast<unsigned int>(state.mMeshes.size() - 1));
+        pushMeshesToNode( meshIndices, state.mNodes.back() );
+        state.mInSolid = false;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Move the meshes and nodes of an ASCII parse to the output scene
+void STLImporter::AddASCIIMeshes( AsciiState &state, aiNode *root ) {
+    if (state.mUnnamed) {
+        pScene->mRootNode->mName.Set("<STL_ASCII>");
     }
 
     // now add the loaded meshes
-    pScene->mNumMeshes = (unsigned int)meshes.size();
+    pScene->mNumMeshes = (unsigned int)state.mMeshes.size();
     pScene->mMeshes = new aiMesh*[pScene->mNumMeshes];
-    for (size_t i = 0; i < meshes.size(); i++) {
-        pScene->mMeshes[ i ] = meshes[i];
+    for (size_t i = 0; i < state.mMeshes.size(); i++) {
+        pScene->mMeshes[ i ] = state.mMeshes[i];
     }
+    state.mMeshes.clear();
 
-    root->mNumChildren = (unsigned int) nodes.size();
+    root->mNumChildren = (unsigned int) state.mNodes.size();
     root->mChildren = new aiNode*[ root->mNumChildren ];
-    for ( size_t i=0; i<nodes.size(); ++i ) {
-        root->mChildren[ i ] = nodes[ i ];
+    for ( size_t i=0; i<state.mNodes.size(); ++i ) {
+        state.mNodes[ i ]->mParent = root;
+        root->mChildren[ i ] = state.mNodes[ i ];
     }
+    state.mNodes.clear();
 }
 
 // ------------------------------------------------------------------------------------------------
 // Read a binary STL file
-bool STLImporter::LoadBinaryFile()
+bool STLImporter::LoadBinaryFile( IOStream *file )
 {
     // allocate one mesh
     pScene->mNumMeshes = 1;
@@ -405,34 +1079,14 @@ bool STLImporter::LoadBinaryFile()
     if (fileSize < 84) {
         throw DeadlyImportError("STL: file is too small for the header");
     }
-    bool bIsMaterialise = false;
-
     // search for an occurrence of "COLOR=" in the header
-    const unsigned char* sz2 = (const unsigned char*)mBuffer;
-    const unsigned char* const szEnd = sz2+80;
-    while (sz2 < szEnd) {
-
-        if ('C' == *sz2++ && 'O' == *sz2++ && 'L' == *sz2++ &&
-            'O' == *sz2++ && 'R' == *sz2++ && '=' == *sz2++)    {
-
-            // read the default vertex color for facets
-            bIsMaterialise = true;
-            DefaultLogger::get()->info("STL: Taking code path for Materialise files");
-            const ai_real invByte = (ai_real)1.0 / ( ai_real )255.0;
-            clrColorDefault.r = (*sz2++) * invByte;
-            clrColorDefault.g = (*sz2++) * invByte;
-            clrColorDefault.b = (*sz2++) * invByte;
-            clrColorDefault.a = (*sz2++) * invByte;
-            break;
-        }
-    }
+    const bool bIsMaterialise = readMaterialiseColor((const unsigned char*)mBuffer, clrColorDefault);
     const unsigned char* sz = (const unsigned char*)mBuffer + 80;
 
     // now read the number of facets
     pScene->mRootNode->mName.Set("<STL_BINARY>");
 
-    pMesh->mNumFaces = *((uint32_t*)sz);
-    sz += 4;
+    ::memcpy(&pMesh->mNumFaces, sz, sizeof(uint32_t));
 
     if (fileSize < 84 + pMesh->mNumFaces*50) {
         throw DeadlyImportError("STL: file is too small to hold all facets");
@@ -443,64 +1097,26 @@ bool STLImporter::LoadBinaryFile()
     }
 
     pMesh->mNumVertices = pMesh->mNumFaces*3;
+    pMesh->mVertices = new aiVector3D[pMesh->mNumVertices];
+    pMesh->mNormals = new aiVector3D[pMesh->mNumVertices];
+
+    // convert the facets block by block, the file is never held in memory as a whole
+    std::vector<unsigned char> block(std::min(pMesh->mNumFaces, FacetsPerBlock) * FacetSize);
+    for (unsigned int first = 0; first < pMesh->mNumFaces; first += FacetsPerBlock) {
+        const unsigned int count = std::min(FacetsPerBlock, pMesh->mNumFaces - first);
+        if (count * FacetSize != file->Read(&block[0], 1, count * FacetSize)) {
+            throw DeadlyImportError("STL: file is too small to hold all facets");
+        }
 
-    aiVector3D* vp,*vn;
-    vp = pMesh->mVertices = new aiVector3D[pMesh->mNumVertices];
-    vn = pMesh->mNormals = new aiVector3D[pMesh->mNumVertices];
-
-    for (unsigned int i = 0; i < pMesh->mNumFaces;++i) {
-
-        // NOTE: Blender sometimes writes empty normals ... this is not
-        // our fault ... the RemoveInvalidData helper step should fix that
-        *vn = *((aiVector3D*)sz);
-        sz += sizeof(aiVector3D);
-        *(vn+1) = *vn;
-        *(vn+2) = *vn;
-        vn += 3;
-
-        *vp++ = *((aiVector3D*)sz);
-        sz += sizeof(aiVector3D);
-
-        *vp++ = *((aiVector3D*)sz);
-        sz += sizeof(aiVector3D);
-
-        *vp++ = *((aiVector3D*)sz);
-        sz += sizeof(aiVector3D);
-
-        uint16_t color = *((uint16_t*)sz);
-        sz += 2;
-
-        if (color & (1 << 15))
-        {
-            // seems we need to take the color
-            if (!pMesh->mColors[0])
-            {
-                pMesh->mColors[0] = new aiColor4D[pMesh->mNumVertices];
-                for (unsigned int i = 0; i <pMesh->mNumVertices;++i)
-                    *pMesh->mColors[0]++ = this->clrColorDefault;
-                pMesh->mColors[0] -= pMesh->mNumVertices;
+        // vertex colors are allocated as soon as a facet uses them
+        if (!pMesh->mColors[0] && hasFacetColors(&block[0], count)) {
+            pMesh->mColors[0] = new aiColor4D[pMesh->mNumVertices];
+            std::fill(pMesh->mColors[0], pMesh->mColors[0] + pMesh->mNumVertices, clrColorDefault);
 
-                DefaultLogger::get()->info("STL: Mesh has vertex colors");
-            }
-            aiColor4D* clr = &pMesh->mColors[0][i*3];
-            clr->a = 1.0;
-            const ai_real invVal( (ai_real)1.0 / ( ai_real )31.0 );
-            if (bIsMaterialise) // this is reversed
-            {
-                clr->r = (color & 0x31u) *invVal;
-                clr->g = ((color & (0x31u<<5))>>5u) *invVal;
-                clr->b = ((color & (0x31u<<10))>>10u) *invVal;
-            }
-            else
-            {
-                clr->b = (color & 0x31u) *invVal;
-                clr->g = ((color & (0x31u<<5))>>5u) *invVal;
-                clr->r = ((color & (0x31u<<10))>>10u) *invVal;
-            }
-            // assign the color to all vertices of the face
-            *(clr+1) = *clr;
-            *(clr+2) = *clr;
+            DefaultLogger::get()->info("STL: Mesh has vertex colors");
         }
+
+        convertBlock(&block[0], first, count, pMesh->mVertices, pMesh->mNormals, pMesh->mColors[0], bIsMaterialise);
     }
 
     // now copy faces
@@ -47,6 +47,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "BaseImporter.h"
 #include <assimp/types.h>
+#include <memory>
 
 // Forward declarations
 struct aiNode;
@@ -76,6 +77,12 @@ public:
      */
     bool CanRead( const std::string& pFile, IOSystem* pIOHandler, bool checkSig) const;
 
+    /**
+     * @brief   Updates the importer configuration.
+     *  See BaseImporter::SetupProperties() for details.
+     */
+    void SetupProperties( const Importer* pImp );
+
 protected:
 
     /**
@@ -92,16 +99,61 @@ protected:
         IOSystem* pIOHandler);
 
     /**
-     * @brief   Loads a binary .stl file
+     * @brief   Starts an incremental import.
+     *  See BaseImporter::InternBeginIncremental() for details
+     */
+    void InternBeginIncremental();
+
+    /**
+     * @brief   Converts the complete facets of a binary file or parses the
+     *  complete lines of an ASCII file.
+     *  See BaseImporter::InternFeedIncremental() for details
+     */
+    void InternFeedIncremental( const char* pData, size_t pLength );
+
+    /**
+     * @brief   Finishes an incremental import.
+     *  See BaseImporter::InternFinishIncremental() for details
+     */
+    void InternFinishIncremental( aiScene* pScene );
+
+    /**
+     * @brief   Loads a binary .stl file. The header is expected in mBuffer,
+     *  the facets are converted block-wise straight from the stream.
      * @return true if the default vertex color must be used as material color
      */
-    bool LoadBinaryFile();
+    bool LoadBinaryFile( IOStream *file );
 
     /**
      * @brief   Loads a ASCII text .stl file
      */
     void LoadASCIIFile( aiNode *root );
 
+    /** State of an ASCII parse, kept between the pieces of an incremental import */
+    struct AsciiState;
+
+    /** State of an incremental import */
+    struct IncrementalState;
+
+    /**
+     * @brief   Parses the solids of an ASCII text.
+     * @param   bFinal  Set if the text ends with the file. Otherwise the text
+     *  must end behind a line end and the parse stops at its end, ready to
+     *  continue with the next piece.
+     * @return  Position to continue with the next piece
+     */
+    const char* ParseASCII( AsciiState &state, const char* sz, const char* bufferEnd, bool bFinal );
+
+    /**
+     * @brief   Moves the meshes and nodes of an ASCII parse to the output scene.
+     */
+    void AddASCIIMeshes( AsciiState &state, aiNode *root );
+
+    /**
+     * @brief   Welds the vertices if requested and adds the default material.
+     */
+    void FinishScene( bool bMatClr );
+
     void pushMeshesToNode( std::vector<unsigned int> &meshIndices, aiNode *node );
 
 protected:
@@ -117,6 +169,12 @@ protected:
 
     /** Default vertex color */
     aiColor4D clrColorDefault;
+
+    /** Merge identical vertices while loading */
+    bool mWeldVertices;
+
+    /** State of the running incremental import */
+    std::unique_ptr<IncrementalState> mIncremental;
 };
 
 } // end of namespace Assimp
@@ -60,6 +60,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/scene.h>
 #include <assimp/mesh.h>
 #include <stdio.h>
+#include <algorithm>
 #include "ScenePrivate.h"
 
 namespace Assimp {
@@ -973,6 +974,20 @@ void GetArrayCopy(Type*& dest, ai_uint num ) {
     ::memcpy(dest, old, sizeof(Type) * num);
 }
 
+// ------------------------------------------------------------------------------------------------
+// Same as GetArrayCopy(), but copies by assignment, for types which must not be copied with memcpy
+template <typename Type>
+inline
+void GetArrayCopyAssign(Type*& dest, ai_uint num ) {
+    if ( !dest ) {
+        return;
+    }
+    const Type* old = dest;
+
+    dest = new Type[num];
+    std::copy(old, old + num, dest);
+}
+
 // ------------------------------------------------------------------------------------------------
 void SceneCombiner::CopySceneFlat(aiScene** _dest,const aiScene* src) {
     if ( nullptr == _dest || nullptr == src ) {
@@ -1071,6 +1086,14 @@ void SceneCombiner::Copy( aiMesh** _dest, const aiMesh* src ) {
 
     // make a deep copy of all bones
     CopyPtrArray(dest->mBones,dest->mBones,dest->mNumBones);
+    GetArrayCopy( dest->mPackedBoneIndices, dest->mNumVertices * dest->mNumBoneInfluences * dest->mPackedBoneIndexSize );
+    GetArrayCopy( dest->mPackedBoneWeights, dest->mNumVertices * dest->mNumBoneInfluences * dest->mPackedBoneWeightSize );
+    GetArrayCopy( dest->mInstanceTransforms, dest->mNumInstances );
+    GetArrayCopyAssign( dest->mMeshlets, dest->mNumMeshlets );
+    GetArrayCopy( dest->mMeshletVertices, dest->mNumMeshletVertices );
+    GetArrayCopy( dest->mMeshletTriangles, dest->mNumMeshletTriangles * 3 );
+    GetArrayCopyAssign( dest->mBVHNodes, dest->mNumBVHNodes );
+    GetArrayCopy( dest->mBVHFaces, dest->mNumBVHFaces );
 
     // make a deep copy of all faces
     GetArrayCopy(dest->mFaces,dest->mNumFaces);
@@ -229,6 +229,7 @@ void SortByPTypeProcess::Execute( aiScene* pScene)
             // copy data members
             out->mPrimitiveTypes = 1u << real;
             out->mMaterialIndex = mesh->mMaterialIndex;
+            CopyInstanceTable(mesh,out);
 
             // allocate output storage
             out->mNumFaces = aiNumPerPType[real];
@@ -43,7 +43,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 /** @file Implementation of the helper class to quickly find vertices close to a given position */
 
 #include "SpatialSort.h"
+#include "VectorKernels.h"
 #include <assimp/ai_assert.h>
+#include <algorithm>
+#include <utility>
 
 using namespace Assimp;
 
@@ -84,14 +87,54 @@ void SpatialSort::Fill( const aiVector3D* pPositions, unsigned int pNumPositions
     unsigned int pElementOffset,
     bool pFinalize /*= true */)
 {
-    mPositions.clear();
+    mX.clear();
+    mY.clear();
+    mZ.clear();
+    mDistances.clear();
+    mIndices.clear();
     Append(pPositions,pNumPositions,pElementOffset,pFinalize);
 }
 
+// ------------------------------------------------------------------------------------------------
+namespace {
+
+    typedef std::pair<ai_real,unsigned int> SortKey;
+
+    bool CompareDistance( const SortKey& a, const SortKey& b) {
+        return a.first < b.first;
+    }
+
+    // Moves the elements of an array into the given order
+    template <typename T>
+    void ApplyOrder( std::vector<T>& data, const std::vector<SortKey>& order) {
+        std::vector<T> sorted(data.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            sorted[i] = data[order[i].second];
+        }
+        data.swap(sorted);
+    }
+
+} // namespace
+
 // ------------------------------------------------------------------------------------------------
 void SpatialSort :: Finalize()
 {
-    std::sort( mPositions.begin(), mPositions.end());
+    // sort the distances along with their slots and move all arrays into that order. std::sort
+    // decides on the comparisons alone, so entries of equal distance end up in the same order
+    // as if the entries themselves were sorted.
+    std::vector<SortKey> order(mDistances.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = SortKey(mDistances[i],static_cast<unsigned int>(i));
+    }
+    std::sort( order.begin(), order.end(), CompareDistance);
+
+    ApplyOrder(mX,order);
+    ApplyOrder(mY,order);
+    ApplyOrder(mZ,order);
+    ApplyOrder(mIndices,order);
+    for (size_t i = 0; i < order.size(); ++i) {
+        mDistances[i] = order[i].first;
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -100,8 +143,13 @@ void SpatialSort::Append( const aiVector3D* pPositions, unsigned int pNumPositio
     bool pFinalize /*= true */)
 {
     // store references to all given positions along with their distance to the reference plane
-    const size_t initial = mPositions.size();
-    mPositions.reserve(initial + (pFinalize?pNumPositions:pNumPositions*2));
+    const size_t initial = mDistances.size();
+    const size_t capacity = initial + (pFinalize?pNumPositions:pNumPositions*2);
+    mX.reserve(capacity);
+    mY.reserve(capacity);
+    mZ.reserve(capacity);
+    mDistances.reserve(capacity);
+    mIndices.reserve(capacity);
     for( unsigned int a = 0; a < pNumPositions; a++)
     {
         const char* tempPointer = reinterpret_cast<const char*> (pPositions);
@@ -109,7 +157,11 @@ void SpatialSort::Append( const aiVector3D* pPositions, unsigned int pNumPositio
 
         // store position by index and distance
         ai_real distance = *vec * mPlaneNormal;
-        mPositions.push_back( Entry( static_cast<unsigned int>(a+initial), *vec, distance));
+        mX.push_back(vec->x);
+        mY.push_back(vec->y);
+        mZ.push_back(vec->z);
+        mDistances.push_back(distance);
+        mIndices.push_back(static_cast<unsigned int>(a+initial));
     }
 
     if (pFinalize) {
@@ -130,19 +182,19 @@ void SpatialSort::FindPositions( const aiVector3D& pPosition,
     poResults.clear();
 
     // quick check for positions outside the range
-    if( mPositions.size() == 0)
+    if( mDistances.size() == 0)
         return;
-    if( maxDist < mPositions.front().mDistance)
+    if( maxDist < mDistances.front())
         return;
-    if( minDist > mPositions.back().mDistance)
+    if( minDist > mDistances.back())
         return;
 
     // do a binary search for the minimal distance to start the iteration there
-    unsigned int index = (unsigned int)mPositions.size() / 2;
-    unsigned int binaryStepSize = (unsigned int)mPositions.size() / 4;
+    unsigned int index = (unsigned int)mDistances.size() / 2;
+    unsigned int binaryStepSize = (unsigned int)mDistances.size() / 4;
     while( binaryStepSize > 1)
     {
-        if( mPositions[index].mDistance < minDist)
+        if( mDistances[index] < minDist)
             index += binaryStepSize;
         else
             index -= binaryStepSize;
@@ -152,23 +204,16 @@ void SpatialSort::FindPositions( const aiVector3D& pPosition,
 
     // depending on the direction of the last step we need to single step a bit back or forth
     // to find the actual beginning element of the range
-    while( index > 0 && mPositions[index].mDistance > minDist)
+    while( index > 0 && mDistances[index] > minDist)
         index--;
-    while( index < (mPositions.size() - 1) && mPositions[index].mDistance < minDist)
+    while( index < (mDistances.size() - 1) && mDistances[index] < minDist)
         index++;
 
     // Mow start iterating from there until the first position lays outside of the distance range.
     // Add all positions inside the distance range within the given radius to the result aray
-    std::vector<Entry>::const_iterator it = mPositions.begin() + index;
     const ai_real pSquared = pRadius*pRadius;
-    while( it->mDistance < maxDist)
-    {
-        if( (it->mPosition - pPosition).SquareLength() < pSquared)
-            poResults.push_back( it->mIndex);
-        ++it;
-        if( it == mPositions.end())
-            break;
-    }
+    CollectInRadius(&mX[0], &mY[0], &mZ[0], &mDistances[0], &mIndices[0], index,
+        (unsigned int)mDistances.size(), pPosition, maxDist, pSquared, poResults);
 
     // that's it
 }
@@ -272,12 +317,12 @@ void SpatialSort::FindIdenticalPositions( const aiVector3D& pPosition,
     poResults.resize( 0 );
 
     // do a binary search for the minimal distance to start the iteration there
-    unsigned int index = (unsigned int)mPositions.size() / 2;
-    unsigned int binaryStepSize = (unsigned int)mPositions.size() / 4;
+    unsigned int index = (unsigned int)mDistances.size() / 2;
+    unsigned int binaryStepSize = (unsigned int)mDistances.size() / 4;
     while( binaryStepSize > 1)
     {
         // Ugly, but conditional jumps are faster with integers than with floats
-        if( minDistBinary > ToBinary(mPositions[index].mDistance))
+        if( minDistBinary > ToBinary(mDistances[index]))
             index += binaryStepSize;
         else
             index -= binaryStepSize;
@@ -287,21 +332,17 @@ void SpatialSort::FindIdenticalPositions( const aiVector3D& pPosition,
 
     // depending on the direction of the last step we need to single step a bit back or forth
     // to find the actual beginning element of the range
-    while( index > 0 && minDistBinary < ToBinary(mPositions[index].mDistance) )
+    while( index > 0 && minDistBinary < ToBinary(mDistances[index]) )
         index--;
-    while( index < (mPositions.size() - 1) && minDistBinary > ToBinary(mPositions[index].mDistance))
+    while( index < (mDistances.size() - 1) && minDistBinary > ToBinary(mDistances[index]))
         index++;
 
     // Now start iterating from there until the first position lays outside of the distance range.
     // Add all positions inside the distance range within the tolerance to the result aray
-    std::vector<Entry>::const_iterator it = mPositions.begin() + index;
-    while( ToBinary(it->mDistance) < maxDistBinary)
+    for (size_t i = index; i < mDistances.size() && ToBinary(mDistances[i]) < maxDistBinary; ++i)
     {
-        if( distance3DToleranceInULPs >= ToBinary((it->mPosition - pPosition).SquareLength()))
-            poResults.push_back(it->mIndex);
-        ++it;
-        if( it == mPositions.end())
-            break;
+        if( distance3DToleranceInULPs >= ToBinary((GetPosition(i) - pPosition).SquareLength()))
+            poResults.push_back(mIndices[i]);
     }
 
     // that's it
@@ -310,30 +351,30 @@ void SpatialSort::FindIdenticalPositions( const aiVector3D& pPosition,
 // ------------------------------------------------------------------------------------------------
 unsigned int SpatialSort::GenerateMappingTable(std::vector<unsigned int>& fill, ai_real pRadius) const
 {
-    fill.resize(mPositions.size(),UINT_MAX);
+    fill.resize(mIndices.size(),UINT_MAX);
     ai_real dist, maxDist;
 
     unsigned int t=0;
     const ai_real pSquared = pRadius*pRadius;
-    for (size_t i = 0; i < mPositions.size();) {
-        dist = mPositions[i].mPosition * mPlaneNormal;
+    for (size_t i = 0; i < mIndices.size();) {
+        const aiVector3D oldpos = GetPosition(i);
+        dist = oldpos * mPlaneNormal;
         maxDist = dist + pRadius;
 
-        fill[mPositions[i].mIndex] = t;
-        const aiVector3D& oldpos = mPositions[i].mPosition;
-        for (++i; i < fill.size() && mPositions[i].mDistance < maxDist
-            && (mPositions[i].mPosition - oldpos).SquareLength() < pSquared; ++i)
+        fill[mIndices[i]] = t;
+        for (++i; i < fill.size() && mDistances[i] < maxDist
+            && (GetPosition(i) - oldpos).SquareLength() < pSquared; ++i)
         {
-            fill[mPositions[i].mIndex] = t;
+            fill[mIndices[i]] = t;
         }
         ++t;
     }
 
 #ifdef ASSIMP_BUILD_DEBUG
 
-    // debug invariant: mPositions[i].mIndex values must range from 0 to mPositions.size()-1
+    // debug invariant: mIndices[i] values must range from 0 to mIndices.size()-1
     for (size_t i = 0; i < fill.size(); ++i) {
-        ai_assert(fill[i]<mPositions.size());
+        ai_assert(fill[i]<mIndices.size());
     }
 
 #endif
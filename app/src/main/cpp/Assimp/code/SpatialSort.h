@@ -142,28 +142,32 @@ public:
     unsigned int GenerateMappingTable(std::vector<unsigned int>& fill,
         ai_real pRadius) const;
 
+    // ------------------------------------------------------------------------------------
+    /** Returns the indices of all positions, sorted by their distance to the sorting
+     *  plane. Requires the data to be finalized. Looking up the positions in this order
+     *  keeps the ranges searched by consecutive #FindPositions() calls close together
+     *  in memory. */
+    const std::vector<unsigned int>& GetSortedIndices() const {
+        return mIndices;
+    }
+
 protected:
     /** Normal of the sorting plane, normalized. The center is always at (0, 0, 0) */
     aiVector3D mPlaneNormal;
 
-    /** An entry in a spatially sorted position array. Consists of a vertex index,
-     * its position and its precalculated distance from the reference plane */
-    struct Entry
-    {
-        unsigned int mIndex; ///< The vertex referred by this entry
-        aiVector3D mPosition; ///< Position
-        ai_real mDistance; ///< Distance of this vertex to the sorting plane
-
-        Entry() { /** intentionally not initialized.*/ }
-        Entry( unsigned int pIndex, const aiVector3D& pPosition, ai_real pDistance)
-            : mIndex( pIndex), mPosition( pPosition), mDistance( pDistance)
-        {   }
-
-        bool operator < (const Entry& e) const { return mDistance < e.mDistance; }
-    };
-
-    // all positions, sorted by distance to the sorting plane
-    std::vector<Entry> mPositions;
+    // All positions, sorted by distance to the sorting plane once finalized. Each
+    // entry consists of the position, its precalculated distance from the reference
+    // plane and the vertex index referred by it. The components are stored in
+    // separate arrays so the search loop of FindPositions() can test several
+    // entries at once.
+    std::vector<ai_real> mX, mY, mZ;
+    std::vector<ai_real> mDistances;
+    std::vector<unsigned int> mIndices;
+
+    /** Returns the position of the entry at the given sorted index */
+    aiVector3D GetPosition(size_t pEntry) const {
+        return aiVector3D(mX[pEntry],mY[pEntry],mZ[pEntry]);
+    }
 };
 
 } // end of namespace Assimp
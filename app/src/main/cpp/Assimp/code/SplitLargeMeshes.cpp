@@ -171,6 +171,7 @@ void SplitLargeMeshesProcess_Triangle::SplitMesh(
 
             // the name carries the adjacency information between the meshes
             pcMesh->mName = pMesh->mName;
+            CopyInstanceTable(pMesh,pcMesh);
 
             if (i == iSubMeshes-1)
             {
@@ -448,6 +449,7 @@ void SplitLargeMeshesProcess_Vertex::SplitMesh(
 
             // the name carries the adjacency information between the meshes
             pcMesh->mName = pMesh->mName;
+            CopyInstanceTable(pMesh,pcMesh);
 
             typedef std::vector<aiVertexWeight> BoneWeightList;
             if (pMesh->HasBones())
@@ -43,12 +43,292 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/SceneCombiner.h>
 #include "SpatialSort.h"
 #include "ProcessHelper.h"
-#include "Vertex.h"
+#include "ParallelHelper.h"
 #include <assimp/ai_assert.h>
 #include <stdio.h>
+#include <algorithm>
 
 using namespace Assimp;
-void mydummy() {}
+
+namespace {
+
+typedef std::vector<unsigned int> UIntVector;
+
+// Number of work items handed to a thread in one go
+const unsigned int BlockSize = 1024;
+
+// ------------------------------------------------------------------------------------------------
+// Call func(begin,end) for consecutive blocks of [0,count). Blocks may run in parallel.
+template <typename Func>
+void ForEachBlock(unsigned int count, Func func)
+{
+    ParallelFor((count+BlockSize-1)/BlockSize,[&](unsigned int block) {
+        const unsigned int begin = block*BlockSize;
+        func(begin,std::min(count,begin+BlockSize));
+    });
+}
+
+// ------------------------------------------------------------------------------------------------
+// Small helpers to operate on interleaved vertices of 'n' components
+inline void Copy(ai_real* dest, const ai_real* src, unsigned int n)
+{
+    std::copy(src,src+n,dest);
+}
+
+inline void Accumulate(ai_real* dest, const ai_real* src, unsigned int n)
+{
+    for (unsigned int i = 0; i < n; ++i) {
+        dest[i] += src[i];
+    }
+}
+
+inline void Scale(ai_real* dest, ai_real f, unsigned int n)
+{
+    for (unsigned int i = 0; i < n; ++i) {
+        dest[i] *= f;
+    }
+}
+
+inline ai_real Distance(const ai_real* a, const ai_real* b)
+{
+    // the position is always the first component
+    return (aiVector3D(a[0],a[1],a[2])-aiVector3D(b[0],b[1],b[2])).Length();
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Layout of the interleaved vertices the subdivider works on. Only the
+ *  components present in at least one of the input meshes are stored, so
+ *  meshes with positions only don't pay for all the other channels. */
+// ------------------------------------------------------------------------------------------------
+struct VertexLayout
+{
+    VertexLayout(const aiMesh* const* smesh, size_t nmesh)
+        : size(3)
+        , normals(-1)
+        , tangents(-1)
+    {
+        bool hasNormals = false, hasTangents = false;
+        unsigned int numUV = 0, numColors = 0;
+        for (size_t t = 0; t < nmesh; ++t) {
+            const aiMesh* mesh = smesh[t];
+            hasNormals = hasNormals || mesh->HasNormals();
+            hasTangents = hasTangents || mesh->HasTangentsAndBitangents();
+
+            for (unsigned int i = 0; mesh->HasTextureCoords(i); ++i) {
+                numUV = std::max(numUV,i+1);
+            }
+            for (unsigned int i = 0; mesh->HasVertexColors(i); ++i) {
+                numColors = std::max(numColors,i+1);
+            }
+        }
+
+        if (hasNormals) {
+            normals = size;
+            size += 3;
+        }
+        if (hasTangents) {
+            // bitangents follow the tangents
+            tangents = size;
+            size += 6;
+        }
+        for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+            texcoords[i] = i < numUV ? static_cast<int>(size) : -1;
+            size += i < numUV ? 3 : 0;
+        }
+        for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_COLOR_SETS; ++i) {
+            colors[i] = i < numColors ? static_cast<int>(size) : -1;
+            size += i < numColors ? 4 : 0;
+        }
+    }
+
+    // --------------------------------------------------------------------------------------------
+    /** Extract a vertex from a mesh. Components the mesh doesn't have are zeroed. */
+    void Load(const aiMesh* mesh, unsigned int idx, ai_real* out) const
+    {
+        std::fill(out,out+size,static_cast<ai_real>(0.));
+        Load(mesh->mVertices[idx],out);
+
+        if (mesh->HasNormals()) {
+            Load(mesh->mNormals[idx],out+normals);
+        }
+        if (mesh->HasTangentsAndBitangents()) {
+            Load(mesh->mTangents[idx],out+tangents);
+            Load(mesh->mBitangents[idx],out+tangents+3);
+        }
+        for (unsigned int i = 0; mesh->HasTextureCoords(i); ++i) {
+            Load(mesh->mTextureCoords[i][idx],out+texcoords[i]);
+        }
+        for (unsigned int i = 0; mesh->HasVertexColors(i); ++i) {
+            const aiColor4D& c = mesh->mColors[i][idx];
+            ai_real* const o = out+colors[i];
+            o[0] = c.r; o[1] = c.g; o[2] = c.b; o[3] = c.a;
+        }
+    }
+
+    // --------------------------------------------------------------------------------------------
+    /** Write a vertex back to all components present in a mesh */
+    void Store(const ai_real* in, aiMesh* mesh, unsigned int idx) const
+    {
+        ai_assert(idx < mesh->mNumVertices);
+        Store(in,mesh->mVertices[idx]);
+
+        if (mesh->HasNormals()) {
+            Store(in+normals,mesh->mNormals[idx]);
+        }
+        if (mesh->HasTangentsAndBitangents()) {
+            Store(in+tangents,mesh->mTangents[idx]);
+            Store(in+tangents+3,mesh->mBitangents[idx]);
+        }
+        for (unsigned int i = 0; mesh->HasTextureCoords(i); ++i) {
+            Store(in+texcoords[i],mesh->mTextureCoords[i][idx]);
+        }
+        for (unsigned int i = 0; mesh->HasVertexColors(i); ++i) {
+            const ai_real* const c = in+colors[i];
+            mesh->mColors[i][idx] = aiColor4D(c[0],c[1],c[2],c[3]);
+        }
+    }
+
+    //! Number of components per vertex
+    unsigned int size;
+
+    //! Offsets of the components, -1 if not present
+    int normals, tangents;
+    int texcoords[AI_MAX_NUMBER_OF_TEXTURECOORDS];
+    int colors[AI_MAX_NUMBER_OF_COLOR_SETS];
+
+private:
+
+    static void Load(const aiVector3D& v, ai_real* out) {
+        out[0] = v.x; out[1] = v.y; out[2] = v.z;
+    }
+
+    static void Store(const ai_real* in, aiVector3D& v) {
+        v.x = in[0]; v.y = in[1]; v.z = in[2];
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+/** Polygon soup of one refinement level in half-edge form. The corners of face
+ *  f are [faceStart[f],faceStart[f+1]), corner c is the half edge running from
+ *  vertex cornerVert[c] to the vertex at the next corner of the same face. */
+// ------------------------------------------------------------------------------------------------
+struct Level
+{
+    //! First corner of each face, plus the end of the last face
+    UIntVector faceStart;
+
+    //! Vertex index per corner
+    UIntVector cornerVert;
+
+    //! Distinct point per vertex. Only needed for the input level, where
+    //! several vertices may share a position. Empty if all points are distinct.
+    UIntVector pointOf;
+
+    //! Number of distinct points
+    unsigned int numPoints;
+
+    //! Interleaved vertex components, see #VertexLayout
+    std::vector<ai_real> verts;
+
+    //! First face of each input mesh, plus the end of the last mesh
+    UIntVector meshStart;
+
+    unsigned int PointOf(unsigned int vert) const {
+        return pointOf.empty() ? vert : pointOf[vert];
+    }
+
+    unsigned int NextCorner(unsigned int face, unsigned int corner) const {
+        return corner+1 == faceStart[face+1] ? faceStart[face] : corner+1;
+    }
+
+    unsigned int PrevCorner(unsigned int face, unsigned int corner) const {
+        return corner == faceStart[face] ? faceStart[face+1]-1 : corner-1;
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+/** Open addressing hash table mapping edges to edge indices. The key is built
+ *  from both distinct point indices of the edge, the smaller one first, so it
+ *  is unique and both half edges of an edge map to the same key. */
+// ------------------------------------------------------------------------------------------------
+class EdgeHash
+{
+public:
+
+    explicit EdgeHash(size_t maxEdges)
+    {
+        // keep the load factor below 0.5
+        size_t capacity = 16;
+        while (capacity < maxEdges*2) {
+            capacity <<= 1;
+        }
+        mKeys.resize(capacity,Empty());
+        mValues.resize(capacity);
+        mMask = capacity-1;
+    }
+
+    static uint64_t MakeKey(unsigned int p0, unsigned int p1) {
+        if (p0 > p1) {
+            std::swap(p0,p1);
+        }
+        return (static_cast<uint64_t>(p0) << 32u) | p1;
+    }
+
+    // Returns the value stored for key, or stores and returns value if the
+    // key is not yet present.
+    unsigned int Insert(uint64_t key, unsigned int value) {
+        for (size_t i = Hash(key); ; i = (i+1) & mMask) {
+            if (mKeys[i] == key) {
+                return mValues[i];
+            }
+            if (mKeys[i] == Empty()) {
+                mKeys[i] = key;
+                mValues[i] = value;
+                return value;
+            }
+        }
+    }
+
+private:
+
+    size_t Hash(uint64_t key) const {
+        // Fibonacci hashing to spread neighbouring point indices
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32u) & mMask;
+    }
+
+    // point indices are always smaller than 0xffffffff
+    static uint64_t Empty() {
+        return ~static_cast<uint64_t>(0);
+    }
+
+    std::vector<uint64_t> mKeys;
+    UIntVector mValues;
+    size_t mMask;
+};
+
+// ------------------------------------------------------------------------------------------------
+/** Intermediate description of an edge between two corners of a polygon*/
+// ------------------------------------------------------------------------------------------------
+struct Edge
+{
+    Edge(unsigned int c, unsigned int f)
+        : ref(0)
+        , corner(c)
+        , face0(f)
+        , face1(f)
+    {}
+
+    //! Number of half edges referencing the edge
+    unsigned int ref;
+
+    //! Half edge the edge was found at first
+    unsigned int corner;
+
+    //! First two faces referencing the edge
+    unsigned int face0, face1;
+};
+
+} // ! anon namespace
 
 // ------------------------------------------------------------------------------------------------
 /** Subdivider stub class to implement the Catmull-Clarke subdivision algorithm. The
@@ -62,43 +342,11 @@ public:
     void Subdivide (aiMesh** smesh, size_t nmesh,
         aiMesh** out, unsigned int num, bool discard_input);
 
-    // ---------------------------------------------------------------------------
-    /** Intermediate description of an edge between two corners of a polygon*/
-    // ---------------------------------------------------------------------------
-    struct Edge
-    {
-        Edge()
-            : ref(0)
-        {}
-        Vertex edge_point, midpoint;
-        unsigned int ref;
-    };
-
-    typedef std::vector<unsigned int> UIntVector;
-    typedef std::map<uint64_t,Edge> EdgeMap;
-
-    // ---------------------------------------------------------------------------
-    // Hashing function to derive an index into an #EdgeMap from two given
-    // 'unsigned int' vertex coordinates (!!distinct coordinates - same
-    // vertex position == same index!!).
-    // NOTE - this leads to rare hash collisions if a) sizeof(unsigned int)>4
-    // and (id[0]>2^32-1 or id[0]>2^32-1).
-    // MAKE_EDGE_HASH() uses temporaries, so INIT_EDGE_HASH() needs to be put
-    // at the head of every function which is about to use MAKE_EDGE_HASH().
-    // Reason is that the hash is that hash construction needs to hold the
-    // invariant id0<id1 to identify an edge - else two hashes would refer
-    // to the same edge.
-    // ---------------------------------------------------------------------------
-#define MAKE_EDGE_HASH(id0,id1) (eh_tmp0__=id0,eh_tmp1__=id1,\
-    (eh_tmp0__<eh_tmp1__?std::swap(eh_tmp0__,eh_tmp1__):mydummy()),(uint64_t)eh_tmp0__^((uint64_t)eh_tmp1__<<32u))
-
-
-#define INIT_EDGE_HASH_TEMPORARIES()\
-    unsigned int eh_tmp0__, eh_tmp1__;
-
 private:
     void InternSubdivide (const aiMesh* const * smesh,
         size_t nmesh,aiMesh** out, unsigned int num);
+
+    ai_real RefineLevel(const Level& in, unsigned int stride, Level& out);
 };
 
 
@@ -214,15 +462,13 @@ void CatmullClarkSubdivider::Subdivide (
 }
 
 // ------------------------------------------------------------------------------------------------
-// Note - this is an implementation of the standard (recursive) Cm-Cl algorithm without further
-// optimizations (except we're using some nice LUTs). A description of the algorithm can be found
-// here: http://en.wikipedia.org/wiki/Catmull-Clark_subdivision_surface
+// Note - this is an implementation of the standard (recursive) Cm-Cl algorithm. A description
+// of the algorithm can be found here: http://en.wikipedia.org/wiki/Catmull-Clark_subdivision_surface
 //
-// The code is mostly O(n), however parts are O(nlogn) which is therefore the algorithm's
-// expected total runtime complexity. The implementation is able to work in-place on the same
-// mesh arrays. Calling #InternSubdivide() directly is not encouraged. The code can operate
-// in-place unless 'smesh' and 'out' are equal (no strange overlaps or reorderings).
-// Previous data is replaced/deleted then.
+// The input meshes are welded once and converted to a compact half-edge representation, all
+// refinement steps operate on that representation and only the final level is written back
+// to verbose output meshes. Apart from the initial welding, which is O(nlogn), the code is
+// O(n). Calling #InternSubdivide() directly is not encouraged.
 // ------------------------------------------------------------------------------------------------
 void CatmullClarkSubdivider::InternSubdivide (
     const aiMesh* const * smesh,
@@ -232,109 +478,186 @@ void CatmullClarkSubdivider::InternSubdivide (
     )
 {
     ai_assert(NULL != smesh && NULL != out);
-    INIT_EDGE_HASH_TEMPORARIES();
 
-    // no subdivision requested or end of recursive refinement
+    // no subdivision requested
     if (!num) {
         return;
     }
 
-    UIntVector maptbl;
-    SpatialSort spatial;
+    const VertexLayout layout(smesh,nmesh);
+    const unsigned int stride = layout.size;
 
     // ---------------------------------------------------------------------
     // 0. Offset table to index all meshes continuously, generate a spatially
-    // sorted representation of all vertices in all meshes.
+    // sorted representation of all vertices in all meshes to find the
+    // distinct points of the input meshes.
     // ---------------------------------------------------------------------
-    typedef std::pair<unsigned int,unsigned int> IntPair;
-    std::vector<IntPair> moffsets(nmesh);
-    unsigned int totfaces = 0, totvert = 0;
+    Level level;
+    level.meshStart.resize(nmesh+1);
+
+    UIntVector vertStart(nmesh+1);
+    SpatialSort spatial;
+    unsigned int totfaces = 0, totvert = 0, totcorners = 0;
     for (size_t t = 0; t < nmesh; ++t) {
         const aiMesh* mesh = smesh[t];
 
         spatial.Append(mesh->mVertices,mesh->mNumVertices,sizeof(aiVector3D),false);
-        moffsets[t] = IntPair(totfaces,totvert);
+        level.meshStart[t] = totfaces;
+        vertStart[t] = totvert;
 
+        for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+            totcorners += mesh->mFaces[i].mNumIndices;
+        }
         totfaces += mesh->mNumFaces;
         totvert  += mesh->mNumVertices;
     }
+    level.meshStart[nmesh] = totfaces;
+    vertStart[nmesh] = totvert;
 
     spatial.Finalize();
-    const unsigned int num_unique = spatial.GenerateMappingTable(maptbl,ComputePositionEpsilon(smesh,nmesh));
-
+    level.numPoints = spatial.GenerateMappingTable(level.pointOf,ComputePositionEpsilon(smesh,nmesh));
 
-#define FLATTEN_VERTEX_IDX(mesh_idx, vert_idx) (moffsets[mesh_idx].second+vert_idx)
-#define   FLATTEN_FACE_IDX(mesh_idx, face_idx) (moffsets[mesh_idx].first+face_idx)
-
-    // ---------------------------------------------------------------------
-    // 1. Compute the centroid point for all faces
-    // ---------------------------------------------------------------------
-    std::vector<Vertex> centroids(totfaces);
-    unsigned int nfacesout = 0;
-    for (size_t t = 0, n = 0; t < nmesh; ++t) {
+    level.faceStart.resize(totfaces+1);
+    level.cornerVert.resize(totcorners);
+    level.verts.resize(static_cast<size_t>(totvert)*stride);
+    for (size_t t = 0, f = 0, c = 0; t < nmesh; ++t) {
         const aiMesh* mesh = smesh[t];
-        for (unsigned int i = 0; i < mesh->mNumFaces;++i,++n)
-        {
+        for (unsigned int i = 0; i < mesh->mNumFaces; ++i, ++f) {
             const aiFace& face = mesh->mFaces[i];
-            Vertex& c = centroids[n];
+            level.faceStart[f] = static_cast<unsigned int>(c);
 
-            for (unsigned int a = 0; a < face.mNumIndices;++a) {
-                c += Vertex(mesh,face.mIndices[a]);
+            for (unsigned int a = 0; a < face.mNumIndices; ++a) {
+                level.cornerVert[c++] = vertStart[t]+face.mIndices[a];
             }
-
-            c /= static_cast<float>(face.mNumIndices);
-            nfacesout += face.mNumIndices;
         }
+
+        ForEachBlock(mesh->mNumVertices,[&](unsigned int begin, unsigned int end) {
+            for (unsigned int v = begin; v < end; ++v) {
+                layout.Load(mesh,v,&level.verts[static_cast<size_t>(vertStart[t]+v)*stride]);
+            }
+        });
     }
+    level.faceStart[totfaces] = totcorners;
 
-    {
-    // we want edges to go away before the recursive calls so begin a new scope
-    EdgeMap edges;
+    // ---------------------------------------------------------------------
+    // 1. Refine. In adaptive mode, stop as soon as the last step did not move
+    // the surface farther than the error bound. Further steps would move it
+    // even less.
+    // ---------------------------------------------------------------------
+    for (unsigned int i = 0; i < num; ++i) {
+        Level next;
+        const ai_real error = RefineLevel(level,stride,next);
+        std::swap(level,next);
+
+        if (mMaxError > 0 && error <= mMaxError && i+1 < num) {
+            char tmp[256];
+            ai_snprintf(tmp, 256, "Catmull-Clark Subdivider: error bound reached after %u of %u subdivisions",
+                i+1,num);
+
+            DefaultLogger::get()->debug(tmp);
+            break;
+        }
+    }
 
     // ---------------------------------------------------------------------
-    // 2. Set each edge point to be the average of all neighbouring
-    // face points and original points. Every edge exists twice
-    // if there is a neighboring face.
+    // 2. Write the quads of the final level to the output meshes, keeping
+    // the vertex components and the material index of each input mesh.
     // ---------------------------------------------------------------------
     for (size_t t = 0; t < nmesh; ++t) {
-        const aiMesh* mesh = smesh[t];
+        const aiMesh* const minp = smesh[t];
+        aiMesh* const mout = out[t] = new aiMesh();
 
-        for (unsigned int i = 0; i < mesh->mNumFaces;++i)   {
-            const aiFace& face = mesh->mFaces[i];
+        const unsigned int firstFace = level.meshStart[t];
+        const unsigned int firstCorner = level.faceStart[firstFace];
+
+        mout->mNumFaces = level.meshStart[t+1]-firstFace;
+        mout->mFaces = new aiFace[mout->mNumFaces];
 
-            for (unsigned int p =0; p< face.mNumIndices; ++p) {
-                const unsigned int id[] = {
-                    face.mIndices[p],
-                    face.mIndices[p==face.mNumIndices-1?0:p+1]
-                };
-                const unsigned int mp[] = {
-                    maptbl[FLATTEN_VERTEX_IDX(t,id[0])],
-                    maptbl[FLATTEN_VERTEX_IDX(t,id[1])]
-                };
-
-                Edge& e = edges[MAKE_EDGE_HASH(mp[0],mp[1])];
-                e.ref++;
-                if (e.ref<=2) {
-                    if (e.ref==1) { // original points (end points) - add only once
-                        e.edge_point = e.midpoint = Vertex(mesh,id[0])+Vertex(mesh,id[1]);
-                        e.midpoint *= 0.5f;
-                    }
-                    e.edge_point += centroids[FLATTEN_FACE_IDX(t,i)];
+        mout->mNumVertices = level.faceStart[level.meshStart[t+1]]-firstCorner;
+        mout->mVertices = new aiVector3D[mout->mNumVertices];
+
+        // quads only, keep material index
+        mout->mPrimitiveTypes = aiPrimitiveType_POLYGON;
+        mout->mMaterialIndex = minp->mMaterialIndex;
+
+        if (minp->HasNormals()) {
+            mout->mNormals = new aiVector3D[mout->mNumVertices];
+        }
+
+        if (minp->HasTangentsAndBitangents()) {
+            mout->mTangents = new aiVector3D[mout->mNumVertices];
+            mout->mBitangents = new aiVector3D[mout->mNumVertices];
+        }
+
+        for(unsigned int i = 0; minp->HasTextureCoords(i); ++i) {
+            mout->mTextureCoords[i] = new aiVector3D[mout->mNumVertices];
+            mout->mNumUVComponents[i] = minp->mNumUVComponents[i];
+        }
+
+        for(unsigned int i = 0; minp->HasVertexColors(i); ++i) {
+            mout->mColors[i] = new aiColor4D[mout->mNumVertices];
+        }
+
+        ForEachBlock(mout->mNumFaces,[&](unsigned int begin, unsigned int end) {
+            for (unsigned int i = begin; i < end; ++i) {
+                const unsigned int f = firstFace+i;
+                aiFace& faceOut = mout->mFaces[i];
+                faceOut.mNumIndices = level.faceStart[f+1]-level.faceStart[f];
+                faceOut.mIndices = new unsigned int[faceOut.mNumIndices];
+
+                for (unsigned int c = level.faceStart[f], a = 0; a < faceOut.mNumIndices; ++c, ++a) {
+                    const unsigned int v = faceOut.mIndices[a] = c-firstCorner;
+                    layout.Store(&level.verts[static_cast<size_t>(level.cornerVert[c])*stride],mout,v);
                 }
             }
-        }
+        });
     }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Perform one subdivision step. Returns the largest distance a point of the surface was moved
+// by the step, if adaptive subdivision is enabled, 0 otherwise.
+// ------------------------------------------------------------------------------------------------
+ai_real CatmullClarkSubdivider::RefineLevel(const Level& in, unsigned int stride, Level& out)
+{
+    const unsigned int numFaces   = static_cast<unsigned int>(in.faceStart.size()-1);
+    const unsigned int numCorners = static_cast<unsigned int>(in.cornerVert.size());
+    const unsigned int numPoints  = in.numPoints;
 
     // ---------------------------------------------------------------------
-    // 3. Normalize edge points
+    // 1. Assign an edge to each half edge. Every edge exists twice if
+    // there is a neighboring face. Edges are numbered in the order they are
+    // first encountered, so the result does not depend on the hashing.
     // ---------------------------------------------------------------------
+    UIntVector edgeOf(numCorners), cornerFace(numCorners);
+    std::vector<Edge> edges;
+    edges.reserve(numCorners/2+1);
+    {
+        EdgeHash hash(numCorners);
+        for (unsigned int f = 0; f < numFaces; ++f) {
+            for (unsigned int c = in.faceStart[f]; c < in.faceStart[f+1]; ++c) {
+                const unsigned int id = hash.Insert(EdgeHash::MakeKey(in.PointOf(in.cornerVert[c]),
+                    in.PointOf(in.cornerVert[in.NextCorner(f,c)])),static_cast<unsigned int>(edges.size()));
+
+                if (id == edges.size()) {
+                    edges.push_back(Edge(c,f));
+                }
+                Edge& e = edges[id];
+                if (e.ref++ == 1) {
+                    e.face1 = f;
+                }
+                edgeOf[c] = id;
+                cornerFace[c] = f;
+            }
+        }
+    }
+    const unsigned int numEdges = static_cast<unsigned int>(edges.size());
+
     {unsigned int bad_cnt = 0;
-    for (EdgeMap::iterator it = edges.begin(); it != edges.end(); ++it) {
-        if ((*it).second.ref < 2) {
-            ai_assert((*it).second.ref);
+    for (std::vector<Edge>::const_iterator it = edges.begin(); it != edges.end(); ++it) {
+        if ((*it).ref < 2) {
             ++bad_cnt;
         }
-        (*it).second.edge_point *= 1.f/((*it).second.ref+2.f);
     }
 
     if (bad_cnt) {
@@ -343,248 +666,164 @@ void CatmullClarkSubdivider::InternSubdivide (
         // shapes.
         char tmp[512];
         ai_snprintf(tmp, 512, "Catmull-Clark Subdivider: got %u bad edges touching only one face (totally %u edges). ",
-            bad_cnt,static_cast<unsigned int>(edges.size()));
+            bad_cnt,numEdges);
 
         DefaultLogger::get()->debug(tmp);
     }}
 
+    // The points of the next level are stored in this order: vertex points
+    // (one per distinct point of this level), edge points, face points.
+    const unsigned int edgeBase = numPoints, faceBase = numPoints+numEdges;
+    out.numPoints = faceBase+numFaces;
+    out.verts.resize(static_cast<size_t>(out.numPoints)*stride);
+
+    const ai_real* const inVerts = in.verts.data();
+    ai_real* const outVerts = out.verts.data();
+
     // ---------------------------------------------------------------------
-    // 4. Compute a vertex-face adjacency table. We can't reuse the code
-    // from VertexTriangleAdjacency because we need the table for multiple
-    // meshes and out vertex indices need to be mapped to distinct values
-    // first.
+    // 2. Compute the centroid point for all faces
     // ---------------------------------------------------------------------
-    UIntVector faceadjac(nfacesout), cntadjfac(maptbl.size(),0), ofsadjvec(maptbl.size()+1,0); {
-    for (size_t t = 0; t < nmesh; ++t) {
-        const aiMesh* const minp = smesh[t];
-        for (unsigned int i = 0; i < minp->mNumFaces; ++i) {
-
-            const aiFace& f = minp->mFaces[i];
-            for (unsigned int n = 0; n < f.mNumIndices; ++n) {
-                ++cntadjfac[maptbl[FLATTEN_VERTEX_IDX(t,f.mIndices[n])]];
+    ForEachBlock(numFaces,[&](unsigned int begin, unsigned int end) {
+        for (unsigned int f = begin; f < end; ++f) {
+            ai_real* const fp = outVerts+static_cast<size_t>(faceBase+f)*stride;
+            for (unsigned int c = in.faceStart[f]; c < in.faceStart[f+1]; ++c) {
+                Accumulate(fp,inVerts+static_cast<size_t>(in.cornerVert[c])*stride,stride);
             }
+            Scale(fp,static_cast<ai_real>(1.)/(in.faceStart[f+1]-in.faceStart[f]),stride);
         }
-    }
-    unsigned int cur = 0;
-    for (size_t i = 0; i < cntadjfac.size(); ++i) {
-        ofsadjvec[i+1] = cur;
-        cur += cntadjfac[i];
-    }
-    for (size_t t = 0; t < nmesh; ++t) {
-        const aiMesh* const minp = smesh[t];
-        for (unsigned int i = 0; i < minp->mNumFaces; ++i) {
+    });
 
-            const aiFace& f = minp->mFaces[i];
-            for (unsigned int n = 0; n < f.mNumIndices; ++n) {
-                faceadjac[ofsadjvec[1+maptbl[FLATTEN_VERTEX_IDX(t,f.mIndices[n])]]++] = FLATTEN_FACE_IDX(t,i);
+    // ---------------------------------------------------------------------
+    // 3. Set each edge point to be the average of the two neighbouring
+    // face points and original points.
+    // ---------------------------------------------------------------------
+    std::vector<ai_real> midpoints(static_cast<size_t>(numEdges)*stride);
+    ForEachBlock(numEdges,[&](unsigned int begin, unsigned int end) {
+        for (unsigned int i = begin; i < end; ++i) {
+            const Edge& e = edges[i];
+            const ai_real* const v0 = inVerts+static_cast<size_t>(in.cornerVert[e.corner])*stride;
+            const ai_real* const v1 = inVerts+static_cast<size_t>(in.cornerVert[in.NextCorner(e.face0,e.corner)])*stride;
+
+            ai_real* const mp = &midpoints[static_cast<size_t>(i)*stride];
+            ai_real* const ep = outVerts+static_cast<size_t>(edgeBase+i)*stride;
+            for (unsigned int k = 0; k < stride; ++k) {
+                mp[k] = v0[k]+v1[k];
             }
-        }
-    }
 
-    // check the other way round for consistency
-#ifdef ASSIMP_BUILD_DEBUG
-
-    for (size_t t = 0; t < ofsadjvec.size()-1; ++t) {
-        for (unsigned int m = 0; m <  cntadjfac[t]; ++m) {
-            const unsigned int fidx = faceadjac[ofsadjvec[t]+m];
-            ai_assert(fidx < totfaces);
-            for (size_t n = 1; n < nmesh; ++n) {
-
-                if (moffsets[n].first > fidx) {
-                    const aiMesh* msh = smesh[--n];
-                    const aiFace& f = msh->mFaces[fidx-moffsets[n].first];
-
-                    bool haveit = false;
-                    for (unsigned int i = 0; i < f.mNumIndices; ++i) {
-                        if (maptbl[FLATTEN_VERTEX_IDX(n,f.mIndices[i])]==(unsigned int)t) {
-                            haveit = true;
-                            break;
-                        }
-                    }
-                    ai_assert(haveit);
-                    if (!haveit) {
-                        DefaultLogger::get()->debug("Catmull-Clark Subdivider: Index not used");
-                    }
-                    break;
-                }
+            Copy(ep,mp,stride);
+            Accumulate(ep,outVerts+static_cast<size_t>(faceBase+e.face0)*stride,stride);
+            if (e.ref >= 2) {
+                Accumulate(ep,outVerts+static_cast<size_t>(faceBase+e.face1)*stride,stride);
             }
+            Scale(ep,static_cast<ai_real>(1.)/(e.ref+2),stride);
+            Scale(mp,static_cast<ai_real>(0.5),stride);
         }
-    }
+    });
 
-#endif
+    // ---------------------------------------------------------------------
+    // 4. Compute a point-corner adjacency table. We can't reuse the code
+    // from VertexTriangleAdjacency because we need the table for polygons
+    // and for distinct points rather than vertices.
+    // ---------------------------------------------------------------------
+    UIntVector cornerStart(numPoints+1,0), pointCorners(numCorners);
+    for (unsigned int c = 0; c < numCorners; ++c) {
+        ++cornerStart[in.PointOf(in.cornerVert[c])+1];
     }
+    for (unsigned int p = 0; p < numPoints; ++p) {
+        cornerStart[p+1] += cornerStart[p];
+    }
+    {UIntVector cur(cornerStart.begin(),cornerStart.end()-1);
+    for (unsigned int c = 0; c < numCorners; ++c) {
+        pointCorners[cur[in.PointOf(in.cornerVert[c])]++] = c;
+    }}
 
-#define GET_ADJACENT_FACES_AND_CNT(vidx,fstartout,numout) \
-    fstartout = &faceadjac[ofsadjvec[vidx]], numout = cntadjfac[vidx]
-
-    typedef std::pair<bool,Vertex> TouchedOVertex;
-    std::vector<TouchedOVertex > new_points(num_unique,TouchedOVertex(false,Vertex()));
     // ---------------------------------------------------------------------
-    // 5. Spawn a quad from each face point to the corresponding edge points
-    // the original points being the fourth quad points.
+    // 5. Move the original points. For an original point P referenced by
+    // n corners:
+    // F := sum of the centroids of the faces of the corners
+    // R := sum of the midpoints of both edges of the corners
+    //
+    // (F+R+(n-3)P)/n. In a closed shape every edge is added twice to R, so
+    // the factor 2 of the original formula is left out.
     // ---------------------------------------------------------------------
-    for (size_t t = 0; t < nmesh; ++t) {
-        const aiMesh* const minp = smesh[t];
-        aiMesh* const mout = out[t] = new aiMesh();
-
-        for (unsigned int a  = 0; a < minp->mNumFaces; ++a) {
-            mout->mNumFaces += minp->mFaces[a].mNumIndices;
-        }
-
-        // We need random access to the old face buffer, so reuse is not possible.
-        mout->mFaces = new aiFace[mout->mNumFaces];
-
-        mout->mNumVertices = mout->mNumFaces*4;
-        mout->mVertices = new aiVector3D[mout->mNumVertices];
-
-        // quads only, keep material index
-        mout->mPrimitiveTypes = aiPrimitiveType_POLYGON;
-        mout->mMaterialIndex = minp->mMaterialIndex;
-
-        if (minp->HasNormals()) {
-            mout->mNormals = new aiVector3D[mout->mNumVertices];
-        }
+    const bool measure = mMaxError > 0;
+    std::vector<ai_real> moved(measure ? numPoints : 0);
+    ForEachBlock(numPoints,[&](unsigned int begin, unsigned int end) {
+        std::vector<ai_real> F(stride), R(stride);
+        for (unsigned int p = begin; p < end; ++p) {
+            const unsigned int first = cornerStart[p], cnt = cornerStart[p+1]-first;
+            ai_real* const vp = outVerts+static_cast<size_t>(p)*stride;
+            if (!cnt) {
+                // vertex not referenced by any face
+                continue;
+            }
 
-        if (minp->HasTangentsAndBitangents()) {
-            mout->mTangents = new aiVector3D[mout->mNumVertices];
-            mout->mBitangents = new aiVector3D[mout->mNumVertices];
-        }
+            const ai_real* const P = inVerts+static_cast<size_t>(in.cornerVert[pointCorners[first]])*stride;
+            if (cnt < 3) {
+                Copy(vp,P,stride);
+                continue;
+            }
 
-        for(unsigned int i = 0; minp->HasTextureCoords(i); ++i) {
-            mout->mTextureCoords[i] = new aiVector3D[mout->mNumVertices];
-            mout->mNumUVComponents[i] = minp->mNumUVComponents[i];
-        }
+            std::fill(F.begin(),F.end(),static_cast<ai_real>(0.));
+            std::fill(R.begin(),R.end(),static_cast<ai_real>(0.));
+            for (unsigned int o = first; o < first+cnt; ++o) {
+                const unsigned int c = pointCorners[o], f = cornerFace[c];
+                Accumulate(F.data(),outVerts+static_cast<size_t>(faceBase+f)*stride,stride);
+                Accumulate(R.data(),&midpoints[static_cast<size_t>(edgeOf[c])*stride],stride);
+                Accumulate(R.data(),&midpoints[static_cast<size_t>(edgeOf[in.PrevCorner(f,c)])*stride],stride);
+            }
 
-        for(unsigned int i = 0; minp->HasVertexColors(i); ++i) {
-            mout->mColors[i] = new aiColor4D[mout->mNumVertices];
+            const ai_real div = static_cast<ai_real>(cnt), divsq = static_cast<ai_real>(1.)/(div*div);
+            for (unsigned int k = 0; k < stride; ++k) {
+                vp[k] = P[k]*((div-3)/div) + (R[k]+F[k])*divsq;
+            }
+            if (measure) {
+                moved[p] = Distance(vp,P);
+            }
         }
+    });
 
-        mout->mNumVertices = mout->mNumFaces<<2u;
-        for (unsigned int i = 0, v = 0, n = 0; i < minp->mNumFaces;++i) {
-
-            const aiFace& face = minp->mFaces[i];
-            for (unsigned int a = 0; a < face.mNumIndices;++a)  {
-
-                // Get a clean new face.
-                aiFace& faceOut = mout->mFaces[n++];
-                faceOut.mIndices = new unsigned int [faceOut.mNumIndices = 4];
-
-                // Spawn a new quadrilateral (ccw winding) for this original point between:
-                // a) face centroid
-                centroids[FLATTEN_FACE_IDX(t,i)].SortBack(mout,faceOut.mIndices[0]=v++);
-
-                // b) adjacent edge on the left, seen from the centroid
-                const Edge& e0 = edges[MAKE_EDGE_HASH(maptbl[FLATTEN_VERTEX_IDX(t,face.mIndices[a])],
-                    maptbl[FLATTEN_VERTEX_IDX(t,face.mIndices[a==face.mNumIndices-1?0:a+1])
-                    ])];  // fixme: replace with mod face.mNumIndices?
-
-                // c) adjacent edge on the right, seen from the centroid
-                const Edge& e1 = edges[MAKE_EDGE_HASH(maptbl[FLATTEN_VERTEX_IDX(t,face.mIndices[a])],
-                    maptbl[FLATTEN_VERTEX_IDX(t,face.mIndices[!a?face.mNumIndices-1:a-1])
-                    ])];  // fixme: replace with mod face.mNumIndices?
-
-                e0.edge_point.SortBack(mout,faceOut.mIndices[3]=v++);
-                e1.edge_point.SortBack(mout,faceOut.mIndices[1]=v++);
-
-                // d= original point P with distinct index i
-                // F := 0
-                // R := 0
-                // n := 0
-                // for each face f containing i
-                //    F := F+ centroid of f
-                //    R := R+ midpoint of edge of f from i to i+1
-                //    n := n+1
-                //
-                // (F+2R+(n-3)P)/n
-                const unsigned int org = maptbl[FLATTEN_VERTEX_IDX(t,face.mIndices[a])];
-                TouchedOVertex& ov = new_points[org];
-
-                if (!ov.first) {
-                    ov.first = true;
-
-                    const unsigned int* adj; unsigned int cnt;
-                    GET_ADJACENT_FACES_AND_CNT(org,adj,cnt);
-
-                    if (cnt < 3) {
-                        ov.second = Vertex(minp,face.mIndices[a]);
-                    }
-                    else {
-
-                        Vertex F,R;
-                        for (unsigned int o = 0; o < cnt; ++o) {
-                            ai_assert(adj[o] < totfaces);
-                            F += centroids[adj[o]];
-
-                            // adj[0] is a global face index - search the face in the mesh list
-                            const aiMesh* mp = NULL;
-                            size_t nidx;
-
-                            if (adj[o] < moffsets[0].first) {
-                                mp = smesh[nidx=0];
-                            }
-                            else {
-                                for (nidx = 1; nidx<= nmesh; ++nidx) {
-                                    if (nidx == nmesh ||moffsets[nidx].first > adj[o]) {
-                                        mp = smesh[--nidx];
-                                        break;
-                                    }
-                                }
-                            }
-
-                            ai_assert(adj[o]-moffsets[nidx].first < mp->mNumFaces);
-                            const aiFace& f = mp->mFaces[adj[o]-moffsets[nidx].first];
-                            bool haveit = false;
-
-                            // find our original point in the face
-                            for (unsigned int m = 0; m < f.mNumIndices; ++m) {
-                                if (maptbl[FLATTEN_VERTEX_IDX(nidx,f.mIndices[m])] == org) {
-
-                                    // add *both* edges. this way, we can be sure that we add
-                                    // *all* adjacent edges to R. In a closed shape, every
-                                    // edge is added twice - so we simply leave out the
-                                    // factor 2.f in the amove formula and get the right
-                                    // result.
-
-                                    const Edge& c0 = edges[MAKE_EDGE_HASH(org,maptbl[FLATTEN_VERTEX_IDX(
-                                        nidx,f.mIndices[!m?f.mNumIndices-1:m-1])])];
-                                    // fixme: replace with mod face.mNumIndices?
-
-                                    const Edge& c1 = edges[MAKE_EDGE_HASH(org,maptbl[FLATTEN_VERTEX_IDX(
-                                        nidx,f.mIndices[m==f.mNumIndices-1?0:m+1])])];
-                                    // fixme: replace with mod face.mNumIndices?
-                                    R += c0.midpoint+c1.midpoint;
-
-                                    haveit = true;
-                                    break;
-                                }
-                            }
-
-                            // this invariant *must* hold if the vertex-to-face adjacency table is valid
-                            ai_assert(haveit);
-                            if ( !haveit ) {
-                                DefaultLogger::get()->warn( "OBJ: no name for material library specified." );
-                            }
-                        }
-
-                        const float div = static_cast<float>(cnt), divsq = 1.f/(div*div);
-                        ov.second = Vertex(minp,face.mIndices[a])*((div-3.f) / div) + R*divsq + F*divsq;
-                    }
-                }
-                ov.second.SortBack(mout,faceOut.mIndices[2]=v++);
+    // ---------------------------------------------------------------------
+    // 6. Spawn a quad from each face point to the corresponding edge points
+    // the original points being the fourth quad points. Quad q of the next
+    // level belongs to corner q of this level.
+    // ---------------------------------------------------------------------
+    out.pointOf.clear();
+    out.faceStart.resize(numCorners+1);
+    out.cornerVert.resize(static_cast<size_t>(numCorners)*4);
+    ForEachBlock(numFaces,[&](unsigned int begin, unsigned int end) {
+        for (unsigned int f = begin; f < end; ++f) {
+            for (unsigned int c = in.faceStart[f]; c < in.faceStart[f+1]; ++c) {
+                unsigned int* const quad = &out.cornerVert[static_cast<size_t>(c)*4];
+                out.faceStart[c] = c*4;
+
+                // ccw winding: face centroid, adjacent edge on the right, seen from
+                // the centroid, original point, adjacent edge on the left.
+                quad[0] = faceBase+f;
+                quad[1] = edgeBase+edgeOf[in.PrevCorner(f,c)];
+                quad[2] = in.PointOf(in.cornerVert[c]);
+                quad[3] = edgeBase+edgeOf[c];
             }
         }
+    });
+    out.faceStart[numCorners] = numCorners*4;
+
+    out.meshStart.resize(in.meshStart.size());
+    for (size_t t = 0; t < in.meshStart.size(); ++t) {
+        out.meshStart[t] = in.faceStart[in.meshStart[t]];
     }
-    }  // end of scope for edges, freeing its memory
 
     // ---------------------------------------------------------------------
-    // 7. Apply the next subdivision step.
+    // 7. Estimate the error of this level: how far did the step move the
+    // original points and the edge midpoints?
     // ---------------------------------------------------------------------
-    if (num != 1) {
-        std::vector<aiMesh*> tmp(nmesh);
-        InternSubdivide (out,nmesh,&tmp.front(),num-1);
-        for (size_t i = 0; i < nmesh; ++i) {
-            delete out[i];
-            out[i] = tmp[i];
+    ai_real error = 0;
+    if (measure) {
+        error = moved.empty() ? error : *std::max_element(moved.begin(),moved.end());
+        for (unsigned int i = 0; i < numEdges; ++i) {
+            error = std::max(error,Distance(outVerts+static_cast<size_t>(edgeBase+i)*stride,
+                &midpoints[static_cast<size_t>(i)*stride]));
         }
     }
+    return error;
 }
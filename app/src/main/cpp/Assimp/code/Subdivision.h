@@ -63,6 +63,7 @@ public:
         CATMULL_CLARKE = 0x1
     };
 
+    Subdivider();
     virtual ~Subdivider();
 
     // ---------------------------------------------------------------
@@ -116,8 +117,33 @@ public:
         unsigned int num,
         bool discard_input = false) = 0;
 
+    // ---------------------------------------------------------------
+    /** Enable adaptive subdivision.
+     *
+     *  If a positive error bound is set, refinement stops before the
+     *  requested number of subdivisions is reached as soon as the last
+     *  subdivision step moved no point of the surface farther than
+     *  @c maxError. As the surface is smoothed as a whole, flat or
+     *  little curved objects thus end up with fewer faces than highly
+     *  curved ones. At least one subdivision is always performed.
+     *
+     *  @param maxError Maximum geometric error, in object space.
+     *    Pass 0 (the default) to always perform all subdivisions. */
+    void SetMaxError(ai_real maxError) {
+        mMaxError = maxError;
+    }
+
+protected:
+
+    ai_real mMaxError;
 };
 
+inline
+Subdivider::Subdivider()
+: mMaxError(0) {
+    // empty
+}
+
 inline
 Subdivider::~Subdivider() {
     // empty
@@ -0,0 +1,256 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2017, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+
+/** @file  TextCursor.h
+ *  @brief Line and token scanning over the text buffer of an importer.
+ *
+ *  The text importers read the whole file into a zero-terminated buffer
+ *  (BaseImporter::TextFileToBuffer). TextCursor walks the lines of such a
+ *  buffer in place instead of copying each of them, and the free functions
+ *  below search eight characters at a time.
+ */
+#ifndef AI_TEXTCURSOR_H_INC
+#define AI_TEXTCURSOR_H_INC
+
+#include "ParsingUtils.h"
+#include "fast_atof.h"
+#include <assimp/ai_assert.h>
+
+#include <cstring>
+#include <stdint.h>
+
+namespace Assimp {
+
+// ------------------------------------------------------------------------------------------------
+/** @brief Returns a non-zero value if any of the eight characters packed into
+ *  word equals c. */
+AI_FORCE_INLINE uint64_t HasChar(uint64_t word, char c)
+{
+    static const uint64_t Ones = 0x0101010101010101ULL, Highs = 0x8080808080808080ULL;
+    const uint64_t x = word ^ (Ones * static_cast<unsigned char>(c));
+    return (x - Ones) & ~x & Highs;
+}
+
+// ------------------------------------------------------------------------------------------------
+/** @brief Returns the first character in [begin,end) which is one of the
+ *  numChars characters at chars, or end.
+ *
+ *  The text is searched eight characters at a time, so this pays off for
+ *  long runs of characters which aren't in the set. */
+AI_FORCE_INLINE const char* FindFirstOf(const char* begin, const char* end,
+    const char* chars, unsigned int numChars)
+{
+    const char* it = begin;
+    for ( ; end - it >= 8; it += 8) {
+        uint64_t word;
+        ::memcpy(&word, it, 8);
+        uint64_t found = 0;
+        for (unsigned int i = 0; i < numChars; ++i) {
+            found |= HasChar(word, chars[i]);
+        }
+        if (found) {
+            break;
+        }
+    }
+    for ( ; it != end; ++it) {
+        for (unsigned int i = 0; i < numChars; ++i) {
+            if (*it == chars[i]) {
+                return it;
+            }
+        }
+    }
+    return end;
+}
+
+// ------------------------------------------------------------------------------------------------
+/** @brief Returns the first line end (see IsLineEnd()) in [begin,end), or end. */
+inline const char* FindLineEnd(const char* begin, const char* end)
+{
+    return FindFirstOf(begin, end, "\0\r\n\f", 4);
+}
+
+template <class T>
+inline const T* FindLineEnd(const T* begin, const T* end)
+{
+    while (begin != end && !IsLineEnd(*begin)) {
+        ++begin;
+    }
+    return begin;
+}
+
+// ------------------------------------------------------------------------------------------------
+/** @brief Walks the lines of a zero-terminated text buffer in place.
+ *
+ *  NextLine() follows the rules of GetNextLine(): reading stops at the first
+ *  binary zero and all line ends behind a line are skipped, so only the first
+ *  line of the buffer can be empty. Instead of copying the line, its line end
+ *  is temporarily replaced with a binary zero, so the current line can still
+ *  be handled as a C string. The character is restored as soon as the cursor
+ *  moves on or is destroyed, hence the buffer must be writable and must not be
+ *  modified by others while the cursor is in use.
+ */
+class TextCursor
+{
+public:
+    // --------------------------------------------------------------------------------------------
+    /** @param begin Start of the text
+     *  @param end Terminating zero of the text */
+    TextCursor(char* begin, char* end)
+        : mPos(begin)
+        , mEnd(end)
+        , mLine(begin)
+        , mLineEnd(NULL)
+        , mSaved('\0')
+    {
+        ai_assert(NULL != begin && begin <= end && '\0' == *end);
+    }
+
+    ~TextCursor()
+    {
+        Restore();
+    }
+
+    // --------------------------------------------------------------------------------------------
+    /** @brief Moves to the next line.
+     *  @return false if the end of the text has been reached. The current
+     *    line stays valid then. */
+    bool NextLine()
+    {
+        if ('\0' == *mPos) {
+            return false;
+        }
+        Restore();
+        mLine = mPos;
+        mLineEnd = const_cast<char*>(FindLineEnd(mPos, mEnd));
+        for (mPos = mLineEnd; IsLineEnd(*mPos) && '\0' != *mPos; ++mPos);
+
+        mSaved = *mLineEnd;
+        *mLineEnd = '\0';
+        return true;
+    }
+
+    // --------------------------------------------------------------------------------------------
+    /** @brief Moves to the next line and returns it in line, see NextLine() */
+    bool NextLine(const char*& line)
+    {
+        if (!NextLine()) {
+            return false;
+        }
+        line = mLine;
+        return true;
+    }
+
+    // --------------------------------------------------------------------------------------------
+    /** @brief Current line, terminated by a binary zero */
+    const char* GetLine() const {
+        return mLine;
+    }
+
+    /** @brief Terminating zero of the current line */
+    const char* GetLineEnd() const {
+        return mLineEnd;
+    }
+
+    // --------------------------------------------------------------------------------------------
+    /** @brief Start of the line NextLine() moves to. Can be passed to
+     *  SetPosition() to read the following lines again. */
+    const char* GetPosition() const {
+        return mPos;
+    }
+
+    void SetPosition(const char* pos)
+    {
+        ai_assert(NULL != pos && pos <= mEnd);
+        Restore();
+        mPos = const_cast<char*>(pos);
+    }
+
+    // --------------------------------------------------------------------------------------------
+    /** @brief Parses n reals at in, which points into the current line.
+     *
+     *  Each number must be preceded by spaces or tabs only and must be
+     *  followed by a space, a tab or the end of the line.
+     *  @return true if all n numbers were read. In is moved behind the last
+     *    of them then, otherwise in is left untouched so callers can fall back
+     *    to more forgiving parsing. */
+    template <typename Real>
+    bool ReadReals(const char*& in, Real* out, unsigned int n) const
+    {
+        const char* pos;
+        if (fast_atoreal_n<Real>(in, mLineEnd, out, n, &pos) != n) {
+            return false;
+        }
+        in = pos;
+        return true;
+    }
+
+    // --------------------------------------------------------------------------------------------
+    /** @brief Parses n unsigned integers at in, see ReadReals() */
+    bool ReadUInts(const char*& in, unsigned int* out, unsigned int n) const
+    {
+        const char* pos;
+        if (strtoul10_n(in, mLineEnd, out, n, &pos) != n) {
+            return false;
+        }
+        in = pos;
+        return true;
+    }
+
+private:
+    void Restore()
+    {
+        if (mLineEnd) {
+            *mLineEnd = mSaved;
+            mLineEnd = NULL;
+        }
+    }
+
+    char* mPos;
+    char* const mEnd;
+    char* mLine;
+    char* mLineEnd;
+    char mSaved;
+};
+
+} // end of namespace Assimp
+
+#endif // !! AI_TEXTCURSOR_H_INC
@@ -0,0 +1,537 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2017, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file TextureAtlasProcess.cpp
+ *  @brief Implementation of the TextureAtlasProcess post processing step
+ */
+
+#ifndef ASSIMP_BUILD_NO_TEXTUREATLAS_PROCESS
+
+#include "TextureAtlasProcess.h"
+#include "StringUtils.h"
+#include "fast_atof.h"
+#include <assimp/postprocess.h>
+#include <assimp/DefaultLogger.hpp>
+#include <assimp/material.h>
+#include <assimp/scene.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace Assimp;
+
+namespace {
+
+const unsigned int NotSet = 0xffffffff;
+
+// texture coordinates may exceed [0,1] by this much and still be packed
+const ai_real UVEpsilon = ai_real(1e-4);
+
+// ------------------------------------------------------------------------------------------------
+// A texture to be placed in an atlas, sizes and position include the padding
+struct Rect
+{
+    unsigned int mTexture;
+    unsigned int mWidth, mHeight;
+    unsigned int mX, mY;
+    bool mPlaced;
+};
+
+// ------------------------------------------------------------------------------------------------
+// Get the index of the embedded texture a "$tex.file" property refers to
+bool GetEmbeddedIndex(const aiMaterialProperty* prop, unsigned int& out)
+{
+    if (prop->mType != aiPTI_String || prop->mDataLength < 6 || ::strcmp(prop->mKey.data,_AI_MATKEY_TEXTURE_BASE)) {
+        return false;
+    }
+    // the string is stored as a 32 bit length followed by the characters
+    const char* s = prop->mData + 4;
+    if (s[0] != '*' || s[1] < '0' || s[1] > '9') {
+        return false;
+    }
+    const char* end;
+    out = strtoul10(s + 1,&end);
+    return *end == '\0';
+}
+
+// ------------------------------------------------------------------------------------------------
+// Build a key which is equal for all materials which differ only by their diffuse texture
+std::string GetGroupKey(const aiMaterial* mat, const aiTexture* tex)
+{
+    std::vector<const aiMaterialProperty*> props;
+    props.reserve(mat->mNumProperties);
+    for (unsigned int i = 0; i < mat->mNumProperties; ++i) {
+        const aiMaterialProperty* prop = mat->mProperties[i];
+
+        // names and other '?' properties are not part of the appearance
+        if (prop->mKey.data[0] == '?' || (prop->mSemantic == aiTextureType_DIFFUSE && !prop->mIndex &&
+            !::strcmp(prop->mKey.data,_AI_MATKEY_TEXTURE_BASE))) {
+            continue;
+        }
+        props.push_back(prop);
+    }
+
+    // the order of the properties depends on the loader, sort them
+    std::sort(props.begin(),props.end(),[](const aiMaterialProperty* a, const aiMaterialProperty* b) {
+        const int c = ::strcmp(a->mKey.data,b->mKey.data);
+        if (c) {
+            return c < 0;
+        }
+        return a->mSemantic != b->mSemantic ? a->mSemantic < b->mSemantic : a->mIndex < b->mIndex;
+    });
+
+    std::string key(tex->achFormatHint);
+    for (const aiMaterialProperty* prop : props) {
+        const unsigned int head[] = { prop->mSemantic, prop->mIndex, prop->mType, prop->mDataLength };
+        key.append(prop->mKey.data,prop->mKey.length + 1);
+        key.append(reinterpret_cast<const char*>(head),sizeof(head));
+        key.append(prop->mData,prop->mDataLength);
+    }
+    return key;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Place the rectangles, sorted by decreasing height, on shelves of the given width.
+// Rectangles which would exceed the maximum height are skipped. Returns the height used.
+unsigned int PackShelves(std::vector<Rect>& rects, unsigned int width, unsigned int maxHeight)
+{
+    unsigned int x = 0, y = 0, shelf = 0;
+    for (Rect& r : rects) {
+        r.mPlaced = false;
+        if (r.mWidth > width) {
+            continue;
+        }
+        if (x + r.mWidth > width) {
+            y += shelf;
+            x = shelf = 0;
+        }
+        if (y + r.mHeight > maxHeight) {
+            continue;
+        }
+        r.mX = x;
+        r.mY = y;
+        r.mPlaced = true;
+        x += r.mWidth;
+        shelf = std::max(shelf,r.mHeight);
+    }
+    return y + shelf;
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned int NextPowerOfTwo(unsigned int n)
+{
+    unsigned int p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Find the smallest power of two atlas for the rectangles. If they do not fit into the maximum
+// size, as many as possible are placed in an atlas of maximum size.
+void PackAtlas(std::vector<Rect>& rects, unsigned int maxSize, unsigned int& outWidth,
+    unsigned int& outHeight)
+{
+    std::sort(rects.begin(),rects.end(),[](const Rect& a, const Rect& b) {
+        return a.mHeight != b.mHeight ? a.mHeight > b.mHeight : a.mWidth > b.mWidth;
+    });
+
+    unsigned int maxWidth = 0;
+    double area = 0.;
+    for (const Rect& r : rects) {
+        maxWidth = std::max(maxWidth,r.mWidth);
+        area += double(r.mWidth) * r.mHeight;
+    }
+
+    unsigned int bestWidth = 0, bestHeight = 0;
+    for (unsigned int w = NextPowerOfTwo(std::max(maxWidth,static_cast<unsigned int>(sqrt(area)))); w <= maxSize; w <<= 1) {
+        const unsigned int h = NextPowerOfTwo(PackShelves(rects,w,NotSet));
+        if (h <= maxSize && (!bestWidth || double(w) * h < double(bestWidth) * bestHeight)) {
+            bestWidth = w;
+            bestHeight = h;
+        }
+    }
+
+    if (bestWidth) {
+        PackShelves(rects,bestWidth,bestHeight);
+        outWidth = bestWidth;
+        outHeight = bestHeight;
+        return;
+    }
+    outWidth = maxSize;
+    outHeight = NextPowerOfTwo(PackShelves(rects,maxSize,maxSize));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Copy the placed textures into a new atlas texture. The padding repeats the border texels.
+aiTexture* BuildAtlas(const aiScene* pScene, const std::vector<Rect>& rects, unsigned int width,
+    unsigned int height, unsigned int padding)
+{
+    aiTexture* atlas = new aiTexture();
+    atlas->mWidth = width;
+    atlas->mHeight = height;
+    atlas->pcData = new aiTexel[width * height];
+    ::memset(atlas->pcData,0,width * height * sizeof(aiTexel));
+
+    for (const Rect& r : rects) {
+        if (!r.mPlaced) {
+            continue;
+        }
+        const aiTexture* tex = pScene->mTextures[r.mTexture];
+        if (!atlas->achFormatHint[0]) {
+            ::memcpy(atlas->achFormatHint,tex->achFormatHint,sizeof(atlas->achFormatHint));
+        }
+
+        for (unsigned int y = 0; y < r.mHeight; ++y) {
+            const unsigned int sy = std::min(tex->mHeight - 1,y < padding ? 0 : y - padding);
+            const aiTexel* src = tex->pcData + sy * tex->mWidth;
+            aiTexel* dst = atlas->pcData + (r.mY + y) * width + r.mX;
+            for (unsigned int x = 0; x < r.mWidth; ++x) {
+                dst[x] = src[std::min(tex->mWidth - 1,x < padding ? 0 : x - padding)];
+            }
+        }
+    }
+    return atlas;
+}
+
+} // end of anonymous namespace
+
+// ------------------------------------------------------------------------------------------------
+// Constructor to be privately used by Importer
+TextureAtlasProcess::TextureAtlasProcess()
+: mMaxSize(AI_TA_DEFAULT_MAX_SIZE)
+, mPadding(AI_TA_DEFAULT_PADDING)
+{
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+// Destructor, private as well
+TextureAtlasProcess::~TextureAtlasProcess()
+{
+    // nothing to do here
+}
+
+// ------------------------------------------------------------------------------------------------
+// Returns whether the processing step is present in the given flag field.
+bool TextureAtlasProcess::IsActive( unsigned int pFlags) const
+{
+    return (pFlags & aiProcess_GenTextureAtlas) != 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Setup configuration properties for the step
+void TextureAtlasProcess::SetupProperties(const Importer* pImp)
+{
+    mMaxSize = std::max(1,pImp->GetPropertyInteger(AI_CONFIG_PP_TA_MAX_SIZE,AI_TA_DEFAULT_MAX_SIZE));
+    mPadding = std::max(0,pImp->GetPropertyInteger(AI_CONFIG_PP_TA_PADDING,AI_TA_DEFAULT_PADDING));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Checks whether a material can be merged into an atlas
+bool TextureAtlasProcess::IsMergeable( const aiScene* pScene, unsigned int pIndex,
+    unsigned int& pTexture) const
+{
+    const aiMaterial* mat = pScene->mMaterials[pIndex];
+
+    // the diffuse texture must be the only one, others would be sampled with the remapped UVs
+    bool found = false;
+    for (unsigned int i = 0; i < mat->mNumProperties; ++i) {
+        const aiMaterialProperty* prop = mat->mProperties[i];
+        if (::strcmp(prop->mKey.data,_AI_MATKEY_TEXTURE_BASE)) {
+            continue;
+        }
+        if (found || prop->mSemantic != aiTextureType_DIFFUSE || prop->mIndex ||
+            !GetEmbeddedIndex(prop,pTexture)) {
+            return false;
+        }
+        found = true;
+    }
+    if (!found || pTexture >= pScene->mNumTextures) {
+        return false;
+    }
+
+    // compressed textures would have to be decoded first
+    const aiTexture* tex = pScene->mTextures[pTexture];
+    if (!tex->mHeight || !tex->pcData || tex->mWidth + 2 * mPadding > mMaxSize ||
+        tex->mHeight + 2 * mPadding > mMaxSize) {
+        return false;
+    }
+
+    // the texture must be mapped with plain UV coordinates from the first channel
+    int value;
+    if (AI_SUCCESS == mat->Get(_AI_MATKEY_UVWSRC_BASE,aiTextureType_DIFFUSE,0,value) && value) {
+        return false;
+    }
+    if (AI_SUCCESS == mat->Get(_AI_MATKEY_MAPPING_BASE,aiTextureType_DIFFUSE,0,value) &&
+        value != aiTextureMapping_UV) {
+        return false;
+    }
+    aiUVTransform trafo;
+    return AI_SUCCESS != mat->Get(_AI_MATKEY_UVTRANSFORM_BASE,aiTextureType_DIFFUSE,0,trafo);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on the given imported data.
+void TextureAtlasProcess::Execute( aiScene* pScene)
+{
+    DefaultLogger::get()->debug("TextureAtlasProcess begin");
+
+    // find the materials whose meshes can be remapped
+    std::vector<bool> usable(pScene->mNumMaterials,true), used(pScene->mNumMaterials,false);
+    for (unsigned int a = 0; a < pScene->mNumMeshes; ++a) {
+        const aiMesh* mesh = pScene->mMeshes[a];
+        const unsigned int mat = mesh->mMaterialIndex;
+        if (mat >= pScene->mNumMaterials) {
+            continue;
+        }
+        used[mat] = true;
+        if (!usable[mat]) {
+            continue;
+        }
+        if (!IsMeshDirty(a) || !mesh->HasTextureCoords(0) || mesh->mNumUVComponents[0] < 2) {
+            usable[mat] = false;
+            continue;
+        }
+        for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+            const aiVector3D& uv = mesh->mTextureCoords[0][i];
+            if (uv.x < -UVEpsilon || uv.x > 1 + UVEpsilon || uv.y < -UVEpsilon || uv.y > 1 + UVEpsilon) {
+                usable[mat] = false;
+                break;
+            }
+        }
+    }
+
+    // group the materials which differ only by their diffuse texture
+    std::vector<unsigned int> textureOf(pScene->mNumMaterials,NotSet);
+    std::map<std::string, std::vector<unsigned int> > groups;
+    for (unsigned int i = 0; i < pScene->mNumMaterials; ++i) {
+        unsigned int tex;
+        if (used[i] && usable[i] && IsMergeable(pScene,i,tex)) {
+            textureOf[i] = tex;
+            groups[GetGroupKey(pScene->mMaterials[i],pScene->mTextures[tex])].push_back(i);
+        }
+    }
+
+    // pack the textures of each group, possibly into several atlases
+    std::vector<unsigned int> atlasOf(pScene->mNumMaterials,NotSet);
+    std::vector<aiTexture*> atlases;
+    std::vector<aiMaterial*> atlasMaterials;
+    std::vector<bool> packed(pScene->mNumTextures,false);
+    unsigned int numMerged = 0;
+
+    for (std::map<std::string, std::vector<unsigned int> >::const_iterator it = groups.begin(); it != groups.end(); ++it) {
+        const std::vector<unsigned int>& mats = it->second;
+
+        std::vector<Rect> rects;
+        for (unsigned int m : mats) {
+            const unsigned int tex = textureOf[m];
+            bool dup = false;
+            for (const Rect& r : rects) {
+                dup = dup || r.mTexture == tex;
+            }
+            if (!dup) {
+                const Rect r = { tex, pScene->mTextures[tex]->mWidth + 2 * mPadding,
+                    pScene->mTextures[tex]->mHeight + 2 * mPadding, 0, 0, false };
+                rects.push_back(r);
+            }
+        }
+
+        while (rects.size() >= 2) {
+            unsigned int width, height;
+            PackAtlas(rects,mMaxSize,width,height);
+
+            std::vector<Rect> placed, rest;
+            for (const Rect& r : rects) {
+                (r.mPlaced ? placed : rest).push_back(r);
+            }
+            if (placed.size() < 2) {
+                break;
+            }
+
+            const unsigned int atlasIndex = static_cast<unsigned int>(atlases.size());
+            const unsigned int texIndex = pScene->mNumTextures + atlasIndex;
+            atlases.push_back(BuildAtlas(pScene,placed,width,height,mPadding));
+
+            for (unsigned int m : mats) {
+                const Rect* r = NULL;
+                for (const Rect& p : placed) {
+                    r = p.mTexture == textureOf[m] ? &p : r;
+                }
+                if (!r) {
+                    continue;
+                }
+                atlasOf[m] = atlasIndex;
+                ++numMerged;
+
+                // the atlas material is a copy of the first merged material
+                if (atlasMaterials.size() == atlasIndex) {
+                    aiMaterial* mat = new aiMaterial();
+                    aiMaterial::CopyPropertyList(mat,pScene->mMaterials[m]);
+
+                    char buffer[32];
+                    aiString s;
+                    ai_snprintf(buffer,32,"*%u",texIndex);
+                    s.Set(buffer);
+                    mat->AddProperty(&s,AI_MATKEY_TEXTURE_DIFFUSE(0));
+                    ai_snprintf(buffer,32,"Atlas_%u",atlasIndex);
+                    s.Set(buffer);
+                    mat->AddProperty(&s,AI_MATKEY_NAME);
+                    atlasMaterials.push_back(mat);
+                }
+
+                // move the texture coordinates to the area of the texture in the atlas
+                const aiTexture* tex = pScene->mTextures[r->mTexture];
+                const ai_real x = ai_real(r->mX + mPadding), y = ai_real(r->mY + mPadding);
+                for (unsigned int a = 0; a < pScene->mNumMeshes; ++a) {
+                    aiMesh* mesh = pScene->mMeshes[a];
+                    if (mesh->mMaterialIndex != m) {
+                        continue;
+                    }
+                    for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+                        aiVector3D& uv = mesh->mTextureCoords[0][i];
+                        const ai_real u = std::min(ai_real(1),std::max(ai_real(0),uv.x));
+                        const ai_real v = std::min(ai_real(1),std::max(ai_real(0),uv.y));
+                        uv.x = (x + u * tex->mWidth) / width;
+                        uv.y = 1 - (y + (1 - v) * tex->mHeight) / height;
+                    }
+                }
+                packed[r->mTexture] = true;
+            }
+            rects.swap(rest);
+        }
+    }
+
+    if (!atlases.empty()) {
+        // replace the merged materials by their atlas material
+        std::vector<unsigned int> materialMap(pScene->mNumMaterials);
+        std::vector<unsigned int> atlasMaterialIndex(atlasMaterials.size(),NotSet);
+        aiMaterial** materials = new aiMaterial*[pScene->mNumMaterials];
+        unsigned int numMaterials = 0;
+        for (unsigned int i = 0; i < pScene->mNumMaterials; ++i) {
+            if (atlasOf[i] == NotSet) {
+                materialMap[i] = numMaterials;
+                materials[numMaterials++] = pScene->mMaterials[i];
+                continue;
+            }
+            unsigned int& idx = atlasMaterialIndex[atlasOf[i]];
+            if (idx == NotSet) {
+                idx = numMaterials;
+                materials[numMaterials++] = atlasMaterials[atlasOf[i]];
+            }
+            materialMap[i] = idx;
+            delete pScene->mMaterials[i];
+        }
+        delete[] pScene->mMaterials;
+        pScene->mMaterials = materials;
+        pScene->mNumMaterials = numMaterials;
+
+        for (unsigned int a = 0; a < pScene->mNumMeshes; ++a) {
+            aiMesh* mesh = pScene->mMeshes[a];
+            if (mesh->mMaterialIndex < materialMap.size()) {
+                mesh->mMaterialIndex = materialMap[mesh->mMaterialIndex];
+            }
+        }
+
+        // append the atlases, then drop the packed textures nobody refers to any longer
+        const unsigned int numTextures = pScene->mNumTextures + static_cast<unsigned int>(atlases.size());
+        std::vector<bool> referenced(numTextures,false);
+        for (unsigned int i = 0; i < pScene->mNumMaterials; ++i) {
+            const aiMaterial* mat = pScene->mMaterials[i];
+            for (unsigned int p = 0; p < mat->mNumProperties; ++p) {
+                unsigned int tex;
+                if (GetEmbeddedIndex(mat->mProperties[p],tex) && tex < numTextures) {
+                    referenced[tex] = true;
+                }
+            }
+        }
+
+        std::vector<unsigned int> textureMap(numTextures);
+        aiTexture** textures = new aiTexture*[numTextures];
+        unsigned int numOut = 0;
+        for (unsigned int i = 0; i < numTextures; ++i) {
+            aiTexture* tex = i < pScene->mNumTextures ? pScene->mTextures[i] : atlases[i - pScene->mNumTextures];
+            if (i < pScene->mNumTextures && packed[i] && !referenced[i]) {
+                textureMap[i] = NotSet;
+                delete tex;
+                continue;
+            }
+            textureMap[i] = numOut;
+            textures[numOut++] = tex;
+        }
+        delete[] pScene->mTextures;
+        pScene->mTextures = textures;
+        pScene->mNumTextures = numOut;
+
+        // update the references to embedded textures
+        for (unsigned int i = 0; i < pScene->mNumMaterials; ++i) {
+            aiMaterial* mat = pScene->mMaterials[i];
+            for (unsigned int p = 0; p < mat->mNumProperties; ++p) {
+                const aiMaterialProperty* prop = mat->mProperties[p];
+                unsigned int tex;
+                if (!GetEmbeddedIndex(prop,tex) || tex >= numTextures || textureMap[tex] == tex) {
+                    continue;
+                }
+                char buffer[32];
+                ai_snprintf(buffer,32,"*%u",textureMap[tex]);
+                aiString s;
+                s.Set(buffer);
+                // replaces the property in place, the key is not taken from prop as it is deleted
+                mat->AddProperty(&s,_AI_MATKEY_TEXTURE_BASE,prop->mSemantic,prop->mIndex);
+            }
+        }
+    }
+
+    if (!DefaultLogger::isNullLogger()) {
+        char buffer[1024];
+        ai_snprintf(buffer,1024,"TextureAtlasProcess finished. Merged %u materials into %u atlases",
+            numMerged,static_cast<unsigned int>(atlases.size()));
+        DefaultLogger::get()->info(buffer);
+    }
+}
+
+#endif // !! ASSIMP_BUILD_NO_TEXTUREATLAS_PROCESS
@@ -0,0 +1,125 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2017, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+
+/** @file TextureAtlasProcess.h
+ *  @brief Defines a post processing step to merge materials into texture atlases.
+ */
+#ifndef AI_TEXTUREATLASPROCESS_H_INC
+#define AI_TEXTUREATLASPROCESS_H_INC
+
+#include "BaseProcess.h"
+
+namespace Assimp
+{
+
+// default value for AI_CONFIG_PP_TA_MAX_SIZE
+#if (!defined AI_TA_DEFAULT_MAX_SIZE)
+#   define AI_TA_DEFAULT_MAX_SIZE 4096
+#endif
+
+// default value for AI_CONFIG_PP_TA_PADDING
+#if (!defined AI_TA_DEFAULT_PADDING)
+#   define AI_TA_DEFAULT_PADDING 2
+#endif
+
+// ---------------------------------------------------------------------------
+/** The TextureAtlasProcess merges materials which differ only in their
+ *  diffuse texture. The textures are packed into an atlas which replaces
+ *  them, and the texture coordinates of the affected meshes are remapped
+ *  to the area of the atlas their texture was copied to.
+ *
+ *  Only embedded, uncompressed textures can be packed. Row 0 of a texture
+ *  is assumed to be at v = 1, which is the convention of the loaders.
+ */
+class ASSIMP_API TextureAtlasProcess : public BaseProcess
+{
+public:
+
+    TextureAtlasProcess();
+    ~TextureAtlasProcess();
+
+public:
+    // -------------------------------------------------------------------
+    /** Returns whether the processing step is present in the given flag.
+    * @param pFlags The processing flags the importer was called with.
+    *   A bitwise combination of #aiPostProcessSteps.
+    * @return true if the process is present in this flag fields,
+    *   false if not.
+    */
+    bool IsActive( unsigned int pFlags) const;
+
+    // -------------------------------------------------------------------
+    /** Called prior to ExecuteOnScene().
+    * The function is a request to the process to update its configuration
+    * basing on the Importer's configuration property list.
+    */
+    void SetupProperties(const Importer* pImp);
+
+    // -------------------------------------------------------------------
+    /** Executes the post processing step on the given imported data.
+    * At the moment a process is not supposed to fail.
+    * @param pScene The imported data to work at.
+    */
+    void Execute( aiScene* pScene);
+
+private:
+    // -------------------------------------------------------------------
+    /** Checks whether a material can be merged into an atlas.
+    * @param pScene The scene the material belongs to.
+    * @param pIndex Index of the material.
+    * @param[out] pTexture Receives the index of the embedded diffuse
+    *   texture of the material.
+    * @return true if the material can be merged.
+    */
+    bool IsMergeable( const aiScene* pScene, unsigned int pIndex,
+        unsigned int& pTexture) const;
+
+    /** Maximum width and height of an atlas */
+    unsigned int mMaxSize;
+
+    /** Pixels around each texture filled with its border pixels */
+    unsigned int mPadding;
+};
+
+} // end of namespace Assimp
+
+#endif // AI_TEXTUREATLASPROCESS_H_INC
@@ -49,6 +49,15 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *  Self-intersecting or non-planar polygons are not rejected, but
  *  they're probably not triangulated correctly.
  *
+ *  Convex polygons are fanned directly. Concave polygons are ear-cut,
+ *  where only the vertices which are not strictly convex or share their
+ *  position with another vertex need to be tested against each ear
+ *  candidate. Large polygons with many of them keep them in a uniform
+ *  grid. This is close to linear for the polygons of typical CAD exports,
+ *  but there's no O(n log n) bound: the worst case of the ear cutter is
+ *  still O(n^2). Meshes are triangulated concurrently, the output of each
+ *  mesh does not depend on the number of threads.
+ *
  * DEBUG SWITCHES - do not enable any of them in release builds:
  *
  * AI_BUILD_TRIANGULATE_COLOR_FACE_WINDING
@@ -62,7 +71,13 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "TriangulateProcess.h"
 #include "ProcessHelper.h"
 #include "PolyTools.h"
+#include "ParallelHelper.h"
 #include <memory>
+#include <algorithm>
+#include <cmath>
+
+/** Polygons with more vertices which can be contained in an ear put them into a grid */
+#define AI_TRIANGULATE_GRID_THRESHOLD 32
 
 //#define AI_BUILD_TRIANGULATE_COLOR_FACE_WINDING
 //#define AI_BUILD_TRIANGULATE_DEBUG_POLYS
@@ -74,6 +89,24 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 using namespace Assimp;
 
+// ------------------------------------------------------------------------------------------------
+// Cell coordinate of a value along one axis of the grid used by the ear cutter
+static inline int GridCoord(float v, float min, float scale, int size)
+{
+    const float f = (v - min) * scale;
+    if (!(f > 0.f)) {
+        return 0;
+    }
+    return f < size ? std::min(size-1,static_cast<int>(f)) : size-1;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Cell of a point in the grid used by the ear cutter
+static inline int GridCell(const aiVector2D& v, const aiVector2D& min, const aiVector2D& scale, int size)
+{
+    return GridCoord(v.y,min.y,scale.y,size) * size + GridCoord(v.x,min.x,scale.x,size);
+}
+
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 TriangulateProcess::TriangulateProcess()
@@ -101,13 +134,18 @@ void TriangulateProcess::Execute( aiScene* pScene)
 {
     DefaultLogger::get()->debug("TriangulateProcess begin");
 
-    bool bHas = false;
-    for( unsigned int a = 0; a < pScene->mNumMeshes; a++)
-    {
-        if ( TriangulateMesh( pScene->mMeshes[ a ] ) ) {
-            bHas = true;
-        }
-    }
+    // meshes are independent from each other, so they can be processed concurrently
+    std::vector<unsigned char> abHas(pScene->mNumMeshes,0);
+#ifdef AI_BUILD_TRIANGULATE_DEBUG_POLYS
+    const unsigned int maxThreads = 1; // all meshes write to the same debug file
+#else
+    const unsigned int maxThreads = 0;
+#endif
+    ParallelFor(pScene->mNumMeshes, [&](unsigned int a) {
+        abHas[a] = IsMeshDirty(a) && TriangulateMesh( pScene->mMeshes[ a ] ) ? 1 : 0;
+    }, maxThreads);
+
+    const bool bHas = std::find(abHas.begin(),abHas.end(),1) != abHas.end();
     if ( bHas ) {
         DefaultLogger::get()->info( "TriangulateProcess finished. All polygons have been triangulated." );
     } else {
@@ -194,6 +232,13 @@ bool TriangulateProcess::TriangulateMesh( aiMesh* pMesh)
 
     // use std::unique_ptr to avoid slow std::vector<bool> specialiations
     std::unique_ptr<bool[]> done(new bool[max_out]);
+
+    // scratch buffers for the ear cutter, reused for all faces of the mesh:
+    // the successor of each polygon vertex, the vertices which can be
+    // contained in an ear and the grid to look them up
+    std::vector<int> next_vertex(max_out), reflex, sorted, grid_start, grid_items;
+    reflex.reserve(max_out);
+    sorted.reserve(max_out);
     for( unsigned int a = 0; a < pMesh->mNumFaces; a++) {
         aiFace& face = pMesh->mFaces[a];
 
@@ -324,6 +369,65 @@ bool TriangulateProcess::TriangulateMesh( aiMesh* pMesh)
                 temp_verts[tmp].x = verts[idx[tmp]][ac];
                 temp_verts[tmp].y = verts[idx[tmp]][bc];
                 done[tmp] = false;
+                next_vertex[tmp] = tmp+1 < max ? tmp+1 : 0;
+            }
+
+            // Collect the vertices which can be contained in an ear: the reflex and collinear
+            // ones, and all vertices at a position used more than once, so the polygon may
+            // touch itself (concave_polygon.obj is a sample). Cutting ears only ever makes
+            // the remaining vertices 'more convex', so no other vertex needs to be added later on.
+            sorted.clear();
+            for (tmp = 0; tmp < max; ++tmp) {
+                sorted.push_back(tmp);
+            }
+            std::sort(sorted.begin(),sorted.end(),[&temp_verts](int i, int j) {
+                return temp_verts[i].x < temp_verts[j].x ||
+                    (temp_verts[i].x == temp_verts[j].x && temp_verts[i].y < temp_verts[j].y);
+            });
+            reflex.clear();
+            for (int i = 0; i < max; ++i) {
+                const aiVector2D& v = temp_verts[sorted[i]];
+                if ((i > 0 && temp_verts[sorted[i-1]] == v) || (i+1 < max && temp_verts[sorted[i+1]] == v)) {
+                    done[sorted[i]] = true; // marks the duplicates for the loop below
+                }
+            }
+            for (tmp = 0; tmp < max; ++tmp) {
+                if (done[tmp] || GetArea2D(temp_verts[tmp ? tmp-1 : max-1],temp_verts[tmp],temp_verts[next_vertex[tmp]]) >= 0) {
+                    reflex.push_back(tmp);
+                }
+                done[tmp] = false;
+            }
+
+            // Put them into a uniform grid with about one vertex per cell if there are
+            // many of them, the ear test only needs to look at the cells the ear covers.
+            int grid_size = 0;
+            aiVector2D grid_min, grid_scale;
+            if (reflex.size() > AI_TRIANGULATE_GRID_THRESHOLD) {
+                grid_size = static_cast<int>(std::sqrt(static_cast<double>(reflex.size())));
+                aiVector2D grid_max = grid_min = temp_verts[reflex[0]];
+                for (size_t r = 1; r < reflex.size(); ++r) {
+                    const aiVector2D& v = temp_verts[reflex[r]];
+                    grid_min.x = std::min(grid_min.x,v.x); grid_min.y = std::min(grid_min.y,v.y);
+                    grid_max.x = std::max(grid_max.x,v.x); grid_max.y = std::max(grid_max.y,v.y);
+                }
+                grid_scale.x = grid_max.x > grid_min.x ? grid_size / (grid_max.x - grid_min.x) : 0.f;
+                grid_scale.y = grid_max.y > grid_min.y ? grid_size / (grid_max.y - grid_min.y) : 0.f;
+
+                grid_start.assign(grid_size*grid_size+1,0);
+                grid_items.resize(reflex.size());
+                for (size_t r = 0; r < reflex.size(); ++r) {
+                    ++grid_start[GridCell(temp_verts[reflex[r]],grid_min,grid_scale,grid_size)+1];
+                }
+                for (int c = 0; c < grid_size*grid_size; ++c) {
+                    grid_start[c+1] += grid_start[c];
+                }
+                for (size_t r = 0; r < reflex.size(); ++r) {
+                    grid_items[grid_start[GridCell(temp_verts[reflex[r]],grid_min,grid_scale,grid_size)]++] = reflex[r];
+                }
+                for (int c = grid_size*grid_size; c > 0; --c) {
+                    grid_start[c] = grid_start[c-1];
+                }
+                grid_start[0] = 0;
             }
 
 #ifdef AI_BUILD_TRIANGULATE_DEBUG_POLYS
@@ -354,9 +458,25 @@ bool TriangulateProcess::TriangulateMesh( aiMesh* pMesh)
             fprintf(fout,"\ntriangulation sequence: ");
 #endif
 
-            //
-            // FIXME: currently this is the slow O(kn) variant with a worst case
-            // complexity of O(n^2) (I think). Can be done in O(n).
+            if (reflex.empty()) {
+                // Convex polygon, every vertex is an ear. Tri-fan it the same
+                // way the ear cutter below would do.
+                for (tmp = 0; tmp < max-3; ++tmp) {
+                    aiFace& nface = *curOut++;
+                    nface.mNumIndices = 3;
+                    if (!nface.mIndices) {
+                        nface.mIndices = new unsigned int[3];
+                    }
+                    nface.mIndices[0] = max-1;
+                    nface.mIndices[1] = tmp;
+                    nface.mIndices[2] = tmp+1;
+                    done[tmp] = true;
+                }
+                num = 3;
+            }
+
+            // Ear cutting, only the vertices collected above can be contained in an ear.
+            // The complexity is O(kn) for k such vertices, with a worst case of O(n^2).
             while (num > 3) {
 
                 // Find the next ear of the polygon
@@ -364,7 +484,7 @@ bool TriangulateProcess::TriangulateMesh( aiMesh* pMesh)
                 for (ear = next;;prev = ear,ear = next) {
 
                     // break after we looped two times without a positive match
-                    for (next=ear+1;done[(next>=max?next=0:next)];++next);
+                    next = next_vertex[ear];
                     if (next < ear) {
                         if (++num_found == 2) {
                             break;
@@ -380,21 +500,49 @@ bool TriangulateProcess::TriangulateMesh( aiMesh* pMesh)
                     }
 
                     // and no other point may be contained in this triangle
-                    for ( tmp = 0; tmp < max; ++tmp) {
-
-                        // We need to compare the actual values because it's possible that multiple indexes in
-                        // the polygon are referring to the same position. concave_polygon.obj is a sample
-                        //
-                        // FIXME: Use 'epsiloned' comparisons instead? Due to numeric inaccuracies in
-                        // PointInTriangle() I'm guessing that it's actually possible to construct
-                        // input data that would cause us to end up with no ears. The problem is,
-                        // which epsilon? If we chose a too large value, we'd get wrong results
-                        const aiVector2D& vtmp = temp_verts[tmp];
-                        if ( vtmp != *pnt1 && vtmp != *pnt2 && vtmp != *pnt0 && PointInTriangle2D(*pnt0,*pnt1,*pnt2,vtmp)) {
+                    const int* cand = reflex.data();
+                    int num_cand = static_cast<int>(reflex.size());
+                    int cell_x0 = 0, cell_x1 = 0, cell_y = 0, cell_y1 = 0;
+                    if (grid_size) {
+                        const aiVector2D lo(std::min(pnt0->x,std::min(pnt1->x,pnt2->x)),std::min(pnt0->y,std::min(pnt1->y,pnt2->y)));
+                        const aiVector2D hi(std::max(pnt0->x,std::max(pnt1->x,pnt2->x)),std::max(pnt0->y,std::max(pnt1->y,pnt2->y)));
+                        cell_x0 = GridCoord(lo.x,grid_min.x,grid_scale.x,grid_size);
+                        cell_x1 = GridCoord(hi.x,grid_min.x,grid_scale.x,grid_size);
+                        cell_y  = GridCoord(lo.y,grid_min.y,grid_scale.y,grid_size);
+                        cell_y1 = GridCoord(hi.y,grid_min.y,grid_scale.y,grid_size);
+                        num_cand = 0;
+                    }
+                    bool contained = false;
+                    for (;;) {
+                        for (int r = 0; r < num_cand; ++r) {
+                            tmp = cand[r];
+                            if (done[tmp]) {
+                                continue;
+                            }
+
+                            // We need to compare the actual values because it's possible that multiple indexes in
+                            // the polygon are referring to the same position. concave_polygon.obj is a sample
+                            //
+                            // FIXME: Use 'epsiloned' comparisons instead? Due to numeric inaccuracies in
+                            // PointInTriangle() I'm guessing that it's actually possible to construct
+                            // input data that would cause us to end up with no ears. The problem is,
+                            // which epsilon? If we chose a too large value, we'd get wrong results
+                            const aiVector2D& vtmp = temp_verts[tmp];
+                            if ( vtmp != *pnt1 && vtmp != *pnt2 && vtmp != *pnt0 && PointInTriangle2D(*pnt0,*pnt1,*pnt2,vtmp)) {
+                                contained = true;
+                                break;
+                            }
+                        }
+
+                        // next row of cells covered by the ear, if the grid is used
+                        if (contained || !grid_size || cell_y > cell_y1) {
                             break;
                         }
+                        const int row = cell_y++ * grid_size;
+                        cand = &grid_items[0] + grid_start[row + cell_x0];
+                        num_cand = grid_start[row + cell_x1 + 1] - grid_start[row + cell_x0];
                     }
-                    if (tmp != max) {
+                    if (contained) {
                         continue;
                     }
 
@@ -448,6 +596,7 @@ bool TriangulateProcess::TriangulateMesh( aiMesh* pMesh)
 
                 // exclude the ear from most further processing
                 done[ear] = true;
+                next_vertex[prev] = next;
                 --num;
             }
             if (num > 0) {
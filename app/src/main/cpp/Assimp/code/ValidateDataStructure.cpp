@@ -52,17 +52,95 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "BaseImporter.h"
 #include "fast_atof.h"
 #include "ProcessHelper.h"
+#include "ParallelHelper.h"
 #include <memory>
+#include <vector>
+
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+#   include <mutex>
+#endif
 
 // CRT headers
 #include <stdarg.h>
+#include <stdint.h>
 
 using namespace Assimp;
 
+// ------------------------------------------------------------------------------------------------
+// Bit sets are recycled, so a validation run allocates only as many of them as there are
+// meshes validated at the same time.
+struct ValidateDSProcess::Scratch
+{
+    std::vector< std::vector<uint32_t>* > mFreeBitSets;
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+    std::mutex mMutex;
+#endif
+
+    // A cleared bit set taken from the pool, returned on destruction
+    class BitSet
+    {
+    public:
+        BitSet(Scratch& pool, unsigned int numBits)
+        : mPool(pool)
+        {
+            {
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+                std::lock_guard<std::mutex> lock(mPool.mMutex);
+#endif
+                if (mPool.mFreeBitSets.empty()) {
+                    mBits = new std::vector<uint32_t>();
+                }
+                else {
+                    mBits = mPool.mFreeBitSets.back();
+                    mPool.mFreeBitSets.pop_back();
+                }
+            }
+            mBits->assign((numBits + 31) / 32,0);
+        }
+
+        ~BitSet()
+        {
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+            std::lock_guard<std::mutex> lock(mPool.mMutex);
+#endif
+            mPool.mFreeBitSets.push_back(mBits);
+        }
+
+        void Set(unsigned int i)
+            { (*mBits)[i >> 5] |= 1u << (i & 31); }
+
+        // Checks whether all of the first numBits bits are set
+        bool AllSet(unsigned int numBits) const
+        {
+            const unsigned int full = numBits / 32;
+            for (unsigned int i = 0; i < full; ++i) {
+                if ((*mBits)[i] != 0xffffffff) {
+                    return false;
+                }
+            }
+            const uint32_t rest = (1u << (numBits & 31)) - 1;
+            return !rest || ((*mBits)[full] & rest) == rest;
+        }
+
+    private:
+        Scratch& mPool;
+        std::vector<uint32_t>* mBits;
+    };
+
+    ~Scratch()
+    {
+        for (std::vector< std::vector<uint32_t>* >::iterator it = mFreeBitSets.begin(); it != mFreeBitSets.end(); ++it) {
+            delete *it;
+        }
+    }
+};
+
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 ValidateDSProcess::ValidateDSProcess() :
-    mScene()
+    mScene(),
+    mLevel(AI_VDS_LEVEL_FULL),
+    mScratch(new Scratch())
 {}
 
 // ------------------------------------------------------------------------------------------------
@@ -76,6 +154,13 @@ bool ValidateDSProcess::IsActive( unsigned int pFlags) const
 {
     return (pFlags & aiProcess_ValidateDataStructure) != 0;
 }
+
+// ------------------------------------------------------------------------------------------------
+// Setup configuration properties for the step
+void ValidateDSProcess::SetupProperties(const Importer* pImp)
+{
+    mLevel = pImp->GetPropertyInteger(AI_CONFIG_PP_VDS_LEVEL,AI_VDS_LEVEL_FULL);
+}
 // ------------------------------------------------------------------------------------------------
 AI_WONT_RETURN void ValidateDSProcess::ReportError(const char* msg,...)
 {
@@ -96,6 +181,9 @@ AI_WONT_RETURN void ValidateDSProcess::ReportError(const char* msg,...)
 void ValidateDSProcess::ReportWarning(const char* msg,...)
 {
     ai_assert(NULL != msg);
+    if (AI_VDS_LEVEL_FAST == mLevel) {
+        return;
+    }
 
     va_list args;
     va_start(args,msg);
@@ -105,6 +193,8 @@ void ValidateDSProcess::ReportWarning(const char* msg,...)
     ai_assert(iLen > 0);
 
     va_end(args);
+
+    // warnings of concurrent checks are logged by ParallelFor() in item order
     DefaultLogger::get()->warn("Validation warning: " + std::string(szBuffer,iLen));
 }
 
@@ -131,15 +221,15 @@ inline void ValidateDSProcess::DoValidation(T** parray, unsigned int size,
             ReportError("aiScene::%s is NULL (aiScene::%s is %i)",
                 firstName, secondName, size);
         }
-        for (unsigned int i = 0; i < size;++i)
-        {
+        // the entries don't depend on each other
+        ParallelFor(size, [&](unsigned int i) {
             if (!parray[i])
             {
                 ReportError("aiScene::%s[%i] is NULL (aiScene::%s is %i)",
                     firstName,i,secondName,size);
             }
             Validate(parray[i]);
-        }
+        });
     }
 }
 
@@ -163,6 +253,9 @@ inline void ValidateDSProcess::DoValidationEx(T** parray, unsigned int size,
                     firstName,i,secondName,size);
             }
             Validate(parray[i]);
+            if (AI_VDS_LEVEL_FAST == mLevel) {
+                continue;
+            }
 
             // check whether there are duplicate names
             for (unsigned int a = i+1; a < size;++a)
@@ -185,6 +278,9 @@ inline void ValidateDSProcess::DoValidationWithNameCheck(T** array,
 {
     // validate all entries
     DoValidationEx(array,size,firstName,secondName);
+    if (AI_VDS_LEVEL_FAST == mLevel) {
+        return;
+    }
 
     for (unsigned int i = 0; i < size;++i)
     {
@@ -321,6 +417,32 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh)
 
     Validate(&pMesh->mName);
 
+    // positions must always be there ...
+    if (!pMesh->mNumVertices || (!pMesh->mVertices && !mScene->mFlags)) {
+        ReportError("The mesh contains no vertices");
+    }
+
+    if (pMesh->mNumVertices > AI_MAX_VERTICES) {
+        ReportError("Mesh has too many vertices: %u, but the limit is %u",pMesh->mNumVertices,AI_MAX_VERTICES);
+    }
+    if (pMesh->mNumFaces > AI_MAX_FACES) {
+        ReportError("Mesh has too many faces: %u, but the limit is %u",pMesh->mNumFaces,AI_MAX_FACES);
+    }
+
+    // if tangents are there there must also be bitangent vectors ...
+    if ((pMesh->mTangents != NULL) != (pMesh->mBitangents != NULL)) {
+        ReportError("If there are tangents, bitangent vectors must be present as well");
+    }
+
+    // faces, too
+    if (!pMesh->mNumFaces || (!pMesh->mFaces && !mScene->mFlags))   {
+        ReportError("Mesh contains no faces");
+    }
+
+    // now check the primitive types and the indices of all faces in a single pass,
+    // the vertex usage is only tracked for the warning about unreferenced vertices
+    const bool trackUsage = AI_VDS_LEVEL_FAST != mLevel;
+    Scratch::BitSet refs(*mScratch,trackUsage ? pMesh->mNumVertices : 0);
     for (unsigned int i = 0; i < pMesh->mNumFaces; ++i)
     {
         aiFace& face = pMesh->mFaces[i];
@@ -364,37 +486,7 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh)
 
         if (!face.mIndices)
             ReportError("aiMesh::mFaces[%i].mIndices is NULL",i);
-    }
-
-    // positions must always be there ...
-    if (!pMesh->mNumVertices || (!pMesh->mVertices && !mScene->mFlags)) {
-        ReportError("The mesh contains no vertices");
-    }
 
-    if (pMesh->mNumVertices > AI_MAX_VERTICES) {
-        ReportError("Mesh has too many vertices: %u, but the limit is %u",pMesh->mNumVertices,AI_MAX_VERTICES);
-    }
-    if (pMesh->mNumFaces > AI_MAX_FACES) {
-        ReportError("Mesh has too many faces: %u, but the limit is %u",pMesh->mNumFaces,AI_MAX_FACES);
-    }
-
-    // if tangents are there there must also be bitangent vectors ...
-    if ((pMesh->mTangents != NULL) != (pMesh->mBitangents != NULL)) {
-        ReportError("If there are tangents, bitangent vectors must be present as well");
-    }
-
-    // faces, too
-    if (!pMesh->mNumFaces || (!pMesh->mFaces && !mScene->mFlags))   {
-        ReportError("Mesh contains no faces");
-    }
-
-    // now check whether the face indexing layout is correct:
-    // unique vertices, pseudo-indexed.
-    std::vector<bool> abRefList;
-    abRefList.resize(pMesh->mNumVertices,false);
-    for (unsigned int i = 0; i < pMesh->mNumFaces;++i)
-    {
-        aiFace& face = pMesh->mFaces[i];
         if (face.mNumIndices > AI_MAX_FACE_INDICES) {
             ReportError("Face %u has too many faces: %u, but the limit is %u",i,face.mNumIndices,AI_MAX_FACE_INDICES);
         }
@@ -404,26 +496,16 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh)
             if (face.mIndices[a] >= pMesh->mNumVertices)    {
                 ReportError("aiMesh::mFaces[%i]::mIndices[%i] is out of range",i,a);
             }
-            // the MSB flag is temporarily used by the extra verbose
-            // mode to tell us that the JoinVerticesProcess might have
-            // been executed already.
-			/*if ( !(this->mScene->mFlags & AI_SCENE_FLAGS_NON_VERBOSE_FORMAT ) && !(this->mScene->mFlags & AI_SCENE_FLAGS_ALLOW_SHARED) &&
-				abRefList[face.mIndices[a]])
-            {
-                ReportError("aiMesh::mVertices[%i] is referenced twice - second "
-                    "time by aiMesh::mFaces[%i]::mIndices[%i]",face.mIndices[a],i,a);
-            }*/
-            abRefList[face.mIndices[a]] = true;
+            if (trackUsage) {
+                refs.Set(face.mIndices[a]);
+            }
         }
     }
 
     // check whether there are vertices that aren't referenced by a face
-    bool b = false;
-    for (unsigned int i = 0; i < pMesh->mNumVertices;++i)   {
-        if (!abRefList[i])b = true;
+    if (trackUsage && !refs.AllSet(pMesh->mNumVertices)) {
+        ReportWarning("There are unreferenced vertices");
     }
-    abRefList.clear();
-    if (b)ReportWarning("There are unreferenced vertices");
 
     // texture channel 2 may not be set if channel 1 is zero ...
     {
@@ -463,8 +545,10 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh)
             ReportError("aiMesh::mBones is NULL (aiMesh::mNumBones is %i)",
                 pMesh->mNumBones);
         }
+        // the weight sums and the bone names are checked in full mode only
+        const bool full = AI_VDS_LEVEL_FAST != mLevel;
         std::unique_ptr<float[]> afSum(nullptr);
-        if (pMesh->mNumVertices)
+        if (full && pMesh->mNumVertices)
         {
             afSum.reset(new float[pMesh->mNumVertices]);
             for (unsigned int i = 0; i < pMesh->mNumVertices;++i)
@@ -485,6 +569,9 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh)
                     i,pMesh->mNumBones);
             }
             Validate(pMesh,pMesh->mBones[i],afSum.get());
+            if (!full) {
+                continue;
+            }
 
             for (unsigned int a = i+1; a < pMesh->mNumBones;++a)
             {
@@ -496,7 +583,7 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh)
             }
         }
         // check whether all bone weights for a vertex sum to 1.0 ...
-        for (unsigned int i = 0; i < pMesh->mNumVertices;++i)
+        for (unsigned int i = 0; full && i < pMesh->mNumVertices;++i)
         {
             if (afSum[i] && (afSum[i] <= 0.94 || afSum[i] >= 1.05)) {
                 ReportWarning("aiMesh::mVertices[%i]: bone weight sum != 1.0 (sum is %f)",i,afSum[i]);
@@ -507,6 +594,123 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh)
     {
         ReportError("aiMesh::mBones is non-null although there are no bones");
     }
+
+    // validate the packed skinning streams
+    if (pMesh->mNumBoneInfluences)
+    {
+        if (!pMesh->mPackedBoneIndices || !pMesh->mPackedBoneWeights)
+        {
+            ReportError("aiMesh::mPackedBoneIndices or aiMesh::mPackedBoneWeights is NULL "
+                "(aiMesh::mNumBoneInfluences is %i)",pMesh->mNumBoneInfluences);
+        }
+        if ((pMesh->mPackedBoneIndexSize != 1 && pMesh->mPackedBoneIndexSize != 2) ||
+            (pMesh->mPackedBoneWeightSize != 1 && pMesh->mPackedBoneWeightSize != 4))
+        {
+            ReportError("aiMesh::mPackedBoneIndexSize or aiMesh::mPackedBoneWeightSize is invalid");
+        }
+        for (unsigned int i = 0; i < pMesh->mNumVertices;++i)
+        {
+            for (unsigned int a = 0; a < pMesh->mNumBoneInfluences;++a)
+            {
+                if (pMesh->GetPackedBoneIndex(i,a) >= std::max(1u,pMesh->mNumBones))
+                {
+                    ReportError("aiMesh::mPackedBoneIndices: index %i of vertex %i is out of range",a,i);
+                }
+            }
+        }
+    }
+    else if (pMesh->mPackedBoneIndices || pMesh->mPackedBoneWeights)
+    {
+        ReportError("aiMesh::mPackedBoneIndices is non-null although there are no influences");
+    }
+
+    // validate the instance table
+    if (pMesh->mNumInstances)
+    {
+        if (!pMesh->mInstanceTransforms)
+        {
+            ReportError("aiMesh::mInstanceTransforms is NULL (aiMesh::mNumInstances is %i)",
+                pMesh->mNumInstances);
+        }
+    }
+    else if (pMesh->mInstanceTransforms)
+    {
+        ReportError("aiMesh::mInstanceTransforms is non-null although there are no instances");
+    }
+
+    // validate the meshlets
+    if (pMesh->mNumMeshlets)
+    {
+        if (!pMesh->mMeshlets || !pMesh->mMeshletVertices || !pMesh->mMeshletTriangles)
+        {
+            ReportError("aiMesh::mMeshlets, aiMesh::mMeshletVertices or aiMesh::mMeshletTriangles is NULL "
+                "(aiMesh::mNumMeshlets is %i)",pMesh->mNumMeshlets);
+        }
+        for (unsigned int i = 0; i < pMesh->mNumMeshlets;++i)
+        {
+            const aiMeshlet& m = pMesh->mMeshlets[i];
+            if (m.mVertexOffset + m.mNumVertices > pMesh->mNumMeshletVertices ||
+                m.mTriangleOffset + m.mNumTriangles > pMesh->mNumMeshletTriangles)
+            {
+                ReportError("aiMesh::mMeshlets[%i] is out of range",i);
+            }
+            for (unsigned int a = 0; a < m.mNumTriangles * 3;++a)
+            {
+                if (pMesh->mMeshletTriangles[m.mTriangleOffset * 3 + a] >= m.mNumVertices)
+                {
+                    ReportError("aiMesh::mMeshlets[%i]: local vertex index %i is out of range",i,a);
+                }
+            }
+        }
+        for (unsigned int i = 0; i < pMesh->mNumMeshletVertices;++i)
+        {
+            if (pMesh->mMeshletVertices[i] >= pMesh->mNumVertices)
+            {
+                ReportError("aiMesh::mMeshletVertices[%i] is out of range",i);
+            }
+        }
+    }
+    else if (pMesh->mMeshlets)
+    {
+        ReportError("aiMesh::mMeshlets is non-null although there are no meshlets");
+    }
+
+    // validate the bounding volume hierarchy
+    if (pMesh->mNumBVHNodes)
+    {
+        if (!pMesh->mBVHNodes || !pMesh->mBVHFaces)
+        {
+            ReportError("aiMesh::mBVHNodes or aiMesh::mBVHFaces is NULL (aiMesh::mNumBVHNodes is %i)",
+                pMesh->mNumBVHNodes);
+        }
+        for (unsigned int i = 0; i < pMesh->mNumBVHNodes;++i)
+        {
+            const aiBVHNode& n = pMesh->mBVHNodes[i];
+            if (n.IsLeaf() ? n.mFirst + n.mNumFaces > pMesh->mNumBVHFaces
+                : (n.mFirst <= i || n.mFirst + 1 >= pMesh->mNumBVHNodes))
+            {
+                ReportError("aiMesh::mBVHNodes[%i] is out of range",i);
+            }
+        }
+        for (unsigned int i = 0; i < pMesh->mNumBVHFaces;++i)
+        {
+            if (pMesh->mBVHFaces[i] >= pMesh->mNumBVHFaces)
+            {
+                ReportError("aiMesh::mBVHFaces[%i] is out of range",i);
+            }
+        }
+
+        // a later step changed the faces, which is allowed
+        if (pMesh->mNumBVHFaces != pMesh->mNumFaces)
+        {
+            ReportWarning("aiMesh::mBVHNodes is out of date, it was built for %i faces",
+                pMesh->mNumBVHFaces);
+        }
+    }
+    else if (pMesh->mBVHNodes || pMesh->mBVHFaces || pMesh->mNumBVHFaces)
+    {
+        ReportError("aiMesh::mBVHNodes is non-null although there is no hierarchy");
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -525,7 +729,11 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh,
         if (pBone->mWeights[i].mVertexId >= pMesh->mNumVertices)    {
             ReportError("aiBone::mWeights[%i].mVertexId is out of range",i);
         }
-        else if (!pBone->mWeights[i].mWeight || pBone->mWeights[i].mWeight > 1.0f)  {
+        if (!afSum) {
+            // fast mode, only the indices are checked
+            continue;
+        }
+        if (!pBone->mWeights[i].mWeight || pBone->mWeights[i].mWeight > 1.0f)  {
             ReportWarning("aiBone::mWeights[%i].mWeight has an invalid value",i);
         }
         afSum[pBone->mWeights[i].mVertexId] += pBone->mWeights[i].mWeight;
@@ -717,6 +925,9 @@ void ValidateDSProcess::Validate( const aiMaterial* pMaterial)
         }
         // TODO: check whether there is a key with an unknown name ...
     }
+    if (AI_VDS_LEVEL_FAST == mLevel) {
+        return;
+    }
 
     // make some more specific tests
     ai_real fTemp;
@@ -805,6 +1016,9 @@ void ValidateDSProcess::Validate( const aiAnimation* pAnimation,
     if (!pNodeAnim->mNumPositionKeys && !pNodeAnim->mScalingKeys && !pNodeAnim->mNumRotationKeys)
         ReportError("Empty node animation channel");
 
+    // the keys themselves are checked in full mode only
+    const bool full = AI_VDS_LEVEL_FAST != mLevel;
+
     // otherwise check whether one of the keys exceeds the total duration of the animation
     if (pNodeAnim->mNumPositionKeys)
     {
@@ -814,7 +1028,7 @@ void ValidateDSProcess::Validate( const aiAnimation* pAnimation,
                 pNodeAnim->mNumPositionKeys);
         }
         double dLast = -10e10;
-        for (unsigned int i = 0; i < pNodeAnim->mNumPositionKeys;++i)
+        for (unsigned int i = 0; full && i < pNodeAnim->mNumPositionKeys;++i)
         {
             // ScenePreprocessor will compute the duration if still the default value
             // (Aramis) Add small epsilon, comparison tended to fail if max_time == duration,
@@ -845,7 +1059,7 @@ void ValidateDSProcess::Validate( const aiAnimation* pAnimation,
                 pNodeAnim->mNumRotationKeys);
         }
         double dLast = -10e10;
-        for (unsigned int i = 0; i < pNodeAnim->mNumRotationKeys;++i)
+        for (unsigned int i = 0; full && i < pNodeAnim->mNumRotationKeys;++i)
         {
             if (pAnimation->mDuration > 0. && pNodeAnim->mRotationKeys[i].mTime > pAnimation->mDuration+0.001)
             {
@@ -872,7 +1086,7 @@ void ValidateDSProcess::Validate( const aiAnimation* pAnimation,
                 pNodeAnim->mNumScalingKeys);
         }
         double dLast = -10e10;
-        for (unsigned int i = 0; i < pNodeAnim->mNumScalingKeys;++i)
+        for (unsigned int i = 0; full && i < pNodeAnim->mNumScalingKeys;++i)
         {
             if (pAnimation->mDuration > 0. && pNodeAnim->mScalingKeys[i].mTime > pAnimation->mDuration+0.001)
             {
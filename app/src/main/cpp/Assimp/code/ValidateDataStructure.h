@@ -48,6 +48,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/types.h>
 #include <assimp/material.h>
 #include "BaseProcess.h"
+#include <memory>
 
 struct aiBone;
 struct aiMesh;
@@ -64,7 +65,11 @@ namespace Assimp    {
 
 // --------------------------------------------------------------------------------------
 /** Validates the whole ASSIMP scene data structure for correctness.
- *  ImportErrorException is thrown of the scene is corrupt.*/
+ *  ImportErrorException is thrown of the scene is corrupt.
+ *
+ *  Meshes, materials, animations and textures are independent of each
+ *  other and are validated concurrently. See #AI_CONFIG_PP_VDS_LEVEL
+ *  for a faster, less thorough mode. */
 // --------------------------------------------------------------------------------------
 class ValidateDSProcess : public BaseProcess
 {
@@ -77,6 +82,9 @@ public:
     // -------------------------------------------------------------------
     bool IsActive( unsigned int pFlags) const;
 
+    // -------------------------------------------------------------------
+    void SetupProperties(const Importer* pImp);
+
     // -------------------------------------------------------------------
     void Execute( aiScene* pScene);
 
@@ -177,6 +185,13 @@ private:
         const char* firstName, const char* secondName);
 
     aiScene* mScene;
+
+    /** Validation level, see #AI_CONFIG_PP_VDS_LEVEL */
+    int mLevel;
+
+    /** Scratch memory shared by the concurrently validated items */
+    struct Scratch;
+    std::unique_ptr<Scratch> mScratch;
 };
 
 
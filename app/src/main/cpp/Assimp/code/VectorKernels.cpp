@@ -0,0 +1,345 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2017, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file Implementation of the batched vector kernels used by the normal
+ *  and tangent generation, bounding box and degenerate search steps and
+ *  by the SpatialSort.
+ */
+
+// internal headers
+#include "VectorKernels.h"
+#include "qnan.h"
+#include <assimp/mesh.h>
+#include <assimp/ai_assert.h>
+#include <algorithm>
+#include <cmath>
+
+#if defined(AI_VECTORKERNELS_SSE2)
+#   include <emmintrin.h>
+#elif defined(AI_VECTORKERNELS_NEON)
+#   include <arm_neon.h>
+#endif
+
+using namespace Assimp;
+
+#if defined(AI_VECTORKERNELS_SSE2)
+    typedef __m128 simd_t;
+#   define AI_VK_LOAD(p)        _mm_loadu_ps(p)
+#   define AI_VK_STORE(p,v)     _mm_storeu_ps(p,v)
+#   define AI_VK_SPLAT(f)       _mm_set1_ps(f)
+#   define AI_VK_ADD(a,b)       _mm_add_ps(a,b)
+#   define AI_VK_SUB(a,b)       _mm_sub_ps(a,b)
+#   define AI_VK_MUL(a,b)       _mm_mul_ps(a,b)
+#   define AI_VK_DIV(a,b)       _mm_div_ps(a,b)
+#   define AI_VK_SQRT(a)        _mm_sqrt_ps(a)
+    // (a < b ? a : b) and (a > b ? a : b), same as std::min(b,a) and std::max(b,a)
+#   define AI_VK_MIN(a,b)       _mm_min_ps(a,b)
+#   define AI_VK_MAX(a,b)       _mm_max_ps(a,b)
+    // select a where the length is > 0, b otherwise
+#   define AI_VK_SELECT_GT0(len,a,b) _mm_or_ps(_mm_and_ps(_mm_cmpgt_ps(len,_mm_setzero_ps()),a), \
+        _mm_andnot_ps(_mm_cmpgt_ps(len,_mm_setzero_ps()),b))
+    // bit k is set if lane k of a is < b
+#   define AI_VK_LT_BITS(a,b)   _mm_movemask_ps(_mm_cmplt_ps(a,b))
+#   define AI_VK_WIDTH 4
+#elif defined(AI_VECTORKERNELS_NEON)
+    typedef float32x4_t simd_t;
+#   define AI_VK_LOAD(p)        vld1q_f32(p)
+#   define AI_VK_STORE(p,v)     vst1q_f32(p,v)
+#   define AI_VK_SPLAT(f)       vdupq_n_f32(f)
+#   define AI_VK_ADD(a,b)       vaddq_f32(a,b)
+#   define AI_VK_SUB(a,b)       vsubq_f32(a,b)
+#   define AI_VK_MUL(a,b)       vmulq_f32(a,b)
+#   define AI_VK_DIV(a,b)       vdivq_f32(a,b)
+#   define AI_VK_SQRT(a)        vsqrtq_f32(a)
+    // vminq_f32 and vmaxq_f32 treat NaN differently from the SSE2 and scalar code
+#   define AI_VK_MIN(a,b)       vbslq_f32(vcltq_f32(a,b),a,b)
+#   define AI_VK_MAX(a,b)       vbslq_f32(vcgtq_f32(a,b),a,b)
+#   define AI_VK_SELECT_GT0(len,a,b) vbslq_f32(vcgtq_f32(len,vdupq_n_f32(0.f)),a,b)
+#   define AI_VK_LT_BITS(a,b)   LaneBits(vcltq_f32(a,b))
+#   define AI_VK_WIDTH 4
+
+namespace {
+    // movemask replacement, one bit per lane
+    inline int LaneBits(uint32x4_t mask) {
+        static const uint32_t bits[4] = { 1, 2, 4, 8 };
+        return static_cast<int>(vaddvq_u32(vandq_u32(mask,vld1q_u32(bits))));
+    }
+}
+#endif
+
+// ------------------------------------------------------------------------------------------------
+void Assimp::CrossBatch(const ai_real* ax, const ai_real* ay, const ai_real* az,
+    const ai_real* bx, const ai_real* by, const ai_real* bz,
+    ai_real* ox, ai_real* oy, ai_real* oz, unsigned int n)
+{
+    unsigned int i = 0;
+#ifdef AI_VK_WIDTH
+    for (; i + AI_VK_WIDTH <= n; i += AI_VK_WIDTH) {
+        const simd_t vax = AI_VK_LOAD(ax+i), vay = AI_VK_LOAD(ay+i), vaz = AI_VK_LOAD(az+i);
+        const simd_t vbx = AI_VK_LOAD(bx+i), vby = AI_VK_LOAD(by+i), vbz = AI_VK_LOAD(bz+i);
+
+        AI_VK_STORE(ox+i, AI_VK_SUB(AI_VK_MUL(vay,vbz), AI_VK_MUL(vaz,vby)));
+        AI_VK_STORE(oy+i, AI_VK_SUB(AI_VK_MUL(vaz,vbx), AI_VK_MUL(vax,vbz)));
+        AI_VK_STORE(oz+i, AI_VK_SUB(AI_VK_MUL(vax,vby), AI_VK_MUL(vay,vbx)));
+    }
+#endif
+    for (; i < n; ++i) {
+        const ai_real x = ay[i]*bz[i] - az[i]*by[i];
+        const ai_real y = az[i]*bx[i] - ax[i]*bz[i];
+        const ai_real z = ax[i]*by[i] - ay[i]*bx[i];
+        ox[i] = x; oy[i] = y; oz[i] = z;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Assimp::OrthogonalizeBatch(ai_real* tx, ai_real* ty, ai_real* tz,
+    const ai_real* nx, const ai_real* ny, const ai_real* nz, unsigned int n)
+{
+    unsigned int i = 0;
+#ifdef AI_VK_WIDTH
+    for (; i + AI_VK_WIDTH <= n; i += AI_VK_WIDTH) {
+        const simd_t vtx = AI_VK_LOAD(tx+i), vty = AI_VK_LOAD(ty+i), vtz = AI_VK_LOAD(tz+i);
+        const simd_t vnx = AI_VK_LOAD(nx+i), vny = AI_VK_LOAD(ny+i), vnz = AI_VK_LOAD(nz+i);
+
+        const simd_t d = AI_VK_ADD(AI_VK_ADD(AI_VK_MUL(vtx,vnx), AI_VK_MUL(vty,vny)), AI_VK_MUL(vtz,vnz));
+        AI_VK_STORE(tx+i, AI_VK_SUB(vtx, AI_VK_MUL(vnx,d)));
+        AI_VK_STORE(ty+i, AI_VK_SUB(vty, AI_VK_MUL(vny,d)));
+        AI_VK_STORE(tz+i, AI_VK_SUB(vtz, AI_VK_MUL(vnz,d)));
+    }
+#endif
+    for (; i < n; ++i) {
+        const ai_real d = tx[i]*nx[i] + ty[i]*ny[i] + tz[i]*nz[i];
+        tx[i] -= nx[i]*d;
+        ty[i] -= ny[i]*d;
+        tz[i] -= nz[i]*d;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Assimp::NormalizeBatch(ai_real* x, ai_real* y, ai_real* z, unsigned int n, bool safe)
+{
+    unsigned int i = 0;
+#ifdef AI_VK_WIDTH
+    for (; i + AI_VK_WIDTH <= n; i += AI_VK_WIDTH) {
+        const simd_t vx = AI_VK_LOAD(x+i), vy = AI_VK_LOAD(y+i), vz = AI_VK_LOAD(z+i);
+        const simd_t len = AI_VK_SQRT(AI_VK_ADD(AI_VK_ADD(AI_VK_MUL(vx,vx), AI_VK_MUL(vy,vy)), AI_VK_MUL(vz,vz)));
+
+        simd_t rx = AI_VK_DIV(vx,len), ry = AI_VK_DIV(vy,len), rz = AI_VK_DIV(vz,len);
+        if (safe) {
+            rx = AI_VK_SELECT_GT0(len,rx,vx);
+            ry = AI_VK_SELECT_GT0(len,ry,vy);
+            rz = AI_VK_SELECT_GT0(len,rz,vz);
+        }
+        AI_VK_STORE(x+i,rx);
+        AI_VK_STORE(y+i,ry);
+        AI_VK_STORE(z+i,rz);
+    }
+#endif
+    for (; i < n; ++i) {
+        const ai_real len = std::sqrt(x[i]*x[i] + y[i]*y[i] + z[i]*z[i]);
+        if (safe && !(len > static_cast<ai_real>(0))) {
+            continue;
+        }
+        x[i] /= len; y[i] /= len; z[i] /= len;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Assimp::LengthBatch(const ai_real* x, const ai_real* y, const ai_real* z,
+    ai_real* out, unsigned int n)
+{
+    unsigned int i = 0;
+#ifdef AI_VK_WIDTH
+    for (; i + AI_VK_WIDTH <= n; i += AI_VK_WIDTH) {
+        const simd_t vx = AI_VK_LOAD(x+i), vy = AI_VK_LOAD(y+i), vz = AI_VK_LOAD(z+i);
+        AI_VK_STORE(out+i, AI_VK_SQRT(AI_VK_ADD(AI_VK_ADD(AI_VK_MUL(vx,vx), AI_VK_MUL(vy,vy)), AI_VK_MUL(vz,vz))));
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] = std::sqrt(x[i]*x[i] + y[i]*y[i] + z[i]*z[i]);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Assimp::SquareLengthBatch(const ai_real* x, const ai_real* y, const ai_real* z,
+    ai_real* out, unsigned int n)
+{
+    unsigned int i = 0;
+#ifdef AI_VK_WIDTH
+    for (; i + AI_VK_WIDTH <= n; i += AI_VK_WIDTH) {
+        const simd_t vx = AI_VK_LOAD(x+i), vy = AI_VK_LOAD(y+i), vz = AI_VK_LOAD(z+i);
+        AI_VK_STORE(out+i, AI_VK_ADD(AI_VK_ADD(AI_VK_MUL(vx,vx), AI_VK_MUL(vy,vy)), AI_VK_MUL(vz,vz)));
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] = x[i]*x[i] + y[i]*y[i] + z[i]*z[i];
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Assimp::GrowBoundsBatch(const aiVector3D* v, unsigned int n, aiVector3D& min, aiVector3D& max)
+{
+    unsigned int i = 0;
+#ifdef AI_VK_WIDTH
+    static_assert(sizeof(aiVector3D) == 3 * sizeof(ai_real), "aiVector3D is expected to be packed");
+
+    if (n > 1) {
+        // x,y,z of one vertex per load, the fourth lane holds the x of the next
+        // vertex and is never read back. The last vertex is left to the scalar
+        // loop so we never read past the end of the array.
+        ai_real lo[AI_VK_WIDTH] = { min.x, min.y, min.z, 0 };
+        ai_real hi[AI_VK_WIDTH] = { max.x, max.y, max.z, 0 };
+        simd_t vmin = AI_VK_LOAD(lo), vmax = AI_VK_LOAD(hi);
+        for (; i + 1 < n; ++i) {
+            const simd_t p = AI_VK_LOAD(&v[i].x);
+            vmin = AI_VK_MIN(vmin,p);
+            vmax = AI_VK_MAX(vmax,p);
+        }
+        AI_VK_STORE(lo,vmin);
+        AI_VK_STORE(hi,vmax);
+        min = aiVector3D(lo[0],lo[1],lo[2]);
+        max = aiVector3D(hi[0],hi[1],hi[2]);
+    }
+#endif
+    for (; i < n; ++i) {
+        min.x = std::min(v[i].x,min.x); max.x = std::max(v[i].x,max.x);
+        min.y = std::min(v[i].y,min.y); max.y = std::max(v[i].y,max.y);
+        min.z = std::min(v[i].z,min.z); max.z = std::max(v[i].z,max.z);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Assimp::CollectInRadius(const ai_real* x, const ai_real* y, const ai_real* z,
+    const ai_real* d, const unsigned int* idx, unsigned int first, unsigned int n,
+    const aiVector3D& p, ai_real maxDist, ai_real sqrRadius, std::vector<unsigned int>& out)
+{
+    unsigned int i = first;
+#ifdef AI_VK_WIDTH
+    const simd_t px = AI_VK_SPLAT(p.x), py = AI_VK_SPLAT(p.y), pz = AI_VK_SPLAT(p.z);
+    const simd_t vmax = AI_VK_SPLAT(maxDist), vsqr = AI_VK_SPLAT(sqrRadius);
+    for (; i + AI_VK_WIDTH <= n; i += AI_VK_WIDTH) {
+        const simd_t dx = AI_VK_SUB(AI_VK_LOAD(x+i),px);
+        const simd_t dy = AI_VK_SUB(AI_VK_LOAD(y+i),py);
+        const simd_t dz = AI_VK_SUB(AI_VK_LOAD(z+i),pz);
+        const simd_t sqr = AI_VK_ADD(AI_VK_ADD(AI_VK_MUL(dx,dx), AI_VK_MUL(dy,dy)), AI_VK_MUL(dz,dz));
+
+        const int inRange = AI_VK_LT_BITS(AI_VK_LOAD(d+i),vmax);
+        int hits = AI_VK_LT_BITS(sqr,vsqr);
+        if (inRange != (1 << AI_VK_WIDTH) - 1) {
+            // keep the lanes before the first one out of range, the scalar
+            // loop stops there as well
+            hits &= (~inRange & (inRange + 1)) - 1;
+        }
+        for (unsigned int k = 0; hits; ++k, hits >>= 1) {
+            if (hits & 1) {
+                out.push_back(idx[i+k]);
+            }
+        }
+        if (inRange != (1 << AI_VK_WIDTH) - 1) {
+            return;
+        }
+    }
+#endif
+    for (; i < n && d[i] < maxDist; ++i) {
+        const ai_real dx = x[i] - p.x, dy = y[i] - p.y, dz = z[i] - p.z;
+        if (dx*dx + dy*dy + dz*dz < sqrRadius) {
+            out.push_back(idx[i]);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Assimp::ComputeFaceNormalsBatched(const aiMesh* pMesh, aiVector3D* out, bool normalize)
+{
+    ai_assert(NULL != pMesh && NULL != out);
+
+    // SoA staging area for one batch of faces: edge vectors go in, normals come out
+    ai_real e1x[AI_VECTORKERNELS_BATCH_SIZE], e1y[AI_VECTORKERNELS_BATCH_SIZE], e1z[AI_VECTORKERNELS_BATCH_SIZE];
+    ai_real e2x[AI_VECTORKERNELS_BATCH_SIZE], e2y[AI_VECTORKERNELS_BATCH_SIZE], e2z[AI_VECTORKERNELS_BATCH_SIZE];
+    unsigned int faces[AI_VECTORKERNELS_BATCH_SIZE];
+
+    const ai_real qnan = get_qnan();
+    const aiVector3D* const pos = pMesh->mVertices;
+
+    unsigned int a = 0;
+    while (a < pMesh->mNumFaces) {
+        // gather the edges of the next batch of polygons
+        unsigned int cnt = 0;
+        for (; a < pMesh->mNumFaces && cnt < AI_VECTORKERNELS_BATCH_SIZE; ++a) {
+            const aiFace& face = pMesh->mFaces[a];
+            if (face.mNumIndices < 3) {
+                if (cnt) {
+                    // scatter the pending faces first, shared vertices get
+                    // the value of the last face in order, as in the scalar code
+                    break;
+                }
+                // either a point or a line -> no normal vector
+                for (unsigned int i = 0;i < face.mNumIndices;++i) {
+                    out[face.mIndices[i]] = aiVector3D(qnan);
+                }
+                continue;
+            }
+
+            const aiVector3D& v1 = pos[face.mIndices[0]];
+            const aiVector3D& v2 = pos[face.mIndices[1]];
+            const aiVector3D& v3 = pos[face.mIndices[face.mNumIndices-1]];
+            e1x[cnt] = v2.x - v1.x; e1y[cnt] = v2.y - v1.y; e1z[cnt] = v2.z - v1.z;
+            e2x[cnt] = v3.x - v1.x; e2y[cnt] = v3.y - v1.y; e2z[cnt] = v3.z - v1.z;
+            faces[cnt++] = a;
+        }
+
+        // compute the normals in place of the first edge
+        CrossBatch(e1x,e1y,e1z,e2x,e2y,e2z,e1x,e1y,e1z,cnt);
+        if (normalize) {
+            NormalizeBatch(e1x,e1y,e1z,cnt,false);
+        }
+
+        // and scatter them to all vertices of their faces
+        for (unsigned int i = 0; i < cnt; ++i) {
+            const aiFace& face = pMesh->mFaces[faces[i]];
+            const aiVector3D vNor(e1x[i],e1y[i],e1z[i]);
+            for (unsigned int n = 0; n < face.mNumIndices; ++n) {
+                out[face.mIndices[n]] = vNor;
+            }
+        }
+    }
+}
@@ -0,0 +1,142 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2017, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file VectorKernels.h
+ *  @brief Batched structure-of-arrays kernels used by the normal and
+ *    tangent generation, bounding box and degenerate search steps and
+ *    by the SpatialSort.
+ *
+ *  The kernels work on plain ai_real arrays and use SSE2 or AArch64 NEON
+ *  if available. Assimp falls back to a scalar implementation otherwise
+ *  (and always in double precision builds). All variants perform the same
+ *  sequence of IEEE operations as the corresponding aiVector3D operators,
+ *  so results match the scalar code within floating-point tolerance.
+ */
+#ifndef AI_VECTORKERNELS_H_INC
+#define AI_VECTORKERNELS_H_INC
+
+#include <assimp/types.h>
+#include <vector>
+
+struct aiMesh;
+
+#if !defined(ASSIMP_DOUBLE_PRECISION) && !defined(ASSIMP_BUILD_NO_SIMD)
+#   if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#       define AI_VECTORKERNELS_SSE2
+#   elif defined(__aarch64__) && defined(__ARM_NEON)
+#       define AI_VECTORKERNELS_NEON
+#   endif
+#endif
+
+/** Number of elements processed per batch by the face-batched helpers */
+#define AI_VECTORKERNELS_BATCH_SIZE 64
+
+namespace Assimp {
+
+// ------------------------------------------------------------------------------------------------
+/** @brief Computes o = a ^ b for n vectors stored as separate x/y/z arrays.
+ *
+ *  The output arrays may alias the input arrays. */
+void CrossBatch(const ai_real* ax, const ai_real* ay, const ai_real* az,
+    const ai_real* bx, const ai_real* by, const ai_real* bz,
+    ai_real* ox, ai_real* oy, ai_real* oz, unsigned int n);
+
+// ------------------------------------------------------------------------------------------------
+/** @brief Computes t = t - nrm * (t * nrm) for n vectors, i.e. projects t
+ *  into the plane given by the normal nrm. */
+void OrthogonalizeBatch(ai_real* tx, ai_real* ty, ai_real* tz,
+    const ai_real* nx, const ai_real* ny, const ai_real* nz, unsigned int n);
+
+// ------------------------------------------------------------------------------------------------
+/** @brief Normalizes n vectors in place.
+ *
+ *  @param safe If true, zero-length vectors are left untouched (as in
+ *    aiVector3D::NormalizeSafe), otherwise they become qnan (as in
+ *    aiVector3D::Normalize). */
+void NormalizeBatch(ai_real* x, ai_real* y, ai_real* z, unsigned int n, bool safe);
+
+// ------------------------------------------------------------------------------------------------
+/** @brief Computes the length of n vectors. */
+void LengthBatch(const ai_real* x, const ai_real* y, const ai_real* z,
+    ai_real* out, unsigned int n);
+
+// ------------------------------------------------------------------------------------------------
+/** @brief Computes the squared length of n vectors. */
+void SquareLengthBatch(const ai_real* x, const ai_real* y, const ai_real* z,
+    ai_real* out, unsigned int n);
+
+// ------------------------------------------------------------------------------------------------
+/** @brief Grows the box [min,max] to contain n positions.
+ *
+ *  Same result as std::min / std::max per component in index order, which
+ *  is what ArrayBounds() does after its own initialization. */
+void GrowBoundsBatch(const aiVector3D* v, unsigned int n, aiVector3D& min, aiVector3D& max);
+
+// ------------------------------------------------------------------------------------------------
+/** @brief Collects the positions within a radius, the search loop of SpatialSort.
+ *
+ *  Walks the arrays from index first on as long as d[i] < maxDist and
+ *  appends idx[i] to out for each position whose squared distance to p is
+ *  below sqrRadius, in array order.
+ *  @param n Number of elements in the arrays */
+void CollectInRadius(const ai_real* x, const ai_real* y, const ai_real* z,
+    const ai_real* d, const unsigned int* idx, unsigned int first, unsigned int n,
+    const aiVector3D& p, ai_real maxDist, ai_real sqrRadius, std::vector<unsigned int>& out);
+
+// ------------------------------------------------------------------------------------------------
+/** @brief Computes per-face normals and stores them per-vertex.
+ *
+ *  The mesh is expected to be in verbose format. Faces are processed in
+ *  batches of #AI_VECTORKERNELS_BATCH_SIZE: their edges are gathered into
+ *  SoA arrays, the cross products are computed with #CrossBatch and the
+ *  results are scattered back to all vertices of the face. Points and
+ *  lines receive qnan normals. A batch ends at the next point or line,
+ *  so faces are written in order and a vertex shared by several faces
+ *  ends up with the value of the last one, like the scalar loop.
+ *  @param pMesh Input mesh
+ *  @param out Output array, pMesh->mNumVertices entries
+ *  @param normalize Normalize the face normals. If false, the length of
+ *    each normal is twice the area of its triangle. */
+void ComputeFaceNormalsBatched(const aiMesh* pMesh, aiVector3D* out, bool normalize);
+
+} // end of namespace Assimp
+
+#endif // !! AI_VECTORKERNELS_H_INC
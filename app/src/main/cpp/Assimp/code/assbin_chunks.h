@@ -2,7 +2,7 @@
 #define INCLUDED_ASSBIN_CHUNKS_H
 
 #define ASSBIN_VERSION_MAJOR 1
-#define ASSBIN_VERSION_MINOR 0
+#define ASSBIN_VERSION_MINOR 1
 
 /**
 @page assfile .ASS File formats
@@ -146,6 +146,10 @@ The general 'rule' to get from Assimp headers to the serialized layout is:
      the kinds of vertex components actually present in the mesh. This is a
      bitwise combination of the ASSBIN_MESH_HAS_xxx constants.
 
+   - If ASSBIN_MESH_HAS_MESHLETS is set, the meshlets follow the bones: the
+     aiMeshlet array, the meshlet vertex array and the meshlet triangle array,
+     each prefixed with its size. Added in version 1.1.
+
 [[aiFace]]
 
    - mNumIndices is stored as short
@@ -186,6 +190,7 @@ The general 'rule' to get from Assimp headers to the serialized layout is:
 #define ASSBIN_MESH_HAS_POSITIONS                   0x1
 #define ASSBIN_MESH_HAS_NORMALS                     0x2
 #define ASSBIN_MESH_HAS_TANGENTS_AND_BITANGENTS     0x4
+#define ASSBIN_MESH_HAS_MESHLETS                    0x8
 #define ASSBIN_MESH_HAS_TEXCOORD_BASE               0x100
 #define ASSBIN_MESH_HAS_COLOR_BASE                  0x10000
 
@@ -48,7 +48,8 @@ aiNode::aiNode()
 , mChildren(NULL)
 , mNumMeshes(0)
 , mMeshes(NULL)
-, mMetaData(NULL) {
+, mMetaData(NULL)
+, mWorldAABB() {
     // empty
 }
 
@@ -59,7 +60,8 @@ aiNode::aiNode(const std::string& name)
 , mChildren(NULL)
 , mNumMeshes(0)
 , mMeshes(NULL)
-, mMetaData(NULL) {
+, mMetaData(NULL)
+, mWorldAABB() {
     // empty
 }
 
@@ -436,6 +436,53 @@ public:
         unsigned int pFlags,
         const char* pHint = "");
 
+    // -------------------------------------------------------------------
+    /** Starts an incremental import of a file which arrives in pieces,
+     *  e.g. over a network connection.
+     *
+     * Pass the pieces to #Feed() as they arrive, the loader parses all
+     * complete records at once. #FinishIncremental() parses the rest and
+     * returns the scene, so the import is done shortly after the last
+     * piece arrived instead of starting then. Only the STL and PLY
+     * loaders support incremental imports. The previous scene is deleted
+     * during this call, an unfinished incremental import is discarded.
+     * Calling this method doesn't affect the active IOSystem.
+     * @param pHint File extension of the data, used to pick the loader.
+     *   There is no signature-based detection.
+     * @param pFlags Optional post processing steps, they are executed by
+     *   #FinishIncremental(). See #ReadFile().
+     * @return false if no loader supports incremental imports of the
+     *   format. A human-readable error description can be retrieved by
+     *   calling GetErrorString().
+     */
+    bool BeginIncremental(
+        const char* pHint,
+        unsigned int pFlags);
+
+    // -------------------------------------------------------------------
+    /** Passes the next piece of the file to the incremental import
+     *  started by #BeginIncremental().
+     *
+     * The data is copied as far as it is needed, the buffer can be
+     * reused after the call.
+     * @param pBuffer Pointer to the next bytes of the file
+     * @param pLength Length of pBuffer, in bytes
+     * @return false if the data is invalid. The incremental import is
+     *   discarded then, GetErrorString() gives the details.
+     */
+    bool Feed(
+        const void* pBuffer,
+        size_t pLength);
+
+    // -------------------------------------------------------------------
+    /** Finishes the incremental import after the last piece of the file
+     *  was passed to #Feed().
+     *
+     * @return A pointer to the imported data, NULL if the import failed.
+     *   The same rules as for #ReadFile() apply.
+     */
+    const aiScene* FinishIncremental();
+
     // -------------------------------------------------------------------
     /** Apply post-processing to an already-imported scene.
      *
@@ -456,6 +503,27 @@ public:
      *    to the #Importer instance.  */
     const aiScene* ApplyPostProcessing(unsigned int pFlags);
 
+    // -------------------------------------------------------------------
+    /** Apply post-processing to a subset of the meshes of an
+     *  already-imported scene.
+     *
+     *  Use this after modifying some meshes of the scene, e.g. in an
+     *  editor. Steps which process each mesh on its own (normal, tangent
+     *  and degenerate handling, triangulation, vertex joining, cache
+     *  optimization, bone weight limiting, ...) only touch the given
+     *  meshes, so their cost is proportional to the change. Steps which
+     *  work on the scene as a whole still run on everything. If such a
+     *  step changes the number of meshes, all meshes are processed by
+     *  the remaining steps.
+     *  @param pFlags Provide a bitwise combination of the
+     *   #aiPostProcessSteps flags.
+     *  @param pDirtyMeshes Indices of the modified meshes
+     *  @param pNumDirtyMeshes Number of entries in pDirtyMeshes
+     *  @return See #ApplyPostProcessing(unsigned int) */
+    const aiScene* ApplyPostProcessing(unsigned int pFlags,
+        const unsigned int* pDirtyMeshes,
+        unsigned int pNumDirtyMeshes);
+
     const aiScene* ApplyCustomizedPostProcessing( BaseProcess *rootProcess, bool requestValidation );
 
     // -------------------------------------------------------------------
@@ -606,6 +674,14 @@ public:
      *   is (naturally) not included.*/
     void GetMemoryRequirements(aiMemoryInfo& in) const;
 
+    // -------------------------------------------------------------------
+    /** Returns what the #aiProcess_FindDegenerates step found and removed
+     * during its most recent run on a scene of this importer.
+     *
+     * @param in Data structure to be filled. All counts are zero if the
+     *   step hasn't been executed yet.*/
+    void GetDegenerateInfo(aiDegenerateInfo& in) const;
+
     // -------------------------------------------------------------------
     /** Enables "extra verbose" mode.
      *
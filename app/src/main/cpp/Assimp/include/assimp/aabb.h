@@ -0,0 +1,132 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2017, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file aabb.h
+ *  @brief Defines the aiAABB data structure
+ */
+
+#pragma once
+#ifndef AI_AABB_H_INC
+#define AI_AABB_H_INC
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ---------------------------------------------------------------------------
+/** An axis-aligned bounding box, given by its minimum and maximum corner.
+ *
+ *  Boxes are computed by the #aiProcess_GenBoundingBoxes step. A box whose
+ *  minimum is greater than its maximum on any axis is empty.
+ */
+struct aiAABB
+{
+    /** Minimum corner of the box */
+    C_STRUCT aiVector3D mMin;
+
+    /** Maximum corner of the box */
+    C_STRUCT aiVector3D mMax;
+
+#ifdef __cplusplus
+
+    aiAABB()
+        : mMin()
+        , mMax()
+    {
+    }
+
+    aiAABB(const aiVector3D& pMin, const aiVector3D& pMax)
+        : mMin(pMin)
+        , mMax(pMax)
+    {
+    }
+
+    //! Check whether the box contains any points
+    bool IsEmpty() const
+        { return mMin.x > mMax.x || mMin.y > mMax.y || mMin.z > mMax.z; }
+
+#endif // __cplusplus
+};
+
+// ---------------------------------------------------------------------------
+/** A node of a bounding volume hierarchy over the faces of a mesh.
+ *
+ *  The nodes are stored in aiMesh::mBVHNodes, the root being the first
+ *  entry. Leaves reference a range of aiMesh::mBVHFaces, inner nodes
+ *  have two children which are stored next to each other.
+ */
+struct aiBVHNode
+{
+    /** Bounds of all faces below the node, in mesh space */
+    C_STRUCT aiAABB mBounds;
+
+    /** For leaves, the first entry in aiMesh::mBVHFaces. For inner
+     *  nodes, the index of the first child in aiMesh::mBVHNodes, the
+     *  second child follows directly.
+     */
+    unsigned int mFirst;
+
+    /** Number of faces of a leaf, 0 for inner nodes */
+    unsigned int mNumFaces;
+
+#ifdef __cplusplus
+
+    aiBVHNode()
+        : mFirst( 0 )
+        , mNumFaces( 0 )
+    {
+    }
+
+    //! Check whether the node is a leaf
+    bool IsLeaf() const
+        { return mNumFaces > 0; }
+
+#endif // __cplusplus
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AI_AABB_H_INC
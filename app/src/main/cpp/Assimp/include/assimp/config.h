@@ -158,6 +158,27 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define AI_CONFIG_PP_CT_TEXTURE_CHANNEL_INDEX \
     "PP_CT_TEXTURE_CHANNEL_INDEX"
 
+// ---------------------------------------------------------------------------
+/** @brief  Compute tangents compatible with the MikkTSpace reference.
+ *
+ * If enabled, the CalcTangentSpace-Step follows the rules of the MikkTSpace
+ * reference: quads are split along their shorter diagonal in texture space,
+ * vertices with identical position, normal and texture coordinate are
+ * welded, and the angle-weighted tangents of the faces around a vertex are
+ * averaged over the faces connected by edges which share the UV orientation.
+ * Degenerate triangles take the tangents of the other corners at the same
+ * vertex. Bitangents are derived as sign * (normal x tangent). Normal maps
+ * baked for the MikkTSpace tangent basis can be used without recomputing the
+ * tangents. Only triangles and quads are supported, run the Triangulate-Step
+ * for meshes with larger polygons. A vertex shared by faces in different
+ * groups can only keep one of the tangents, so the results match the
+ * reference exactly for meshes in verbose format.
+ * #AI_CONFIG_PP_CT_MAX_SMOOTHING_ANGLE is ignored in this mode.
+ * Property type: bool. Default value: false.
+ */
+#define AI_CONFIG_PP_CT_MIKKTSPACE \
+    "PP_CT_MIKKTSPACE"
+
 // ---------------------------------------------------------------------------
 /** @brief  Specifies the maximum angle that may be between two face normals
  *          at the same vertex position that their are smoothed together.
@@ -209,6 +230,18 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define AI_CONFIG_PP_RRM_EXCLUDE_LIST   \
     "PP_RRM_EXCLUDE_LIST"
 
+// ---------------------------------------------------------------------------
+/** @brief Configures the tolerance of the #aiProcess_RemoveRedundantMaterials
+ *  step for floating-point properties.
+ *
+ * Values are rounded to multiples of this tolerance before materials are
+ * compared, so materials whose colors or factors differ only by rounding
+ * noise are merged. Set it to 0 to compare the values exactly.
+ * Property type: float. Default value: 1e-6
+ */
+#define AI_CONFIG_PP_RRM_EPSILON   \
+    "PP_RRM_EPSILON"
+
 // ---------------------------------------------------------------------------
 /** @brief Configures the #aiProcess_PreTransformVertices step to
  *  keep the scene hierarchy. Meshes are moved to worldspace, but
@@ -296,6 +329,22 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define AI_CONFIG_PP_OG_EXCLUDE_LIST    \
     "PP_OG_EXCLUDE_LIST"
 
+// ---------------------------------------------------------------------------
+/** @brief  Configures the #aiProcess_OptimizeGraph step to collect meshes
+ *  referenced by multiple nodes into instance tables.
+ *
+ *  Each such mesh gets an #aiMesh::mInstanceTransforms table with one entry
+ *  per reference and is referenced by a single new node below the root
+ *  node afterwards, so the nodes which only existed to place the copies can
+ *  be removed. Meshes with bones and meshes referenced by a node which is
+ *  animated or excluded from optimization (see #AI_CONFIG_PP_OG_EXCLUDE_LIST)
+ *  are not affected. Only set this if your application draws the tables,
+ *  e.g. with hardware instancing.
+ *  This is a boolean property, its default value is false.
+ */
+#define AI_CONFIG_PP_OG_INSTANCE_TABLES \
+    "PP_OG_INSTANCE_TABLES"
+
 // ---------------------------------------------------------------------------
 /** @brief  Set the maximum number of triangles in a mesh.
  *
@@ -337,6 +386,175 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define AI_CONFIG_PP_LBW_MAX_WEIGHTS    \
     "PP_LBW_MAX_WEIGHTS"
 
+// ---------------------------------------------------------------------------
+/** @brief  Number of bone influences per vertex written by the
+ *  #aiProcess_PackSkinning step.
+ *
+ * Property type: integer. Default value: 4, the same as
+ * #AI_CONFIG_PP_LBW_MAX_WEIGHTS.
+ */
+#define AI_CONFIG_PP_PS_MAX_INFLUENCES  \
+    "PP_PS_MAX_INFLUENCES"
+
+// ---------------------------------------------------------------------------
+/** @brief  Whether the #aiProcess_PackSkinning step stores the bone weights
+ *  as unsigned normalized 8 bit values instead of floats.
+ *
+ * The quantized weights of each vertex still sum up to exactly 255.
+ * Property type: bool. Default value: false.
+ */
+#define AI_CONFIG_PP_PS_UNORM8_WEIGHTS  \
+    "PP_PS_UNORM8_WEIGHTS"
+
+// ---------------------------------------------------------------------------
+/** @brief Set the maximum number of vertices per meshlet for the
+ *  #aiProcess_GenerateMeshlets step.
+ *
+ * Values are clamped to the range [3,256], local indices are stored in
+ * 8 bits. The default value is 64.
+ * Property type: integer.
+ */
+#define AI_CONFIG_PP_GM_MAX_VERTICES    \
+    "PP_GM_MAX_VERTICES"
+
+// ---------------------------------------------------------------------------
+/** @brief Set the maximum number of triangles per meshlet for the
+ *  #aiProcess_GenerateMeshlets step.
+ *
+ * The default value is 124, a common limit for mesh shaders.
+ * Property type: integer.
+ */
+#define AI_CONFIG_PP_GM_MAX_TRIANGLES   \
+    "PP_GM_MAX_TRIANGLES"
+
+// ---------------------------------------------------------------------------
+/** @brief Enables the construction of a bounding volume hierarchy over the
+ *  faces of each mesh in the #aiProcess_GenBoundingBoxes step.
+ *
+ * The hierarchy is built using the surface area heuristic and is stored
+ * in aiMesh::mBVHNodes. The default value is false.
+ * Property type: bool.
+ */
+#define AI_CONFIG_PP_GB_BVH \
+    "PP_GB_BVH"
+
+// ---------------------------------------------------------------------------
+/** @brief Set the maximum number of faces per leaf of the bounding volume
+ *  hierarchies built by the #aiProcess_GenBoundingBoxes step.
+ *
+ * Leaves may contain fewer faces if splitting them is cheaper according
+ * to the surface area heuristic. The default value is 4.
+ * Property type: integer.
+ */
+#define AI_CONFIG_PP_GB_BVH_MAX_LEAF_SIZE   \
+    "PP_GB_BVH_MAX_LEAF_SIZE"
+
+// ValidateDataStructure runs all checks and reports all warnings
+#define AI_VDS_LEVEL_FULL 0
+
+// ValidateDataStructure only checks for NULL pointers and indices or
+// offsets which are out of range
+#define AI_VDS_LEVEL_FAST 1
+
+// ---------------------------------------------------------------------------
+/** @brief Set how thoroughly the #aiProcess_ValidateDataStructure step
+ *  checks the scene.
+ *
+ * #AI_VDS_LEVEL_FAST skips all checks which only lead to warnings, the
+ * checks for duplicate names and the per-key checks of animations. It
+ * still guarantees that the scene can be traversed safely. This is
+ * useful if the step is run repeatedly, e.g. in extra verbose mode.
+ * The default value is #AI_VDS_LEVEL_FULL.
+ * Property type: integer.
+ */
+#define AI_CONFIG_PP_VDS_LEVEL  \
+    "PP_VDS_LEVEL"
+
+// ---------------------------------------------------------------------------
+/** @brief Set the maximum width and height of a texture atlas generated by
+ *  the #aiProcess_GenTextureAtlas step.
+ *
+ * Atlases have power of two sizes. Textures which do not fit into one
+ * atlas of this size are packed into further atlases. The default value
+ * is 4096.
+ * Property type: integer.
+ */
+#define AI_CONFIG_PP_TA_MAX_SIZE    \
+    "PP_TA_MAX_SIZE"
+
+// ---------------------------------------------------------------------------
+/** @brief Set the number of texels around each texture in an atlas
+ *  generated by the #aiProcess_GenTextureAtlas step.
+ *
+ * The padding repeats the border texels of the texture, which avoids
+ * bleeding between neighbouring textures when the atlas is filtered.
+ * The default value is 2.
+ * Property type: integer.
+ */
+#define AI_CONFIG_PP_TA_PADDING    \
+    "PP_TA_PADDING"
+
+// ---------------------------------------------------------------------------
+/** @brief Set the tolerance for position keys in the
+ *  #aiProcess_OptimizeAnimations step.
+ *
+ * A key is removed if interpolating its neighbours reproduces it up to
+ * this distance. A negative value keeps all keys. The default value is
+ * 1e-4.
+ * Property type: float.
+ */
+#define AI_CONFIG_PP_OA_POSITION_EPSILON    \
+    "PP_OA_POSITION_EPSILON"
+
+// ---------------------------------------------------------------------------
+/** @brief Set the tolerance for rotation keys in the
+ *  #aiProcess_OptimizeAnimations step.
+ *
+ * The tolerance is the angle, in radians, between a key and the rotation
+ * interpolated from its neighbours. A negative value keeps all keys. The
+ * default value is 1e-4.
+ * Property type: float.
+ */
+#define AI_CONFIG_PP_OA_ROTATION_EPSILON    \
+    "PP_OA_ROTATION_EPSILON"
+
+// ---------------------------------------------------------------------------
+/** @brief Set the tolerance for scaling keys in the
+ *  #aiProcess_OptimizeAnimations step.
+ *
+ * A negative value keeps all keys. The default value is 1e-4.
+ * Property type: float.
+ */
+#define AI_CONFIG_PP_OA_SCALING_EPSILON    \
+    "PP_OA_SCALING_EPSILON"
+
+// ---------------------------------------------------------------------------
+/** @brief Resample all node animation channels to this number of keys
+ *  per second in the #aiProcess_OptimizeAnimations step.
+ *
+ * The resampled keys are interpolated from the original ones, redundant
+ * keys are removed afterwards. The default value is 0, which keeps the
+ * original key times.
+ * Property type: float.
+ */
+#define AI_CONFIG_PP_OA_SAMPLE_RATE    \
+    "PP_OA_SAMPLE_RATE"
+
+// ---------------------------------------------------------------------------
+/** @brief Quantize rotation keys to this number of bits per component in
+ *  the #aiProcess_OptimizeAnimations step.
+ *
+ * The quaternions are normalized and their components are rounded to a
+ * signed normalized grid, i.e. to multiples of 1/(2^(bits-1)-1). The keys
+ * store the rounded values, so they are not exactly of unit length and
+ * should be normalized before use. Redundant keys are removed afterwards.
+ * Values are clamped to [3,24]. The default value is 0, which disables the
+ * quantization.
+ * Property type: integer.
+ */
+#define AI_CONFIG_PP_OA_QUANTIZE_ROTATIONS    \
+    "PP_OA_QUANTIZE_ROTATIONS"
+
 // default value for AI_CONFIG_PP_LBW_MAX_WEIGHTS
 #if (!defined AI_LMW_MAX_WEIGHTS)
 #   define AI_LMW_MAX_WEIGHTS   0x4
@@ -497,6 +715,17 @@ enum aiComponent
 #define AI_CONFIG_PP_FID_ANIM_ACCURACY              \
     "PP_FID_ANIM_ACCURACY"
 
+// ---------------------------------------------------------------------------
+/** @brief Input parameter to the #aiProcess_FindInstances step:
+ *  Also detect meshes which are copies of another mesh moved by a rigid
+ *  transformation (rotation and translation). Such meshes are removed and
+ *  replaced by a child node which carries the transformation and references
+ *  the original mesh. Meshes with bones are never merged this way.
+ *  This is a boolean property, its default value is false.
+ */
+#define AI_CONFIG_PP_FI_RIGID_INSTANCES             \
+    "PP_FI_RIGID_INSTANCES"
+
 
 // TransformUVCoords evaluates UV scalings
 #define AI_UVTRAFO_SCALING 0x1
@@ -693,6 +922,21 @@ enum aiComponent
 #define AI_CONFIG_IMPORT_AC_EVAL_SUBDIVISION    \
     "IMPORT_AC_EVAL_SUBDIVISION"
 
+// ---------------------------------------------------------------------------
+/** @brief  Enables adaptive evaluation of subdivision surfaces in the AC
+ *  loader.
+ *
+ *  If set to a positive value, the loader performs fewer subdivisions than
+ *  requested by the file as soon as a subdivision step doesn't move the
+ *  surface by more than this distance (in object space). At least one
+ *  subdivision is always performed. This has no effect if
+ *  #AI_CONFIG_IMPORT_AC_EVAL_SUBDIVISION is false.
+ *
+ * Property type: float. Default value: 0 (always perform all subdivisions)
+ */
+#define AI_CONFIG_IMPORT_AC_SUBDIVISION_MAX_ERROR    \
+    "IMPORT_AC_SUBDIVISION_MAX_ERROR"
+
 // ---------------------------------------------------------------------------
 /** @brief  Configures the UNREAL 3D loader to separate faces with different
  *    surface flags (e.g. two-sided vs. single-sided).
@@ -933,6 +1177,66 @@ enum aiComponent
  */
 #define AI_CONFIG_IMPORT_COLLADA_IGNORE_UP_DIRECTION "IMPORT_COLLADA_IGNORE_UP_DIRECTION"
 
+// ---------------------------------------------------------------------------
+/** @brief Specifies whether the OBJ loader parses the file in memory.
+ *
+ * If this property is set to true, the whole file is read into memory,
+ * split into line-aligned chunks and the chunks are parsed in parallel
+ * (if assimp is built with thread support). Set it to false to use the
+ * streaming line-by-line parser, which needs less memory for huge files.
+ * Property type: Bool. Default value: true.
+ */
+#define AI_CONFIG_IMPORT_OBJ_PARALLEL "IMPORT_OBJ_PARALLEL"
+
+// ---------------------------------------------------------------------------
+/** @brief Specifies whether the OBJ loader shares vertices between face corners.
+ *
+ * If this property is set to true, face corners which reference the same
+ * vertex, texture coordinate and normal indices share one output vertex, so
+ * the meshes are indexed right away and #aiProcess_JoinIdenticalVertices
+ * is not needed. Otherwise every face corner gets its own vertex.
+ * Property type: Bool. Default value: false.
+ */
+#define AI_CONFIG_IMPORT_OBJ_DEDUP_VERTICES "IMPORT_OBJ_DEDUP_VERTICES"
+
+// ---------------------------------------------------------------------------
+/** @brief Specifies whether the OBJ loader reads the file in two passes.
+ *
+ * If this property is set to true, the file is streamed twice. The first
+ * pass keeps the vertex data and only counts the faces of each mesh, the
+ * second pass writes the faces right into the preallocated meshes. The
+ * faces are never stored in an intermediate representation, so the peak
+ * memory is about the size of the resulting scene plus the stream window
+ * (see #AI_CONFIG_IMPORT_STREAM_WINDOW_SIZE). This mode takes precedence
+ * over #AI_CONFIG_IMPORT_OBJ_PARALLEL, and
+ * #AI_CONFIG_IMPORT_OBJ_DEDUP_VERTICES is ignored.
+ * Property type: Bool. Default value: false.
+ */
+#define AI_CONFIG_IMPORT_OBJ_TWO_PASS "IMPORT_OBJ_TWO_PASS"
+
+// ---------------------------------------------------------------------------
+/** @brief Sets the size of the window in which the streaming loaders read a file.
+ *
+ * The PLY loader and the streaming OBJ loader (see #AI_CONFIG_IMPORT_OBJ_PARALLEL)
+ * parse text lines right in this window instead of copying them. If the
+ * window is larger than the file, the whole file is read at once. A window
+ * smaller than the longest line grows on demand. The size is given in bytes,
+ * 0 selects the default of the loader, which is 16 MB for OBJ and 1 MB for PLY.
+ * Property type: integer. Default value: 0.
+ */
+#define AI_CONFIG_IMPORT_STREAM_WINDOW_SIZE "IMPORT_STREAM_WINDOW_SIZE"
+
+// ---------------------------------------------------------------------------
+/** @brief Specifies whether the STL loader welds identical vertices.
+ *
+ * STL stores three separate vertices for every facet. If this property is
+ * set to true, vertices with bitwise identical position, normal and color
+ * are merged while loading, so the meshes are indexed right away and
+ * #aiProcess_JoinIdenticalVertices is not needed.
+ * Property type: Bool. Default value: false.
+ */
+#define AI_CONFIG_IMPORT_STL_WELD_VERTICES "IMPORT_STL_WELD_VERTICES"
+
 // ---------- All the Export defines ------------
 
 /** @brief Specifies the xfile use double for real values of float
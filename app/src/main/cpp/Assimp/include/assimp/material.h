@@ -867,6 +867,20 @@ public:
     static void CopyPropertyList(aiMaterial* pcDest,
         const aiMaterial* pcSrc);
 
+    // ------------------------------------------------------------------------------
+    /** @brief Builds a hash index over the keys of all properties.
+     *
+     *  Afterwards, looking up a property by key, type and index takes
+     *  constant time instead of a linear search. This pays off for
+     *  materials with many properties that are queried frequently. The
+     *  member functions of this class keep the index up to date; if the
+     *  property list is modified directly, call this function again. */
+    void BuildPropertyIndex();
+
+    // ------------------------------------------------------------------------------
+    /** @brief Releases the index built by BuildPropertyIndex(). */
+    void ReleasePropertyIndex();
+
 
 #endif
 
@@ -878,6 +892,10 @@ public:
 
      /** Storage allocated */
     unsigned int mNumAllocated;
+
+    /** Index over the property keys, see aiMaterial::BuildPropertyIndex().
+     *  NULL unless an index was built. Internal data, do not touch */
+    void* mPropertyIndex;
 };
 
 // Go back to extern "C" again
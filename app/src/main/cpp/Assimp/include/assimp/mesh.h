@@ -48,6 +48,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define AI_MESH_H_INC
 
 #include "types.h"
+#include "aabb.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -474,6 +475,67 @@ enum aiMorphingMethod
 #endif
 }; //! enum aiMorphingMethod
 
+// ---------------------------------------------------------------------------
+/** @brief A meshlet is a small cluster of connected triangles of a mesh.
+ *
+ *  Meshlets are generated by the #aiProcess_GenerateMeshlets step and are
+ *  stored in aiMesh::mMeshlets. The vertices of a meshlet are listed in
+ *  aiMesh::mMeshletVertices, its triangles in aiMesh::mMeshletTriangles,
+ *  using 8 bit indices relative to the vertex list of the meshlet.
+ *  Bounds are given in mesh space.
+ */
+struct aiMeshlet
+{
+    /** Index of the first entry of the meshlet in aiMesh::mMeshletVertices */
+    unsigned int mVertexOffset;
+
+    /** Index of the first triangle of the meshlet in
+     *  aiMesh::mMeshletTriangles. Each triangle occupies three entries.
+     */
+    unsigned int mTriangleOffset;
+
+    /** Number of vertices referenced by the meshlet */
+    unsigned int mNumVertices;
+
+    /** Number of triangles in the meshlet */
+    unsigned int mNumTriangles;
+
+    /** Center of a bounding sphere of the meshlet. The sphere is not
+     *  necessarily the smallest possible one. */
+    C_STRUCT aiVector3D mCenter;
+
+    /** Radius of the bounding sphere */
+    ai_real mRadius;
+
+    /** Apex of the normal cone of the meshlet */
+    C_STRUCT aiVector3D mConeApex;
+
+    /** Axis of the normal cone of the meshlet, unit length */
+    C_STRUCT aiVector3D mConeAxis;
+
+    /** Cutoff of the normal cone. All triangles of the meshlet face away
+     *  from a camera at position p if
+     *  dot(normalize(mConeApex - p), mConeAxis) >= mConeCutoff.
+     *  The cutoff is 1 if the normals vary too much to ever cull the
+     *  meshlet this way.
+     */
+    ai_real mConeCutoff;
+
+#ifdef __cplusplus
+
+    aiMeshlet()
+        : mVertexOffset( 0 )
+        , mTriangleOffset( 0 )
+        , mNumVertices( 0 )
+        , mNumTriangles( 0 )
+        , mRadius( 0 )
+        , mConeCutoff( 1 )
+    {
+    }
+
+#endif // __cplusplus
+};
+
 // ---------------------------------------------------------------------------
 /** @brief A mesh represents a geometry or model with a single material.
 *
@@ -640,6 +702,118 @@ struct aiMesh
      *  Method of morphing when animeshes are specified. 
      */
     unsigned int mMethod;
+
+    /** Number of bone influences stored per vertex in the packed skinning
+     *  streams #mPackedBoneIndices and #mPackedBoneWeights. 0 if the
+     *  streams are not present. They are generated by the
+     *  #aiProcess_PackSkinning step and complement, not replace, #mBones.
+     */
+    unsigned int mNumBoneInfluences;
+
+    /** Size of a single entry of #mPackedBoneIndices in bytes. Either
+     *  1 (unsigned 8 bit index) or 2 (unsigned 16 bit index).
+     */
+    unsigned int mPackedBoneIndexSize;
+
+    /** Size of a single entry of #mPackedBoneWeights in bytes. Either
+     *  1 (unsigned normalized 8 bit weight, 255 equals 1.0) or 4 (float).
+     */
+    unsigned int mPackedBoneWeightSize;
+
+    /** Bone indices (into #mBones) per vertex, vertex-major. There are
+     *  #mNumVertices * #mNumBoneInfluences entries of
+     *  #mPackedBoneIndexSize bytes each, in native byte order. The
+     *  influences of each vertex are sorted by descending weight, unused
+     *  slots have index 0 and weight 0.
+     */
+    unsigned char* mPackedBoneIndices;
+
+    /** Bone weights per vertex, vertex-major. Same layout as
+     *  #mPackedBoneIndices, but with entries of #mPackedBoneWeightSize
+     *  bytes each. The weights of a vertex sum up to 1 (or 255).
+     */
+    unsigned char* mPackedBoneWeights;
+
+    /** Number of entries in #mInstanceTransforms. 0 if the mesh is not
+     *  instanced, which is the default.
+     */
+    unsigned int mNumInstances;
+
+    /** Instance transformation table. If present, the mesh is to be drawn
+     *  once per entry, each time with the entry applied before the
+     *  transformation of the node referencing the mesh. Such meshes are
+     *  referenced by a single node. The table is built by the
+     *  #aiProcess_OptimizeGraph step if #AI_CONFIG_PP_OG_INSTANCE_TABLES
+     *  is set, applications which don't support it should not set it.
+     *  #aiProcess_PreTransformVertices expands the table into one copy
+     *  of the mesh per instance.
+     */
+    C_STRUCT aiMatrix4x4* mInstanceTransforms;
+
+    /** Number of meshlets in #mMeshlets. 0 unless the
+     *  #aiProcess_GenerateMeshlets step was executed. The meshlets
+     *  describe the faces of the mesh at the time the step ran.
+     */
+    unsigned int mNumMeshlets;
+
+    /** The meshlets of the mesh, see #aiMeshlet. Together they cover
+     *  all triangles of the mesh.
+     */
+    C_STRUCT aiMeshlet* mMeshlets;
+
+    /** Number of entries in #mMeshletVertices */
+    unsigned int mNumMeshletVertices;
+
+    /** Vertex lists of all meshlets, indices into the vertex arrays of
+     *  the mesh. Vertices shared by multiple meshlets are listed once
+     *  per meshlet.
+     */
+    unsigned int* mMeshletVertices;
+
+    /** Number of triangles in #mMeshletTriangles */
+    unsigned int mNumMeshletTriangles;
+
+    /** Triangles of all meshlets, three entries per triangle. Each entry
+     *  is an index into the vertex list of the respective meshlet.
+     */
+    unsigned char* mMeshletTriangles;
+
+    /** Axis-aligned bounding box of the vertex positions, computed by the
+     *  #aiProcess_GenBoundingBoxes step. Left empty (all zero) otherwise.
+     */
+    C_STRUCT aiAABB mAABB;
+
+    /** Center of a bounding sphere of the vertex positions, computed by
+     *  the #aiProcess_GenBoundingBoxes step. The sphere is not necessarily
+     *  the smallest possible one.
+     */
+    C_STRUCT aiVector3D mBoundingSphereCenter;
+
+    /** Radius of the bounding sphere, 0 if it wasn't computed */
+    ai_real mBoundingSphereRadius;
+
+    /** Number of nodes in #mBVHNodes. 0 unless the
+     *  #aiProcess_GenBoundingBoxes step was executed with
+     *  #AI_CONFIG_PP_GB_BVH set. The hierarchy describes the faces of
+     *  the mesh at the time the step ran.
+     */
+    unsigned int mNumBVHNodes;
+
+    /** Bounding volume hierarchy over the faces of the mesh, see
+     *  #aiBVHNode. The first entry is the root.
+     */
+    C_STRUCT aiBVHNode* mBVHNodes;
+
+    /** Number of entries in #mBVHFaces, the number of faces the mesh had
+     *  when the hierarchy was built. Steps which change the faces later
+     *  leave the hierarchy as is, it is out of date then.
+     */
+    unsigned int mNumBVHFaces;
+
+    /** Face indices referenced by the leaves of #mBVHNodes, a permutation
+     *  of [0,#mNumBVHFaces). NULL if there is no hierarchy.
+     */
+    unsigned int* mBVHFaces;
 	
 #ifdef __cplusplus
 
@@ -659,6 +833,26 @@ struct aiMesh
         , mNumAnimMeshes( 0 )
         , mAnimMeshes( NULL )
         , mMethod( 0 )
+        , mNumBoneInfluences( 0 )
+        , mPackedBoneIndexSize( 0 )
+        , mPackedBoneWeightSize( 0 )
+        , mPackedBoneIndices( NULL )
+        , mPackedBoneWeights( NULL )
+        , mNumInstances( 0 )
+        , mInstanceTransforms( NULL )
+        , mNumMeshlets( 0 )
+        , mMeshlets( NULL )
+        , mNumMeshletVertices( 0 )
+        , mMeshletVertices( NULL )
+        , mNumMeshletTriangles( 0 )
+        , mMeshletTriangles( NULL )
+        , mAABB()
+        , mBoundingSphereCenter()
+        , mBoundingSphereRadius( 0 )
+        , mNumBVHNodes( 0 )
+        , mBVHNodes( NULL )
+        , mNumBVHFaces( 0 )
+        , mBVHFaces( NULL )
     {
         for( unsigned int a = 0; a < AI_MAX_NUMBER_OF_TEXTURECOORDS; a++)
         {
@@ -700,6 +894,14 @@ struct aiMesh
         }
 
         delete [] mFaces;
+        delete [] mPackedBoneIndices;
+        delete [] mPackedBoneWeights;
+        delete [] mInstanceTransforms;
+        delete [] mMeshlets;
+        delete [] mMeshletVertices;
+        delete [] mMeshletTriangles;
+        delete [] mBVHNodes;
+        delete [] mBVHFaces;
     }
 
     //! Check whether the mesh contains positions. Provided no special
@@ -763,6 +965,46 @@ struct aiMesh
     inline bool HasBones() const
         { return mBones != NULL && mNumBones > 0; }
 
+    //! Check whether the mesh contains packed skinning streams
+    inline bool HasPackedSkinning() const
+        { return mPackedBoneIndices != NULL && mPackedBoneWeights != NULL && mNumBoneInfluences > 0; }
+
+    //! Get a bone index from the packed skinning streams
+    //! \param pVertex Index of the vertex
+    //! \param pInfluence Index of the influence, 0 <= pInfluence < mNumBoneInfluences
+    unsigned int GetPackedBoneIndex( unsigned int pVertex, unsigned int pInfluence) const
+    {
+        const unsigned int n = pVertex * mNumBoneInfluences + pInfluence;
+        if( mPackedBoneIndexSize == 1)
+            return mPackedBoneIndices[n];
+        else
+            return reinterpret_cast<const unsigned short*>(mPackedBoneIndices)[n];
+    }
+
+    //! Get a bone weight from the packed skinning streams, converted to float
+    //! \param pVertex Index of the vertex
+    //! \param pInfluence Index of the influence, 0 <= pInfluence < mNumBoneInfluences
+    float GetPackedBoneWeight( unsigned int pVertex, unsigned int pInfluence) const
+    {
+        const unsigned int n = pVertex * mNumBoneInfluences + pInfluence;
+        if( mPackedBoneWeightSize == 1)
+            return mPackedBoneWeights[n] / 255.f;
+        else
+            return reinterpret_cast<const float*>(mPackedBoneWeights)[n];
+    }
+
+    //! Check whether the mesh has an instance transformation table
+    inline bool HasInstances() const
+        { return mInstanceTransforms != NULL && mNumInstances > 0; }
+
+    //! Check whether the mesh has been split into meshlets
+    inline bool HasMeshlets() const
+        { return mMeshlets != NULL && mNumMeshlets > 0; }
+
+    //! Check whether the mesh has a bounding volume hierarchy
+    inline bool HasBVH() const
+        { return mBVHNodes != NULL && mNumBVHNodes > 0; }
+
 #endif // __cplusplus
 };
 
@@ -75,7 +75,8 @@ enum aiPostProcessSteps
      * such as normal mapping  applied to the meshes. There's an importer property,
      * <tt>#AI_CONFIG_PP_CT_MAX_SMOOTHING_ANGLE</tt>, which allows you to specify
      * a maximum smoothing angle for the algorithm. However, usually you'll
-     * want to leave it at the default value.
+     * want to leave it at the default value. Set <tt>#AI_CONFIG_PP_CT_MIKKTSPACE</tt>
+     * to get tangents matching normal maps baked in MikkTSpace.
      */
     aiProcess_CalcTangentSpace = 0x1,
 
@@ -315,6 +316,28 @@ enum aiPostProcessSteps
     */
     aiProcess_FixInfacingNormals = 0x2000,
 
+    // -------------------------------------------------------------------------
+    /** <hr>Merges materials which differ only by their diffuse texture into
+     *  a single material that uses a texture atlas.
+     *
+     *  The textures are packed into one or more new embedded textures and
+     *  the texture coordinates of the affected meshes are remapped to the
+     *  area of the atlas their texture was copied to. Combine this flag with
+     *  #aiProcess_OptimizeMeshes and #aiProcess_OptimizeGraph to merge the
+     *  meshes which now share a material, which reduces the number of draw
+     *  calls.
+     *
+     *  Only embedded, uncompressed textures (aiTexture::mHeight != 0) are
+     *  packed, and only for meshes whose coordinates in the first UV channel
+     *  lie within [0,1]. Materials with further textures, texture transforms
+     *  or other UV channels are left untouched.
+     *
+     *  Use <tt>#AI_CONFIG_PP_TA_MAX_SIZE</tt> to limit the size of an atlas
+     *  and <tt>#AI_CONFIG_PP_TA_PADDING</tt> to set the padding around each
+     *  texture.
+     */
+    aiProcess_GenTextureAtlas = 0x4000,
+
     // -------------------------------------------------------------------------
     /** <hr>This step splits meshes with more than one primitive type in
      *  homogeneous sub-meshes.
@@ -428,6 +451,9 @@ enum aiPostProcessSteps
      *  assignment to meshes, which means that identical meshes with
      *  different materials are currently *not* joined, although this is
      *  planned for future versions.
+     *  Set #AI_CONFIG_PP_FI_RIGID_INSTANCES to also replace meshes which
+     *  are only rotated and/or translated copies of another mesh. They are
+     *  referenced through an additional child node then.
      */
     aiProcess_FindInstances = 0x100000,
 
@@ -455,6 +481,11 @@ enum aiPostProcessSteps
      *  list of node names you want to be kept. Nodes matching one of the names
      *  in this list won't be touched or modified.
      *
+     *  Meshes referenced by multiple nodes are never joined. Set
+     *  <tt>#AI_CONFIG_PP_OG_INSTANCE_TABLES</tt> to collect such references
+     *  into per-mesh instance tables (#aiMesh::mInstanceTransforms) instead,
+     *  for applications that draw them with hardware instancing.
+     *
      *  Use this flag with caution. Most simple files will be collapsed to a
      *  single node, so complex hierarchies are usually completely lost. This is not
      *  useful for editor environments, but probably a very effective
@@ -535,10 +566,86 @@ enum aiPostProcessSteps
     *
     *  Use <tt>#AI_CONFIG_GLOBAL_SCALE_FACTOR_KEY</tt> to control this.
     */
-    aiProcess_GlobalScale = 0x8000000
+    aiProcess_GlobalScale = 0x8000000,
+
+    // -------------------------------------------------------------------------
+    /** <hr>Generates vertex-major packed skinning streams for all meshes with
+     *  bones.
+     *
+     *  Assimp stores skinning data bone-major in aiBone::mWeights. This step
+     *  additionally stores a fixed number of bone indices and weights per
+     *  vertex in aiMesh::mPackedBoneIndices and aiMesh::mPackedBoneWeights,
+     *  a layout which can be uploaded to the GPU as is. Indices are 8 bit if
+     *  the mesh has no more than 256 bones, 16 bit otherwise. Vertices
+     *  affected by more bones than there are slots keep their strongest
+     *  influences, with the weights renormalized. The bones themselves are
+     *  left untouched; combine with #aiProcess_LimitBoneWeights to keep
+     *  both in sync. Meshes with more than 65536 bones are skipped, use
+     *  #aiProcess_SplitByBoneCount to avoid that.
+     *
+     *  Use <tt>#AI_CONFIG_PP_PS_MAX_INFLUENCES</tt> to set the number of
+     *  influences per vertex and <tt>#AI_CONFIG_PP_PS_UNORM8_WEIGHTS</tt> to
+     *  select the weight format.
+     */
+    aiProcess_PackSkinning = 0x10000000,
+
+    // -------------------------------------------------------------------------
+    /** <hr>Partitions all triangle meshes into meshlets, small clusters of
+     *  connected triangles for cluster-based culling and mesh shaders.
+     *
+     *  Each meshlet references a limited number of vertices and triangles
+     *  and gets a bounding sphere and a normal cone, see #aiMeshlet. The
+     *  results are stored in aiMesh::mMeshlets in addition to the regular
+     *  faces. Meshlets are built in face order, so the step should be
+     *  combined with #aiProcess_Triangulate and
+     *  #aiProcess_ImproveCacheLocality. Meshes which contain points or
+     *  lines are skipped.
+     *
+     *  Use <tt>#AI_CONFIG_PP_GM_MAX_VERTICES</tt> and
+     *  <tt>#AI_CONFIG_PP_GM_MAX_TRIANGLES</tt> to set the size limits.
+     */
+    aiProcess_GenerateMeshlets = 0x20000000,
+
+    // -------------------------------------------------------------------------
+    /** <hr>Computes bounding volumes for all meshes and nodes.
+     *
+     *  Each mesh gets an axis-aligned bounding box and a bounding sphere of
+     *  its vertex positions, each node the world-space bounding box of the
+     *  meshes in its subtree (aiNode::mWorldAABB). If
+     *  <tt>#AI_CONFIG_PP_GB_BVH</tt> is set, a bounding volume hierarchy
+     *  over the faces of each mesh is built too, see aiMesh::mBVHNodes.
+     *
+     *  The step runs after all other steps which modify vertex positions
+     *  or the node graph, so the results describe the final scene. They
+     *  are not updated if the scene is modified afterwards.
+     */
+    aiProcess_GenBoundingBoxes = 0x40000000,
+
+    // -------------------------------------------------------------------------
+    /** <hr>Removes redundant keys from node animation channels.
+     *
+     *  Importers such as FBX and Collada often produce one key per frame,
+     *  even for linear or constant motion. This step drops all position,
+     *  rotation and scaling keys which can be interpolated from the
+     *  remaining keys within a tolerance, see
+     *  <tt>#AI_CONFIG_PP_OA_POSITION_EPSILON</tt>,
+     *  <tt>#AI_CONFIG_PP_OA_ROTATION_EPSILON</tt> and
+     *  <tt>#AI_CONFIG_PP_OA_SCALING_EPSILON</tt>.
+     *
+     *  Optionally, the channels are resampled to a fixed rate first
+     *  (<tt>#AI_CONFIG_PP_OA_SAMPLE_RATE</tt>) and the components of the
+     *  rotation keys are quantized
+     *  (<tt>#AI_CONFIG_PP_OA_QUANTIZE_ROTATIONS</tt>). Mesh animations are
+     *  left untouched.
+     *
+     *  @note This is the last free bit of the 32 bit flag word. 0x80000000
+     *  does not fit into a signed int, so ISO C compilers warn about the
+     *  enumerator value in pedantic mode (C++ accepts it). New steps need
+     *  another way to be enabled.
+     */
+    aiProcess_OptimizeAnimations = 0x80000000
 
     // aiProcess_GenEntityMeshes = 0x100000,
-    // aiProcess_OptimizeAnimations = 0x200000
     // aiProcess_FixTexturePaths = 0x200000
 };
 
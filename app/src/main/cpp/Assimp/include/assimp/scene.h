@@ -128,6 +128,14 @@ struct ASSIMP_API aiNode
       */
     C_STRUCT aiMetadata* mMetaData;
 
+    /** World-space bounds of all meshes referenced by this node and its
+      * children, computed by the #aiProcess_GenBoundingBoxes step from the
+      * mesh bounding boxes. The box is conservative, not tight, if the
+      * node is rotated. Empty (see aiAABB::IsEmpty) if the subtree has no
+      * meshes, all zero if the step wasn't executed.
+      */
+    C_STRUCT aiAABB mWorldAABB;
+
 #ifdef __cplusplus
     /** Constructor */
     aiNode();
@@ -503,6 +503,40 @@ struct aiMemoryInfo
     unsigned int total;
 }; // !struct aiMemoryInfo
 
+// ----------------------------------------------------------------------------------
+/** Statistics of the #aiProcess_FindDegenerates step, counted over all meshes
+ *  processed by its most recent run.
+ *  @see Importer::GetDegenerateInfo()
+*/
+struct aiDegenerateInfo
+{
+#ifdef __cplusplus
+
+    /** Default constructor */
+    aiDegenerateInfo()
+        : degenerate        (0)
+        , removedIndices    (0)
+        , removedDegenerate (0)
+        , removedZeroArea   (0)
+    {}
+
+#endif
+
+    /** Faces which referenced the same vertex position more than once */
+    unsigned int degenerate;
+
+    /** Indices removed from degenerate faces because they duplicated a
+     *  position of the same face */
+    unsigned int removedIndices;
+
+    /** Degenerate faces removed entirely, see #AI_CONFIG_PP_FD_REMOVE */
+    unsigned int removedDegenerate;
+
+    /** Triangles removed because their area is (nearly) zero, see
+     *  #AI_CONFIG_PP_FD_CHECKAREA */
+    unsigned int removedZeroArea;
+}; // !struct aiDegenerateInfo
+
 #ifdef __cplusplus
 }
 #endif //!  __cplusplus
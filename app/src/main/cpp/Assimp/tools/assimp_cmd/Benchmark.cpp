@@ -0,0 +1,438 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2017, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file  Benchmark.cpp
+ *  @brief Implementation of the 'assimp bench' utility  */
+
+#include "Main.h"
+#include "fast_atof.h"
+#include "ParsingUtils.h"
+#include "StringUtils.h"
+#include "ByteSwapper.h"
+
+#include <stdlib.h>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+const char* AICMD_MSG_BENCH_HELP_E =
+"assimp bench <file> [<file> ...] [-n<runs>] [common parameters]\n"
+"\tImport each file several times and print the best import time and the\n"
+"\tthroughput per file and per file format. Post-processing is only done\n"
+"\tif requested by the common parameters, so by default the timings cover\n"
+"\treading and parsing the files only.\n"
+"assimp bench --numbers [-n<runs>]\n"
+"\tParse 4M generated numbers, a vertex or a face per line, with the\n"
+"\tsingle and the bulk number parsers of the text importers and print\n"
+"\tthe throughput of each.\n"
+"assimp bench --normals [-n<runs>]\n"
+"\tGenerate a grid mesh with 1M triangles and time the normal and tangent\n"
+"\tgeneration steps on it.\n"
+"\t-n<runs>: Number of runs per file, parser or step, defaults to 5\n";
+
+namespace {
+
+// -----------------------------------------------------------------------------------
+// Accumulated results for all files of a format
+struct FormatStats
+{
+	FormatStats()
+		:	files	(0)
+		,	bytes	(0)
+		,	seconds	(0.0)
+	{}
+
+	unsigned int files;
+	uint64_t bytes;
+	double seconds;
+};
+
+// -----------------------------------------------------------------------------------
+uint64_t GetFileSize(const char* path)
+{
+	FILE* file = fopen(path,"rb");
+	if (!file) {
+		return 0;
+	}
+	fseek(file,0,SEEK_END);
+	const long size = ftell(file);
+	fclose(file);
+	return size > 0 ? static_cast<uint64_t>(size) : 0;
+}
+
+// -----------------------------------------------------------------------------------
+std::string GetExtension(const std::string& path)
+{
+	const std::string::size_type pos = path.find_last_of('.');
+	if (pos == std::string::npos || path.find_first_of("/\\",pos) != std::string::npos) {
+		return "<none>";
+	}
+	std::string ext = path.substr(pos+1);
+	for (std::string::iterator it = ext.begin(); it != ext.end(); ++it) {
+		*it = static_cast<char>(::tolower(*it));
+	}
+	return ext;
+}
+
+// -----------------------------------------------------------------------------------
+double GetMegabytesPerSecond(uint64_t bytes, double seconds)
+{
+	return seconds > 0.0 ? bytes / (1024.0 * 1024.0) / seconds : 0.0;
+}
+
+// -----------------------------------------------------------------------------------
+// Generates the text of a simple mesh, lines of three reals for vertices or three
+// indices for faces. A small LCG keeps the text the same for every run.
+std::string GenerateNumbers(unsigned int numLines, bool reals)
+{
+	std::string text;
+	text.reserve(numLines * (reals ? 30 : 20));
+
+	uint32_t seed = 0x2545f491;
+	char buffer[64];
+	for (unsigned int i = 0; i < numLines; ++i) {
+		int values[3];
+		for (unsigned int k = 0; k < 3; ++k) {
+			seed = seed * 1664525u + 1013904223u;
+			values[k] = static_cast<int>(seed >> 8);
+		}
+		if (reals) {
+			ai_snprintf(buffer,sizeof(buffer),"%.6f %.6f %.6f\n",(values[0] % 2000000 - 1000000) * 1e-4,
+				(values[1] % 2000000 - 1000000) * 1e-4,(values[2] % 2000000 - 1000000) * 1e-4);
+		}
+		else {
+			ai_snprintf(buffer,sizeof(buffer),"%d %d %d\n",values[0] % 1000000,values[1] % 1000000,
+				values[2] % 1000000);
+		}
+		text += buffer;
+	}
+	return text;
+}
+
+// -----------------------------------------------------------------------------------
+// Parses all numbers of text with one of the parsers, returns their sum which
+// goes to numberSink so the work can't be optimized away. All parsers store up
+// to 256 values into a buffer which is summed up afterwards, as the importers
+// keep the values, too, so the numbers only differ by the parsers themselves.
+volatile double numberSink = 0.0;
+
+enum NumberParser
+{
+	Parser_Single,
+	Parser_Bulk,
+	Parser_Strtod
+};
+
+double ParseNumbers(const std::string& text, bool reals, NumberParser parser)
+{
+	const char* c = text.c_str();
+	const char* const end = c + text.length();
+	double sum = 0.0;
+
+	float fvalues[256];
+	unsigned int ivalues[256];
+	for (;;) {
+		size_t num = 0;
+		if (Parser_Bulk == parser) {
+			num = reals ? fast_atoreal_n<float>(c,end,fvalues,256,&c,true)
+				: strtoul10_n(c,end,ivalues,256,&c,true);
+		}
+		else {
+			for (SkipSpacesAndLineEnd(&c); c != end && num < 256; SkipSpacesAndLineEnd(&c), ++num) {
+				if (Parser_Strtod == parser) {
+					char* next;
+					if (reals) {
+						fvalues[num] = static_cast<float>(strtod(c,&next));
+					}
+					else {
+						ivalues[num] = static_cast<unsigned int>(strtoul(c,&next,10));
+					}
+					c = next;
+				}
+				else if (reals) {
+					c = fast_atoreal_move<float>(c,fvalues[num]);
+				}
+				else {
+					ivalues[num] = strtoul10(c,&c);
+				}
+			}
+		}
+		if (!num) {
+			break;
+		}
+		for (size_t i = 0; i < num; ++i) {
+			sum += reals ? fvalues[i] : ivalues[i];
+		}
+	}
+	return sum;
+}
+
+// -----------------------------------------------------------------------------------
+int BenchmarkNumbers(unsigned int runs)
+{
+	static const char* const names[] = {"fast_atoreal_move","fast_atoreal_n","strtod",
+		"strtoul10","strtoul10_n","strtoul"};
+
+	printf("%-40s %12s %12s %10s\n","parser","size [KiB]","best [ms]","MiB/s");
+	for (unsigned int type = 0; type < 2; ++type) {
+		const bool reals = !type;
+		const std::string text = GenerateNumbers(4000000 / 3,reals);
+
+		for (unsigned int p = Parser_Single; p <= Parser_Strtod; ++p) {
+			double best = 0.0;
+			for (unsigned int r = 0; r < runs; ++r) {
+				const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				numberSink = ParseNumbers(text,reals,static_cast<NumberParser>(p));
+				const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				if (!r || seconds < best) {
+					best = seconds;
+				}
+			}
+			printf("%-40s %12.1f %12.2f %10.2f\n",names[type * 3 + p],text.length()/1024.0,
+				best*1000.0,GetMegabytesPerSecond(text.length(),best));
+		}
+	}
+	return 0;
+}
+
+// -----------------------------------------------------------------------------------
+// Appends a 4 byte value to a binary little endian PLY body
+template <typename T>
+void AppendBinary(std::string& data, T value)
+{
+	static_assert(sizeof(T) == 4,"AppendBinary expects 4 byte values");
+	AI_SWAP4(value);
+	data.append(reinterpret_cast<const char*>(&value),sizeof(T));
+}
+
+// -----------------------------------------------------------------------------------
+// Generates a binary PLY grid of width*height quads, two triangles each, with
+// positions and texture coordinates. Every triangle has its own three vertices,
+// like a verbose mesh after the import. The heights come from a small LCG so the
+// normals point in different directions and the file is the same for every run.
+std::string GenerateGrid(unsigned int width, unsigned int height)
+{
+	const unsigned int numFaces = width * height * 2, numVertices = numFaces * 3;
+
+	char header[256];
+	ai_snprintf(header,sizeof(header),"ply\nformat binary_little_endian 1.0\n"
+		"element vertex %u\nproperty float x\nproperty float y\nproperty float z\n"
+		"property float s\nproperty float t\n"
+		"element face %u\nproperty list uchar int vertex_indices\nend_header\n",numVertices,numFaces);
+
+	std::vector<float> heights((width+1) * (height+1));
+	uint32_t seed = 0x2545f491;
+	for (std::vector<float>::iterator it = heights.begin(); it != heights.end(); ++it) {
+		seed = seed * 1664525u + 1013904223u;
+		*it = (seed >> 8) / static_cast<float>(1u << 24);
+	}
+
+	std::string data = header;
+	data.reserve(data.length() + numVertices * 20 + numFaces * 13);
+
+	static const unsigned int corners[2][3][2] = {{{0,0},{1,0},{1,1}},{{0,0},{1,1},{0,1}}};
+	for (unsigned int y = 0; y < height; ++y) {
+		for (unsigned int x = 0; x < width; ++x) {
+			for (unsigned int t = 0; t < 2; ++t) {
+				for (unsigned int k = 0; k < 3; ++k) {
+					const unsigned int cx = x + corners[t][k][0], cy = y + corners[t][k][1];
+					AppendBinary(data,static_cast<float>(cx));
+					AppendBinary(data,static_cast<float>(cy));
+					AppendBinary(data,heights[cy * (width+1) + cx]);
+					AppendBinary(data,cx / static_cast<float>(width));
+					AppendBinary(data,cy / static_cast<float>(height));
+				}
+			}
+		}
+	}
+	for (unsigned int f = 0; f < numFaces; ++f) {
+		data += static_cast<char>(3);
+		for (unsigned int k = 0; k < 3; ++k) {
+			AppendBinary(data,static_cast<int32_t>(f * 3 + k));
+		}
+	}
+	return data;
+}
+
+// -----------------------------------------------------------------------------------
+// Times the normal and tangent generation steps on a 1M triangle mesh. The mesh is
+// imported again for every run, only ApplyPostProcessing() is timed.
+int BenchmarkNormals(unsigned int runs)
+{
+	static const struct {
+		const char* name;
+		unsigned int prepare, step;
+	} steps[] = {
+		{"aiProcess_GenNormals",0,aiProcess_GenNormals},
+		{"aiProcess_GenSmoothNormals",0,aiProcess_GenSmoothNormals},
+		{"aiProcess_CalcTangentSpace",aiProcess_GenSmoothNormals,aiProcess_CalcTangentSpace}
+	};
+
+	const unsigned int width = 1000, height = 500, numTriangles = width * height * 2;
+	const std::string data = GenerateGrid(width,height);
+
+	printf("%-40s %12s %12s %10s\n","step","triangles","best [ms]","Mtris/s");
+	for (unsigned int s = 0; s < sizeof(steps)/sizeof(steps[0]); ++s) {
+		double best = 0.0;
+		for (unsigned int r = 0; r < runs; ++r) {
+			if (!globalImporter->ReadFileFromMemory(data.c_str(),data.length(),0,"ply") ||
+				(steps[s].prepare && !globalImporter->ApplyPostProcessing(steps[s].prepare))) {
+				printf("%-40s failed: %s\n",steps[s].name,globalImporter->GetErrorString());
+				return 5;
+			}
+
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			const aiScene* scene = globalImporter->ApplyPostProcessing(steps[s].step);
+			const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			globalImporter->FreeScene();
+
+			if (!scene) {
+				printf("%-40s failed: %s\n",steps[s].name,globalImporter->GetErrorString());
+				return 5;
+			}
+			if (!r || seconds < best) {
+				best = seconds;
+			}
+		}
+		printf("%-40s %12u %12.2f %10.2f\n",steps[s].name,numTriangles,best*1000.0,
+			best > 0.0 ? numTriangles / best * 1e-6 : 0.0);
+	}
+	return 0;
+}
+
+} // end of anonymous namespace
+
+// -----------------------------------------------------------------------------------
+int Assimp_Benchmark (const char* const* params, unsigned int num)
+{
+	if (num < 1) {
+		printf("assimp bench: Invalid number of arguments. "
+			"See \'assimp bench --help\'\n");
+		return 1;
+	}
+
+	// --help
+	if (!strcmp( params[0],"-h")||!strcmp( params[0],"--help")||!strcmp( params[0],"-?") ) {
+		printf("%s",AICMD_MSG_BENCH_HELP_E);
+		return 0;
+	}
+
+	ImportData import;
+	if (ProcessStandardArguments(import,params,num)) {
+		return 1;
+	}
+
+	// everything which isn't an option is a file
+	unsigned int runs = 5;
+	bool numbers = false, normals = false;
+	std::vector<const char*> files;
+	for (unsigned int i = 0; i < num; ++i) {
+		if (!strcmp(params[i],"--numbers")) {
+			numbers = true;
+		}
+		else if (!strcmp(params[i],"--normals")) {
+			normals = true;
+		}
+		else if (!strncmp(params[i],"-n",2)) {
+			runs = std::max(1,atoi(params[i]+2));
+		}
+		else if ('-' != params[i][0]) {
+			files.push_back(params[i]);
+		}
+	}
+	if (numbers) {
+		return BenchmarkNumbers(runs);
+	}
+	if (normals) {
+		return BenchmarkNormals(runs);
+	}
+	if (files.empty()) {
+		printf("assimp bench: No input files specified. "
+			"See \'assimp bench --help\'\n");
+		return 1;
+	}
+
+	printf("%-40s %12s %12s %10s\n","file","size [KiB]","best [ms]","MiB/s");
+
+	std::map<std::string,FormatStats> formats;
+	int result = 0;
+	for (std::vector<const char*>::const_iterator it = files.begin(); it != files.end(); ++it) {
+		const uint64_t bytes = GetFileSize(*it);
+
+		// the first import also warms up the file system cache
+		double best = 0.0;
+		std::string error;
+		for (unsigned int r = 0; r < runs && error.empty(); ++r) {
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			if (!globalImporter->ReadFile(*it,import.ppFlags)) {
+				error = globalImporter->GetErrorString();
+			}
+			const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			globalImporter->FreeScene();
+
+			if (!r || seconds < best) {
+				best = seconds;
+			}
+		}
+		if (!error.empty()) {
+			printf("%-40s failed: %s\n",*it,error.c_str());
+			result = 5;
+			continue;
+		}
+
+		printf("%-40s %12.1f %12.2f %10.2f\n",*it,bytes/1024.0,best*1000.0,
+			GetMegabytesPerSecond(bytes,best));
+
+		FormatStats& stats = formats[GetExtension(*it)];
+		++stats.files;
+		stats.bytes += bytes;
+		stats.seconds += best;
+	}
+
+	printf("\n%-40s %12s %12s %10s\n","format","files","size [KiB]","MiB/s");
+	for (std::map<std::string,FormatStats>::const_iterator it = formats.begin(); it != formats.end(); ++it) {
+		printf("%-40s %12u %12.1f %10.2f\n",it->first.c_str(),it->second.files,
+			it->second.bytes/1024.0,GetMegabytesPerSecond(it->second.bytes,it->second.seconds));
+	}
+	return result;
+}
@@ -68,6 +68,8 @@ const char* AICMD_MSG_HELP =
 " \textract    - Extract embedded texture images\n"
 " \tdump       - Convert models to a binary or textual dump (ASSBIN/ASSXML)\n"
 " \tcmpdump    - Compare dumps created using \'assimp dump <file> -s ...\'\n"
+" \tbench      - Measure the import throughput per file format, of the number parsers\n"
+" \t             or of the normal and tangent generation\n"
 " \tversion    - Display Assimp version\n"
 "\n Use \'assimp <verb> --help\' for detailed help on a command.\n"
 ;
@@ -218,6 +220,12 @@ int main (int argc, char* argv[])
 		return Assimp_Extract (&argv[2],argc-2);
 	}
 
+	// assimp bench
+	// Measure how fast files are imported
+	if (! strcmp(argv[1], "bench")) {
+		return Assimp_Benchmark (&argv[2],argc-2);
+	}
+
 	// assimp testbatchload
 	// Used by /test/other/streamload.py to load a list of files
 	// using the same importer instance to check for incompatible
@@ -195,6 +195,15 @@ int Assimp_Info (
 	const char* const* params, 
 	unsigned int num);
 
+// ------------------------------------------------------------------------------
+/** @brief assimp bench utility
+ *  @param params Command line parameters to 'assimp bench'
+ *  @param Number of params
+ *  @return 0 for success */
+int Assimp_Benchmark (
+	const char* const* params, 
+	unsigned int num);
+
 // ------------------------------------------------------------------------------
 /** @brief assimp testbatchload utility
  *  @param params Command line parameters to 'assimp testbatchload'
@@ -895,6 +895,30 @@ static bool loadMeshes(JNIEnv *env, const aiScene* cScene, jobject& jScene)
             }
         }
 
+        /* 将打包的蒙皮数据推送到 Java */
+        if (cMesh->HasPackedSkinning())
+        {
+            jvalue allocateSkinningParams[3];
+            allocateSkinningParams[0].i = cMesh->mNumBoneInfluences;
+            allocateSkinningParams[1].i = cMesh->mPackedBoneIndexSize;
+            allocateSkinningParams[2].i = cMesh->mPackedBoneWeightSize;
+            if (!callv(env, jMesh, "com/jason/jassimp/AiMesh", "allocateSkinningBuffers", "(III)V", allocateSkinningParams))
+            {
+                lprintf("无法分配蒙皮数据缓冲区\n");
+                return false;
+            }
+
+            const size_t numEntries = (size_t) cMesh->mNumVertices * cMesh->mNumBoneInfluences;
+            if (!copyBuffer(env, jMesh, "m_boneIndices", cMesh->mPackedBoneIndices, numEntries * cMesh->mPackedBoneIndexSize) ||
+                !copyBuffer(env, jMesh, "m_boneWeights", cMesh->mPackedBoneWeights, numEntries * cMesh->mPackedBoneWeightSize))
+            {
+                lprintf("无法复制蒙皮数据\n");
+                return false;
+            }
+
+            lprintf("    具有打包的蒙皮数据，每个顶点 %u 个影响\n", cMesh->mNumBoneInfluences);
+        }
+
         for (unsigned int b = 0; b < cMesh->mNumBones; b++)
         {
             aiBone *cBone = cMesh->mBones[b];
@@ -313,6 +313,122 @@ public final class AiMesh {
     public List<AiBone> getBones() {
         return m_bones;
     }
+
+    
+    /**
+     * Tells whether the mesh has packed skinning data.<p>
+     * 
+     * Packed skinning data is only available if the 
+     * {@link AiPostProcessSteps#PACK_SKINNING} post processing option was 
+     * used when loading the scene
+     * 
+     * @return true if packed bone indices and weights are available
+     */
+    public boolean hasPackedSkinning() {
+        return m_boneIndices != null && m_boneWeights != null;
+    }
+    
+    
+    /**
+     * Returns the number of bone influences stored per vertex in the packed
+     * skinning buffers.
+     * 
+     * @return the number of influences, 0 if there is no packed skinning data
+     */
+    public int getNumBoneInfluences() {
+        return m_numBoneInfluences;
+    }
+    
+    
+    /**
+     * Returns the size of a bone index in the packed skinning data.
+     * 
+     * @return 1 for unsigned 8 bit indices, 2 for unsigned 16 bit indices
+     */
+    public int getBoneIndexSize() {
+        return m_boneIndexSize;
+    }
+    
+    
+    /**
+     * Returns the size of a bone weight in the packed skinning data.
+     * 
+     * @return 1 for unsigned normalized 8 bit weights, 4 for floats
+     */
+    public int getBoneWeightSize() {
+        return m_boneWeightSize;
+    }
+    
+    
+    /**
+     * Returns a buffer containing the packed bone indices.<p>
+     * 
+     * The buffer contains <code>getNumBoneInfluences()</code> indices into 
+     * {@link #getBones()} per vertex, each <code>getBoneIndexSize()</code> 
+     * bytes large. Unused slots have index 0 and weight 0
+     * 
+     * @return a native-order direct buffer, or null
+     */
+    public ByteBuffer getBoneIndexBuffer() {
+        return m_boneIndices;
+    }
+    
+    
+    /**
+     * Returns a buffer containing the packed bone weights.<p>
+     * 
+     * The buffer has the same layout as {@link #getBoneIndexBuffer()}, with 
+     * entries of <code>getBoneWeightSize()</code> bytes
+     * 
+     * @return a native-order direct buffer, or null
+     */
+    public ByteBuffer getBoneWeightBuffer() {
+        return m_boneWeights;
+    }
+    
+    
+    /**
+     * Returns a bone index from the packed skinning data.
+     * 
+     * @param vertex the vertex index
+     * @param influence the influence index
+     * @return the bone index
+     */
+    public int getBoneIndex(int vertex, int influence) {
+        if (!hasPackedSkinning()) {
+            throw new IllegalStateException("mesh has no packed skinning data");
+        }
+        
+        checkVertexIndexBounds(vertex);
+        
+        int n = vertex * m_numBoneInfluences + influence;
+        if (m_boneIndexSize == 1) {
+            return m_boneIndices.get(n) & 0xff;
+        }
+        return m_boneIndices.getShort(n * 2) & 0xffff;
+    }
+    
+    
+    /**
+     * Returns a bone weight from the packed skinning data.
+     * 
+     * @param vertex the vertex index
+     * @param influence the influence index
+     * @return the weight, between 0 and 1
+     */
+    public float getBoneWeight(int vertex, int influence) {
+        if (!hasPackedSkinning()) {
+            throw new IllegalStateException("mesh has no packed skinning data");
+        }
+        
+        checkVertexIndexBounds(vertex);
+        
+        int n = vertex * m_numBoneInfluences + influence;
+        if (m_boneWeightSize == 1) {
+            return (m_boneWeights.get(n) & 0xff) / 255.0f;
+        }
+        return m_boneWeights.getFloat(n * SIZEOF_FLOAT);
+    }
     
     
     /**
@@ -1334,6 +1450,32 @@ public final class AiMesh {
             throw new IllegalArgumentException("unsupported channel type");
         }
     }
+    
+    
+    /**
+     * This method is used by JNI. Do not call or modify.<p>
+     * 
+     * Allocates the byte buffers for packed skinning data
+     * 
+     * @param numInfluences the number of influences per vertex
+     * @param indexSize the size of a bone index in bytes
+     * @param weightSize the size of a bone weight in bytes
+     */
+    @SuppressWarnings("unused")
+    private void allocateSkinningBuffers(int numInfluences, int indexSize,
+            int weightSize) {
+        m_numBoneInfluences = numInfluences;
+        m_boneIndexSize = indexSize;
+        m_boneWeightSize = weightSize;
+        
+        m_boneIndices = ByteBuffer.allocateDirect(
+                m_numVertices * numInfluences * indexSize);
+        m_boneIndices.order(ByteOrder.nativeOrder());
+        
+        m_boneWeights = ByteBuffer.allocateDirect(
+                m_numVertices * numInfluences * weightSize);
+        m_boneWeights.order(ByteOrder.nativeOrder());
+    }
     // }}
     
     
@@ -1430,4 +1572,34 @@ public final class AiMesh {
      * Bones.
      */
     private final List<AiBone> m_bones = new ArrayList<AiBone>();
+    
+    
+    /**
+     * Number of bone influences per vertex in the packed skinning data.
+     */
+    private int m_numBoneInfluences = 0;
+    
+    
+    /**
+     * Size of a packed bone index in bytes.
+     */
+    private int m_boneIndexSize = 0;
+    
+    
+    /**
+     * Size of a packed bone weight in bytes.
+     */
+    private int m_boneWeightSize = 0;
+    
+    
+    /**
+     * Buffer for packed bone indices.
+     */
+    private ByteBuffer m_boneIndices = null;
+    
+    
+    /**
+     * Buffer for packed bone weights.
+     */
+    private ByteBuffer m_boneWeights = null;
 }
@@ -312,6 +312,20 @@ public enum AiPostProcessSteps {
     FIX_INFACING_NORMALS(0x2000),
 
 
+    /**
+     * Merges materials which differ only by their diffuse texture into a
+     * single material that uses a texture atlas.<p>
+     *
+     * The textures are packed into new embedded textures and the texture
+     * coordinates of the affected meshes are remapped accordingly. Combine
+     * with {@link #OPTIMIZE_MESHES} and {@link #OPTIMIZE_GRAPH} to merge the meshes which now share a
+     * material. Only embedded, uncompressed textures are packed. Use the
+     * <tt>#AI_CONFIG_PP_TA_MAX_SIZE</tt> and <tt>#AI_CONFIG_PP_TA_PADDING</tt>
+     * options to configure the atlas.
+     */
+    GEN_TEXTURE_ATLAS(0x4000),
+
+
     /**
      * This step splits meshes with more than one primitive type in homogeneous
      * sub-meshes.<p>
@@ -530,7 +544,57 @@ public enum AiPostProcessSteps {
      * <tt>#AI_CONFIG_PP_DB_ALL_OR_NONE</tt> if you want bones removed if and
      * only if all bones within the scene qualify for removal.
      */
-    DEBONE(0x4000000);
+    DEBONE(0x4000000),
+
+
+    /**
+     * This step stores the bone weights of each mesh vertex-major in packed
+     * per-vertex streams.<p>
+     * 
+     * Each vertex gets a fixed number of bone index and weight slots, see
+     * {@link AiMesh#getBoneIndexBuffer()} and 
+     * {@link AiMesh#getBoneWeightBuffer()}. Vertices affected by more bones
+     * keep their strongest influences.<p>
+     * 
+     * Use <tt>#AI_CONFIG_PP_PS_MAX_INFLUENCES</tt> to set the number of slots
+     * and <tt>#AI_CONFIG_PP_PS_UNORM8_WEIGHTS</tt> to select 8 bit weights.
+     */
+    PACK_SKINNING(0x10000000),
+
+
+    /**
+     * Partitions all triangle meshes into meshlets.<p>
+     *
+     * Each meshlet references a limited number of vertices and triangles and
+     * carries a bounding sphere and a normal cone for cluster culling. Combine
+     * with {@link #TRIANGULATE} and {@link #IMPROVE_CACHE_LOCALITY}.<p>
+     *
+     * Use <tt>#AI_CONFIG_PP_GM_MAX_VERTICES</tt> and
+     * <tt>#AI_CONFIG_PP_GM_MAX_TRIANGLES</tt> to set the size limits.
+     */
+    GENERATE_MESHLETS(0x20000000),
+
+
+    /**
+     * Computes bounding volumes for all meshes and nodes.<p>
+     *
+     * Each mesh gets an axis-aligned bounding box and a bounding sphere,
+     * each node the world-space bounding box of its subtree. Set
+     * <tt>#AI_CONFIG_PP_GB_BVH</tt> to also build a bounding volume hierarchy
+     * over the faces of each mesh.
+     */
+    GEN_BOUNDING_BOXES(0x40000000),
+
+
+    /**
+     * Removes redundant keys from node animation channels.<p>
+     *
+     * Keys which can be interpolated from their neighbours within a
+     * tolerance are dropped. Optionally, the channels are resampled to a
+     * fixed rate and rotation keys are quantized. See the
+     * <tt>#AI_CONFIG_PP_OA_XXX</tt> options.
+     */
+    OPTIMIZE_ANIMATIONS(0x80000000L);
 
     
     /**